@@ -37,7 +37,8 @@ public class HearthshireVoxel : ModuleRules
         PrivateDependencyModuleNames.AddRange(
             new string[] {
                 "Slate",
-                "SlateCore"
+                "SlateCore",
+                "Json"
             }
         );
         
@@ -0,0 +1,769 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelBenchmark.h"
+#include "VoxelMeshGenerator.h"
+#include "VoxelGreedyMesher.h"
+#include "VoxelTerrainGenerator.h"
+#include "VoxelWorldTemplate.h"
+#include "HearthshireVoxelModule.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+#include <atomic>
+
+namespace VoxelBenchmark
+{
+    void AddMeshCounters(FVoxelBenchmarkResult& Result, const FVoxelMeshData& MeshData)
+    {
+        Result.Counters.Add(TEXT("vertices"), MeshData.Vertices.Num());
+        Result.Counters.Add(TEXT("triangles"), MeshData.Triangles.Num() / 3);
+        Result.Counters.Add(TEXT("translucent_triangles"), MeshData.Translucent.Triangles.Num() / 3);
+    }
+
+    void SerializeMaterials(const FVoxelChunkData& ChunkData, TArray<uint8>& OutBytes)
+    {
+        OutBytes.SetNum(ChunkData.Voxels.Num());
+        for (int32 i = 0; i < ChunkData.Voxels.Num(); i++)
+        {
+            OutBytes[i] = (uint8)ChunkData.Voxels[i].Material;
+        }
+    }
+
+    /** Quiets per-chunk generator logging so it does not dominate the timings */
+    struct FScopedLogSilence
+    {
+        ELogVerbosity::Type Previous;
+
+        FScopedLogSilence()
+        {
+            Previous = LogHearthshireVoxel.GetVerbosity();
+            LogHearthshireVoxel.SetVerbosity(ELogVerbosity::Warning);
+        }
+
+        ~FScopedLogSilence()
+        {
+            LogHearthshireVoxel.SetVerbosity(Previous);
+        }
+    };
+}
+
+FVoxelBenchmarkRunner::FVoxelBenchmarkRunner(int32 InWarmupIterations, int32 InIterations)
+{
+    WarmupIterations = FMath::Max(InWarmupIterations, 0);
+    Iterations = FMath::Max(InIterations, 1);
+}
+
+FVoxelBenchmarkResult* FVoxelBenchmarkRunner::Run(const FString& Stage, const FString& Fixture, TFunctionRef<void()> Body)
+{
+    FVoxelBenchmarkResult Result;
+    Result.Stage = Stage;
+    Result.Fixture = Fixture;
+
+    if (!PassesFilter(Result.GetName()))
+    {
+        return nullptr;
+    }
+
+    for (int32 i = 0; i < WarmupIterations; i++)
+    {
+        Body();
+    }
+
+    TArray<double> SamplesMs;
+    SamplesMs.Reserve(Iterations);
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        Body();
+        SamplesMs.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    }
+
+    ComputeStatistics(SamplesMs, Result);
+
+    return &Results.Add_GetRef(MoveTemp(Result));
+}
+
+bool FVoxelBenchmarkRunner::PassesFilter(const FString& Name) const
+{
+    if (Filter.IsEmpty())
+    {
+        return true;
+    }
+
+    TArray<FString> Terms;
+    Filter.ParseIntoArray(Terms, TEXT(","));
+    return Terms.ContainsByPredicate([&Name](const FString& Term) { return Name.Contains(Term); });
+}
+
+void FVoxelBenchmarkRunner::ComputeStatistics(TArray<double>& SamplesMs, FVoxelBenchmarkResult& OutResult)
+{
+    OutResult.Iterations = SamplesMs.Num();
+    if (SamplesMs.Num() == 0)
+    {
+        return;
+    }
+
+    SamplesMs.Sort();
+
+    // Nearest-rank percentiles
+    auto Percentile = [&SamplesMs](double P)
+    {
+        const int32 Rank = FMath::CeilToInt(P * SamplesMs.Num()) - 1;
+        return SamplesMs[FMath::Clamp(Rank, 0, SamplesMs.Num() - 1)];
+    };
+
+    double Total = 0.0;
+    for (double Sample : SamplesMs)
+    {
+        Total += Sample;
+    }
+
+    OutResult.MedianMs = Percentile(0.5);
+    OutResult.P95Ms = Percentile(0.95);
+    OutResult.P99Ms = Percentile(0.99);
+    OutResult.MeanMs = Total / SamplesMs.Num();
+    OutResult.MinMs = SamplesMs[0];
+    OutResult.MaxMs = SamplesMs.Last();
+}
+
+void FVoxelBenchmarkRunner::RunPipeline(const TArray<FVoxelBenchmarkFixture>& Fixtures)
+{
+    using namespace VoxelBenchmark;
+
+    FScopedLogSilence LogSilence;
+
+    for (const FVoxelBenchmarkFixture& Fixture : Fixtures)
+    {
+        const FVoxelChunkData& ChunkData = Fixture.ChunkData;
+
+        FFixtureInfo& Info = FixtureInfo.AddDefaulted_GetRef();
+        Info.Name = Fixture.Name;
+        Info.Size = ChunkData.ChunkSize;
+        for (const FVoxel& Voxel : ChunkData.Voxels)
+        {
+            Info.SolidVoxels += Voxel.IsSolid() ? 1 : 0;
+        }
+
+        // Generation
+        if (Fixture.Generator)
+        {
+            FVoxelChunkData Generated;
+            Generated.ChunkSize = ChunkData.ChunkSize;
+            Generated.ChunkPosition = ChunkData.ChunkPosition;
+            Run(TEXT("Generate"), Fixture.Name, [&]() { Fixture.Generator(Generated); });
+        }
+
+        // Meshing
+        FVoxelMeshData MeshData;
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("BasicMesh"), Fixture.Name,
+            [&]() { FVoxelMeshGenerator::GenerateBasicMesh(ChunkData, MeshData); }))
+        {
+            AddMeshCounters(*Result, MeshData);
+        }
+
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("GreedyMesh"), Fixture.Name,
+            [&]() { FVoxelMeshGenerator::GenerateGreedyMesh(ChunkData, MeshData); }))
+        {
+            AddMeshCounters(*Result, MeshData);
+        }
+
+        FVoxelMeshGenerator::FGenerationConfig MergedConfig;
+        MergedConfig.bMergeAcrossMaterials = true;
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("GreedyMeshMerged"), Fixture.Name,
+            [&]() { FVoxelMeshGenerator::GenerateGreedyMesh(ChunkData, MeshData, MergedConfig); }))
+        {
+            AddMeshCounters(*Result, MeshData);
+        }
+
+        // Column storage - compaction, the span mesher, and the expansion a first edit pays. Fixtures that
+        // don't fit the world's default span limit (caves, checkerboards) stop after the compaction attempt
+        FVoxelColumnChunk Columns;
+        bool bCompacted = false;
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("CompactColumns"), Fixture.Name,
+            [&]() { bCompacted = Columns.Build(ChunkData.ChunkSize.ToIntVector(), ChunkData.Voxels, 8); }))
+        {
+            Result->Counters.Add(TEXT("compacted"), bCompacted ? 1.0 : 0.0);
+            Result->Counters.Add(TEXT("dense_bytes"), ChunkData.Voxels.GetAllocatedSize());
+            Result->Counters.Add(TEXT("column_bytes"), Columns.GetAllocatedSize());
+        }
+
+        FVoxelChunkData ColumnData = ChunkData;
+        if (ColumnData.CompactToColumns(8))
+        {
+            if (FVoxelBenchmarkResult* Result = Run(TEXT("ColumnGreedyMesh"), Fixture.Name,
+                [&]() { FVoxelMeshGenerator::GenerateGreedyMesh(ColumnData, MeshData); }))
+            {
+                AddMeshCounters(*Result, MeshData);
+            }
+
+            TArray<FVoxel> Expanded;
+            if (FVoxelBenchmarkResult* Result = Run(TEXT("ExpandColumns"), Fixture.Name,
+                [&]() { ColumnData.Columns.ToDense(Expanded); }))
+            {
+                Result->Counters.Add(TEXT("roundtrip_ok"), Expanded == ChunkData.Voxels ? 1.0 : 0.0);
+            }
+        }
+
+        // LOD
+        TArray<EVoxelMaterial> LODVoxels;
+        FVoxelChunkSize LODSize;
+        for (int32 BlockSize : { 2, 4 })
+        {
+            if (FVoxelBenchmarkResult* Result = Run(FString::Printf(TEXT("Downsample%d"), BlockSize), Fixture.Name,
+                [&]() { FVoxelMeshGenerator::DownsampleVoxels(ChunkData, BlockSize, LODVoxels, LODSize); }))
+            {
+                Result->Counters.Add(TEXT("lod_voxels"), LODVoxels.Num());
+            }
+        }
+
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("LOD1Mesh"), Fixture.Name,
+            [&]() { FVoxelMeshGenerator::GenerateLODMesh(ChunkData, MeshData, 1); }))
+        {
+            AddMeshCounters(*Result, MeshData);
+        }
+
+        // Compression
+        TArray<uint8> Uncompressed;
+        SerializeMaterials(ChunkData, Uncompressed);
+
+        TArray<uint8> Compressed;
+        bool bCompressed = false;
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("Compress"), Fixture.Name,
+            [&]() { bCompressed = UVoxelTemplateUtility::CompressVoxelData(Uncompressed, Compressed); }))
+        {
+            Result->Counters.Add(TEXT("uncompressed_bytes"), Uncompressed.Num());
+            Result->Counters.Add(TEXT("compressed_bytes"), Compressed.Num());
+        }
+
+        if (!bCompressed)
+        {
+            // Filtered out or failed - decompression still needs input
+            bCompressed = UVoxelTemplateUtility::CompressVoxelData(Uncompressed, Compressed);
+        }
+
+        if (bCompressed)
+        {
+            TArray<uint8> Decompressed;
+            bool bDecompressed = false;
+            if (FVoxelBenchmarkResult* Result = Run(TEXT("Decompress"), Fixture.Name,
+                [&]() { bDecompressed = UVoxelTemplateUtility::DecompressVoxelData(Compressed, Decompressed, Uncompressed.Num()); }))
+            {
+                Result->Counters.Add(TEXT("roundtrip_ok"), bDecompressed && Decompressed == Uncompressed ? 1.0 : 0.0);
+            }
+        }
+        else
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("Benchmark: Failed to compress fixture %s"), *Fixture.Name);
+        }
+    }
+}
+
+FVoxelScalingSample FVoxelBenchmarkRunner::RunConcurrentBatch(const TArray<FVoxelBenchmarkFixture>& Fixtures, int32 BatchSize, int32 Workers, EVoxelScalingStage Stage)
+{
+    FVoxelScalingSample Sample;
+
+    // Template chunks have no generator and only take part in meshing
+    const bool bGenerates = Stage == EVoxelScalingStage::Generate || Stage == EVoxelScalingStage::GenerateAndMesh;
+    TArray<const FVoxelBenchmarkFixture*> Inputs;
+    for (const FVoxelBenchmarkFixture& Fixture : Fixtures)
+    {
+        if (!bGenerates || Fixture.Generator)
+        {
+            Inputs.Add(&Fixture);
+        }
+    }
+
+    if (Inputs.Num() == 0 || BatchSize <= 0)
+    {
+        return Sample;
+    }
+
+    VoxelBenchmark::FScopedLogSilence LogSilence;
+
+    Workers = FMath::Clamp(Workers, 1, BatchSize);
+
+    std::atomic<int32> NextChunk{ 0 };
+    std::atomic<int32> ReadyWorkers{ 0 };
+    std::atomic<bool> bStart{ false };
+    std::atomic<uint64> BusyCycles{ 0 };
+    std::atomic<uint32> ControlSink{ 0 };
+
+    auto WorkerBody = [&]()
+    {
+        uint64 LocalBusyCycles = 0;
+
+        // Spin until every worker exists so thread creation stays out of the timing
+        ReadyWorkers.fetch_add(1);
+        while (!bStart.load(std::memory_order_acquire))
+        {
+            FPlatformProcess::Yield();
+        }
+
+        for (int32 Index = NextChunk.fetch_add(1); Index < BatchSize; Index = NextChunk.fetch_add(1))
+        {
+            const FVoxelBenchmarkFixture& Fixture = *Inputs[Index % Inputs.Num()];
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+
+            switch (Stage)
+            {
+                case EVoxelScalingStage::Control:
+                {
+                    uint32 Hash = Index;
+                    for (int32 i = 0; i < Fixture.ChunkData.Voxels.Num() * 16; i++)
+                    {
+                        Hash = (Hash ^ (Hash >> 15)) * 0x2C1B3C6Du + i;
+                    }
+                    ControlSink.fetch_add(Hash, std::memory_order_relaxed);
+                    break;
+                }
+                case EVoxelScalingStage::Generate:
+                {
+                    FVoxelChunkData Generated;
+                    Generated.ChunkSize = Fixture.ChunkData.ChunkSize;
+                    Generated.ChunkPosition = Fixture.ChunkData.ChunkPosition + FIntVector(Index, 0, 0);
+                    Fixture.Generator(Generated);
+                    break;
+                }
+                case EVoxelScalingStage::GreedyMesh:
+                {
+                    FVoxelMeshData MeshData;
+                    FVoxelMeshGenerator::GenerateGreedyMesh(Fixture.ChunkData, MeshData);
+                    break;
+                }
+                case EVoxelScalingStage::GenerateAndMesh:
+                {
+                    FVoxelChunkData Generated;
+                    Generated.ChunkSize = Fixture.ChunkData.ChunkSize;
+                    Generated.ChunkPosition = Fixture.ChunkData.ChunkPosition + FIntVector(Index, 0, 0);
+                    Fixture.Generator(Generated);
+
+                    FVoxelMeshData MeshData;
+                    FVoxelMeshGenerator::GenerateGreedyMesh(Generated, MeshData);
+                    break;
+                }
+            }
+
+            LocalBusyCycles += FPlatformTime::Cycles64() - StartCycles;
+        }
+
+        BusyCycles.fetch_add(LocalBusyCycles);
+    };
+
+    // Dedicated threads rather than the task graph so the worker count is exact
+    TArray<TFuture<void>> Futures;
+    for (int32 i = 0; i < Workers; i++)
+    {
+        Futures.Add(Async(EAsyncExecution::Thread, WorkerBody));
+    }
+
+    while (ReadyWorkers.load() < Workers)
+    {
+        FPlatformProcess::Yield();
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    bStart.store(true, std::memory_order_release);
+
+    for (TFuture<void>& Future : Futures)
+    {
+        Future.Wait();
+    }
+
+    Sample.WallMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    Sample.BusyMs = FPlatformTime::ToMilliseconds64(BusyCycles.load());
+    Sample.Chunks = BatchSize;
+    return Sample;
+}
+
+void FVoxelBenchmarkRunner::RunThreadScaling(const TArray<FVoxelBenchmarkFixture>& Fixtures, int32 BatchSize, int32 MaxWorkers)
+{
+    if (MaxWorkers <= 0)
+    {
+        MaxWorkers = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    }
+
+    TArray<int32> WorkerCounts;
+    for (int32 Workers = 1; Workers < MaxWorkers; Workers *= 2)
+    {
+        WorkerCounts.Add(Workers);
+    }
+    WorkerCounts.Add(MaxWorkers);
+
+    // Per-chunk slowdown of the control stage at each worker count
+    TMap<int32, double> ControlInflation;
+
+    for (EVoxelScalingStage Stage : { EVoxelScalingStage::Control, EVoxelScalingStage::Generate, EVoxelScalingStage::GreedyMesh, EVoxelScalingStage::GenerateAndMesh })
+    {
+        const FString StageName = FString::Printf(TEXT("Scaling%s"), GetScalingStageName(Stage));
+        double BaselineChunksPerSecond = 0.0;
+        double BaselinePerChunkMs = 0.0;
+
+        for (int32 Workers : WorkerCounts)
+        {
+            FVoxelBenchmarkResult Result;
+            Result.Stage = StageName;
+            Result.Fixture = FString::Printf(TEXT("%02dT"), Workers);
+
+            if (!PassesFilter(Result.GetName()))
+            {
+                continue;
+            }
+
+            for (int32 i = 0; i < WarmupIterations; i++)
+            {
+                RunConcurrentBatch(Fixtures, BatchSize, Workers, Stage);
+            }
+
+            TArray<double> WallMs;
+            double BusyMs = 0.0;
+            int32 Chunks = 0;
+            for (int32 i = 0; i < Iterations; i++)
+            {
+                const FVoxelScalingSample Sample = RunConcurrentBatch(Fixtures, BatchSize, Workers, Stage);
+                WallMs.Add(Sample.WallMs);
+                BusyMs += Sample.BusyMs;
+                Chunks += Sample.Chunks;
+            }
+
+            if (Chunks == 0)
+            {
+                UE_LOG(LogHearthshireVoxel, Warning, TEXT("Benchmark: No fixtures usable for %s"), *StageName);
+                break;
+            }
+
+            double TotalWallMs = 0.0;
+            for (double Ms : WallMs)
+            {
+                TotalWallMs += Ms;
+            }
+
+            ComputeStatistics(WallMs, Result);
+
+            const double ChunksPerSecond = BatchSize / (Result.MedianMs / 1000.0);
+            const double PerChunkMs = BusyMs / Chunks;
+            if (Workers == 1)
+            {
+                BaselineChunksPerSecond = ChunksPerSecond;
+                BaselinePerChunkMs = PerChunkMs;
+            }
+
+            Result.Counters.Add(TEXT("workers"), Workers);
+            Result.Counters.Add(TEXT("chunks"), BatchSize);
+            Result.Counters.Add(TEXT("chunks_per_sec"), ChunksPerSecond);
+            Result.Counters.Add(TEXT("per_chunk_ms"), PerChunkMs);
+
+            // Share of the workers' time spent on chunks rather than waiting for the last one
+            Result.Counters.Add(TEXT("busy_fraction"), BusyMs / (TotalWallMs * Workers));
+
+            if (BaselineChunksPerSecond > 0.0)
+            {
+                const double SpeedUp = ChunksPerSecond / BaselineChunksPerSecond;
+                const double Efficiency = SpeedUp / Workers;
+                const double Inflation = PerChunkMs / BaselinePerChunkMs;
+                Result.Counters.Add(TEXT("speedup"), SpeedUp);
+                Result.Counters.Add(TEXT("efficiency"), Efficiency);
+                Result.Counters.Add(TEXT("per_chunk_inflation"), Inflation);
+
+                if (Stage == EVoxelScalingStage::Control)
+                {
+                    ControlInflation.Add(Workers, Inflation);
+                }
+                else if (const double* Control = ControlInflation.Find(Workers))
+                {
+                    // Slowdown beyond what clocks and SMT explain comes from shared state
+                    const double Contention = Inflation / *Control;
+                    Result.Counters.Add(TEXT("contention"), Contention);
+
+                    if (Contention > 1.3)
+                    {
+                        UE_LOG(LogHearthshireVoxel, Warning, TEXT("Benchmark: %s per-chunk time is %.2fx the control slowdown - allocator, lock or memory bandwidth contention"),
+                            *Result.GetName(), Contention);
+                    }
+                }
+            }
+
+            Results.Add(MoveTemp(Result));
+        }
+    }
+}
+
+FVoxelLayoutRecommendation FVoxelBenchmarkRunner::RunLayoutComparison(const TArray<FVoxelBenchmarkFixture>& Fixtures)
+{
+    using namespace VoxelBenchmark;
+
+    FScopedLogSilence LogSilence;
+
+    const EVoxelDataLayout Layouts[] = { EVoxelDataLayout::Linear, EVoxelDataLayout::Tiled };
+    const EVoxelFace Faces[] = { EVoxelFace::Front, EVoxelFace::Back, EVoxelFace::Right, EVoxelFace::Left, EVoxelFace::Top, EVoxelFace::Bottom };
+
+    // Summed medians per pass, linear then tiled
+    double MeshTotalMs[2] = { 0.0, 0.0 };
+    double DownsampleTotalMs[2] = { 0.0, 0.0 };
+    int32 ComparedFixtures = 0;
+
+    for (const FVoxelBenchmarkFixture& Fixture : Fixtures)
+    {
+        const FVoxelChunkData& ChunkData = Fixture.ChunkData;
+        if (!VoxelChunkKernels::SupportsTiledLayout(ChunkData.ChunkSize))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("Benchmark: %s is %dx%dx%d, which has no tiled layout - skipped"),
+                *Fixture.Name, ChunkData.ChunkSize.X, ChunkData.ChunkSize.Y, ChunkData.ChunkSize.Z);
+            continue;
+        }
+
+        // Conversion cost and round trip
+        TArray<FVoxel> Tiled;
+        TArray<FVoxel> Linear;
+        Run(TEXT("LayoutToTiled"), Fixture.Name, [&]() { VoxelChunkKernels::ConvertToTiled(ChunkData, Tiled); });
+        VoxelChunkKernels::ConvertToTiled(ChunkData, Tiled);
+        if (FVoxelBenchmarkResult* Result = Run(TEXT("LayoutToLinear"), Fixture.Name,
+            [&]() { VoxelChunkKernels::ConvertToLinear(Tiled, ChunkData.ChunkSize, Linear); }))
+        {
+            Result->Counters.Add(TEXT("roundtrip_ok"), Linear == ChunkData.Voxels ? 1.0 : 0.0);
+        }
+
+        ComparedFixtures++;
+
+        for (int32 LayoutIndex = 0; LayoutIndex < UE_ARRAY_COUNT(Layouts); LayoutIndex++)
+        {
+            const EVoxelDataLayout Layout = Layouts[LayoutIndex];
+            const TCHAR* LayoutName = Layout == EVoxelDataLayout::Tiled ? TEXT("Tiled") : TEXT("Linear");
+
+            TArray<FVoxelGreedyMesher::FGreedyQuad> Quads;
+            for (EVoxelFace Face : Faces)
+            {
+                const FString Stage = FString::Printf(TEXT("GreedyFace%s%s"), *StaticEnum<EVoxelFace>()->GetNameStringByValue((int64)Face), LayoutName);
+                if (FVoxelBenchmarkResult* Result = Run(Stage, Fixture.Name,
+                    [&]() { FVoxelGreedyMesher::GenerateFaceQuads(ChunkData, Face, Quads, false, Layout); }))
+                {
+                    Result->Counters.Add(TEXT("quads"), Quads.Num());
+                }
+            }
+
+            FVoxelMeshGenerator::FGenerationConfig Config;
+            Config.Layout = Layout;
+            FVoxelMeshData MeshData;
+            if (FVoxelBenchmarkResult* Result = Run(FString::Printf(TEXT("GreedyMesh%s"), LayoutName), Fixture.Name,
+                [&]() { FVoxelMeshGenerator::GenerateGreedyMesh(ChunkData, MeshData, Config); }))
+            {
+                AddMeshCounters(*Result, MeshData);
+                MeshTotalMs[LayoutIndex] += Result->MedianMs;
+            }
+
+            TArray<EVoxelMaterial> LODVoxels;
+            FVoxelChunkSize LODSize;
+            for (int32 BlockSize : { 2, 4 })
+            {
+                if (FVoxelBenchmarkResult* Result = Run(FString::Printf(TEXT("Downsample%d%s"), BlockSize, LayoutName), Fixture.Name,
+                    [&]() { FVoxelMeshGenerator::DownsampleVoxels(ChunkData, BlockSize, LODVoxels, LODSize, Layout); }))
+                {
+                    Result->Counters.Add(TEXT("lod_voxels"), LODVoxels.Num());
+                    DownsampleTotalMs[LayoutIndex] += Result->MedianMs;
+                }
+            }
+        }
+    }
+
+    FVoxelLayoutRecommendation Recommendation;
+
+    auto Decide = [this, ComparedFixtures](const TCHAR* PassName, const double (&TotalMs)[2], EVoxelDataLayout& OutLayout)
+    {
+        // Filtered out on either side - nothing to compare
+        if (TotalMs[0] <= 0.0 || TotalMs[1] <= 0.0)
+        {
+            return;
+        }
+
+        OutLayout = TotalMs[1] < TotalMs[0] ? EVoxelDataLayout::Tiled : EVoxelDataLayout::Linear;
+
+        FVoxelBenchmarkResult Result;
+        Result.Stage = FString::Printf(TEXT("Layout%s"), PassName);
+        Result.Fixture = TEXT("Total");
+        Result.Iterations = Iterations;
+        Result.MedianMs = FMath::Min(TotalMs[0], TotalMs[1]);
+        Result.Counters.Add(TEXT("fixtures"), ComparedFixtures);
+        Result.Counters.Add(TEXT("linear_ms"), TotalMs[0]);
+        Result.Counters.Add(TEXT("tiled_ms"), TotalMs[1]);
+        Result.Counters.Add(TEXT("tiled_speedup"), TotalMs[0] / TotalMs[1]);
+        Results.Add(MoveTemp(Result));
+
+        UE_LOG(LogHearthshireVoxel, Display, TEXT("Benchmark: %s pass %.3fms linear, %.3fms tiled over %d chunks - %s is faster"),
+            PassName, TotalMs[0], TotalMs[1], ComparedFixtures, OutLayout == EVoxelDataLayout::Tiled ? TEXT("tiled") : TEXT("linear"));
+    };
+
+    Decide(TEXT("Mesh"), MeshTotalMs, Recommendation.Mesh);
+    Decide(TEXT("Downsample"), DownsampleTotalMs, Recommendation.Downsample);
+
+    return Recommendation;
+}
+
+const TCHAR* FVoxelBenchmarkRunner::GetScalingStageName(EVoxelScalingStage Stage)
+{
+    switch (Stage)
+    {
+        case EVoxelScalingStage::Control: return TEXT("Control");
+        case EVoxelScalingStage::Generate: return TEXT("Generate");
+        case EVoxelScalingStage::GreedyMesh: return TEXT("GreedyMesh");
+        case EVoxelScalingStage::GenerateAndMesh: return TEXT("GenerateAndMesh");
+        default: return TEXT("Unknown");
+    }
+}
+
+FString FVoxelBenchmarkRunner::GetSummary() const
+{
+    FString Summary = FString::Printf(TEXT("%-36s %10s %10s %10s %10s\n"), TEXT("Case"), TEXT("Median ms"), TEXT("P95 ms"), TEXT("P99 ms"), TEXT("Max ms"));
+
+    for (const FVoxelBenchmarkResult& Result : Results)
+    {
+        Summary += FString::Printf(TEXT("%-36s %10.3f %10.3f %10.3f %10.3f\n"),
+            *Result.GetName(), Result.MedianMs, Result.P95Ms, Result.P99Ms, Result.MaxMs);
+    }
+
+    return Summary;
+}
+
+FString FVoxelBenchmarkRunner::ToJson() const
+{
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetStringField(TEXT("suite"), TEXT("HearthshireVoxel"));
+    Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+    Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+    Root->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Root->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+    Root->SetNumberField(TEXT("cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    Root->SetNumberField(TEXT("warmup_iterations"), WarmupIterations);
+    Root->SetNumberField(TEXT("iterations"), Iterations);
+
+    TArray<TSharedPtr<FJsonValue>> FixtureValues;
+    for (const FFixtureInfo& Info : FixtureInfo)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetStringField(TEXT("name"), Info.Name);
+        Object->SetStringField(TEXT("size"), FString::Printf(TEXT("%dx%dx%d"), Info.Size.X, Info.Size.Y, Info.Size.Z));
+        Object->SetNumberField(TEXT("solid_voxels"), Info.SolidVoxels);
+        FixtureValues.Add(MakeShared<FJsonValueObject>(Object));
+    }
+    Root->SetArrayField(TEXT("fixtures"), FixtureValues);
+
+    TArray<TSharedPtr<FJsonValue>> ResultValues;
+    for (const FVoxelBenchmarkResult& Result : Results)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetStringField(TEXT("name"), Result.GetName());
+        Object->SetStringField(TEXT("stage"), Result.Stage);
+        Object->SetStringField(TEXT("fixture"), Result.Fixture);
+        Object->SetNumberField(TEXT("iterations"), Result.Iterations);
+        Object->SetNumberField(TEXT("median_ms"), Result.MedianMs);
+        Object->SetNumberField(TEXT("p95_ms"), Result.P95Ms);
+        Object->SetNumberField(TEXT("p99_ms"), Result.P99Ms);
+        Object->SetNumberField(TEXT("mean_ms"), Result.MeanMs);
+        Object->SetNumberField(TEXT("min_ms"), Result.MinMs);
+        Object->SetNumberField(TEXT("max_ms"), Result.MaxMs);
+
+        TSharedRef<FJsonObject> Counters = MakeShared<FJsonObject>();
+        for (const TPair<FString, double>& Counter : Result.Counters)
+        {
+            Counters->SetNumberField(Counter.Key, Counter.Value);
+        }
+        Object->SetObjectField(TEXT("counters"), Counters);
+
+        ResultValues.Add(MakeShared<FJsonValueObject>(Object));
+    }
+    Root->SetArrayField(TEXT("results"), ResultValues);
+
+    FString Output;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+    FJsonSerializer::Serialize(Root, Writer);
+    return Output;
+}
+
+bool FVoxelBenchmarkRunner::SaveJson(const FString& FilePath) const
+{
+    if (!FFileHelper::SaveStringToFile(ToJson(), *FilePath))
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("Benchmark: Failed to write results to %s"), *FilePath);
+        return false;
+    }
+
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("Benchmark: Wrote %d results to %s"), Results.Num(), *FilePath);
+    return true;
+}
+
+void FVoxelBenchmarkRunner::BuildSyntheticFixtures(const FVoxelChunkSize& ChunkSize, TArray<FVoxelBenchmarkFixture>& OutFixtures)
+{
+    auto AddFixture = [&](const TCHAR* Name, TFunction<void(FVoxelChunkData&)> Generator)
+    {
+        FVoxelBenchmarkFixture& Fixture = OutFixtures.AddDefaulted_GetRef();
+        Fixture.Name = Name;
+        Fixture.ChunkData.ChunkSize = ChunkSize;
+        Fixture.ChunkData.ChunkPosition = FIntVector(3, 5, 0); // Away from the noise origin
+        Fixture.Generator = MoveTemp(Generator);
+        Fixture.Generator(Fixture.ChunkData);
+    };
+
+    AddFixture(TEXT("Flat"), [SurfaceHeight = ChunkSize.Z / 2](FVoxelChunkData& ChunkData)
+    {
+        FVoxelTerrainGenerator::GenerateFlat(ChunkData, SurfaceHeight);
+    });
+
+    AddFixture(TEXT("Hills"), [](FVoxelChunkData& ChunkData)
+    {
+        FVoxelTerrainGenerator::GenerateRollingHills(ChunkData);
+    });
+
+    AddFixture(TEXT("Caves"), [](FVoxelChunkData& ChunkData)
+    {
+        FVoxelTerrainGenerator::GenerateCaves(ChunkData);
+    });
+
+    AddFixture(TEXT("Checkerboard"), [](FVoxelChunkData& ChunkData)
+    {
+        FVoxelTerrainGenerator::GenerateCheckerboard(ChunkData);
+    });
+}
+
+int32 FVoxelBenchmarkRunner::AddTemplateFixtures(UVoxelWorldTemplate* Template, int32 MaxChunks, TArray<FVoxelBenchmarkFixture>& OutFixtures)
+{
+    if (!Template)
+    {
+        return 0;
+    }
+
+    VoxelBenchmark::FScopedLogSilence LogSilence;
+
+    int32 Added = 0;
+    for (const FVoxelTemplateChunk& TemplateChunk : Template->ChunkData)
+    {
+        if (Added >= MaxChunks)
+        {
+            break;
+        }
+
+        if (!TemplateChunk.bHasData)
+        {
+            continue;
+        }
+
+        FVoxelBenchmarkFixture Fixture;
+        if (UVoxelTemplateUtility::LoadChunkFromTemplate(Template, TemplateChunk.ChunkPosition, Fixture.ChunkData))
+        {
+            Fixture.Name = FString::Printf(TEXT("Template_%d_%d_%d"),
+                TemplateChunk.ChunkPosition.X, TemplateChunk.ChunkPosition.Y, TemplateChunk.ChunkPosition.Z);
+            OutFixtures.Add(MoveTemp(Fixture));
+            Added++;
+        }
+    }
+
+    return Added;
+}
+
+FString FVoxelBenchmarkRunner::GetDefaultOutputPath()
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"),
+        FString::Printf(TEXT("VoxelBenchmark-%s.json"), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"))));
+}
@@ -0,0 +1,406 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelBenchmark.h"
+#include "VoxelCameraPath.h"
+#include "VoxelChunk.h"
+#include "VoxelWorld.h"
+#include "VoxelReplication.h"
+#include "VoxelWorldTemplate.h"
+#include "HearthshireVoxelModule.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Voxel pipeline benchmark. Needs no world or renderer, run headless with:
+ *   UnrealEditor-Cmd Heartshire.uproject -nullrhi -unattended -nosplash -nosound
+ *     -ExecCmds="Automation RunTests HearthshireVoxel.Benchmark; Quit"
+ * Options: -VoxelBenchIterations= -VoxelBenchWarmup= -VoxelBenchFilter= -VoxelBenchOutput=
+ *          -VoxelBenchTemplate=/Game/Path/To/Template -VoxelBenchTemplateChunks=
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelPipelineBenchmarkTest, "HearthshireVoxel.Benchmark.Pipeline",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVoxelPipelineBenchmarkTest::RunTest(const FString& Parameters)
+{
+    const TCHAR* CommandLine = FCommandLine::Get();
+
+    int32 Iterations = 30;
+    int32 WarmupIterations = 3;
+    int32 MaxTemplateChunks = 8;
+    FString Filter;
+    FString OutputPath;
+    FString TemplatePath;
+    FParse::Value(CommandLine, TEXT("VoxelBenchIterations="), Iterations);
+    FParse::Value(CommandLine, TEXT("VoxelBenchWarmup="), WarmupIterations);
+    FParse::Value(CommandLine, TEXT("VoxelBenchTemplateChunks="), MaxTemplateChunks);
+    FParse::Value(CommandLine, TEXT("VoxelBenchFilter="), Filter);
+    FParse::Value(CommandLine, TEXT("VoxelBenchOutput="), OutputPath);
+    FParse::Value(CommandLine, TEXT("VoxelBenchTemplate="), TemplatePath);
+
+    TArray<FVoxelBenchmarkFixture> Fixtures;
+    FVoxelBenchmarkRunner::BuildSyntheticFixtures(FVoxelChunkSize(), Fixtures);
+
+    if (!TemplatePath.IsEmpty())
+    {
+        UVoxelWorldTemplate* Template = LoadObject<UVoxelWorldTemplate>(nullptr, *TemplatePath);
+        if (!Template)
+        {
+            AddError(FString::Printf(TEXT("Could not load voxel world template %s"), *TemplatePath));
+            return false;
+        }
+
+        const int32 Added = FVoxelBenchmarkRunner::AddTemplateFixtures(Template, MaxTemplateChunks, Fixtures);
+        AddInfo(FString::Printf(TEXT("Added %d template chunks from %s"), Added, *TemplatePath));
+    }
+    else
+    {
+        AddInfo(TEXT("No -VoxelBenchTemplate given, running synthetic fixtures only"));
+    }
+
+    FVoxelBenchmarkRunner Runner(WarmupIterations, Iterations);
+    Runner.Filter = Filter;
+    Runner.RunPipeline(Fixtures);
+
+    for (const FVoxelBenchmarkResult& Result : Runner.GetResults())
+    {
+        const double* RoundTrip = Result.Counters.Find(TEXT("roundtrip_ok"));
+        if (RoundTrip && *RoundTrip == 0.0)
+        {
+            AddError(FString::Printf(TEXT("%s: decompressed data does not match the input"), *Result.GetName()));
+        }
+    }
+
+    UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel benchmark results:\n%s"), *Runner.GetSummary());
+
+    if (OutputPath.IsEmpty())
+    {
+        OutputPath = FVoxelBenchmarkRunner::GetDefaultOutputPath();
+    }
+
+    if (!Runner.SaveJson(OutputPath))
+    {
+        AddError(FString::Printf(TEXT("Failed to write benchmark results to %s"), *OutputPath));
+    }
+    else
+    {
+        AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *OutputPath));
+    }
+
+    return !HasAnyErrors();
+}
+
+/**
+ * Generation and meshing throughput at 1, 2, 4... worker threads on a fixed batch of chunks.
+ * Options: -VoxelScalingBatch= -VoxelScalingMaxWorkers= -VoxelBenchIterations= -VoxelBenchFilter= -VoxelBenchOutput=
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelThreadScalingBenchmarkTest, "HearthshireVoxel.Benchmark.ThreadScaling",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVoxelThreadScalingBenchmarkTest::RunTest(const FString& Parameters)
+{
+    const TCHAR* CommandLine = FCommandLine::Get();
+
+    int32 Iterations = 10;
+    int32 BatchSize = 64;
+    int32 MaxWorkers = 0;
+    FString Filter;
+    FString OutputPath;
+    FParse::Value(CommandLine, TEXT("VoxelBenchIterations="), Iterations);
+    FParse::Value(CommandLine, TEXT("VoxelScalingBatch="), BatchSize);
+    FParse::Value(CommandLine, TEXT("VoxelScalingMaxWorkers="), MaxWorkers);
+    FParse::Value(CommandLine, TEXT("VoxelBenchFilter="), Filter);
+    FParse::Value(CommandLine, TEXT("VoxelBenchOutput="), OutputPath);
+
+    TArray<FVoxelBenchmarkFixture> Fixtures;
+    FVoxelBenchmarkRunner::BuildSyntheticFixtures(FVoxelChunkSize(), Fixtures);
+
+    FVoxelBenchmarkRunner Runner(1, Iterations);
+    Runner.Filter = Filter;
+    Runner.RunThreadScaling(Fixtures, BatchSize, MaxWorkers);
+
+    UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel thread scaling results:\n%s"), *Runner.GetSummary());
+
+    for (const FVoxelBenchmarkResult& Result : Runner.GetResults())
+    {
+        const double* Efficiency = Result.Counters.Find(TEXT("efficiency"));
+        const double* Contention = Result.Counters.Find(TEXT("contention"));
+        if (Efficiency && Contention)
+        {
+            AddInfo(FString::Printf(TEXT("%s: %.0f chunks/s, efficiency %.2f, contention %.2f"),
+                *Result.GetName(), Result.Counters[TEXT("chunks_per_sec")], *Efficiency, *Contention));
+        }
+    }
+
+    if (OutputPath.IsEmpty())
+    {
+        OutputPath = FVoxelBenchmarkRunner::GetDefaultOutputPath();
+    }
+
+    if (!Runner.SaveJson(OutputPath))
+    {
+        AddError(FString::Printf(TEXT("Failed to write benchmark results to %s"), *OutputPath));
+    }
+    else
+    {
+        AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *OutputPath));
+    }
+
+    return !HasAnyErrors();
+}
+
+/**
+ * Linear against tiled voxel layout for each neighbourhood-heavy pass, conversion included.
+ * Reports the voxel.Layout.* values that are faster on this machine.
+ * Options: -VoxelBenchIterations= -VoxelBenchFilter= -VoxelBenchOutput=
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelLayoutBenchmarkTest, "HearthshireVoxel.Benchmark.Layout",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVoxelLayoutBenchmarkTest::RunTest(const FString& Parameters)
+{
+    const TCHAR* CommandLine = FCommandLine::Get();
+
+    int32 Iterations = 20;
+    FString Filter;
+    FString OutputPath;
+    FParse::Value(CommandLine, TEXT("VoxelBenchIterations="), Iterations);
+    FParse::Value(CommandLine, TEXT("VoxelBenchFilter="), Filter);
+    FParse::Value(CommandLine, TEXT("VoxelBenchOutput="), OutputPath);
+
+    TArray<FVoxelBenchmarkFixture> Fixtures;
+    FVoxelBenchmarkRunner::BuildSyntheticFixtures(FVoxelChunkSize(), Fixtures);
+
+    FVoxelBenchmarkRunner Runner(2, Iterations);
+    Runner.Filter = Filter;
+    const FVoxelLayoutRecommendation Recommendation = Runner.RunLayoutComparison(Fixtures);
+
+    UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel layout results:\n%s"), *Runner.GetSummary());
+
+    for (const FVoxelBenchmarkResult& Result : Runner.GetResults())
+    {
+        const double* RoundTrip = Result.Counters.Find(TEXT("roundtrip_ok"));
+        if (RoundTrip && *RoundTrip < 1.0)
+        {
+            AddError(FString::Printf(TEXT("%s: tiled layout round trip does not match the source"), *Result.GetName()));
+        }
+
+        const double* Speedup = Result.Counters.Find(TEXT("tiled_speedup"));
+        if (Speedup)
+        {
+            AddInfo(FString::Printf(TEXT("%s: %.3fms linear, %.3fms tiled (x%.2f)"),
+                *Result.GetName(), Result.Counters[TEXT("linear_ms")], Result.Counters[TEXT("tiled_ms")], *Speedup));
+        }
+    }
+
+    AddInfo(FString::Printf(TEXT("Recommended: voxel.Layout.Mesh %d, voxel.Layout.Downsample %d"),
+        Recommendation.Mesh == EVoxelDataLayout::Tiled ? 1 : 0, Recommendation.Downsample == EVoxelDataLayout::Tiled ? 1 : 0));
+
+    if (OutputPath.IsEmpty())
+    {
+        OutputPath = FVoxelBenchmarkRunner::GetDefaultOutputPath();
+    }
+
+    if (!Runner.SaveJson(OutputPath))
+    {
+        AddError(FString::Printf(TEXT("Failed to write benchmark results to %s"), *OutputPath));
+    }
+    else
+    {
+        AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *OutputPath));
+    }
+
+    return !HasAnyErrors();
+}
+
+/**
+ * Camera path replay in a throwaway game world. Reports frame time percentiles and
+ * request-to-visible latency for the path, run headless like the pipeline benchmark.
+ * Options: -VoxelReplayPath=/Game/VoxelPaths/Name -VoxelReplayFixedDelta= -VoxelReplaySeed= -VoxelBenchOutput=
+ * Without a path a straight synthetic fly-over is used so the test always has input.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelCameraPathReplayTest, "HearthshireVoxel.Benchmark.CameraPath",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVoxelCameraPathReplayTest::RunTest(const FString& Parameters)
+{
+    const TCHAR* CommandLine = FCommandLine::Get();
+
+    FString PathName;
+    FString OutputPath;
+    FVoxelPathReplaySettings Settings;
+    FParse::Value(CommandLine, TEXT("VoxelReplayPath="), PathName);
+    FParse::Value(CommandLine, TEXT("VoxelReplayFixedDelta="), Settings.FixedDeltaTime);
+    FParse::Value(CommandLine, TEXT("VoxelReplaySeed="), Settings.Seed);
+    FParse::Value(CommandLine, TEXT("VoxelBenchOutput="), OutputPath);
+
+    UVoxelCameraPath* Path = nullptr;
+    if (!PathName.IsEmpty())
+    {
+        Path = LoadObject<UVoxelCameraPath>(nullptr, *PathName);
+        if (!Path)
+        {
+            AddError(FString::Printf(TEXT("Could not load camera path %s"), *PathName));
+            return false;
+        }
+    }
+    else
+    {
+        // 20 seconds across 32 chunks at walking height
+        Path = NewObject<UVoxelCameraPath>(GetTransientPackage(), TEXT("SyntheticFlyOver"));
+        const float ChunkWorldSize = FVoxelChunkSize().X * UVoxelChunkComponent::VoxelSize;
+        for (int32 Index = 0; Index <= 20; Index++)
+        {
+            FVoxelCameraPathKey& Key = Path->Keys.AddDefaulted_GetRef();
+            Key.Time = Index;
+            Key.Location = FVector(Index * ChunkWorldSize * 1.6f, 0.0f, 500.0f);
+        }
+        AddInfo(TEXT("No -VoxelReplayPath given, replaying a synthetic fly-over"));
+    }
+
+    FVoxelBenchmarkResult Result;
+    if (!FVoxelCameraPathPlayer::RunHeadless(Path, Settings, Result))
+    {
+        AddError(FString::Printf(TEXT("Replay of %s failed"), *Path->GetName()));
+        return false;
+    }
+
+    // A world that never began play finishes the replay too, just without streaming anything
+    const double* PeakActiveChunks = Result.Counters.Find(TEXT("peak_active_chunks"));
+    const double* VisibleChunks = Result.Counters.Find(TEXT("chunks_visible"));
+    if (!PeakActiveChunks || *PeakActiveChunks <= 0.0 || !VisibleChunks || *VisibleChunks <= 0.0)
+    {
+        AddError(FString::Printf(TEXT("Replay of %s streamed no chunks (%.0f active, %.0f visible)"), *Path->GetName(),
+            PeakActiveChunks ? *PeakActiveChunks : 0.0, VisibleChunks ? *VisibleChunks : 0.0));
+    }
+
+    FVoxelBenchmarkRunner Runner(0, Result.Iterations);
+    Runner.AddResult(Result);
+
+    UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel camera path results:\n%s"), *Runner.GetSummary());
+
+    if (OutputPath.IsEmpty())
+    {
+        OutputPath = FVoxelBenchmarkRunner::GetDefaultOutputPath();
+    }
+
+    if (!Runner.SaveJson(OutputPath))
+    {
+        AddError(FString::Printf(TEXT("Failed to write replay results to %s"), *OutputPath));
+    }
+    else
+    {
+        AddInfo(FString::Printf(TEXT("Replay results written to %s"), *OutputPath));
+    }
+
+    return !HasAnyErrors();
+}
+
+/**
+ * Server and client voxel worlds in one throwaway world, synchronised over the loopback transport.
+ * Edits the server through AVoxelWorld::SetVoxelSphere, UVoxelChunkComponent::SetVoxel, SetVoxelRange
+ * and PaintVoxelSurface, then checks the client holds the same voxels.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelReplicationLoopbackTest, "HearthshireVoxel.Replication.Loopback",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVoxelReplicationLoopbackTest::RunTest(const FString& Parameters)
+{
+    if (!GEngine)
+    {
+        AddError(TEXT("No engine"));
+        return false;
+    }
+
+    // Never begins play - the worlds only hold what the test puts in them
+    UWorld* GameWorld = UWorld::CreateWorld(EWorldType::Game, false, TEXT("VoxelReplicationTest"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(GameWorld);
+
+    AVoxelWorld* ServerWorld = GameWorld->SpawnActor<AVoxelWorld>();
+    AVoxelWorld* ClientWorld = GameWorld->SpawnActor<AVoxelWorld>();
+    if (ServerWorld && ClientWorld)
+    {
+        // Synchronous meshing, so nothing is in flight when the world goes away
+        ServerWorld->Config.bUseMultithreading = false;
+        ClientWorld->Config.bUseMultithreading = false;
+
+        const FIntVector ChunkPosition = FIntVector::ZeroValue;
+        AVoxelChunk* ServerChunk = ServerWorld->GetOrCreateChunk(ChunkPosition);
+        UVoxelChunkComponent* ServerComp = ServerChunk ? ServerChunk->ChunkComponent : nullptr;
+        if (!ServerComp)
+        {
+            AddError(TEXT("Failed to create the server chunk"));
+        }
+        else
+        {
+            ServerComp->bEnableAsyncGeneration = false;
+
+            FVoxelReplicationSettings Settings;
+            Settings.MaxBytesPerSecond = 4 * 1024 * 1024;
+            Settings.MaxBurstBytes = Settings.MaxBytesPerSecond;
+            Settings.InterestRadiusInChunks = 1;
+
+            FVoxelReplicationLoopback Loopback(ServerWorld, ClientWorld, Settings);
+            Loopback.SetClientFocus(ServerWorld->ChunkToWorldPosition(ChunkPosition));
+            Loopback.Tick(1.0f);
+
+            if (!ClientWorld->GetChunkAtPosition(ChunkPosition))
+            {
+                AddError(TEXT("Client never received the chunk snapshot"));
+            }
+
+            // Topmost solid voxel of the centre column, so painting finds a surface
+            const FVoxelChunkSize ChunkSize = ServerComp->GetChunkSize();
+            const int32 CenterX = ChunkSize.X / 2;
+            const int32 CenterY = ChunkSize.Y / 2;
+            int32 SurfaceZ = ChunkSize.Z - 1;
+            while (SurfaceZ > 0 && ServerComp->GetVoxel(CenterX, CenterY, SurfaceZ) == EVoxelMaterial::Air)
+            {
+                SurfaceZ--;
+            }
+
+            const FVector SurfacePosition = ServerComp->LocalToWorldPosition(FIntVector(CenterX, CenterY, SurfaceZ));
+            const float VoxelSize = UVoxelChunkComponent::VoxelSize;
+
+            ServerWorld->SetVoxelSphere(SurfacePosition + FVector(4.0f * VoxelSize, 0.0f, 0.0f), 1.5f * VoxelSize, EVoxelMaterial::Stone);
+            ServerComp->SetVoxel(CenterX, CenterY, FMath::Min(SurfaceZ + 1, ChunkSize.Z - 1), EVoxelMaterial::Wood);
+            ServerComp->SetVoxelRange(FIntVector(1, 1, 0), FIntVector(3, 3, 2), EVoxelMaterial::Snow);
+            ServerComp->PaintVoxelSurface(SurfacePosition - FVector(4.0f * VoxelSize, 0.0f, 0.0f), 2.0f * VoxelSize, EVoxelMaterial::Sand);
+
+            Loopback.Tick(1.0f / 30.0f);
+
+            if (Loopback.GetClient().GetAppliedDeltaCount() == 0)
+            {
+                AddError(TEXT("Client applied no edit deltas"));
+            }
+
+            TArray<FIntVector> MismatchedChunks;
+            if (!FVoxelReplicationLoopback::CompareWorlds(ServerWorld, ClientWorld, &MismatchedChunks))
+            {
+                for (const FIntVector& Mismatched : MismatchedChunks)
+                {
+                    AddError(FString::Printf(TEXT("Chunk %s differs between server and client"), *Mismatched.ToString()));
+                }
+            }
+
+            AddInfo(FString::Printf(TEXT("%d full chunks (%lld bytes), %d edit deltas (%lld bytes)"),
+                Loopback.GetServer().GetStats().FullChunksSent, Loopback.GetServer().GetStats().FullChunkBytes,
+                Loopback.GetServer().GetStats().EditDeltasSent, Loopback.GetServer().GetStats().EditDeltaBytes));
+        }
+    }
+    else
+    {
+        AddError(TEXT("Failed to spawn the voxel worlds"));
+    }
+
+    GEngine->DestroyWorldContext(GameWorld);
+    GameWorld->DestroyWorld(false);
+    return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelBlockEntities.h"
+#include "HearthshireVoxelModule.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace VoxelBlockEntities
+{
+    // Bumped when the Save layout changes
+    static constexpr uint8 StreamVersion = 1;
+}
+
+static_assert(FVoxelBlockEntity::IsValidPayload<FVoxelCropEntity>(), "FVoxelCropEntity doesn't fit a block entity");
+static_assert(FVoxelBlockEntity::IsValidPayload<FVoxelContainerEntity>(), "FVoxelContainerEntity doesn't fit a block entity");
+static_assert(FVoxelBlockEntity::IsValidPayload<FVoxelMachineEntity>(), "FVoxelMachineEntity doesn't fit a block entity");
+
+void FVoxelBlockEntityStore::Save(int32 VoxelCount, TArray<uint8>& OutBytes) const
+{
+    OutBytes.Reset();
+    if (Entities.Num() == 0)
+    {
+        return;
+    }
+
+    FMemoryWriter Writer(OutBytes);
+
+    uint8 Version = VoxelBlockEntities::StreamVersion;
+    uint32 PackedVoxelCount = VoxelCount;
+    uint32 EntityCount = Entities.Num();
+    Writer << Version;
+    Writer.SerializeIntPacked(PackedVoxelCount);
+    Writer.SerializeIntPacked(EntityCount);
+
+    // Indices as deltas from the previous entity - a planted row packs to a byte each
+    int32 PreviousIndex = 0;
+    ForEach([&Writer, &PreviousIndex](int32 VoxelIndex, const FVoxelBlockEntity& Entity)
+    {
+        uint32 IndexDelta = VoxelIndex - PreviousIndex;
+        uint8 Type = (uint8)Entity.Type;
+        uint8 PayloadSize = Entity.PayloadSize;
+        Writer.SerializeIntPacked(IndexDelta);
+        Writer << Type;
+        Writer << PayloadSize;
+        Writer.Serialize(const_cast<uint8*>(Entity.Data), PayloadSize);
+        PreviousIndex = VoxelIndex;
+    });
+}
+
+bool FVoxelBlockEntityStore::Load(const TArray<uint8>& Bytes, int32 VoxelCount)
+{
+    Reset();
+    if (Bytes.Num() == 0)
+    {
+        return true;
+    }
+
+    FMemoryReader Reader(Bytes);
+
+    uint8 Version = 0;
+    uint32 StoredVoxelCount = 0;
+    uint32 EntityCount = 0;
+    Reader << Version;
+    Reader.SerializeIntPacked(StoredVoxelCount);
+    Reader.SerializeIntPacked(EntityCount);
+
+    if (Reader.IsError() || Version != VoxelBlockEntities::StreamVersion || (int32)StoredVoxelCount != VoxelCount || EntityCount > (uint32)VoxelCount)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelBlockEntities: Malformed block entity header (version %d, %u voxels, %u entities)"),
+            Version, StoredVoxelCount, EntityCount);
+        return false;
+    }
+
+    Entities.Reserve(EntityCount);
+    SortedIndices.Reserve(EntityCount);
+    int64 VoxelIndex = 0;
+    for (uint32 EntryIndex = 0; EntryIndex < EntityCount; EntryIndex++)
+    {
+        uint32 IndexDelta = 0;
+        uint8 Type = 0;
+        uint8 PayloadSize = 0;
+        Reader.SerializeIntPacked(IndexDelta);
+        Reader << Type;
+        Reader << PayloadSize;
+
+        // Strictly ascending after the first entry, so duplicates can't occur
+        VoxelIndex += IndexDelta;
+        if (Reader.IsError() || (EntryIndex > 0 && IndexDelta == 0) || VoxelIndex >= VoxelCount
+            || Type == (uint8)EVoxelBlockEntityType::None || PayloadSize > FVoxelBlockEntity::MaxPayloadSize
+            || PayloadSize > Reader.TotalSize() - Reader.Tell())
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelBlockEntities: Malformed block entity entry %u"), EntryIndex);
+            Reset();
+            return false;
+        }
+
+        FVoxelBlockEntity Entity;
+        Entity.Type = (EVoxelBlockEntityType)Type;
+        Entity.PayloadSize = PayloadSize;
+        Reader.Serialize(Entity.Data, PayloadSize);
+        // Stored ascending, so the index goes on the end
+        Entities.Add((int32)VoxelIndex, Entity);
+        SortedIndices.Add((int32)VoxelIndex);
+    }
+
+    return !Reader.IsError();
+}
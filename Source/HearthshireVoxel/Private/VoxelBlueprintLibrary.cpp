@@ -3,6 +3,7 @@
 #include "VoxelBlueprintLibrary.h"
 #include "VoxelWorld.h"
 #include "VoxelChunk.h"
+#include "VoxelDebugRenderer.h"
 #include "Engine/World.h"
 #include "DrawDebugHelpers.h"
 #include "Kismet/GameplayStatics.h"
@@ -148,8 +149,9 @@ void UVoxelBlueprintLibrary::RegenerateChunksInRadius(
         return;
     }
     
-    const float ChunkWorldSize = VoxelWorld->Config.ChunkSize * GetVoxelSize();
-    const int32 ChunkRadius = FMath::CeilToInt(Radius / ChunkWorldSize);
+    const FVector ChunkWorldSize = VoxelWorld->Config.GetChunkWorldSize(GetVoxelSize());
+    const int32 ChunkRadius = FMath::CeilToInt(Radius / ChunkWorldSize.X);
+    const int32 ChunkRadiusZ = FMath::CeilToInt(Radius / ChunkWorldSize.Z);
     
     FIntVector CenterChunk = VoxelWorld->WorldToChunkPosition(Center);
     
@@ -157,10 +159,10 @@ void UVoxelBlueprintLibrary::RegenerateChunksInRadius(
     {
         for (int32 Y = -ChunkRadius; Y <= ChunkRadius; Y++)
         {
-            for (int32 Z = -ChunkRadius; Z <= ChunkRadius; Z++)
+            for (int32 Z = -ChunkRadiusZ; Z <= ChunkRadiusZ; Z++)
             {
                 FIntVector ChunkPos = CenterChunk + FIntVector(X, Y, Z);
-                FVector ChunkWorldPos = FVector(ChunkPos) * ChunkWorldSize;
+                FVector ChunkWorldPos = VoxelWorld->ChunkToWorldPosition(ChunkPos);
                 
                 if (FVector::Dist(ChunkWorldPos, Center) <= Radius)
                 {
@@ -257,12 +259,15 @@ void UVoxelBlueprintLibrary::GeneratePerlinTerrain(
 FIntVector UVoxelBlueprintLibrary::WorldToChunkPosition(
     const FVector& WorldPosition,
     int32 ChunkSize,
-    float VoxelSize)
+    float VoxelSize,
+    int32 ChunkHeight)
 {
+    // 0 height = cubic chunks
+    const int32 Height = ChunkHeight > 0 ? ChunkHeight : ChunkSize;
     return FIntVector(
         FMath::FloorToInt(WorldPosition.X / (ChunkSize * VoxelSize)),
         FMath::FloorToInt(WorldPosition.Y / (ChunkSize * VoxelSize)),
-        FMath::FloorToInt(WorldPosition.Z / (ChunkSize * VoxelSize))
+        FMath::FloorToInt(WorldPosition.Z / (Height * VoxelSize))
     );
 }
 
@@ -301,6 +306,11 @@ FVoxelPerformanceReport UVoxelBlueprintLibrary::GetPerformanceReport()
     FString ReportString = FVoxelPerformanceMonitor::Get().GetPerformanceReport();
     Report.PerformanceSummary = ReportString;
     
+    const FVoxelLatencyHistogram& Latency = FVoxelPerformanceMonitor::Get().GetLatencyHistogram(EVoxelLatencyStage::RequestToVisible);
+    Report.StreamingLatencyP50Ms = Latency.GetPercentileMs(0.5);
+    Report.StreamingLatencyP95Ms = Latency.GetPercentileMs(0.95);
+    Report.StreamingLatencyP99Ms = Latency.GetPercentileMs(0.99);
+    
     // TODO: Parse individual values from the monitor
     
     return Report;
@@ -323,16 +333,7 @@ void UVoxelBlueprintLibrary::SetVoxelMaterial(
 {
     if (MaterialSet)
     {
-        if (FVoxelMaterialConfig* Config = MaterialSet->Materials.Find(VoxelMaterial))
-        {
-            Config->Material = Material;
-        }
-        else
-        {
-            FVoxelMaterialConfig NewConfig;
-            NewConfig.Material = Material;
-            MaterialSet->Materials.Add(VoxelMaterial, NewConfig);
-        }
+        MaterialSet->MaterialConfigs.FindOrAdd((uint8)VoxelMaterial).Material = Material;
     }
 }
 
@@ -369,6 +370,7 @@ void UVoxelBlueprintLibrary::OptimizeVoxelWorldForPlatform(
         VoxelWorld->Config.ChunkSize = 16;
         VoxelWorld->Config.ViewDistanceInChunks = 6;
         VoxelWorld->Config.MaxConcurrentChunkGenerations = 2;
+        VoxelWorld->Config.MaxChunksPerFrame = 3;
         VoxelWorld->Config.ChunkPoolSize = 50;
     }
     else
@@ -377,10 +379,36 @@ void UVoxelBlueprintLibrary::OptimizeVoxelWorldForPlatform(
         VoxelWorld->Config.ChunkSize = 32;
         VoxelWorld->Config.ViewDistanceInChunks = 10;
         VoxelWorld->Config.MaxConcurrentChunkGenerations = 4;
+        VoxelWorld->Config.MaxChunksPerFrame = 5;
         VoxelWorld->Config.ChunkPoolSize = 100;
     }
 }
 
+FVoxelCalibrationResult UVoxelBlueprintLibrary::CalibrateVoxelWorld(
+    AVoxelWorld* VoxelWorld,
+    int32 TargetFPS,
+    bool bForceRecalibrate)
+{
+    FVoxelCalibrationResult Result;
+    if (bForceRecalibrate)
+    {
+        Result = FVoxelCalibration::Run(TargetFPS);
+        FVoxelCalibration::Save(Result);
+    }
+    else
+    {
+        Result = FVoxelCalibration::GetOrRun(TargetFPS);
+    }
+    
+    if (VoxelWorld)
+    {
+        // Chunk size can only change before any chunk exists
+        FVoxelCalibration::ApplyToConfig(Result, VoxelWorld->Config, VoxelWorld->GetActiveChunkCount() == 0 && !VoxelWorld->bUseTemplate);
+    }
+    
+    return Result;
+}
+
 void UVoxelBlueprintLibrary::DrawDebugVoxel(
     UObject* WorldContextObject,
     const FVector& VoxelPosition,
@@ -404,7 +432,8 @@ void UVoxelBlueprintLibrary::DrawDebugChunk(
     int32 ChunkSize,
     float VoxelSize,
     const FLinearColor& Color,
-    float Duration)
+    float Duration,
+    int32 ChunkHeight)
 {
     UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
     if (!World)
@@ -412,8 +441,9 @@ void UVoxelBlueprintLibrary::DrawDebugChunk(
         return;
     }
     
-    FVector ChunkWorldPos = FVector(ChunkPosition) * ChunkSize * VoxelSize;
-    FVector ChunkExtent = FVector(ChunkSize) * VoxelSize * 0.5f;
+    const FVector ChunkWorldSize = FVector(ChunkSize, ChunkSize, ChunkHeight > 0 ? ChunkHeight : ChunkSize) * VoxelSize;
+    FVector ChunkWorldPos = FVector(ChunkPosition) * ChunkWorldSize;
+    FVector ChunkExtent = ChunkWorldSize * 0.5f;
     FVector Center = ChunkWorldPos + ChunkExtent;
     
     DrawDebugBox(World, Center, ChunkExtent, Color.ToFColor(true), false, Duration, 0, 2.0f);
@@ -761,22 +791,18 @@ void UVoxelBlueprintLibrary::HighlightModifiedChunks(
         return;
     }
     
-    UWorld* World = VoxelWorld->GetWorld();
-    const float ChunkWorldSize = VoxelWorld->Config.ChunkSize * GetVoxelSize();
+    const FVector ChunkWorldSize = VoxelWorld->Config.GetChunkWorldSize(GetVoxelSize());
     
+    TArray<FBox> Boxes;
     for (const auto& ChunkPair : VoxelWorld->ActiveChunks)
     {
-        if (ChunkPair.Value && ChunkPair.Value->ChunkComponent)
+        // Only chunks edited at runtime carry an edit timestamp
+        if (ChunkPair.Value && ChunkPair.Value->ChunkComponent && ChunkPair.Value->ChunkComponent->LastEditTime > 0.0)
         {
-            UVoxelChunkComponent* ChunkComp = ChunkPair.Value->ChunkComponent;
-            
-            // Check if chunk has been modified (you might want to track this separately)
-            // For now, highlight all active chunks
-            FVector ChunkWorldPos = FVector(ChunkPair.Key) * ChunkWorldSize;
-            FVector ChunkCenter = ChunkWorldPos + FVector(ChunkWorldSize * 0.5f);
-            FVector ChunkExtent = FVector(ChunkWorldSize * 0.5f);
-            
-            DrawDebugBox(World, ChunkCenter, ChunkExtent, Color.ToFColor(true), false, Duration, 0, 3.0f);
+            const FVector ChunkWorldPos = VoxelWorld->ChunkToWorldPosition(ChunkPair.Key);
+            Boxes.Add(FBox(ChunkWorldPos, ChunkWorldPos + ChunkWorldSize));
         }
     }
+    
+    FVoxelDebugRenderer::DrawBoxes(VoxelWorld->GetWorld(), Boxes, { Color }, 3.0f, Duration);
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelCalibration.h"
+#include "VoxelWorld.h"
+#include "VoxelBenchmark.h"
+#include "VoxelMeshGenerator.h"
+#include "HearthshireVoxelModule.h"
+#include "ProceduralMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "UObject/Package.h"
+
+namespace VoxelCalibration
+{
+    const TCHAR* ConfigSection = TEXT("/Script/HearthshireVoxel.VoxelCalibration");
+
+    // Share of the frame the game thread may spend applying streamed meshes
+    constexpr float ApplyBudgetFraction = 0.2f;
+
+    // A whole chunk must be generated and meshed within this many frames to avoid visible pop-in lag
+    constexpr float MaxFramesPerChunk = 2.0f;
+
+    // Workers are added while each one still adds at least this share of a full worker
+    constexpr double MinWorkerEfficiency = 0.6;
+
+    // Time to fill the whole view from scratch at the sustained throughput
+    constexpr float ViewFillSeconds = 10.0f;
+
+    // Vertical chunk layers loaded around the player (see AVoxelWorld::UpdateChunks)
+    constexpr int32 VerticalLayers = 5;
+
+    constexpr int32 SamplesPerSize = 8;
+
+    int32 ResolveTargetFPS(int32 TargetFPS)
+    {
+        if (TargetFPS > 0)
+        {
+            return TargetFPS;
+        }
+#if VOXEL_MOBILE_PLATFORM
+        return 30;
+#else
+        return 60;
+#endif
+    }
+
+    struct FSizeTiming
+    {
+        float WorkerMs = 0.0f;
+        float ApplyMs = 0.0f;
+    };
+
+    FSizeTiming MeasureChunkSize(int32 ChunkSize, TArray<FVoxelBenchmarkFixture>& OutFixtures)
+    {
+        FSizeTiming Timing;
+
+        // Hills and caves are the realistic fixtures, flat and checkerboard are the extremes
+        TArray<FVoxelBenchmarkFixture> AllFixtures;
+        FVoxelBenchmarkRunner::BuildSyntheticFixtures(FVoxelChunkSize(ChunkSize), AllFixtures);
+        OutFixtures.Reset();
+        for (FVoxelBenchmarkFixture& Fixture : AllFixtures)
+        {
+            if (Fixture.Name == TEXT("Hills") || Fixture.Name == TEXT("Caves"))
+            {
+                OutFixtures.Add(MoveTemp(Fixture));
+            }
+        }
+
+        // Warm caches and the allocator before timing
+        FVoxelBenchmarkRunner::RunConcurrentBatch(OutFixtures, 2, 1, EVoxelScalingStage::GenerateAndMesh);
+        const FVoxelScalingSample Sample = FVoxelBenchmarkRunner::RunConcurrentBatch(OutFixtures, SamplesPerSize, 1, EVoxelScalingStage::GenerateAndMesh);
+        Timing.WorkerMs = Sample.BusyMs / FMath::Max(Sample.Chunks, 1);
+
+        // Apply on the calling (game) thread into an unregistered component
+        UProceduralMeshComponent* MeshComponent = NewObject<UProceduralMeshComponent>(GetTransientPackage());
+        FVoxelMeshData MeshData;
+        FVoxelMeshGenerator::GenerateGreedyMesh(OutFixtures[0].ChunkData, MeshData);
+
+        const ELogVerbosity::Type PreviousVerbosity = LogHearthshireVoxel.GetVerbosity();
+        LogHearthshireVoxel.SetVerbosity(ELogVerbosity::Error);
+
+        FVoxelMeshGenerator::ApplyMeshToComponent(MeshComponent, MeshData);
+        const double ApplyStartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < SamplesPerSize; i++)
+        {
+            FVoxelMeshGenerator::ApplyMeshToComponent(MeshComponent, MeshData);
+        }
+        Timing.ApplyMs = (FPlatformTime::Seconds() - ApplyStartTime) * 1000.0 / SamplesPerSize;
+
+        LogHearthshireVoxel.SetVerbosity(PreviousVerbosity);
+
+        MeshComponent->ClearAllMeshSections();
+        MeshComponent->MarkAsGarbage();
+
+        return Timing;
+    }
+}
+
+FString FVoxelCalibrationResult::ToString() const
+{
+    return FString::Printf(
+        TEXT("ChunkSize %d, Workers %d, ChunksPerFrame %d, ViewDistance %d (target %.1fms, worker %.2f/%.2fms, apply %.2f/%.2fms for 16/32, %.0f chunks/s) on %s"),
+        ChunkSize, MaxConcurrentChunkGenerations, MaxChunksPerFrame, ViewDistanceInChunks,
+        TargetFrameMs, WorkerMsPerChunk16, WorkerMsPerChunk32, ApplyMsPerChunk16, ApplyMsPerChunk32, ChunksPerSecond, *DeviceId);
+}
+
+FVoxelCalibrationResult FVoxelCalibration::GetOrRun(int32 TargetFPS)
+{
+    // A stored result planned for a different frame rate is measured again
+    const float TargetFrameMs = 1000.0f / VoxelCalibration::ResolveTargetFPS(TargetFPS);
+
+    FVoxelCalibrationResult Result;
+    if (Load(Result) && FMath::IsNearlyEqual(Result.TargetFrameMs, TargetFrameMs, 0.1f))
+    {
+        return Result;
+    }
+
+    Result = Run(TargetFPS);
+    Save(Result);
+    return Result;
+}
+
+FVoxelCalibrationResult FVoxelCalibration::Run(int32 TargetFPS)
+{
+    using namespace VoxelCalibration;
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    TargetFPS = ResolveTargetFPS(TargetFPS);
+
+    FVoxelCalibrationResult Result;
+    Result.DeviceId = GetDeviceId();
+    Result.TargetFrameMs = 1000.0f / TargetFPS;
+
+    TArray<FVoxelBenchmarkFixture> Fixtures16;
+    TArray<FVoxelBenchmarkFixture> Fixtures32;
+    const FSizeTiming Timing16 = MeasureChunkSize(16, Fixtures16);
+    const FSizeTiming Timing32 = MeasureChunkSize(32, Fixtures32);
+    Result.WorkerMsPerChunk16 = Timing16.WorkerMs;
+    Result.WorkerMsPerChunk32 = Timing32.WorkerMs;
+    Result.ApplyMsPerChunk16 = Timing16.ApplyMs;
+    Result.ApplyMsPerChunk32 = Timing32.ApplyMs;
+
+    // Large chunks mean fewer actors and draw calls, but only while one still fits the budgets
+    const float ApplyBudgetMs = Result.TargetFrameMs * ApplyBudgetFraction;
+    const bool bLargeChunksFit = Timing32.ApplyMs <= ApplyBudgetMs && Timing32.WorkerMs <= Result.TargetFrameMs * MaxFramesPerChunk;
+    Result.ChunkSize = bLargeChunksFit ? 32 : 16;
+
+    const FSizeTiming& Chosen = bLargeChunksFit ? Timing32 : Timing16;
+    const TArray<FVoxelBenchmarkFixture>& ChosenFixtures = bLargeChunksFit ? Fixtures32 : Fixtures16;
+
+    // Leave the game and render threads their own cores
+    const int32 MaxWorkers = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 2, 1, 8);
+    const int32 BatchSize = FMath::Max(MaxWorkers * 2, SamplesPerSize);
+
+    const FVoxelScalingSample Baseline = FVoxelBenchmarkRunner::RunConcurrentBatch(ChosenFixtures, BatchSize, 1, EVoxelScalingStage::GenerateAndMesh);
+    const double BaselineChunksPerSecond = BatchSize / (Baseline.WallMs / 1000.0);
+    double BestChunksPerSecond = BaselineChunksPerSecond;
+    Result.MaxConcurrentChunkGenerations = 1;
+
+    for (int32 Workers = 2; Workers <= MaxWorkers; Workers *= 2)
+    {
+        const FVoxelScalingSample Sample = FVoxelBenchmarkRunner::RunConcurrentBatch(ChosenFixtures, BatchSize, Workers, EVoxelScalingStage::GenerateAndMesh);
+        const double ChunksPerSecond = BatchSize / (Sample.WallMs / 1000.0);
+        const double Efficiency = ChunksPerSecond / BaselineChunksPerSecond / Workers;
+        if (Efficiency < MinWorkerEfficiency)
+        {
+            break;
+        }
+
+        Result.MaxConcurrentChunkGenerations = Workers;
+        BestChunksPerSecond = ChunksPerSecond;
+    }
+
+    Result.MaxChunksPerFrame = FMath::Clamp(FMath::FloorToInt(ApplyBudgetMs / FMath::Max(Chosen.ApplyMs, 0.01f)), 1, 20);
+
+    // Streaming is bound by whichever is slower, the workers or the per-frame apply budget
+    Result.ChunksPerSecond = FMath::Min((float)BestChunksPerSecond, Result.MaxChunksPerFrame * (1000.0f / Result.TargetFrameMs));
+
+    // Loaded area is roughly a disc of radius ViewDistance, VerticalLayers chunks deep
+    const float FillableChunks = Result.ChunksPerSecond * ViewFillSeconds;
+    Result.ViewDistanceInChunks = FMath::Clamp(FMath::FloorToInt(FMath::Sqrt(FillableChunks / (PI * VerticalLayers))), 2, 20);
+
+    Result.bValid = true;
+
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("Voxel calibration took %.0fms: %s"),
+        (FPlatformTime::Seconds() - StartTime) * 1000.0, *Result.ToString());
+
+    return Result;
+}
+
+bool FVoxelCalibration::Load(FVoxelCalibrationResult& OutResult)
+{
+    if (!GConfig)
+    {
+        return false;
+    }
+
+    int32 StoredVersion = 0;
+    FString StoredDeviceId;
+    if (!GConfig->GetInt(VoxelCalibration::ConfigSection, TEXT("Version"), StoredVersion, GGameUserSettingsIni) ||
+        !GConfig->GetString(VoxelCalibration::ConfigSection, TEXT("DeviceId"), StoredDeviceId, GGameUserSettingsIni))
+    {
+        return false;
+    }
+
+    // Settings measured on other hardware or with older rules are not trusted
+    if (StoredVersion != Version || StoredDeviceId != GetDeviceId())
+    {
+        UE_LOG(LogHearthshireVoxel, Log, TEXT("Voxel calibration is stale (version %d, device %s), recalibrating"), StoredVersion, *StoredDeviceId);
+        return false;
+    }
+
+    FVoxelCalibrationResult Result;
+    Result.DeviceId = StoredDeviceId;
+    GConfig->GetInt(VoxelCalibration::ConfigSection, TEXT("ChunkSize"), Result.ChunkSize, GGameUserSettingsIni);
+    GConfig->GetInt(VoxelCalibration::ConfigSection, TEXT("MaxConcurrentChunkGenerations"), Result.MaxConcurrentChunkGenerations, GGameUserSettingsIni);
+    GConfig->GetInt(VoxelCalibration::ConfigSection, TEXT("MaxChunksPerFrame"), Result.MaxChunksPerFrame, GGameUserSettingsIni);
+    GConfig->GetInt(VoxelCalibration::ConfigSection, TEXT("ViewDistanceInChunks"), Result.ViewDistanceInChunks, GGameUserSettingsIni);
+    GConfig->GetFloat(VoxelCalibration::ConfigSection, TEXT("TargetFrameMs"), Result.TargetFrameMs, GGameUserSettingsIni);
+    GConfig->GetFloat(VoxelCalibration::ConfigSection, TEXT("WorkerMsPerChunk16"), Result.WorkerMsPerChunk16, GGameUserSettingsIni);
+    GConfig->GetFloat(VoxelCalibration::ConfigSection, TEXT("WorkerMsPerChunk32"), Result.WorkerMsPerChunk32, GGameUserSettingsIni);
+    GConfig->GetFloat(VoxelCalibration::ConfigSection, TEXT("ApplyMsPerChunk16"), Result.ApplyMsPerChunk16, GGameUserSettingsIni);
+    GConfig->GetFloat(VoxelCalibration::ConfigSection, TEXT("ApplyMsPerChunk32"), Result.ApplyMsPerChunk32, GGameUserSettingsIni);
+    GConfig->GetFloat(VoxelCalibration::ConfigSection, TEXT("ChunksPerSecond"), Result.ChunksPerSecond, GGameUserSettingsIni);
+    Result.bValid = true;
+
+    OutResult = Result;
+    return true;
+}
+
+void FVoxelCalibration::Save(const FVoxelCalibrationResult& Result)
+{
+    if (!GConfig || !Result.bValid)
+    {
+        return;
+    }
+
+    GConfig->SetInt(VoxelCalibration::ConfigSection, TEXT("Version"), Version, GGameUserSettingsIni);
+    GConfig->SetString(VoxelCalibration::ConfigSection, TEXT("DeviceId"), *Result.DeviceId, GGameUserSettingsIni);
+    GConfig->SetInt(VoxelCalibration::ConfigSection, TEXT("ChunkSize"), Result.ChunkSize, GGameUserSettingsIni);
+    GConfig->SetInt(VoxelCalibration::ConfigSection, TEXT("MaxConcurrentChunkGenerations"), Result.MaxConcurrentChunkGenerations, GGameUserSettingsIni);
+    GConfig->SetInt(VoxelCalibration::ConfigSection, TEXT("MaxChunksPerFrame"), Result.MaxChunksPerFrame, GGameUserSettingsIni);
+    GConfig->SetInt(VoxelCalibration::ConfigSection, TEXT("ViewDistanceInChunks"), Result.ViewDistanceInChunks, GGameUserSettingsIni);
+    GConfig->SetFloat(VoxelCalibration::ConfigSection, TEXT("TargetFrameMs"), Result.TargetFrameMs, GGameUserSettingsIni);
+    GConfig->SetFloat(VoxelCalibration::ConfigSection, TEXT("WorkerMsPerChunk16"), Result.WorkerMsPerChunk16, GGameUserSettingsIni);
+    GConfig->SetFloat(VoxelCalibration::ConfigSection, TEXT("WorkerMsPerChunk32"), Result.WorkerMsPerChunk32, GGameUserSettingsIni);
+    GConfig->SetFloat(VoxelCalibration::ConfigSection, TEXT("ApplyMsPerChunk16"), Result.ApplyMsPerChunk16, GGameUserSettingsIni);
+    GConfig->SetFloat(VoxelCalibration::ConfigSection, TEXT("ApplyMsPerChunk32"), Result.ApplyMsPerChunk32, GGameUserSettingsIni);
+    GConfig->SetFloat(VoxelCalibration::ConfigSection, TEXT("ChunksPerSecond"), Result.ChunksPerSecond, GGameUserSettingsIni);
+    GConfig->Flush(false, GGameUserSettingsIni);
+}
+
+void FVoxelCalibration::Clear()
+{
+    if (GConfig)
+    {
+        GConfig->EmptySection(VoxelCalibration::ConfigSection, GGameUserSettingsIni);
+        GConfig->Flush(false, GGameUserSettingsIni);
+    }
+}
+
+void FVoxelCalibration::ApplyToConfig(const FVoxelCalibrationResult& Result, FVoxelWorldConfig& Config, bool bAllowChunkSizeChange)
+{
+    if (!Result.bValid)
+    {
+        return;
+    }
+
+    if (bAllowChunkSizeChange)
+    {
+        Config.ChunkSize = Result.ChunkSize;
+        Config.ViewDistanceInChunks = Result.ViewDistanceInChunks;
+    }
+    else if (Config.ChunkSize > 0)
+    {
+        // Same world distance in chunks of the size we are stuck with
+        Config.ViewDistanceInChunks = FMath::Clamp(Result.ViewDistanceInChunks * Result.ChunkSize / Config.ChunkSize, 1, 20);
+    }
+
+    Config.MaxConcurrentChunkGenerations = Result.MaxConcurrentChunkGenerations;
+    Config.MaxChunksPerFrame = Result.MaxChunksPerFrame;
+    Config.bUseMultithreading = true;
+
+    // Measured on cubes - a column chunk costs its height in cubes to apply
+    const FVoxelChunkSize Dimensions = Config.GetChunkDimensions();
+    if (Dimensions.Z > Dimensions.X)
+    {
+        Config.MaxChunksPerFrame = FMath::Max(1, Config.MaxChunksPerFrame * Dimensions.X / Dimensions.Z);
+    }
+}
+
+FString FVoxelCalibration::GetDeviceId()
+{
+    return FString::Printf(TEXT("%s/%d"), *FPlatformMisc::GetCPUBrand().TrimStartAndEnd(), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+}
+
+static FAutoConsoleCommand VoxelCalibrateCommand(
+    TEXT("voxel.calibrate"),
+    TEXT("Measure voxel streaming settings for this device and store them. Optional argument: target FPS. 'voxel.calibrate clear' forgets the stored result."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() > 0 && Args[0] == TEXT("clear"))
+        {
+            FVoxelCalibration::Clear();
+            UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel calibration cleared, it runs again on the next voxel world start"));
+            return;
+        }
+
+        const FVoxelCalibrationResult Result = FVoxelCalibration::Run(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0);
+        FVoxelCalibration::Save(Result);
+        UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel calibration stored: %s"), *Result.ToString());
+    }));
@@ -0,0 +1,528 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelCameraPath.h"
+#include "VoxelWorld.h"
+#include "VoxelPerformanceStats.h"
+#include "HearthshireVoxelModule.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Algo/BinarySearch.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#endif
+
+bool UVoxelCameraPath::Sample(float Time, FVector& OutLocation, FRotator& OutRotation) const
+{
+    if (Keys.Num() == 0)
+    {
+        return false;
+    }
+
+    if (Time <= Keys[0].Time || Keys.Num() == 1)
+    {
+        OutLocation = Keys[0].Location;
+        OutRotation = Keys[0].Rotation;
+        return true;
+    }
+
+    if (Time >= Keys.Last().Time)
+    {
+        OutLocation = Keys.Last().Location;
+        OutRotation = Keys.Last().Rotation;
+        return true;
+    }
+
+    // First key after Time - keys are sorted by time
+    const int32 Next = Algo::UpperBoundBy(Keys, Time, &FVoxelCameraPathKey::Time);
+    const FVoxelCameraPathKey& A = Keys[Next - 1];
+    const FVoxelCameraPathKey& B = Keys[Next];
+
+    const float Alpha = B.Time > A.Time ? (Time - A.Time) / (B.Time - A.Time) : 0.0f;
+    OutLocation = FMath::Lerp(A.Location, B.Location, Alpha);
+    OutRotation = FQuat::Slerp(A.Rotation.Quaternion(), B.Rotation.Quaternion(), Alpha).Rotator();
+    return true;
+}
+
+// FVoxelCameraPathRecorder Implementation
+
+FVoxelCameraPathRecorder::~FVoxelCameraPathRecorder()
+{
+    if (TickHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+    }
+}
+
+void FVoxelCameraPathRecorder::Start(AVoxelWorld* InWorld, float InSampleInterval)
+{
+    if (!InWorld)
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("CameraPathRecorder: No voxel world to record"));
+        return;
+    }
+
+    if (TickHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+    }
+
+    World = InWorld;
+    Keys.Reset();
+    SampleInterval = FMath::Max(InSampleInterval, 0.01f);
+    ElapsedTime = 0.0f;
+    TimeSinceSample = 0.0f;
+
+    // Key at time zero so the replay starts exactly where the recording did
+    FVoxelCameraPathKey& FirstKey = Keys.AddDefaulted_GetRef();
+    GetSourceTransform(FirstKey.Location, FirstKey.Rotation);
+
+    TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVoxelCameraPathRecorder::Tick));
+
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("CameraPathRecorder: Recording %s every %.2fs"), *InWorld->GetName(), SampleInterval);
+}
+
+UVoxelCameraPath* FVoxelCameraPathRecorder::Stop(UObject* Outer, FName Name)
+{
+    if (!TickHandle.IsValid())
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("CameraPathRecorder: Not recording"));
+        return nullptr;
+    }
+
+    FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+    TickHandle.Reset();
+
+    // Close the path at the current position
+    FVoxelCameraPathKey LastKey;
+    LastKey.Time = ElapsedTime;
+    if (ElapsedTime > Keys.Last().Time && GetSourceTransform(LastKey.Location, LastKey.Rotation))
+    {
+        Keys.Add(LastKey);
+    }
+
+    UVoxelCameraPath* Path = NewObject<UVoxelCameraPath>(Outer, Name, RF_Public | RF_Standalone);
+    Path->Keys = MoveTemp(Keys);
+    Path->SampleInterval = SampleInterval;
+
+    if (AVoxelWorld* VoxelWorld = World.Get())
+    {
+        Path->Seed = VoxelWorld->WorldSeed;
+        Path->RecordedMap = VoxelWorld->GetWorld() ? VoxelWorld->GetWorld()->GetMapName() : FString();
+    }
+
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("CameraPathRecorder: Recorded %d keys over %.1fs"), Path->Keys.Num(), Path->GetDuration());
+
+    World.Reset();
+    return Path;
+}
+
+bool FVoxelCameraPathRecorder::Tick(float DeltaTime)
+{
+    if (!World.IsValid())
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("CameraPathRecorder: Voxel world went away, recording paused"));
+        TickHandle.Reset();
+        return false;
+    }
+
+    ElapsedTime += DeltaTime;
+    TimeSinceSample += DeltaTime;
+
+    if (TimeSinceSample >= SampleInterval)
+    {
+        TimeSinceSample = 0.0f;
+
+        FVoxelCameraPathKey Key;
+        Key.Time = ElapsedTime;
+        if (GetSourceTransform(Key.Location, Key.Rotation))
+        {
+            Keys.Add(Key);
+        }
+    }
+
+    return true;
+}
+
+bool FVoxelCameraPathRecorder::GetSourceTransform(FVector& OutLocation, FRotator& OutRotation) const
+{
+    const AVoxelWorld* VoxelWorld = World.Get();
+    if (!VoxelWorld)
+    {
+        return false;
+    }
+
+    if (UWorld* GameWorld = VoxelWorld->GetWorld())
+    {
+        const APlayerController* PC = GameWorld->GetFirstPlayerController();
+        if (PC && PC->PlayerCameraManager)
+        {
+            OutLocation = PC->PlayerCameraManager->GetCameraLocation();
+            OutRotation = PC->PlayerCameraManager->GetCameraRotation();
+            return true;
+        }
+    }
+
+    OutRotation = FRotator::ZeroRotator;
+    return VoxelWorld->GetStreamingSourcePosition(OutLocation);
+}
+
+// FVoxelCameraPathPlayer Implementation
+
+FVoxelCameraPathPlayer::FVoxelCameraPathPlayer(AVoxelWorld* InWorld, const UVoxelCameraPath* InPath, const FVoxelPathReplaySettings& InSettings)
+    : World(InWorld)
+    , Path(InPath)
+    , Settings(InSettings)
+{
+}
+
+void FVoxelCameraPathPlayer::Begin()
+{
+    PathTime = 0.0f;
+    PeakActiveChunks = 0;
+    FrameTimesMs.Reset();
+
+    AVoxelWorld* VoxelWorld = World.Get();
+    if (!VoxelWorld || !Path)
+    {
+        return;
+    }
+
+    const int32 Seed = Settings.Seed != INDEX_NONE ? Settings.Seed : Path->Seed;
+    VoxelWorld->WorldSeed = Seed;
+    FMath::RandInit(Seed);
+    FMath::SRandInit(Seed);
+
+    FVoxelPerformanceMonitor::Get().ResetLatency();
+
+    FVector Location;
+    FRotator Rotation;
+    if (Path->Sample(0.0f, Location, Rotation))
+    {
+        VoxelWorld->SetStreamingSourceOverride(Location);
+    }
+}
+
+float FVoxelCameraPathPlayer::GetStepDeltaTime(float FrameDeltaTime) const
+{
+    return Settings.FixedDeltaTime > 0.0f ? Settings.FixedDeltaTime : FrameDeltaTime;
+}
+
+bool FVoxelCameraPathPlayer::Advance(float StepDeltaTime)
+{
+    AVoxelWorld* VoxelWorld = World.Get();
+    if (!VoxelWorld || !Path)
+    {
+        return false;
+    }
+
+    PathTime += StepDeltaTime;
+    PeakActiveChunks = FMath::Max(PeakActiveChunks, VoxelWorld->GetActiveChunkCount());
+
+    FVector Location;
+    FRotator Rotation;
+    if (Path->Sample(PathTime, Location, Rotation))
+    {
+        VoxelWorld->SetStreamingSourceOverride(Location);
+    }
+
+    return PathTime < Path->GetDuration() + Settings.SettleTime;
+}
+
+void FVoxelCameraPathPlayer::RecordFrameTime(double FrameMs)
+{
+    FrameTimesMs.Add(FrameMs);
+}
+
+FVoxelBenchmarkResult FVoxelCameraPathPlayer::Finish()
+{
+    if (AVoxelWorld* VoxelWorld = World.Get())
+    {
+        VoxelWorld->ClearStreamingSourceOverride();
+    }
+
+    FVoxelBenchmarkResult Result;
+    Result.Stage = TEXT("Replay");
+    Result.Fixture = Path ? Path->GetName() : TEXT("None");
+
+    int32 Hitches = 0;
+    for (double FrameMs : FrameTimesMs)
+    {
+        Hitches += FrameMs > 33.3 ? 1 : 0;
+    }
+
+    FVoxelBenchmarkRunner::ComputeStatistics(FrameTimesMs, Result);
+
+    Result.Counters.Add(TEXT("frames"), Result.Iterations);
+    Result.Counters.Add(TEXT("hitches_33ms"), Hitches);
+    Result.Counters.Add(TEXT("simulated_seconds"), PathTime);
+    Result.Counters.Add(TEXT("fixed_delta_time"), Settings.FixedDeltaTime);
+    Result.Counters.Add(TEXT("peak_active_chunks"), PeakActiveChunks);
+
+    // Streaming latency over the run, the histograms were reset in Begin
+    const FVoxelPerformanceMonitor& Monitor = FVoxelPerformanceMonitor::Get();
+    const FVoxelLatencyHistogram& Visible = Monitor.GetLatencyHistogram(EVoxelLatencyStage::RequestToVisible);
+    Result.Counters.Add(TEXT("chunks_visible"), Visible.GetCount());
+    Result.Counters.Add(TEXT("request_to_visible_p50_ms"), Visible.GetPercentileMs(0.5));
+    Result.Counters.Add(TEXT("request_to_visible_p95_ms"), Visible.GetPercentileMs(0.95));
+    Result.Counters.Add(TEXT("request_to_visible_p99_ms"), Visible.GetPercentileMs(0.99));
+    Result.Counters.Add(TEXT("request_to_visible_max_ms"), Visible.GetMaxMs());
+    Result.Counters.Add(TEXT("queue_wait_p95_ms"), Monitor.GetLatencyHistogram(EVoxelLatencyStage::QueueWait).GetPercentileMs(0.95));
+    Result.Counters.Add(TEXT("generate_p95_ms"), Monitor.GetLatencyHistogram(EVoxelLatencyStage::Generate).GetPercentileMs(0.95));
+    Result.Counters.Add(TEXT("mesh_p95_ms"), Monitor.GetLatencyHistogram(EVoxelLatencyStage::Mesh).GetPercentileMs(0.95));
+    Result.Counters.Add(TEXT("apply_p95_ms"), Monitor.GetLatencyHistogram(EVoxelLatencyStage::Apply).GetPercentileMs(0.95));
+
+    return Result;
+}
+
+bool FVoxelCameraPathPlayer::RunHeadless(const UVoxelCameraPath* Path, const FVoxelPathReplaySettings& Settings, FVoxelBenchmarkResult& OutResult)
+{
+    if (!Path || Path->Keys.Num() == 0)
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("RunHeadless: Camera path is missing or empty"));
+        return false;
+    }
+
+    if (!GEngine)
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("RunHeadless: No engine"));
+        return false;
+    }
+
+    // The game instance supplies the game mode - without one the world never dispatches BeginPlay to its
+    // actors, and the voxel world wouldn't stream
+    TStrongObjectPtr<UGameInstance> GameInstance(NewObject<UGameInstance>(GEngine));
+    GameInstance->InitializeStandalone(TEXT("VoxelPathReplay"));
+    UWorld* GameWorld = GameInstance->GetWorld();
+    GameWorld->SetGameMode(FURL());
+    GameWorld->InitializeActorsForPlay(FURL());
+    GameWorld->BeginPlay();
+
+    AVoxelWorld* VoxelWorld = GameWorld->SpawnActor<AVoxelWorld>();
+    if (!VoxelWorld)
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("RunHeadless: Failed to spawn voxel world"));
+        GameInstance->Shutdown();
+        GEngine->DestroyWorldContext(GameWorld);
+        GameWorld->DestroyWorld(false);
+        return false;
+    }
+
+    // No frames to measure real time against, so always step at a fixed rate
+    FVoxelPathReplaySettings HeadlessSettings = Settings;
+    if (HeadlessSettings.FixedDeltaTime <= 0.0f)
+    {
+        HeadlessSettings.FixedDeltaTime = 1.0f / 30.0f;
+    }
+
+    FVoxelCameraPathPlayer Player(VoxelWorld, Path, HeadlessSettings);
+    Player.Begin();
+
+    const float StepDeltaTime = HeadlessSettings.FixedDeltaTime;
+    bool bRunning = true;
+    while (bRunning)
+    {
+        const double FrameStartTime = FPlatformTime::Seconds();
+
+        bRunning = Player.Advance(StepDeltaTime);
+        GameWorld->Tick(LEVELTICK_All, StepDeltaTime);
+
+        // Mesh workers hand their results back through game thread tasks
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+        Player.RecordFrameTime((FPlatformTime::Seconds() - FrameStartTime) * 1000.0);
+    }
+
+    OutResult = Player.Finish();
+
+    // Workers still hold chunk pointers, let them land before the world goes away
+    const double DrainDeadline = FPlatformTime::Seconds() + 10.0;
+    while (VoxelWorld->GetActiveGenerationCount() > 0 && FPlatformTime::Seconds() < DrainDeadline)
+    {
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    GameInstance->Shutdown();
+    GEngine->DestroyWorldContext(GameWorld);
+    GameWorld->DestroyWorld(false);
+    return true;
+}
+
+namespace VoxelCameraPath
+{
+    AVoxelWorld* FindVoxelWorld(UWorld* World)
+    {
+        if (World)
+        {
+            for (TActorIterator<AVoxelWorld> It(World); It; ++It)
+            {
+                return *It;
+            }
+        }
+        return nullptr;
+    }
+
+    TUniquePtr<FVoxelCameraPathRecorder> Recorder;
+
+    /** Replays a path in the running game, one step per engine frame */
+    struct FReplayDriver
+    {
+        TStrongObjectPtr<UVoxelCameraPath> Path;
+        TUniquePtr<FVoxelCameraPathPlayer> Player;
+        FTSTicker::FDelegateHandle TickHandle;
+        FString OutputPath;
+        double LastFrameTime = 0.0;
+        bool bRestoreFixedTimeStep = false;
+        double PreviousFixedDeltaTime = 0.0;
+
+        bool Tick(float DeltaTime);
+        void Stop();
+    };
+
+    TUniquePtr<FReplayDriver> Replay;
+
+    bool FReplayDriver::Tick(float DeltaTime)
+    {
+        // Wall time, DeltaTime is the fixed step when the engine runs with one
+        const double Now = FPlatformTime::Seconds();
+        Player->RecordFrameTime((Now - LastFrameTime) * 1000.0);
+        LastFrameTime = Now;
+
+        if (!Player->Advance(Player->GetStepDeltaTime(DeltaTime)))
+        {
+            Stop();
+            return false;
+        }
+        return true;
+    }
+
+    void FReplayDriver::Stop()
+    {
+        if (bRestoreFixedTimeStep)
+        {
+            FApp::SetUseFixedTimeStep(false);
+            FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+        }
+
+        FVoxelBenchmarkRunner Runner(0, 1);
+        Runner.AddResult(Player->Finish());
+        UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel path replay finished:\n%s"), *Runner.GetSummary());
+        Runner.SaveJson(OutputPath);
+
+        TickHandle.Reset();
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs VoxelPathRecordCommand(
+    TEXT("voxel.path.record"),
+    TEXT("Start recording the voxel streaming source. Optional argument: sample interval in seconds (default 0.1)."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        AVoxelWorld* VoxelWorld = VoxelCameraPath::FindVoxelWorld(World);
+        if (!VoxelWorld)
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("voxel.path.record: No voxel world"));
+            return;
+        }
+
+        const float Interval = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.1f;
+        VoxelCameraPath::Recorder = MakeUnique<FVoxelCameraPathRecorder>();
+        VoxelCameraPath::Recorder->Start(VoxelWorld, Interval);
+    }));
+
+static FAutoConsoleCommand VoxelPathStopCommand(
+    TEXT("voxel.path.stop"),
+    TEXT("Stop recording and create a camera path asset. Optional argument: asset name (created under /Game/VoxelPaths in the editor)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (!VoxelCameraPath::Recorder || !VoxelCameraPath::Recorder->IsRecording())
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("voxel.path.stop: Not recording"));
+            return;
+        }
+
+        const FString AssetName = Args.Num() > 0 ? Args[0] : FString::Printf(TEXT("VoxelPath_%s"), *FDateTime::Now().ToString());
+
+#if WITH_EDITOR
+        const FString PackageName = FString::Printf(TEXT("/Game/VoxelPaths/%s"), *AssetName);
+        UPackage* Package = CreatePackage(*PackageName);
+        UVoxelCameraPath* Path = VoxelCameraPath::Recorder->Stop(Package, *AssetName);
+        if (Path)
+        {
+            Package->MarkPackageDirty();
+            FAssetRegistryModule::AssetCreated(Path);
+            UE_LOG(LogHearthshireVoxel, Log, TEXT("Created camera path asset %s - save it from the content browser"), *PackageName);
+        }
+#else
+        UVoxelCameraPath* Path = VoxelCameraPath::Recorder->Stop(GetTransientPackage(), *AssetName);
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("Camera paths can only be saved as assets in the editor, %s is transient"), Path ? *Path->GetName() : TEXT("path"));
+#endif
+
+        VoxelCameraPath::Recorder.Reset();
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs VoxelPathReplayCommand(
+    TEXT("voxel.path.replay"),
+    TEXT("Replay a camera path through the voxel world: voxel.path.replay <ObjectPath> [FixedDeltaTime, 0 = real time] [OutputFile]."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (Args.Num() == 0)
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("voxel.path.replay: Missing camera path object path"));
+            return;
+        }
+
+        if (VoxelCameraPath::Replay && VoxelCameraPath::Replay->TickHandle.IsValid())
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("voxel.path.replay: A replay is already running"));
+            return;
+        }
+
+        AVoxelWorld* VoxelWorld = VoxelCameraPath::FindVoxelWorld(World);
+        UVoxelCameraPath* Path = LoadObject<UVoxelCameraPath>(nullptr, *Args[0]);
+        if (!VoxelWorld || !Path || Path->Keys.Num() == 0)
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("voxel.path.replay: Need a voxel world and a non-empty camera path (%s)"), *Args[0]);
+            return;
+        }
+
+        FVoxelPathReplaySettings Settings;
+        if (Args.Num() > 1)
+        {
+            Settings.FixedDeltaTime = FCString::Atof(*Args[1]);
+        }
+
+        TUniquePtr<VoxelCameraPath::FReplayDriver> Driver = MakeUnique<VoxelCameraPath::FReplayDriver>();
+        Driver->Path.Reset(Path);
+        Driver->OutputPath = Args.Num() > 2 ? Args[2] : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"),
+            FString::Printf(TEXT("VoxelReplay-%s-%s.json"), *Path->GetName(), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"))));
+        Driver->Player = MakeUnique<FVoxelCameraPathPlayer>(VoxelWorld, Path, Settings);
+
+        // Make the engine step at the same rate the path is simulated
+        if (Settings.FixedDeltaTime > 0.0f && !FApp::UseFixedTimeStep())
+        {
+            Driver->bRestoreFixedTimeStep = true;
+            Driver->PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+            FApp::SetUseFixedTimeStep(true);
+            FApp::SetFixedDeltaTime(Settings.FixedDeltaTime);
+        }
+
+        Driver->Player->Begin();
+        Driver->LastFrameTime = FPlatformTime::Seconds();
+        Driver->TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(Driver.Get(), &VoxelCameraPath::FReplayDriver::Tick));
+
+        VoxelCameraPath::Replay = MoveTemp(Driver);
+        UE_LOG(LogHearthshireVoxel, Log, TEXT("voxel.path.replay: Replaying %s (%.1fs)"), *Path->GetName(), Path->GetDuration());
+    }));
@@ -0,0 +1,293 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelChannels.h"
+#include "HearthshireVoxelModule.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace VoxelChannels
+{
+    // Bumped when the Save layout changes
+    static constexpr uint8 StreamVersion = 1;
+
+    const TCHAR* GetName(EVoxelChannel Channel)
+    {
+        switch (Channel)
+        {
+            case EVoxelChannel::Light:      return TEXT("Light");
+            case EVoxelChannel::WaterLevel: return TEXT("WaterLevel");
+            case EVoxelChannel::Moisture:   return TEXT("Moisture");
+            case EVoxelChannel::Growth:     return TEXT("Growth");
+            case EVoxelChannel::Damage:     return TEXT("Damage");
+            default:                        return TEXT("Unknown");
+        }
+    }
+}
+
+// FVoxelChannelData
+
+void FVoxelChannelData::Allocate(int32 VoxelCount)
+{
+    Data.SetNumUninitialized(VoxelChannels::GetByteCount(Format, VoxelCount));
+
+    switch (Format)
+    {
+        case EVoxelChannelFormat::Bits4:
+            FMemory::Memset(Data.GetData(), (uint8)(UniformValue | (UniformValue << 4)), Data.Num());
+            break;
+        case EVoxelChannelFormat::Bits8:
+            FMemory::Memset(Data.GetData(), (uint8)UniformValue, Data.Num());
+            break;
+        default:
+        {
+            uint16* Values = reinterpret_cast<uint16*>(Data.GetData());
+            for (int32 Index = 0; Index < VoxelCount; Index++)
+            {
+                Values[Index] = UniformValue;
+            }
+            break;
+        }
+    }
+}
+
+bool FVoxelChannelData::Set(int32 Index, uint16 Value, int32 VoxelCount)
+{
+    Value = FMath::Min(Value, VoxelChannels::GetMaxValue(Format));
+
+    const uint16 OldValue = Get(Index);
+    if (OldValue == Value)
+    {
+        return false;
+    }
+
+    // First divergent write allocates
+    if (IsUniform())
+    {
+        Allocate(VoxelCount);
+    }
+
+    Write(Index, Value);
+    DivergentCount += (Value != UniformValue ? 1 : 0) - (OldValue != UniformValue ? 1 : 0);
+
+    // Back to uniform - drop the array
+    if (DivergentCount == 0)
+    {
+        Data.Empty();
+    }
+
+    return true;
+}
+
+void FVoxelChannelData::Fill(uint16 Value)
+{
+    UniformValue = FMath::Min(Value, VoxelChannels::GetMaxValue(Format));
+    DivergentCount = 0;
+    Data.Empty();
+}
+
+bool FVoxelChannelData::Compact(int32 VoxelCount)
+{
+    if (IsUniform())
+    {
+        return true;
+    }
+
+    const uint16 First = Get(0);
+    for (int32 Index = 1; Index < VoxelCount; Index++)
+    {
+        if (Get(Index) != First)
+        {
+            return false;
+        }
+    }
+
+    Fill(First);
+    return true;
+}
+
+// FVoxelChunkChannels
+
+bool FVoxelChunkChannels::Set(EVoxelChannel Channel, int32 Index, uint16 Value, int32 VoxelCount)
+{
+    int32 EntryIndex = Channels.IndexOfByPredicate([Channel](const FVoxelChannelData& Data) { return Data.Channel == Channel; });
+    if (EntryIndex == INDEX_NONE)
+    {
+        // Unwritten channels read as 0, so writing 0 needs no storage
+        if (Value == 0)
+        {
+            return false;
+        }
+        EntryIndex = Channels.Emplace(Channel);
+    }
+
+    FVoxelChannelData& Data = Channels[EntryIndex];
+    const bool bChanged = Data.Set(Index, Value, VoxelCount);
+
+    if (Data.IsUniform() && Data.UniformValue == 0)
+    {
+        RemoveEntry(EntryIndex);
+    }
+
+    return bChanged;
+}
+
+void FVoxelChunkChannels::Fill(EVoxelChannel Channel, uint16 Value)
+{
+    const int32 EntryIndex = Channels.IndexOfByPredicate([Channel](const FVoxelChannelData& Data) { return Data.Channel == Channel; });
+    if (Value == 0)
+    {
+        if (EntryIndex != INDEX_NONE)
+        {
+            RemoveEntry(EntryIndex);
+        }
+        return;
+    }
+
+    FVoxelChannelData& Data = EntryIndex != INDEX_NONE ? Channels[EntryIndex] : Channels[Channels.Emplace(Channel)];
+    Data.Fill(Value);
+}
+
+void FVoxelChunkChannels::Compact(int32 VoxelCount)
+{
+    for (int32 EntryIndex = Channels.Num() - 1; EntryIndex >= 0; EntryIndex--)
+    {
+        FVoxelChannelData& Data = Channels[EntryIndex];
+        if (Data.Compact(VoxelCount) && Data.UniformValue == 0)
+        {
+            RemoveEntry(EntryIndex);
+        }
+    }
+}
+
+void FVoxelChunkChannels::RemoveEntry(int32 EntryIndex)
+{
+    Channels.RemoveAtSwap(EntryIndex);
+
+    // The last channel going away frees the entry array too
+    if (Channels.Num() == 0)
+    {
+        Channels.Empty();
+    }
+}
+
+int64 FVoxelChunkChannels::GetAllocatedSize() const
+{
+    int64 Size = Channels.GetAllocatedSize();
+    for (const FVoxelChannelData& Data : Channels)
+    {
+        Size += Data.Data.GetAllocatedSize();
+    }
+    return Size;
+}
+
+void FVoxelChunkChannels::Save(int32 VoxelCount, TArray<uint8>& OutBytes) const
+{
+    OutBytes.Reset();
+    if (Channels.Num() == 0)
+    {
+        return;
+    }
+
+    FMemoryWriter Writer(OutBytes);
+
+    uint8 Version = VoxelChannels::StreamVersion;
+    uint32 PackedVoxelCount = VoxelCount;
+    uint32 ChannelCount = Channels.Num();
+    Writer << Version;
+    Writer.SerializeIntPacked(PackedVoxelCount);
+    Writer.SerializeIntPacked(ChannelCount);
+
+    for (const FVoxelChannelData& Data : Channels)
+    {
+        uint8 Channel = (uint8)Data.Channel;
+        uint8 bVarying = Data.IsUniform() ? 0 : 1;
+        uint32 UniformValue = Data.UniformValue;
+        Writer << Channel;
+        Writer << bVarying;
+        Writer.SerializeIntPacked(UniformValue);
+
+        if (bVarying)
+        {
+            Writer.Serialize(const_cast<uint8*>(Data.Data.GetData()), Data.Data.Num());
+        }
+    }
+}
+
+bool FVoxelChunkChannels::Load(const TArray<uint8>& Bytes, int32 VoxelCount)
+{
+    Channels.Empty();
+    if (Bytes.Num() == 0)
+    {
+        return true;
+    }
+
+    FMemoryReader Reader(Bytes);
+
+    uint8 Version = 0;
+    uint32 StoredVoxelCount = 0;
+    uint32 ChannelCount = 0;
+    Reader << Version;
+    Reader.SerializeIntPacked(StoredVoxelCount);
+    Reader.SerializeIntPacked(ChannelCount);
+
+    if (Reader.IsError() || Version != VoxelChannels::StreamVersion || (int32)StoredVoxelCount != VoxelCount || ChannelCount > (uint32)EVoxelChannel::Count)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelChannels: Malformed channel header (version %d, %u voxels, %u channels)"),
+            Version, StoredVoxelCount, ChannelCount);
+        return false;
+    }
+
+    for (uint32 EntryIndex = 0; EntryIndex < ChannelCount; EntryIndex++)
+    {
+        uint8 Channel = 0;
+        uint8 bVarying = 0;
+        uint32 UniformValue = 0;
+        Reader << Channel;
+        Reader << bVarying;
+        Reader.SerializeIntPacked(UniformValue);
+
+        if (Reader.IsError() || Channel >= (uint8)EVoxelChannel::Count || HasChannel((EVoxelChannel)Channel))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelChannels: Malformed channel entry %u"), EntryIndex);
+            Channels.Empty();
+            return false;
+        }
+
+        FVoxelChannelData& Data = Channels[Channels.Emplace((EVoxelChannel)Channel)];
+        Data.UniformValue = (uint16)FMath::Min(UniformValue, (uint32)VoxelChannels::GetMaxValue(Data.Format));
+
+        if (bVarying)
+        {
+            const int32 ByteCount = VoxelChannels::GetByteCount(Data.Format, VoxelCount);
+            if (ByteCount > Reader.TotalSize() - Reader.Tell())
+            {
+                UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelChannels: Channel %s is truncated"), VoxelChannels::GetName(Data.Channel));
+                Channels.Empty();
+                return false;
+            }
+
+            Data.Data.SetNumUninitialized(ByteCount);
+            Reader.Serialize(Data.Data.GetData(), ByteCount);
+
+            for (int32 Index = 0; Index < VoxelCount; Index++)
+            {
+                Data.DivergentCount += Data.Get(Index) != Data.UniformValue ? 1 : 0;
+            }
+            if (Data.DivergentCount == 0)
+            {
+                Data.Data.Empty();
+            }
+        }
+    }
+
+    // A channel that was all zero when saved needs no entry
+    for (int32 EntryIndex = Channels.Num() - 1; EntryIndex >= 0; EntryIndex--)
+    {
+        if (Channels[EntryIndex].IsUniform() && Channels[EntryIndex].UniformValue == 0)
+        {
+            RemoveEntry(EntryIndex);
+        }
+    }
+
+    return !Reader.IsError();
+}
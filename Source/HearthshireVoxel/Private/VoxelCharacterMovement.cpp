@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelCharacterMovement.h"
+#include "VoxelCollision.h"
+#include "VoxelWorld.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "Components/CapsuleComponent.h"
+#include "EngineUtils.h"
+#include "HearthshireVoxelModule.h"
+
+UVoxelCharacterMovementComponent::UVoxelCharacterMovementComponent()
+{
+    VoxelWorld = nullptr;
+    bVoxelGrounded = false;
+}
+
+void UVoxelCharacterMovementComponent::SetDefaultMovementMode()
+{
+    if (bUseVoxelWalking && ResolveVoxelWorld())
+    {
+        SetMovementMode(MOVE_Custom, (uint8)EVoxelCustomMovementMode::VoxelWalking);
+        return;
+    }
+
+    Super::SetDefaultMovementMode();
+}
+
+bool UVoxelCharacterMovementComponent::IsMovingOnGround() const
+{
+    return IsVoxelWalking() ? bVoxelGrounded : Super::IsMovingOnGround();
+}
+
+bool UVoxelCharacterMovementComponent::IsFalling() const
+{
+    return IsVoxelWalking() ? !bVoxelGrounded : Super::IsFalling();
+}
+
+float UVoxelCharacterMovementComponent::GetMaxSpeed() const
+{
+    if (IsVoxelWalking())
+    {
+        return IsCrouching() ? MaxWalkSpeedCrouched : MaxWalkSpeed;
+    }
+
+    return Super::GetMaxSpeed();
+}
+
+void UVoxelCharacterMovementComponent::SetVoxelWalking(bool bEnable)
+{
+    bUseVoxelWalking = bEnable;
+
+    if (bEnable && ResolveVoxelWorld())
+    {
+        SetMovementMode(MOVE_Custom, (uint8)EVoxelCustomMovementMode::VoxelWalking);
+    }
+    else if (IsVoxelWalking())
+    {
+        SetMovementMode(MOVE_Falling);
+    }
+}
+
+bool UVoxelCharacterMovementComponent::IsVoxelWalking() const
+{
+    return MovementMode == MOVE_Custom && CustomMovementMode == (uint8)EVoxelCustomMovementMode::VoxelWalking;
+}
+
+void UVoxelCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+    Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+    const bool bWasVoxelWalking = PreviousMovementMode == MOVE_Custom && PreviousCustomMode == (uint8)EVoxelCustomMovementMode::VoxelWalking;
+
+    // Jumping switches to falling - stay in voxel mode and let it integrate the jump
+    if (bWasVoxelWalking && bUseVoxelWalking && MovementMode == MOVE_Falling)
+    {
+        bVoxelGrounded = false;
+        SetMovementMode(MOVE_Custom, (uint8)EVoxelCustomMovementMode::VoxelWalking);
+    }
+}
+
+void UVoxelCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+    if (CustomMovementMode == (uint8)EVoxelCustomMovementMode::VoxelWalking)
+    {
+        PhysVoxelWalking(DeltaTime, Iterations);
+        return;
+    }
+
+    Super::PhysCustom(DeltaTime, Iterations);
+}
+
+void UVoxelCharacterMovementComponent::PhysVoxelWalking(float DeltaTime, int32 Iterations)
+{
+    if (DeltaTime < MIN_TICK_TIME || !CharacterOwner || !UpdatedComponent)
+    {
+        return;
+    }
+
+    AVoxelWorld* World = ResolveVoxelWorld();
+    if (!World)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelWalking: No voxel world found, falling back to default movement"));
+        bUseVoxelWalking = false;
+        SetMovementMode(MOVE_Falling);
+        return;
+    }
+
+    // Horizontal velocity from input, with reduced control in the air
+    if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+    {
+        const FVector SavedAcceleration = Acceleration;
+        const float SavedVelocityZ = Velocity.Z;
+
+        if (!bVoxelGrounded)
+        {
+            Acceleration *= AirControl;
+        }
+
+        Acceleration.Z = 0.0f;
+        Velocity.Z = 0.0f;
+        CalcVelocity(DeltaTime, bVoxelGrounded ? GroundFriction : FallingLateralFriction, false, GetMaxBrakingDeceleration());
+        Velocity.Z = SavedVelocityZ;
+        Acceleration = SavedAcceleration;
+    }
+
+    // Gravity is always integrated; the floor sweep cancels it while grounded
+    const float TerminalVelocity = GetPhysicsVolume() ? GetPhysicsVolume()->TerminalVelocity : 4000.0f;
+    Velocity.Z = FMath::Max(Velocity.Z + GetGravityZ() * DeltaTime, -TerminalVelocity);
+
+    const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+    const float Radius = Capsule->GetScaledCapsuleRadius();
+    const float HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+
+    const FVector Start = UpdatedComponent->GetComponentLocation();
+    const FVector Delta = Velocity * DeltaTime;
+
+    FVoxelSweepResult Result = FVoxelCollisionQuery::SweepCapsule(World, Start, Radius, HalfHeight, Delta, bBlockOnUnloadedTerrain);
+
+    // Step up single voxel ledges when walking into them
+    const float DesiredHorizontal = FVector2D(Delta.X, Delta.Y).Size();
+    const float AppliedHorizontal = FVector2D(Result.AppliedDelta.X, Result.AppliedDelta.Y).Size();
+    if (bVoxelGrounded && VoxelStepHeight > 0.0f && AppliedHorizontal + KINDA_SMALL_NUMBER < DesiredHorizontal)
+    {
+        const FVoxelSweepResult Up = FVoxelCollisionQuery::SweepCapsule(World, Start, Radius, HalfHeight, FVector(0.0f, 0.0f, VoxelStepHeight), bBlockOnUnloadedTerrain);
+        const FVoxelSweepResult Across = FVoxelCollisionQuery::SweepCapsule(World, Up.Location, Radius, HalfHeight, FVector(Delta.X, Delta.Y, 0.0f), bBlockOnUnloadedTerrain);
+        const FVoxelSweepResult Down = FVoxelCollisionQuery::SweepCapsule(World, Across.Location, Radius, HalfHeight, FVector(0.0f, 0.0f, -Up.AppliedDelta.Z + FMath::Min(Delta.Z, 0.0f)), bBlockOnUnloadedTerrain);
+
+        const float SteppedHorizontal = FVector2D(Across.AppliedDelta.X, Across.AppliedDelta.Y).Size();
+        if (Down.bHitFloor && SteppedHorizontal > AppliedHorizontal + KINDA_SMALL_NUMBER)
+        {
+            Result = Down;
+            Result.AppliedDelta = Down.Location - Start;
+        }
+    }
+
+    MoveUpdatedComponent(Result.Location - Start, UpdatedComponent->GetComponentQuat(), false);
+
+    // Cancel horizontal velocity into blocking walls
+    for (int32 Axis = 0; Axis < 2; Axis++)
+    {
+        if (!FMath::IsNearlyEqual(Result.AppliedDelta[Axis], Delta[Axis], 0.01f))
+        {
+            Velocity[Axis] = 0.0f;
+        }
+    }
+
+    if (Result.bHitFloor || Result.bHitCeiling)
+    {
+        Velocity.Z = 0.0f;
+    }
+
+    // Grounded if resting on a walkable voxel, probing just below when the sweep didn't touch down
+    bVoxelGrounded = Result.bHitFloor && Result.bWalkableFloor;
+    if (!Result.bHitFloor && Velocity.Z <= 0.0f)
+    {
+        const FVoxelSweepResult Probe = FVoxelCollisionQuery::SweepCapsule(World, Result.Location, Radius, HalfHeight, FVector(0.0f, 0.0f, -2.0f), bBlockOnUnloadedTerrain);
+        bVoxelGrounded = Probe.bHitFloor && Probe.bWalkableFloor;
+    }
+}
+
+AVoxelWorld* UVoxelCharacterMovementComponent::ResolveVoxelWorld()
+{
+    if (!VoxelWorld)
+    {
+        if (UWorld* World = GetWorld())
+        {
+            TActorIterator<AVoxelWorld> It(World);
+            if (It)
+            {
+                VoxelWorld = *It;
+            }
+        }
+    }
+
+    return VoxelWorld;
+}
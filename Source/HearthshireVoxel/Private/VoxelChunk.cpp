@@ -4,15 +4,20 @@
 #include "ProceduralMeshComponent.h"
 #include "Engine/World.h"
 #include "GameFramework/PlayerController.h"
-#include "DrawDebugHelpers.h"
 #include "Async/Async.h"
 #include "Logging/LogMacros.h"
 #include "HearthshireVoxelModule.h"
 #include "VoxelMeshGenerator.h"
 #include "VoxelGreedyMesher.h"
+#include "VoxelChunkKernels.h"
 #include "VoxelWorld.h"
+#include "VoxelTrace.h"
+#include "VoxelPerformanceStats.h"
 #include "Math/UnrealMathUtility.h"
 #include "KismetProceduralMeshLibrary.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "PhysicsEngine/BodySetup.h"
 
 // VoxelChunkComponent Implementation
 
@@ -24,7 +29,10 @@ UVoxelChunkComponent::UVoxelChunkComponent()
     CurrentLOD = EVoxelChunkLOD::LOD0; // Default to LOD0 for editor visibility
     MaterialSet = nullptr;
     OwnerWorld = nullptr;
+    MaterialVolumeTexture = nullptr;
+    VolumeMaterialInstance = nullptr;
     bIsGeneratingMesh = false;
+    StreamingRequestTime = 0.0;
     WorldPosition = FVector::ZeroVector;
     bHasBeenGenerated = false;
     
@@ -34,6 +42,7 @@ UVoxelChunkComponent::UVoxelChunkComponent()
     ChunkData.bIsDirty = true;
     
     // Pre-allocate voxel array with default size
+    VOXEL_LLM_SCOPE(Data);
     const int32 VoxelCount = ChunkData.ChunkSize.GetVoxelCount();
     ChunkData.Voxels.SetNum(VoxelCount);
     
@@ -75,7 +84,7 @@ void UVoxelChunkComponent::BeginPlay()
     }
     
     // Ensure chunk is initialized with proper defaults if not already done
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("Chunk data not initialized in BeginPlay, initializing with defaults"));
         Initialize(FIntVector::ZeroValue, FVoxelChunkSize(32));
@@ -98,20 +107,12 @@ void UVoxelChunkComponent::TickComponent(float DeltaTime, ELevelTick TickType, F
 
 int32 UVoxelChunkComponent::GetVoxelCount() const
 {
-    int32 Count = 0;
-    for (const FVoxel& Voxel : ChunkData.Voxels)
-    {
-        if (!Voxel.IsAir())
-        {
-            Count++;
-        }
-    }
-    return Count;
+    return VoxelChunkKernels::CountSolidVoxels(ChunkData);
 }
 
 FBox UVoxelChunkComponent::GetWorldBounds() const
 {
-    const FVector ChunkWorldPos = FVector(ChunkData.ChunkPosition) * ChunkData.ChunkSize.X * VoxelSize;
+    const FVector ChunkWorldPos = FVector(ChunkData.ChunkPosition) * FVector(ChunkData.ChunkSize.ToIntVector()) * VoxelSize;
     const FVector ChunkWorldSize = FVector(ChunkData.ChunkSize.ToIntVector()) * VoxelSize;
     return FBox(ChunkWorldPos, ChunkWorldPos + ChunkWorldSize);
 }
@@ -138,18 +139,19 @@ void UVoxelChunkComponent::SetVoxelRange(const FIntVector& Min, const FIntVector
         FMath::Min(ChunkData.ChunkSize.Z - 1, Max.Z)
     );
     
+    bool bChanged = false;
     for (int32 Z = ClampedMin.Z; Z <= ClampedMax.Z; Z++)
     {
         for (int32 Y = ClampedMin.Y; Y <= ClampedMax.Y; Y++)
         {
             for (int32 X = ClampedMin.X; X <= ClampedMax.X; X++)
             {
-                ChunkData.SetVoxel(X, Y, Z, FVoxel(Material));
+                bChanged |= WriteVoxel(X, Y, Z, Material);
             }
         }
     }
     
-    if (ChunkData.bIsDirty)
+    if (bChanged)
     {
         OnChunkUpdated.Broadcast(this);
     }
@@ -161,9 +163,18 @@ void UVoxelChunkComponent::Initialize(const FIntVector& InChunkPosition, const F
     ChunkData.ChunkSize = InChunkSize;
     ChunkData.bIsDirty = true;
     
+    // Pooled components come back with the previous chunk's edit time
+    LastEditTime = 0.0;
+    
     // Allocate voxel data
-    const int32 VoxelCount = InChunkSize.GetVoxelCount();
-    ChunkData.Voxels.SetNum(VoxelCount);
+    {
+        VOXEL_LLM_SCOPE(Data);
+        ChunkData.Columns.Reset();
+        ChunkData.Voxels.SetNum(InChunkSize.GetVoxelCount());
+        ChunkData.Channels.Reset();
+        ChunkData.Refinement.Reset();
+        ChunkData.BlockEntities.Reset();
+    }
     
     // Calculate world position
     WorldPosition = FVector(
@@ -210,18 +221,100 @@ void UVoxelChunkComponent::Initialize(const FIntVector& InChunkPosition, const F
 
 void UVoxelChunkComponent::SetVoxel(int32 X, int32 Y, int32 Z, EVoxelMaterial Material)
 {
-    EVoxelMaterial OldMaterial = ChunkData.GetVoxel(X, Y, Z).Material;
+    WriteVoxel(X, Y, Z, Material);
+    
+    if (ChunkState == EVoxelChunkState::Ready)
+    {
+        OnChunkUpdated.Broadcast(this);
+    }
+}
+
+bool UVoxelChunkComponent::WriteVoxel(int32 X, int32 Y, int32 Z, EVoxelMaterial Material)
+{
+    const EVoxelMaterial OldMaterial = ChunkData.GetVoxel(X, Y, Z).Material;
     ChunkData.SetVoxel(X, Y, Z, FVoxel(Material));
     
-    if (OldMaterial != Material)
+    // Read back - out of range and refined-marker writes are dropped by the chunk data
+    const EVoxelMaterial NewMaterial = ChunkData.GetVoxel(X, Y, Z).Material;
+    if (NewMaterial == OldMaterial)
+    {
+        return false;
+    }
+    
+    LastEditTime = FPlatformTime::Seconds();
+    OnVoxelChanged.Broadcast(FIntVector(X, Y, Z), NewMaterial);
+    
+    if (OwnerWorld)
+    {
+        OwnerWorld->OnVoxelEditedNative.Broadcast(ChunkData.ChunkPosition, FIntVector(X, Y, Z), NewMaterial);
+    }
+    return true;
+}
+
+void UVoxelChunkComponent::NotifyVoxelsReplaced()
+{
+    LastEditTime = FPlatformTime::Seconds();
+    
+    if (ChunkState == EVoxelChunkState::Ready)
+    {
+        OnChunkUpdated.Broadcast(this);
+    }
+    
+    if (OwnerWorld)
+    {
+        OwnerWorld->OnChunkReplacedNative.Broadcast(ChunkData.ChunkPosition);
+    }
+}
+
+bool UVoxelChunkComponent::RefineVoxel(int32 X, int32 Y, int32 Z, int32 Resolution)
+{
+    const EVoxelMaterial OldMaterial = ChunkData.GetVoxel(X, Y, Z).Material;
+    if (!ChunkData.RefineVoxel(X, Y, Z, Resolution))
+    {
+        return false;
+    }
+    
+    if (OldMaterial != EVoxelMaterial::Refined)
+    {
+        LastEditTime = FPlatformTime::Seconds();
+        OnVoxelChanged.Broadcast(FIntVector(X, Y, Z), EVoxelMaterial::Refined);
+        
+        if (OwnerWorld)
+        {
+            OwnerWorld->OnVoxelEditedNative.Broadcast(ChunkData.ChunkPosition, FIntVector(X, Y, Z), EVoxelMaterial::Refined);
+        }
+        
+        if (ChunkState == EVoxelChunkState::Ready)
+        {
+            OnChunkUpdated.Broadcast(this);
+        }
+    }
+    return true;
+}
+
+bool UVoxelChunkComponent::SetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel, EVoxelMaterial Material)
+{
+    if (!ChunkData.SetSubVoxel(X, Y, Z, SubVoxel, Material))
+    {
+        return false;
+    }
+    
+    LastEditTime = FPlatformTime::Seconds();
+    
+    // Refined for a sub-voxel change, or the whole-voxel material the cell folded back into
+    const EVoxelMaterial NewMaterial = ChunkData.GetVoxel(X, Y, Z).Material;
+    OnVoxelChanged.Broadcast(FIntVector(X, Y, Z), NewMaterial);
+    
+    if (OwnerWorld)
     {
-        OnVoxelChanged.Broadcast(FIntVector(X, Y, Z), Material);
+        OwnerWorld->OnVoxelEditedNative.Broadcast(ChunkData.ChunkPosition, FIntVector(X, Y, Z), NewMaterial);
     }
     
     if (ChunkState == EVoxelChunkState::Ready)
     {
         OnChunkUpdated.Broadcast(this);
     }
+    return true;
 }
 
 EVoxelMaterial UVoxelChunkComponent::GetVoxel(int32 X, int32 Y, int32 Z) const
@@ -237,13 +330,14 @@ void UVoxelChunkComponent::SetVoxelBatch(const TArray<FIntVector>& Positions, co
         return;
     }
     
+    bool bChanged = false;
     for (int32 i = 0; i < Positions.Num(); i++)
     {
         const FIntVector& Pos = Positions[i];
-        ChunkData.SetVoxel(Pos.X, Pos.Y, Pos.Z, FVoxel(Materials[i]));
+        bChanged |= WriteVoxel(Pos.X, Pos.Y, Pos.Z, Materials[i]);
     }
     
-    if (ChunkState == EVoxelChunkState::Ready)
+    if (bChanged && ChunkState == EVoxelChunkState::Ready)
     {
         OnChunkUpdated.Broadcast(this);
     }
@@ -252,7 +346,7 @@ void UVoxelChunkComponent::SetVoxelBatch(const TArray<FIntVector>& Positions, co
 void UVoxelChunkComponent::SetChunkData(const FVoxelChunkData& NewChunkData)
 {
     // Validate input data
-    if (NewChunkData.Voxels.Num() != NewChunkData.ChunkSize.GetVoxelCount())
+    if (!NewChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Error, TEXT("SetChunkData: Invalid voxel data size. Expected %d, got %d"),
             NewChunkData.ChunkSize.GetVoxelCount(), NewChunkData.Voxels.Num());
@@ -260,7 +354,10 @@ void UVoxelChunkComponent::SetChunkData(const FVoxelChunkData& NewChunkData)
     }
     
     // Store the new chunk data
-    ChunkData = NewChunkData;
+    {
+        VOXEL_LLM_SCOPE(Data);
+        ChunkData = NewChunkData;
+    }
     
     // Mark as generated since we're setting data manually
     bHasBeenGenerated = true;
@@ -284,7 +381,7 @@ void UVoxelChunkComponent::SetChunkData(const FVoxelChunkData& NewChunkData)
     ChunkState = EVoxelChunkState::Generated;
     
     UE_LOG(LogHearthshireVoxel, Log, TEXT("SetChunkData: Loaded chunk data at position %s with %d voxels"),
-        *ChunkData.ChunkPosition.ToString(), ChunkData.Voxels.Num());
+        *ChunkData.ChunkPosition.ToString(), ChunkData.ChunkSize.GetVoxelCount());
 }
 
 void UVoxelChunkComponent::GenerateMesh(bool bAsync)
@@ -298,8 +395,8 @@ void UVoxelChunkComponent::GenerateMesh(bool bAsync)
         return;
     }
     
-    // Skip if already has mesh and marked as generated
-    if (bHasBeenGenerated && ChunkState == EVoxelChunkState::Ready && MeshData.VertexCount > 0)
+    // Skip if already has an up-to-date mesh and marked as generated
+    if (bHasBeenGenerated && ChunkState == EVoxelChunkState::Ready && MeshData.VertexCount > 0 && !ChunkData.bIsDirty)
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("Chunk %s already has generated mesh with %d vertices, skipping regeneration"), 
             *ChunkData.ChunkPosition.ToString(), MeshData.VertexCount);
@@ -307,7 +404,7 @@ void UVoxelChunkComponent::GenerateMesh(bool bAsync)
     }
     
     // Validate chunk data
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Error, TEXT("GenerateMesh: Chunk data not initialized!"));
         return;
@@ -324,7 +421,11 @@ void UVoxelChunkComponent::GenerateMesh(bool bAsync)
     }
     else
     {
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::MeshStarted, ChunkData.ChunkPosition, CurrentLOD);
+        const double MeshStartTime = FPlatformTime::Seconds();
+        
         // Generate mesh based on current LOD
+        VOXEL_LLM_SCOPE(MeshCPU);
         switch (CurrentLOD)
         {
             case EVoxelChunkLOD::LOD0:
@@ -349,10 +450,31 @@ void UVoxelChunkComponent::GenerateMesh(bool bAsync)
                 break;
         }
         
+        const double MeshTimeMs = (FPlatformTime::Seconds() - MeshStartTime) * 1000.0;
+        FVoxelPerformanceMonitor::Get().RecordLatency(EVoxelLatencyStage::Mesh, MeshTimeMs);
+        FVoxelPerformanceMonitor::Get().RecordMeshGeneration(MeshTimeMs, MeshData.Triangles.Num() / 3, MeshData.Vertices.Num());
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::MeshFinished, ChunkData.ChunkPosition, CurrentLOD);
         ApplyMeshData();
     }
 }
 
+void UVoxelChunkComponent::ApplyPrebuiltMesh(const FVoxelMeshData& InMeshData, EVoxelChunkLOD LOD, bool bWasGenerated)
+{
+    if (bIsGeneratingMesh || !ChunkData.HasVoxelData())
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("ApplyPrebuiltMesh: Chunk %s can't take a prebuilt mesh right now"), *ChunkData.ChunkPosition.ToString());
+        return;
+    }
+    
+    {
+        VOXEL_LLM_SCOPE(MeshCPU);
+        MeshData = InMeshData;
+    }
+    CurrentLOD = LOD == EVoxelChunkLOD::Unloaded ? EVoxelChunkLOD::LOD0 : LOD;
+    bHasBeenGenerated = bWasGenerated;
+    ApplyMeshData();
+}
+
 void UVoxelChunkComponent::ClearMesh()
 {
     if (ProceduralMesh)
@@ -383,6 +505,35 @@ void UVoxelChunkComponent::SetLOD(EVoxelChunkLOD NewLOD)
     }
 }
 
+const FVoxelMaterialTraitTable& UVoxelChunkComponent::GetMaterialTraits() const
+{
+    const UVoxelMaterialSet* ActiveMaterialSet = MaterialSet ? MaterialSet : ConfiguredMaterialSet;
+    return ActiveMaterialSet ? ActiveMaterialSet->GetTraitTable() : FVoxelMaterialTraitTable::GetDefault();
+}
+
+bool UVoxelChunkComponent::ShouldMergeAcrossMaterials()
+{
+    if (!bMergeAcrossMaterials)
+    {
+        return false;
+    }
+    
+    const UVoxelMaterialSet* ActiveMaterialSet = MaterialSet ? MaterialSet : ConfiguredMaterialSet;
+    if (ActiveMaterialSet && ActiveMaterialSet->VolumeMaterial)
+    {
+        return true;
+    }
+    
+    // Merged quads only carry one material each, so without the volume they would shade wrong - mesh per material instead
+    if (!bWarnedMissingVolumeMaterial)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("Chunk %s: Merge Across Materials needs a material set with a VolumeMaterial, meshing per material"),
+            *ChunkData.ChunkPosition.ToString());
+        bWarnedMissingVolumeMaterial = true;
+    }
+    return false;
+}
+
 void UVoxelChunkComponent::GenerateMeshAsync()
 {
     if (bIsGeneratingMesh)
@@ -396,9 +547,19 @@ void UVoxelChunkComponent::GenerateMeshAsync()
     // Capture chunk data for async operation
     FVoxelChunkData AsyncChunkData = ChunkData;
     EVoxelChunkLOD AsyncLOD = CurrentLOD;
+    const bool bAsyncMergeAcrossMaterials = ShouldMergeAcrossMaterials();
+    
+    // Copied so an edit to the material set mid-job cannot change the table under the worker
+    const FVoxelMaterialTraitTable AsyncTraits = GetMaterialTraits();
     
-    Async(EAsyncExecution::ThreadPool, [this, AsyncChunkData, AsyncLOD]()
+    Async(EAsyncExecution::ThreadPool, [this, AsyncChunkData, AsyncLOD, bAsyncMergeAcrossMaterials, AsyncTraits]()
     {
+        VOXEL_TRACE_SCOPE(Voxel_MeshChunkAsync);
+        VOXEL_LLM_SCOPE(Scratch);
+        FVoxelTrace::MeshWorkerStarted();
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::MeshStarted, AsyncChunkData.ChunkPosition, AsyncLOD);
+        const double MeshStartTime = FPlatformTime::Seconds();
+        
         FVoxelMeshData AsyncMeshData;
         
         // Generate mesh based on LOD
@@ -407,6 +568,8 @@ void UVoxelChunkComponent::GenerateMeshAsync()
         Config.bGenerateCollision = (AsyncLOD == EVoxelChunkLOD::LOD0 || AsyncLOD == EVoxelChunkLOD::LOD1);
         Config.bGenerateTangents = true;
         Config.bOptimizeIndices = true;
+        Config.bMergeAcrossMaterials = bAsyncMergeAcrossMaterials;
+        Config.MaterialTraits = &AsyncTraits;
         
         switch (AsyncLOD)
         {
@@ -425,10 +588,19 @@ void UVoxelChunkComponent::GenerateMeshAsync()
                 break;
         }
         
+        const double MeshTimeMs = (FPlatformTime::Seconds() - MeshStartTime) * 1000.0;
+        FVoxelPerformanceMonitor::Get().RecordLatency(EVoxelLatencyStage::Mesh, MeshTimeMs);
+        FVoxelPerformanceMonitor::Get().RecordMeshGeneration(MeshTimeMs, AsyncMeshData.Triangles.Num() / 3, AsyncMeshData.Vertices.Num());
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::MeshFinished, AsyncChunkData.ChunkPosition, AsyncLOD);
+        FVoxelTrace::MeshWorkerFinished();
+        
         // Return to game thread
         AsyncTask(ENamedThreads::GameThread, [this, AsyncMeshData]()
         {
-            MeshData = AsyncMeshData;
+            {
+                VOXEL_LLM_SCOPE(MeshCPU);
+                MeshData = AsyncMeshData;
+            }
             ApplyMeshData();
             bIsGeneratingMesh = false;
         });
@@ -437,11 +609,17 @@ void UVoxelChunkComponent::GenerateMeshAsync()
 
 void UVoxelChunkComponent::ApplyMeshData()
 {
+    VOXEL_TRACE_SCOPE(Voxel_ApplyMeshData);
+    
+    const double ApplyStartTime = FPlatformTime::Seconds();
+    
     if (!ProceduralMesh)
     {
         UE_LOG(LogHearthshireVoxel, Error, TEXT("ApplyMeshData: No ProceduralMesh component!"));
         ChunkState = EVoxelChunkState::Ready;
         ChunkData.bIsDirty = false;
+        RecordApplyLatency(ApplyStartTime);
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::Applied, ChunkData.ChunkPosition, CurrentLOD);
         OnChunkGenerated.Broadcast(this);
         OnGenerationCompleted.Broadcast(LastGenerationTimeMs);
         return;
@@ -503,16 +681,86 @@ void UVoxelChunkComponent::ApplyMeshData()
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("ApplyMeshData: No material set configured, mesh may not be visible!"));
     }
     
-    FVoxelMeshGenerator::ApplyMeshToComponent(ProceduralMesh, MeshData, ActiveMaterialSet);
+    // Sections copy the buffers on the CPU - GetMemoryUsage counts those copies as MeshCPU too
+    {
+        VOXEL_LLM_SCOPE(MeshCPU);
+        FVoxelMeshGenerator::ApplyMeshToComponent(ProceduralMesh, MeshData, ActiveMaterialSet);
+    }
+    {
+        VOXEL_LLM_SCOPE(MeshGPU);
+        ApplyMaterialVolume(ActiveMaterialSet);
+    }
     
     // Update performance stats
     UpdatePerformanceStats();
     
     ChunkState = EVoxelChunkState::Ready;
     ChunkData.bIsDirty = false;
+    RecordApplyLatency(ApplyStartTime);
+    FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::Applied, ChunkData.ChunkPosition, CurrentLOD);
     OnChunkGenerated.Broadcast(this);
     OnGenerationCompleted.Broadcast(LastGenerationTimeMs);
+}
+
+void UVoxelChunkComponent::RecordApplyLatency(double ApplyStartTime)
+{
+    FVoxelPerformanceMonitor& Monitor = FVoxelPerformanceMonitor::Get();
+    const double Now = FPlatformTime::Seconds();
+    
+    Monitor.RecordLatency(EVoxelLatencyStage::Apply, (Now - ApplyStartTime) * 1000.0);
+    
+    // Edits and LOD swaps re-apply without a streaming request
+    if (StreamingRequestTime > 0.0)
+    {
+        Monitor.RecordLatency(EVoxelLatencyStage::RequestToVisible, (Now - StreamingRequestTime) * 1000.0);
+        StreamingRequestTime = 0.0;
+    }
+}
+
+void UVoxelChunkComponent::ApplyMaterialVolume(UVoxelMaterialSet* ActiveMaterialSet)
+{
+    VOXEL_TRACE_SCOPE(Voxel_ApplyMaterialVolume);
+    
+    const FVoxelMaterialVolume& Volume = MeshData.MaterialVolume;
+    if (!Volume.IsValid() || !ActiveMaterialSet || !ActiveMaterialSet->VolumeMaterial)
+    {
+        return;
+    }
+    
+    // Reuse the texture while the atlas size is unchanged
+    if (!MaterialVolumeTexture || MaterialVolumeTexture->GetSizeX() != Volume.AtlasWidth || MaterialVolumeTexture->GetSizeY() != Volume.AtlasHeight)
+    {
+        MaterialVolumeTexture = UTexture2D::CreateTransient(Volume.AtlasWidth, Volume.AtlasHeight, PF_G8);
+        if (!MaterialVolumeTexture)
+        {
+            UE_LOG(LogHearthshireVoxel, Error, TEXT("ApplyMaterialVolume: Failed to create %dx%d volume texture"), Volume.AtlasWidth, Volume.AtlasHeight);
+            return;
+        }
+        
+        MaterialVolumeTexture->Filter = TF_Nearest;
+        MaterialVolumeTexture->SRGB = false;
+        MaterialVolumeTexture->AddressX = TA_Clamp;
+        MaterialVolumeTexture->AddressY = TA_Clamp;
+    }
+    
+    FTexture2DMipMap& Mip = MaterialVolumeTexture->GetPlatformData()->Mips[0];
+    void* TexelData = Mip.BulkData.Lock(LOCK_READ_WRITE);
+    FMemory::Memcpy(TexelData, Volume.Texels.GetData(), Volume.Texels.Num());
+    Mip.BulkData.Unlock();
+    MaterialVolumeTexture->UpdateResource();
+    
+    if (!VolumeMaterialInstance || VolumeMaterialInstance->Parent != ActiveMaterialSet->VolumeMaterial)
+    {
+        VolumeMaterialInstance = UMaterialInstanceDynamic::Create(ActiveMaterialSet->VolumeMaterial, this);
+    }
     
+    VolumeMaterialInstance->SetTextureParameterValue(TEXT("VoxelMaterialVolume"), MaterialVolumeTexture);
+    VolumeMaterialInstance->SetTextureParameterValue(TEXT("VoxelMaterialPalette"), ActiveMaterialSet->GetPaletteTexture());
+    VolumeMaterialInstance->SetVectorParameterValue(TEXT("VoxelVolumeLayout"),
+        FLinearColor(Volume.Dimensions.X, Volume.Dimensions.Y, Volume.Dimensions.Z, Volume.TilesPerRow));
+    VolumeMaterialInstance->SetScalarParameterValue(TEXT("VoxelSize"), Volume.VoxelSize);
+    
+    ProceduralMesh->SetMaterial(0, VolumeMaterialInstance);
 }
 
 void UVoxelChunkComponent::GenerateLOD0Mesh()
@@ -528,6 +776,8 @@ void UVoxelChunkComponent::GenerateLOD0Mesh()
     Config.bGenerateCollision = bGenerateCollision;
     Config.bGenerateTangents = true;
     Config.bOptimizeIndices = true;
+    Config.bMergeAcrossMaterials = ShouldMergeAcrossMaterials();
+    Config.MaterialTraits = &GetMaterialTraits();
     
     if (bEnableGreedyMeshing)
     {
@@ -550,68 +800,20 @@ void UVoxelChunkComponent::GenerateLOD1Mesh()
 {
     // LOD1: Downsample to 50cm voxels (2x2x2 blocks)
     const int32 BlockSize = 2;
-    const FVoxelChunkSize& OriginalSize = ChunkData.ChunkSize;
-    const int32 LODSizeX = OriginalSize.X / BlockSize;
-    const int32 LODSizeY = OriginalSize.Y / BlockSize;
-    const int32 LODSizeZ = OriginalSize.Z / BlockSize;
     
-    // Create temporary downsampled voxel data
     TArray<EVoxelMaterial> LODVoxels;
-    LODVoxels.SetNum(LODSizeX * LODSizeY * LODSizeZ);
-    
-    // Downsample voxels by taking the most common material in each 2x2x2 block
-    for (int32 LODz = 0; LODz < LODSizeZ; LODz++)
-    {
-        for (int32 LODy = 0; LODy < LODSizeY; LODy++)
-        {
-            for (int32 LODx = 0; LODx < LODSizeX; LODx++)
-            {
-                // Sample the 2x2x2 block
-                TMap<EVoxelMaterial, int32> MaterialCounts;
-                
-                for (int32 bz = 0; bz < BlockSize; bz++)
-                {
-                    for (int32 by = 0; by < BlockSize; by++)
-                    {
-                        for (int32 bx = 0; bx < BlockSize; bx++)
-                        {
-                            int32 OrigX = LODx * BlockSize + bx;
-                            int32 OrigY = LODy * BlockSize + by;
-                            int32 OrigZ = LODz * BlockSize + bz;
-                            
-                            if (OrigX < OriginalSize.X && OrigY < OriginalSize.Y && OrigZ < OriginalSize.Z)
-                            {
-                                EVoxelMaterial Mat = GetVoxel(OrigX, OrigY, OrigZ);
-                                MaterialCounts.FindOrAdd(Mat)++;
-                            }
-                        }
-                    }
-                }
-                
-                // Find the most common material
-                EVoxelMaterial MostCommon = EVoxelMaterial::Air;
-                int32 MaxCount = 0;
-                for (const auto& Pair : MaterialCounts)
-                {
-                    if (Pair.Value > MaxCount && Pair.Key != EVoxelMaterial::Air)
-                    {
-                        MaxCount = Pair.Value;
-                        MostCommon = Pair.Key;
-                    }
-                }
-                
-                LODVoxels[LODx + LODy * LODSizeX + LODz * LODSizeX * LODSizeY] = MostCommon;
-            }
-        }
-    }
+    FVoxelChunkSize LODSize;
+    FVoxelMeshGenerator::DownsampleVoxels(ChunkData, BlockSize, LODVoxels, LODSize);
     
     // Generate mesh using greedy mesher with LOD data
     FVoxelMeshData LODMeshData;
     FVoxelGreedyMesher::GenerateGreedyMeshFromData(
         LODVoxels,
-        FVoxelChunkSize(LODSizeX, LODSizeY, LODSizeZ),
+        LODSize,
         VoxelSize * BlockSize, // Double the voxel size
-        LODMeshData
+        LODMeshData,
+        &GetMaterialTraits(),
+        ShouldMergeAcrossMaterials()
     );
     
     // Apply the mesh
@@ -623,68 +825,20 @@ void UVoxelChunkComponent::GenerateLOD2Mesh()
 {
     // LOD2: Downsample to 1m voxels (4x4x4 blocks)
     const int32 BlockSize = 4;
-    const FVoxelChunkSize& OriginalSize = ChunkData.ChunkSize;
-    const int32 LODSizeX = OriginalSize.X / BlockSize;
-    const int32 LODSizeY = OriginalSize.Y / BlockSize;
-    const int32 LODSizeZ = OriginalSize.Z / BlockSize;
     
-    // Create temporary downsampled voxel data
     TArray<EVoxelMaterial> LODVoxels;
-    LODVoxels.SetNum(LODSizeX * LODSizeY * LODSizeZ);
-    
-    // Downsample voxels by taking the most common material in each 4x4x4 block
-    for (int32 LODz = 0; LODz < LODSizeZ; LODz++)
-    {
-        for (int32 LODy = 0; LODy < LODSizeY; LODy++)
-        {
-            for (int32 LODx = 0; LODx < LODSizeX; LODx++)
-            {
-                // Sample the 4x4x4 block
-                TMap<EVoxelMaterial, int32> MaterialCounts;
-                
-                for (int32 bz = 0; bz < BlockSize; bz++)
-                {
-                    for (int32 by = 0; by < BlockSize; by++)
-                    {
-                        for (int32 bx = 0; bx < BlockSize; bx++)
-                        {
-                            int32 OrigX = LODx * BlockSize + bx;
-                            int32 OrigY = LODy * BlockSize + by;
-                            int32 OrigZ = LODz * BlockSize + bz;
-                            
-                            if (OrigX < OriginalSize.X && OrigY < OriginalSize.Y && OrigZ < OriginalSize.Z)
-                            {
-                                EVoxelMaterial Mat = GetVoxel(OrigX, OrigY, OrigZ);
-                                MaterialCounts.FindOrAdd(Mat)++;
-                            }
-                        }
-                    }
-                }
-                
-                // Find the most common material
-                EVoxelMaterial MostCommon = EVoxelMaterial::Air;
-                int32 MaxCount = 0;
-                for (const auto& Pair : MaterialCounts)
-                {
-                    if (Pair.Value > MaxCount && Pair.Key != EVoxelMaterial::Air)
-                    {
-                        MaxCount = Pair.Value;
-                        MostCommon = Pair.Key;
-                    }
-                }
-                
-                LODVoxels[LODx + LODy * LODSizeX + LODz * LODSizeX * LODSizeY] = MostCommon;
-            }
-        }
-    }
+    FVoxelChunkSize LODSize;
+    FVoxelMeshGenerator::DownsampleVoxels(ChunkData, BlockSize, LODVoxels, LODSize);
     
     // Generate mesh using greedy mesher with LOD data
     FVoxelMeshData LODMeshData;
     FVoxelGreedyMesher::GenerateGreedyMeshFromData(
         LODVoxels,
-        FVoxelChunkSize(LODSizeX, LODSizeY, LODSizeZ),
+        LODSize,
         VoxelSize * BlockSize, // 4x the voxel size
-        LODMeshData
+        LODMeshData,
+        &GetMaterialTraits(),
+        ShouldMergeAcrossMaterials()
     );
     
     // Apply the mesh
@@ -861,11 +1015,12 @@ void UVoxelChunkComponent::GenerateFlatTerrain(int32 GroundLevel, EVoxelMaterial
                     Material = GroundMaterial;
                 }
                 
-                SetVoxel(X, Y, Z, Material);
+                SetGeneratedVoxel(X, Y, Z, Material);
             }
         }
     }
     
+    NotifyVoxelsReplaced();
     GenerateMesh(bEnableAsyncGeneration);
 }
 
@@ -905,11 +1060,12 @@ void UVoxelChunkComponent::GeneratePerlinTerrain(float NoiseScale, float HeightS
                     Material = EVoxelMaterial::Grass;
                 }
                 
-                SetVoxel(X, Y, Z, Material);
+                SetGeneratedVoxel(X, Y, Z, Material);
             }
         }
     }
     
+    NotifyVoxelsReplaced();
     GenerateMesh(bEnableAsyncGeneration);
 }
 
@@ -919,17 +1075,7 @@ void UVoxelChunkComponent::GenerateCaveSystem(float CaveFrequency, float CaveSiz
     const FIntVector& ChunkPos = ChunkData.ChunkPosition;
     
     // First, check if chunk has any solid voxels
-    bool bHasSolids = false;
-    for (const FVoxel& Voxel : ChunkData.Voxels)
-    {
-        if (Voxel.IsSolid())
-        {
-            bHasSolids = true;
-            break;
-        }
-    }
-    
-    if (!bHasSolids)
+    if (VoxelChunkKernels::CountSolidVoxels(ChunkData) == 0)
     {
         return; // No point carving caves in air
     }
@@ -949,12 +1095,13 @@ void UVoxelChunkComponent::GenerateCaveSystem(float CaveFrequency, float CaveSiz
                 
                 if (NoiseValue > CaveSize)
                 {
-                    SetVoxel(X, Y, Z, EVoxelMaterial::Air);
+                    SetGeneratedVoxel(X, Y, Z, EVoxelMaterial::Air);
                 }
             }
         }
     }
     
+    NotifyVoxelsReplaced();
     GenerateMesh(bEnableAsyncGeneration);
 }
 
@@ -1161,7 +1308,7 @@ void UVoxelChunkComponent::RegenerateInEditor()
     UE_LOG(LogHearthshireVoxel, Log, TEXT("RegenerateInEditor called"));
     
     // Ensure chunk is initialized
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("RegenerateInEditor: Chunk not initialized, initializing with defaults"));
         Initialize(FIntVector::ZeroValue, FVoxelChunkSize(32));
@@ -1188,7 +1335,7 @@ void UVoxelChunkComponent::GenerateCheckerboardPattern()
     UE_LOG(LogHearthshireVoxel, Log, TEXT("GenerateCheckerboardPattern called"));
     
     // Ensure chunk is initialized
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("GenerateCheckerboardPattern: Chunk not initialized, initializing with defaults"));
         Initialize(FIntVector::ZeroValue, FVoxelChunkSize(32));
@@ -1247,11 +1394,12 @@ void UVoxelChunkComponent::GenerateCheckerboardPattern()
             {
                 bool bIsSolid = ((X + Y + Z) % 2) == 0;
                 EVoxelMaterial Material = bIsSolid ? EVoxelMaterial::Stone : EVoxelMaterial::Air;
-                SetVoxel(X, Y, Z, Material);
+                SetGeneratedVoxel(X, Y, Z, Material);
                 if (bIsSolid) SolidCount++;
             }
         }
     }
+    NotifyVoxelsReplaced();
     
     UE_LOG(LogHearthshireVoxel, Log, TEXT("GenerateCheckerboardPattern: Set %d solid voxels, generating mesh..."), SolidCount);
     GenerateMesh(false);
@@ -1262,7 +1410,7 @@ void UVoxelChunkComponent::GenerateSpherePattern()
     UE_LOG(LogHearthshireVoxel, Log, TEXT("GenerateSpherePattern called"));
     
     // Ensure chunk is initialized
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("GenerateSpherePattern: Chunk not initialized, initializing with defaults"));
         Initialize(FIntVector::ZeroValue, FVoxelChunkSize(32));
@@ -1325,7 +1473,7 @@ void UVoxelChunkComponent::FillSolid(EVoxelMaterial Material)
     UE_LOG(LogHearthshireVoxel, Log, TEXT("FillSolid called with material %d"), (int32)Material);
     
     // Ensure chunk is initialized
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("FillSolid: Chunk not initialized, initializing with defaults"));
         Initialize(FIntVector::ZeroValue, FVoxelChunkSize(32));
@@ -1381,10 +1529,11 @@ void UVoxelChunkComponent::FillSolid(EVoxelMaterial Material)
         {
             for (int32 X = 0; X < Size.X; X++)
             {
-                SetVoxel(X, Y, Z, Material);
+                SetGeneratedVoxel(X, Y, Z, Material);
             }
         }
     }
+    NotifyVoxelsReplaced();
     
     UE_LOG(LogHearthshireVoxel, Log, TEXT("FillSolid: Voxels set, generating mesh..."));
     GenerateMesh(false);
@@ -1395,7 +1544,7 @@ void UVoxelChunkComponent::ClearChunk()
     UE_LOG(LogHearthshireVoxel, Log, TEXT("ClearChunk called"));
     
     // Ensure chunk is initialized
-    if (ChunkData.Voxels.Num() == 0)
+    if (!ChunkData.HasVoxelData())
     {
         UE_LOG(LogHearthshireVoxel, Warning, TEXT("ClearChunk: Chunk not initialized, initializing with defaults"));
         Initialize(FIntVector::ZeroValue, FVoxelChunkSize(32));
@@ -1411,10 +1560,11 @@ void UVoxelChunkComponent::ClearChunk()
         {
             for (int32 X = 0; X < Size.X; X++)
             {
-                SetVoxel(X, Y, Z, EVoxelMaterial::Air);
+                SetGeneratedVoxel(X, Y, Z, EVoxelMaterial::Air);
             }
         }
     }
+    NotifyVoxelsReplaced();
     
     ClearMesh();
     UE_LOG(LogHearthshireVoxel, Log, TEXT("ClearChunk: Chunk cleared"));
@@ -1437,20 +1587,43 @@ float UVoxelChunkComponent::GetTriangleReductionPercentage() const
 
 float UVoxelChunkComponent::GetMemoryUsageEstimate() const
 {
-    // Estimate memory usage
-    float MemoryMB = 0.0f;
+    return GetMemoryUsage().GetTotal() / (1024.0f * 1024.0f);
+}
+
+FVoxelMemoryUsage UVoxelChunkComponent::GetMemoryUsage() const
+{
+    FVoxelMemoryUsage Usage;
+    Usage.VoxelData = ChunkData.Voxels.GetAllocatedSize() + ChunkData.Columns.GetAllocatedSize() +
+        ChunkData.Channels.GetAllocatedSize() + ChunkData.Refinement.GetAllocatedSize() +
+        ChunkData.BlockEntities.GetAllocatedSize();
+    Usage.MeshCPU = MeshData.GetAllocatedSize();
     
-    // Voxel data
-    MemoryMB += (ChunkData.Voxels.Num() * sizeof(FVoxel)) / (1024.0f * 1024.0f);
+    if (ProceduralMesh)
+    {
+        for (int32 SectionIndex = 0; SectionIndex < ProceduralMesh->GetNumSections(); SectionIndex++)
+        {
+            if (const FProcMeshSection* Section = ProceduralMesh->GetProcMeshSection(SectionIndex))
+            {
+                Usage.MeshCPU += Section->ProcVertexBuffer.GetAllocatedSize() + Section->ProcIndexBuffer.GetAllocatedSize();
+                
+                // Position, packed tangent basis, one UV channel and color per vertex, 32-bit indices
+                const int64 GPUVertexSize = sizeof(FVector3f) + 2 * sizeof(FPackedNormal) + sizeof(FVector2f) + sizeof(FColor);
+                Usage.MeshGPU += Section->ProcVertexBuffer.Num() * GPUVertexSize + Section->ProcIndexBuffer.Num() * sizeof(uint32);
+            }
+        }
+        
+        if (ProceduralMesh->ProcMeshBodySetup)
+        {
+            Usage.Collision = ProceduralMesh->ProcMeshBodySetup->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+        }
+    }
     
-    // Mesh data
-    MemoryMB += (MeshData.Vertices.Num() * sizeof(FVector)) / (1024.0f * 1024.0f);
-    MemoryMB += (MeshData.Triangles.Num() * sizeof(int32)) / (1024.0f * 1024.0f);
-    MemoryMB += (MeshData.Normals.Num() * sizeof(FVector)) / (1024.0f * 1024.0f);
-    MemoryMB += (MeshData.UV0.Num() * sizeof(FVector2D)) / (1024.0f * 1024.0f);
-    MemoryMB += (MeshData.Tangents.Num() * sizeof(FProcMeshTangent)) / (1024.0f * 1024.0f);
+    if (MaterialVolumeTexture)
+    {
+        Usage.MaterialVolume = MaterialVolumeTexture->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+    }
     
-    return MemoryMB;
+    return Usage;
 }
 
 bool UVoxelChunkComponent::IsVoxelSolid(int32 X, int32 Y, int32 Z) const
@@ -1575,12 +1748,6 @@ void AVoxelChunk::Tick(float DeltaTime)
         UpdateLODBasedOnDistance();
         LastLODUpdateTime = CurrentTime;
     }
-    
-    // Debug rendering
-    if (bShowDebugInfo || bShowChunkBounds || bShowVoxelGrid)
-    {
-        DrawDebugInfo();
-    }
 }
 
 void AVoxelChunk::InitializeChunk(const FIntVector& ChunkPosition, const FVoxelChunkSize& ChunkSize, AVoxelWorld* World)
@@ -1591,6 +1758,7 @@ void AVoxelChunk::InitializeChunk(const FIntVector& ChunkPosition, const FVoxelC
     if (ChunkComponent)
     {
         ChunkComponent->Initialize(ChunkPosition, ChunkSize);
+        ChunkComponent->SetOwnerWorld(World);
         
         // Pass material set from world to chunk
         if (World && World->Config.MaterialSet)
@@ -1628,7 +1796,13 @@ float AVoxelChunk::GetDistanceToPlayer() const
         return FLT_MAX;
     }
     
-    return FVector::Dist(GetActorLocation(), CachedPlayerPawn->GetActorLocation());
+    // Vertically, measure to the nearest point of the chunk so the top of a tall column chunk counts as near
+    const FVector ChunkLocation = GetActorLocation();
+    const FVector PlayerLocation = CachedPlayerPawn->GetActorLocation();
+    const float ChunkHeight = ChunkComponent ? ChunkComponent->GetChunkSize().Z * UVoxelChunkComponent::VoxelSize : 0.0f;
+    const float NearestZ = FMath::Clamp(PlayerLocation.Z, ChunkLocation.Z, ChunkLocation.Z + ChunkHeight);
+    
+    return FVector::Dist(FVector(ChunkLocation.X, ChunkLocation.Y, NearestZ), PlayerLocation);
 }
 
 bool AVoxelChunk::ShouldBeLoaded(float MaxDistance) const
@@ -1659,10 +1833,11 @@ void AVoxelChunk::FillWithTestPattern()
             {
                 bool bIsSolid = ((X + Y + Z) % 2) == 0;
                 EVoxelMaterial Material = bIsSolid ? EVoxelMaterial::Stone : EVoxelMaterial::Air;
-                ChunkComponent->SetVoxel(X, Y, Z, Material);
+                ChunkComponent->SetGeneratedVoxel(X, Y, Z, Material);
             }
         }
     }
+    ChunkComponent->NotifyVoxelsReplaced();
     
     ChunkComponent->GenerateMesh(false);
 }
@@ -1682,10 +1857,11 @@ void AVoxelChunk::ClearAllVoxels()
         {
             for (int32 X = 0; X < ChunkSize.X; X++)
             {
-                ChunkComponent->SetVoxel(X, Y, Z, EVoxelMaterial::Air);
+                ChunkComponent->SetGeneratedVoxel(X, Y, Z, EVoxelMaterial::Air);
             }
         }
     }
+    ChunkComponent->NotifyVoxelsReplaced();
     
     ChunkComponent->ClearMesh();
 }
@@ -1698,75 +1874,6 @@ void AVoxelChunk::ForceRegenerateMesh()
     }
 }
 
-void AVoxelChunk::DrawDebugInfo() const
-{
-    if (!ChunkComponent)
-    {
-        return;
-    }
-    
-    const FVector ChunkWorldPos = GetActorLocation();
-    const FVoxelChunkSize ChunkSize = ChunkComponent->GetChunkSize();
-    const FVector ChunkExtent = FVector(ChunkSize.X, ChunkSize.Y, ChunkSize.Z) * UVoxelChunkComponent::VoxelSize * 0.5f;
-    
-    // Draw chunk bounds
-    if (bShowChunkBounds)
-    {
-        DrawDebugBox(GetWorld(), ChunkWorldPos + ChunkExtent, ChunkExtent, FColor::Green, false, -1.0f, 0, 2.0f);
-    }
-    
-    // Draw debug info
-    if (bShowDebugInfo)
-    {
-        const FString InfoText = FString::Printf(
-            TEXT("Chunk: %s\nLOD: %d\nState: %d\nDistance: %.1fm"),
-            *ChunkComponent->GetChunkPosition().ToString(),
-            (int32)ChunkComponent->GetCurrentLOD(),
-            (int32)ChunkComponent->GetState(),
-            GetDistanceToPlayer() / 100.0f
-        );
-        
-        DrawDebugString(GetWorld(), ChunkWorldPos + FVector(0, 0, ChunkExtent.Z * 2.0f), InfoText, nullptr, FColor::White, 0.0f, true);
-    }
-    
-    // Draw voxel grid (expensive - use sparingly)
-    if (bShowVoxelGrid && ChunkComponent->GetCurrentLOD() == EVoxelChunkLOD::LOD0)
-    {
-        // Use configured step size
-        const int32 Step = FMath::Max(1, GridDisplayStep);
-        
-        for (int32 X = 0; X < ChunkSize.X; X += Step)
-        {
-            for (int32 Y = 0; Y < ChunkSize.Y; Y += Step)
-            {
-                for (int32 Z = 0; Z < ChunkSize.Z; Z += Step)
-                {
-                    if (ChunkComponent->GetVoxel(X, Y, Z) != EVoxelMaterial::Air)
-                    {
-                        const FVector VoxelPos = ChunkWorldPos + FVector(X, Y, Z) * ChunkComponent->ConfigurableVoxelSize;
-                        DrawDebugPoint(GetWorld(), VoxelPos, 5.0f, ChunkComponent->DebugDrawColor.ToFColor(true), false, -1.0f);
-                    }
-                }
-            }
-        }
-    }
-    
-    // Draw performance stats if enabled
-    if (bShowPerformanceStats && ChunkComponent)
-    {
-        const FString PerfText = FString::Printf(
-            TEXT("Verts: %d\nTris: %d\nGen Time: %.2fms\nMemory: %.2fMB\nReduction: %.1f%%"),
-            ChunkComponent->RuntimeVertexCount,
-            ChunkComponent->RuntimeTriangleCount,
-            ChunkComponent->LastGenerationTimeMs,
-            ChunkComponent->MemoryUsageMB,
-            ChunkComponent->TriangleReductionPercentage
-        );
-        
-        DrawDebugString(GetWorld(), ChunkWorldPos + FVector(0, 0, -20.0f), PerfText, nullptr, FColor::Yellow, 0.0f, true);
-    }
-}
-
 void AVoxelChunk::UpdateLODBasedOnDistance()
 {
     if (!ChunkComponent || !OwnerWorld)
@@ -1774,7 +1881,8 @@ void AVoxelChunk::UpdateLODBasedOnDistance()
         return;
     }
     
-    const float Distance = GetDistanceToPlayer();
+    // Bands shrink when the quality governor lowers the scale
+    const float Distance = GetDistanceToPlayer() / OwnerWorld->GetLODDistanceScale();
     
     // Determine appropriate LOD based on distance
     EVoxelChunkLOD TargetLOD = EVoxelChunkLOD::Unloaded;
@@ -0,0 +1,576 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelCollision.h"
+#include "VoxelWorld.h"
+#include "VoxelChunk.h"
+
+namespace VoxelCollision
+{
+    /** Shape description shared by box and capsule sweeps */
+    struct FSweepShape
+    {
+        // Axis-aligned bounds of the shape
+        FVector HalfExtent;
+
+        // Capsule radius and half length of its core segment along Z
+        float Radius;
+        float CoreHalfHeight;
+        bool bIsCapsule;
+    };
+
+    /** Occupancy lookups with a one-chunk cache - sweeps touch the same chunk repeatedly */
+    struct FOccupancySampler
+    {
+        const AVoxelWorld* World;
+        FIntVector ChunkSize;
+        bool bUnloadedIsSolid;
+        const FVoxelMaterialTraits* Traits;
+
+        FIntVector CachedChunkPosition;
+        const FVoxelChunkData* CachedChunkData;
+        bool bHasCachedChunk;
+
+        FOccupancySampler(const AVoxelWorld* InWorld, bool bInUnloadedIsSolid)
+            : World(InWorld)
+            , ChunkSize(FMath::Max(1, InWorld->Config.ChunkSize), FMath::Max(1, InWorld->Config.ChunkSize), FMath::Max(1, InWorld->Config.GetChunkDimensions().Z))
+            , bUnloadedIsSolid(bInUnloadedIsSolid)
+            , Traits((InWorld->Config.MaterialSet ? InWorld->Config.MaterialSet->GetTraitTable() : FVoxelMaterialTraitTable::GetDefault()).GetData())
+            , CachedChunkPosition(FIntVector::ZeroValue)
+            , CachedChunkData(nullptr)
+            , bHasCachedChunk(false)
+        {
+        }
+
+        static FORCEINLINE int32 FloorDiv(int32 Value, int32 Divisor)
+        {
+            return Value >= 0 ? Value / Divisor : ((Value + 1) / Divisor) - 1;
+        }
+
+        // Traits of the voxel's material, null when its chunk is not loaded. Refined voxels also report their sub-grid
+        const FVoxelMaterialTraits* GetTraits(const FIntVector& GlobalVoxel, const FVoxelRefinedCell** OutRefinedCell = nullptr)
+        {
+            const FIntVector ChunkPosition(
+                FloorDiv(GlobalVoxel.X, ChunkSize.X),
+                FloorDiv(GlobalVoxel.Y, ChunkSize.Y),
+                FloorDiv(GlobalVoxel.Z, ChunkSize.Z));
+
+            if (!bHasCachedChunk || ChunkPosition != CachedChunkPosition)
+            {
+                const AVoxelChunk* Chunk = World->GetChunkAtPosition(ChunkPosition);
+                CachedChunkData = (Chunk && Chunk->ChunkComponent) ? &Chunk->ChunkComponent->GetChunkData() : nullptr;
+                CachedChunkPosition = ChunkPosition;
+                bHasCachedChunk = true;
+            }
+
+            if (OutRefinedCell)
+            {
+                *OutRefinedCell = nullptr;
+            }
+
+            if (!CachedChunkData)
+            {
+                return nullptr;
+            }
+
+            const FIntVector Local = GlobalVoxel - FIntVector(ChunkPosition.X * ChunkSize.X, ChunkPosition.Y * ChunkSize.Y, ChunkPosition.Z * ChunkSize.Z);
+            const EVoxelMaterial Material = CachedChunkData->GetVoxel(Local.X, Local.Y, Local.Z).Material;
+            if (OutRefinedCell && Material == EVoxelMaterial::Refined)
+            {
+                *OutRefinedCell = CachedChunkData->FindRefinedCell(Local.X, Local.Y, Local.Z);
+            }
+            return &Traits[(uint8)Material];
+        }
+
+        // Palette check - a cell with no collidable material needs no per-sub-voxel tests
+        bool HasCollidableSubVoxel(const FVoxelRefinedCell& Cell) const
+        {
+            for (int32 PaletteIndex = 0; PaletteIndex < Cell.Palette.Num(); PaletteIndex++)
+            {
+                if (Cell.PaletteCounts[PaletteIndex] > 0 && Traits[(uint8)Cell.Palette[PaletteIndex]].bCollidable)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Refined voxels count as solid when any of their sub-voxels collide
+        bool IsSolid(const FIntVector& GlobalVoxel)
+        {
+            const FVoxelRefinedCell* RefinedCell = nullptr;
+            const FVoxelMaterialTraits* VoxelTraits = GetTraits(GlobalVoxel, &RefinedCell);
+            if (RefinedCell)
+            {
+                return HasCollidableSubVoxel(*RefinedCell);
+            }
+            return VoxelTraits ? (bool)VoxelTraits->bCollidable : bUnloadedIsSolid;
+        }
+    };
+
+    /** Calls Visit(SubMin, SubMax, Traits) for every collidable sub-voxel of a refined cell */
+    template<typename VisitorType>
+    static void ForEachCollidableSubVoxel(const FVoxelRefinedCell& Cell, const FVoxelMaterialTraits* Traits, const FVector& CellMin, float VoxelSize, VisitorType&& Visit)
+    {
+        const int32 R = Cell.Resolution;
+        const float SubSize = VoxelSize / R;
+
+        for (int32 SZ = 0; SZ < R; SZ++)
+        {
+            for (int32 SY = 0; SY < R; SY++)
+            {
+                for (int32 SX = 0; SX < R; SX++)
+                {
+                    const FVoxelMaterialTraits& SubTraits = Traits[(uint8)Cell.Get(Cell.GetSubIndex(SX, SY, SZ))];
+                    if (!SubTraits.bCollidable)
+                    {
+                        continue;
+                    }
+
+                    const FVector SubMin = CellMin + FVector(SX, SY, SZ) * SubSize;
+                    Visit(SubMin, SubMin + FVector(SubSize), SubTraits);
+                }
+            }
+        }
+    }
+
+    /**
+     * Visits the cells of a grid crossed by a ray in order, starting with the one holding Start.
+     * Visit(Cell, EntryDistance, EntryNormal) returns true to stop.
+     */
+    template<typename VisitorType>
+    static void TraverseGrid(const FVector& Start, const FVector& Direction, float Length, float CellSize, VisitorType&& Visit)
+    {
+        FIntVector Cell(
+            FMath::FloorToInt(Start.X / CellSize),
+            FMath::FloorToInt(Start.Y / CellSize),
+            FMath::FloorToInt(Start.Z / CellSize));
+
+        FIntVector Step;
+        FVector NextBoundary;
+        FVector BoundaryStep;
+        for (int32 Axis = 0; Axis < 3; Axis++)
+        {
+            if (FMath::IsNearlyZero(Direction[Axis]))
+            {
+                Step[Axis] = 0;
+                NextBoundary[Axis] = UE_BIG_NUMBER;
+                BoundaryStep[Axis] = UE_BIG_NUMBER;
+                continue;
+            }
+
+            Step[Axis] = Direction[Axis] > 0.0f ? 1 : -1;
+            const float Boundary = (Cell[Axis] + (Step[Axis] > 0 ? 1 : 0)) * CellSize;
+            NextBoundary[Axis] = (Boundary - Start[Axis]) / Direction[Axis];
+            BoundaryStep[Axis] = CellSize / FMath::Abs(Direction[Axis]);
+        }
+
+        float Distance = 0.0f;
+        FVector Normal = FVector::ZeroVector;
+        while (Distance <= Length)
+        {
+            if (Visit(Cell, Distance, Normal))
+            {
+                return;
+            }
+
+            const int32 Axis = NextBoundary.X < NextBoundary.Y
+                ? (NextBoundary.X < NextBoundary.Z ? 0 : 2)
+                : (NextBoundary.Y < NextBoundary.Z ? 1 : 2);
+
+            Distance = NextBoundary[Axis];
+            NextBoundary[Axis] += BoundaryStep[Axis];
+            Cell[Axis] += Step[Axis];
+            Normal = FVector::ZeroVector;
+            Normal[Axis] = -Step[Axis];
+        }
+    }
+
+    /** Distance the shape can travel along Axis before touching the given cell; negative when already touching */
+    static float ContactDistance(const FSweepShape& Shape, const FVector& Center, int32 Axis, float Direction, const FVector& CellMin, const FVector& CellMax, bool& bOutTouches)
+    {
+        bOutTouches = true;
+
+        if (!Shape.bIsCapsule)
+        {
+            return Direction > 0.0f
+                ? CellMin[Axis] - (Center[Axis] + Shape.HalfExtent[Axis])
+                : (Center[Axis] - Shape.HalfExtent[Axis]) - CellMax[Axis];
+        }
+
+        // Capsule core is a Z segment; distance to a cell is measured from that segment
+        FVector CoreMin = Center;
+        FVector CoreMax = Center;
+        CoreMin.Z -= Shape.CoreHalfHeight;
+        CoreMax.Z += Shape.CoreHalfHeight;
+
+        float OtherDistanceSq = 0.0f;
+        for (int32 OtherAxis = 0; OtherAxis < 3; OtherAxis++)
+        {
+            if (OtherAxis == Axis)
+            {
+                continue;
+            }
+
+            const float Gap = FMath::Max3(0.0f, CellMin[OtherAxis] - CoreMax[OtherAxis], CoreMin[OtherAxis] - CellMax[OtherAxis]);
+            OtherDistanceSq += Gap * Gap;
+        }
+
+        const float RadiusSq = Shape.Radius * Shape.Radius;
+        if (OtherDistanceSq >= RadiusSq)
+        {
+            // Passes beside the cell without ever touching it
+            bOutTouches = false;
+            return 0.0f;
+        }
+
+        const float Reach = FMath::Sqrt(RadiusSq - OtherDistanceSq);
+        return Direction > 0.0f
+            ? CellMin[Axis] - (CoreMax[Axis] + Reach)
+            : (CoreMin[Axis] - Reach) - CellMax[Axis];
+    }
+
+    /** Sweep along one axis; returns the movement that can be applied */
+    static float SweepAxis(FOccupancySampler& Sampler, const FSweepShape& Shape, const FVector& Center, int32 Axis, float Delta, FIntVector& OutHitVoxel, bool& bOutHit, bool& bOutHitWalkable)
+    {
+        bOutHit = false;
+        bOutHitWalkable = false;
+        if (FMath::IsNearlyZero(Delta))
+        {
+            return 0.0f;
+        }
+
+        const float VoxelSize = UVoxelChunkComponent::VoxelSize;
+        const float Offset = FVoxelCollisionQuery::ContactOffset;
+        const int32 AxisU = (Axis + 1) % 3;
+        const int32 AxisV = (Axis + 2) % 3;
+        const float Direction = Delta > 0.0f ? 1.0f : -1.0f;
+
+        const FVector Min = Center - Shape.HalfExtent;
+        const FVector Max = Center + Shape.HalfExtent;
+
+        // Cross-section shrunk by the contact offset so resting contact doesn't block sliding
+        const int32 MinU = FMath::FloorToInt((Min[AxisU] + Offset) / VoxelSize);
+        const int32 MaxU = FMath::FloorToInt((Max[AxisU] - Offset) / VoxelSize);
+        const int32 MinV = FMath::FloorToInt((Min[AxisV] + Offset) / VoxelSize);
+        const int32 MaxV = FMath::FloorToInt((Max[AxisV] - Offset) / VoxelSize);
+
+        // Layers from the ones the bounds already overlap up to the swept leading face
+        const float Leading = Direction > 0.0f ? Max[Axis] : Min[Axis];
+        const int32 FirstLayer = Direction > 0.0f
+            ? FMath::FloorToInt((Min[Axis] + Offset) / VoxelSize)
+            : FMath::FloorToInt((Max[Axis] - Offset) / VoxelSize);
+        const int32 LastLayer = Direction > 0.0f
+            ? FMath::CeilToInt((Leading + Delta) / VoxelSize) - 1
+            : FMath::FloorToInt((Leading + Delta) / VoxelSize);
+        const int32 Step = Direction > 0.0f ? 1 : -1;
+
+        float Allowed = FMath::Abs(Delta);
+
+        for (int32 Layer = FirstLayer; Direction > 0.0f ? Layer <= LastLayer : Layer >= LastLayer; Layer += Step)
+        {
+            // Nothing in this or later layers can be closer than the bounds' gap to it
+            const float LayerGap = Direction > 0.0f ? Layer * VoxelSize - Max[Axis] : Min[Axis] - (Layer + 1) * VoxelSize;
+            if (LayerGap > Allowed)
+            {
+                break;
+            }
+
+            for (int32 U = MinU; U <= MaxU; U++)
+            {
+                for (int32 V = MinV; V <= MaxV; V++)
+                {
+                    FIntVector Cell;
+                    Cell[Axis] = Layer;
+                    Cell[AxisU] = U;
+                    Cell[AxisV] = V;
+
+                    // Boxes only clamp against what their cross-section covers; capsules check that in ContactDistance
+                    auto ConsiderBox = [&](const FVector& BoxMin, const FVector& BoxMax, bool bWalkable)
+                    {
+                        if (!Shape.bIsCapsule &&
+                            (BoxMax[AxisU] <= Min[AxisU] + Offset || BoxMin[AxisU] >= Max[AxisU] - Offset ||
+                             BoxMax[AxisV] <= Min[AxisV] + Offset || BoxMin[AxisV] >= Max[AxisV] - Offset))
+                        {
+                            return;
+                        }
+
+                        bool bTouches = false;
+                        const float Distance = ContactDistance(Shape, Center, Axis, Direction, BoxMin, BoxMax, bTouches);
+
+                        // Cells already penetrated are ignored so shapes can always move out
+                        if (!bTouches || Distance < -Offset)
+                        {
+                            return;
+                        }
+
+                        const float CellAllowed = FMath::Max(0.0f, Distance - Offset);
+                        if (CellAllowed < Allowed)
+                        {
+                            Allowed = CellAllowed;
+                            OutHitVoxel = Cell;
+                            bOutHit = true;
+                            bOutHitWalkable = bWalkable;
+                        }
+                    };
+
+                    const FVector CellMin = FVector(Cell) * VoxelSize;
+
+                    const FVoxelRefinedCell* RefinedCell = nullptr;
+                    const FVoxelMaterialTraits* CellTraits = Sampler.GetTraits(Cell, &RefinedCell);
+                    if (RefinedCell)
+                    {
+                        if (Sampler.HasCollidableSubVoxel(*RefinedCell))
+                        {
+                            ForEachCollidableSubVoxel(*RefinedCell, Sampler.Traits, CellMin, VoxelSize,
+                                [&](const FVector& SubMin, const FVector& SubMax, const FVoxelMaterialTraits& SubTraits)
+                                {
+                                    ConsiderBox(SubMin, SubMax, SubTraits.bWalkable);
+                                });
+                        }
+                    }
+                    else if (CellTraits ? (bool)CellTraits->bCollidable : Sampler.bUnloadedIsSolid)
+                    {
+                        // Unloaded terrain that blocks also counts as ground
+                        ConsiderBox(CellMin, CellMin + FVector(VoxelSize), CellTraits ? (bool)CellTraits->bWalkable : true);
+                    }
+                }
+            }
+        }
+
+        return Allowed * Direction;
+    }
+
+    static FVoxelSweepResult SweepShape(const AVoxelWorld* World, const FSweepShape& Shape, const FVector& Center, const FVector& Delta, bool bUnloadedIsSolid)
+    {
+        FVoxelSweepResult Result;
+        Result.Location = Center;
+
+        if (!World)
+        {
+            Result.Location += Delta;
+            Result.AppliedDelta = Delta;
+            return Result;
+        }
+
+        FOccupancySampler Sampler(World, bUnloadedIsSolid);
+
+        // Vertical first so landing resolves before sliding
+        static const int32 AxisOrder[3] = { 2, 0, 1 };
+
+        for (int32 Axis : AxisOrder)
+        {
+            bool bHit = false;
+            bool bHitWalkable = false;
+            FIntVector HitVoxel;
+            const float Moved = SweepAxis(Sampler, Shape, Result.Location, Axis, Delta[Axis], HitVoxel, bHit, bHitWalkable);
+
+            Result.Location[Axis] += Moved;
+            Result.AppliedDelta[Axis] = Moved;
+
+            if (bHit)
+            {
+                if (!Result.bBlockingHit)
+                {
+                    Result.ImpactNormal = FVector::ZeroVector;
+                    Result.ImpactNormal[Axis] = Delta[Axis] > 0.0f ? -1.0f : 1.0f;
+                    Result.HitVoxel = HitVoxel;
+                }
+
+                Result.bBlockingHit = true;
+
+                if (Axis == 2)
+                {
+                    Result.bHitFloor = Delta.Z < 0.0f;
+                    Result.bWalkableFloor = Result.bHitFloor && bHitWalkable;
+                    Result.bHitCeiling = Delta.Z > 0.0f;
+                }
+            }
+        }
+
+        return Result;
+    }
+}
+
+bool FVoxelCollisionQuery::IsCollidableMaterial(EVoxelMaterial Material)
+{
+    return FVoxelMaterialTraitTable::GetDefault()[Material].bCollidable;
+}
+
+FIntVector FVoxelCollisionQuery::WorldToGlobalVoxel(const AVoxelWorld* World, const FVector& WorldPosition)
+{
+    const float VoxelSize = UVoxelChunkComponent::VoxelSize;
+    return FIntVector(
+        FMath::FloorToInt(WorldPosition.X / VoxelSize),
+        FMath::FloorToInt(WorldPosition.Y / VoxelSize),
+        FMath::FloorToInt(WorldPosition.Z / VoxelSize)
+    );
+}
+
+bool FVoxelCollisionQuery::IsVoxelSolid(const AVoxelWorld* World, const FIntVector& GlobalVoxel, bool bUnloadedIsSolid)
+{
+    if (!World)
+    {
+        return false;
+    }
+
+    VoxelCollision::FOccupancySampler Sampler(World, bUnloadedIsSolid);
+    return Sampler.IsSolid(GlobalVoxel);
+}
+
+bool FVoxelCollisionQuery::OverlapBox(const AVoxelWorld* World, const FBox& Box, bool bUnloadedIsSolid)
+{
+    if (!World || !Box.IsValid)
+    {
+        return false;
+    }
+
+    const float VoxelSize = UVoxelChunkComponent::VoxelSize;
+    const FIntVector MinVoxel = WorldToGlobalVoxel(World, Box.Min + FVector(ContactOffset));
+    const FIntVector MaxVoxel = WorldToGlobalVoxel(World, Box.Max - FVector(ContactOffset));
+
+    const FBox TestBox(Box.Min + FVector(ContactOffset), Box.Max - FVector(ContactOffset));
+
+    VoxelCollision::FOccupancySampler Sampler(World, bUnloadedIsSolid);
+
+    for (int32 Z = MinVoxel.Z; Z <= MaxVoxel.Z; Z++)
+    {
+        for (int32 Y = MinVoxel.Y; Y <= MaxVoxel.Y; Y++)
+        {
+            for (int32 X = MinVoxel.X; X <= MaxVoxel.X; X++)
+            {
+                const FIntVector Cell(X, Y, Z);
+                const FVoxelRefinedCell* RefinedCell = nullptr;
+                const FVoxelMaterialTraits* CellTraits = Sampler.GetTraits(Cell, &RefinedCell);
+
+                if (!RefinedCell)
+                {
+                    if (CellTraits ? (bool)CellTraits->bCollidable : bUnloadedIsSolid)
+                    {
+                        return true;
+                    }
+                    continue;
+                }
+
+                // Refined voxels only overlap where a collidable sub-voxel does
+                bool bOverlaps = false;
+                if (Sampler.HasCollidableSubVoxel(*RefinedCell))
+                {
+                    VoxelCollision::ForEachCollidableSubVoxel(*RefinedCell, Sampler.Traits, FVector(Cell) * VoxelSize, VoxelSize,
+                        [&](const FVector& SubMin, const FVector& SubMax, const FVoxelMaterialTraits&)
+                        {
+                            bOverlaps |= TestBox.Intersect(FBox(SubMin, SubMax));
+                        });
+                }
+                if (bOverlaps)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+FVoxelRaycastResult FVoxelCollisionQuery::Raycast(const AVoxelWorld* World, const FVector& Start, const FVector& End, bool bUnloadedIsSolid)
+{
+    FVoxelRaycastResult Result;
+
+    const FVector Segment = End - Start;
+    const float Length = Segment.Size();
+    if (!World || Length <= KINDA_SMALL_NUMBER)
+    {
+        return Result;
+    }
+
+    const float VoxelSize = UVoxelChunkComponent::VoxelSize;
+    const FVector Direction = Segment / Length;
+
+    VoxelCollision::FOccupancySampler Sampler(World, bUnloadedIsSolid);
+
+    VoxelCollision::TraverseGrid(Start, Direction, Length, VoxelSize, [&](const FIntVector& Cell, float EntryDistance, const FVector& EntryNormal)
+    {
+        const FVoxelRefinedCell* RefinedCell = nullptr;
+        const FVoxelMaterialTraits* CellTraits = Sampler.GetTraits(Cell, &RefinedCell);
+
+        if (!RefinedCell)
+        {
+            if (!(CellTraits ? (bool)CellTraits->bCollidable : bUnloadedIsSolid))
+            {
+                return false;
+            }
+
+            Result.bHit = true;
+            Result.Distance = EntryDistance;
+            Result.ImpactNormal = EntryNormal;
+            Result.HitVoxel = Cell;
+            // Traits point into the 256-entry table, so their offset is the material
+            Result.Material = CellTraits ? (EVoxelMaterial)(CellTraits - Sampler.Traits) : EVoxelMaterial::Air;
+            return true;
+        }
+
+        if (!Sampler.HasCollidableSubVoxel(*RefinedCell))
+        {
+            return false;
+        }
+
+        // Continue inside the cell's sub-grid, from where the ray entered it
+        const int32 R = RefinedCell->Resolution;
+        const FVector CellMin = FVector(Cell) * VoxelSize;
+        const FVector LocalStart = ClampVector(Start + Direction * EntryDistance - CellMin, FVector::ZeroVector, FVector(VoxelSize - KINDA_SMALL_NUMBER));
+
+        bool bSubHit = false;
+        VoxelCollision::TraverseGrid(LocalStart, Direction, Length - EntryDistance, VoxelSize / R, [&](const FIntVector& SubVoxel, float SubDistance, const FVector& SubNormal)
+        {
+            if (SubVoxel.X < 0 || SubVoxel.X >= R || SubVoxel.Y < 0 || SubVoxel.Y >= R || SubVoxel.Z < 0 || SubVoxel.Z >= R)
+            {
+                return true;
+            }
+
+            const EVoxelMaterial SubMaterial = RefinedCell->Get(RefinedCell->GetSubIndex(SubVoxel.X, SubVoxel.Y, SubVoxel.Z));
+            if (!Sampler.Traits[(uint8)SubMaterial].bCollidable)
+            {
+                return false;
+            }
+
+            bSubHit = true;
+            Result.bHit = true;
+            Result.Distance = EntryDistance + SubDistance;
+            Result.ImpactNormal = SubDistance > 0.0f ? SubNormal : EntryNormal;
+            Result.HitVoxel = Cell;
+            Result.HitSubVoxel = SubVoxel;
+            Result.Material = SubMaterial;
+            return true;
+        });
+
+        return bSubHit;
+    });
+
+    if (Result.bHit)
+    {
+        Result.Location = Start + Direction * Result.Distance;
+    }
+    return Result;
+}
+
+FVoxelSweepResult FVoxelCollisionQuery::SweepBox(const AVoxelWorld* World, const FVector& Center, const FVector& HalfExtent, const FVector& Delta, bool bUnloadedIsSolid)
+{
+    VoxelCollision::FSweepShape Shape;
+    Shape.HalfExtent = HalfExtent;
+    Shape.Radius = 0.0f;
+    Shape.CoreHalfHeight = 0.0f;
+    Shape.bIsCapsule = false;
+
+    return VoxelCollision::SweepShape(World, Shape, Center, Delta, bUnloadedIsSolid);
+}
+
+FVoxelSweepResult FVoxelCollisionQuery::SweepCapsule(const AVoxelWorld* World, const FVector& Center, float Radius, float HalfHeight, const FVector& Delta, bool bUnloadedIsSolid)
+{
+    VoxelCollision::FSweepShape Shape;
+    Shape.Radius = FMath::Max(0.0f, Radius);
+    Shape.CoreHalfHeight = FMath::Max(0.0f, HalfHeight - Shape.Radius);
+    Shape.HalfExtent = FVector(Shape.Radius, Shape.Radius, Shape.CoreHalfHeight + Shape.Radius);
+    Shape.bIsCapsule = true;
+
+    return VoxelCollision::SweepShape(World, Shape, Center, Delta, bUnloadedIsSolid);
+}
@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelColumns.h"
+#include "VoxelTypes.h"
+
+int32 FVoxelColumnChunk::GetColumnTop(int32 X, int32 Y) const
+{
+    const TConstArrayView<FVoxelColumnSpan> Column = GetColumn(X, Y);
+    int32 SpanEnd = Size.Z;
+    for (int32 SpanIndex = Column.Num() - 1; SpanIndex >= 0; SpanIndex--)
+    {
+        if (Column[SpanIndex].Material != EVoxelMaterial::Air)
+        {
+            return SpanEnd - 1;
+        }
+        SpanEnd -= Column[SpanIndex].Length;
+    }
+    return INDEX_NONE;
+}
+
+int32 FVoxelColumnChunk::GetColumnBottom(int32 X, int32 Y) const
+{
+    int32 SpanStart = 0;
+    for (const FVoxelColumnSpan& Span : GetColumn(X, Y))
+    {
+        if (Span.Material != EVoxelMaterial::Air)
+        {
+            return SpanStart;
+        }
+        SpanStart += Span.Length;
+    }
+    return INDEX_NONE;
+}
+
+bool FVoxelColumnChunk::Build(const FIntVector& InSize, TConstArrayView<FVoxel> Voxels, int32 MaxSpansPerColumn)
+{
+    Reset();
+
+    const int32 ColumnCount = InSize.X * InSize.Y;
+    if (ColumnCount <= 0 || InSize.Z <= 0 || Voxels.Num() != ColumnCount * InSize.Z || MaxSpansPerColumn <= 0)
+    {
+        return false;
+    }
+
+    Size = InSize;
+    ColumnStarts.SetNumUninitialized(ColumnCount + 1);
+    Spans.Reserve(ColumnCount * FMath::Min(MaxSpansPerColumn, 4));
+
+    bool bColumnsAlike = true;
+    for (int32 Column = 0; Column < ColumnCount; Column++)
+    {
+        const int32 Start = Spans.Num();
+        if (Start > MAX_uint16)
+        {
+            Reset();
+            return false;
+        }
+        ColumnStarts[Column] = (uint16)Start;
+
+        // One layer apart in the dense array
+        for (int32 Z = 0; Z < Size.Z; Z++)
+        {
+            const EVoxelMaterial Material = Voxels[Column + Z * ColumnCount].Material;
+            if (Spans.Num() > Start && Spans.Last().Material == Material && Spans.Last().Length < MAX_uint8)
+            {
+                Spans.Last().Length++;
+                continue;
+            }
+
+            // Caves and overhangs gain little - leave them dense
+            if (Spans.Num() - Start >= MaxSpansPerColumn)
+            {
+                Reset();
+                return false;
+            }
+            Spans.Add({ Material, 1 });
+        }
+
+        const int32 Length = Spans.Num() - Start;
+        bColumnsAlike = bColumnsAlike && (Column == 0 || (Length == ColumnStarts[1] &&
+            FMemory::Memcmp(Spans.GetData() + Start, Spans.GetData(), Length * sizeof(FVoxelColumnSpan)) == 0));
+    }
+
+    if (Spans.Num() > MAX_uint16)
+    {
+        Reset();
+        return false;
+    }
+    ColumnStarts[ColumnCount] = (uint16)Spans.Num();
+
+    // Uniform chunks keep one column and no index
+    if (bColumnsAlike)
+    {
+        Spans.SetNum(ColumnStarts[1]);
+        ColumnStarts.Empty();
+    }
+    Spans.Shrink();
+    return true;
+}
+
+void FVoxelColumnChunk::ToDense(TArray<FVoxel>& OutVoxels) const
+{
+    const int32 ColumnCount = Size.X * Size.Y;
+    OutVoxels.SetNumUninitialized(ColumnCount * Size.Z);
+    if (IsEmpty())
+    {
+        return;
+    }
+
+    FVoxel* Voxels = OutVoxels.GetData();
+    for (int32 Y = 0; Y < Size.Y; Y++)
+    {
+        for (int32 X = 0; X < Size.X; X++)
+        {
+            FVoxel* ColumnVoxel = Voxels + X + Y * Size.X;
+            for (const FVoxelColumnSpan& Span : GetColumn(X, Y))
+            {
+                for (int32 Step = 0; Step < Span.Length; Step++)
+                {
+                    *ColumnVoxel = FVoxel(Span.Material);
+                    ColumnVoxel += ColumnCount;
+                }
+            }
+        }
+    }
+}
+
+int32 FVoxelColumnChunk::CountSolidVoxels() const
+{
+    int32 Count = 0;
+    for (const FVoxelColumnSpan& Span : Spans)
+    {
+        Count += Span.Material != EVoxelMaterial::Air ? Span.Length : 0;
+    }
+    return ColumnStarts.Num() == 0 ? Count * Size.X * Size.Y : Count;
+}
+
+void FVoxelColumnChunk::Reset()
+{
+    Size = FIntVector::ZeroValue;
+    Spans.Empty();
+    ColumnStarts.Empty();
+}
+
+int64 FVoxelColumnChunk::GetAllocatedSize() const
+{
+    return Spans.GetAllocatedSize() + ColumnStarts.GetAllocatedSize();
+}
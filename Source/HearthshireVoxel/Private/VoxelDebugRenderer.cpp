@@ -0,0 +1,291 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelDebugRenderer.h"
+#include "VoxelWorld.h"
+#include "VoxelChunk.h"
+#include "VoxelTrace.h"
+#include "Components/LineBatchComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarVoxelDebugHeatmap(
+    TEXT("voxel.debug.heatmap"),
+    0,
+    TEXT("Colour every voxel chunk's bounds by a cost metric.\n")
+    TEXT("0: off, 1: mesh time, 2: triangle count, 3: queue wait, 4: memory, 5: LOD, 6: last edit age"),
+    ECVF_Cheat);
+
+namespace VoxelDebugRenderer
+{
+    // Edits older than this are drawn fully cold
+    constexpr float EditAgeRangeSeconds = 60.0f;
+
+    constexpr float BoundsThickness = 2.0f;
+    constexpr float GridPointSize = 5.0f;
+
+    void AddBoxLines(const FBox& Box, const FLinearColor& Color, float Thickness, float LifeTime, TArray<FBatchedLine>& OutLines)
+    {
+        const FVector& Min = Box.Min;
+        const FVector& Max = Box.Max;
+        const FVector Corners[8] = {
+            FVector(Min.X, Min.Y, Min.Z), FVector(Max.X, Min.Y, Min.Z), FVector(Max.X, Max.Y, Min.Z), FVector(Min.X, Max.Y, Min.Z),
+            FVector(Min.X, Min.Y, Max.Z), FVector(Max.X, Min.Y, Max.Z), FVector(Max.X, Max.Y, Max.Z), FVector(Min.X, Max.Y, Max.Z)
+        };
+
+        // Bottom ring, top ring, verticals
+        for (int32 i = 0; i < 4; i++)
+        {
+            OutLines.Emplace(Corners[i], Corners[(i + 1) % 4], Color, LifeTime, Thickness, SDPG_World);
+            OutLines.Emplace(Corners[i + 4], Corners[(i + 1) % 4 + 4], Color, LifeTime, Thickness, SDPG_World);
+            OutLines.Emplace(Corners[i], Corners[i + 4], Color, LifeTime, Thickness, SDPG_World);
+        }
+    }
+
+    FBox GetChunkBox(const AVoxelChunk& Chunk)
+    {
+        const FVoxelChunkSize ChunkSize = Chunk.ChunkComponent->GetChunkSize();
+        const FVector Origin = Chunk.GetActorLocation();
+        return FBox(Origin, Origin + FVector(ChunkSize.X, ChunkSize.Y, ChunkSize.Z) * UVoxelChunkComponent::VoxelSize);
+    }
+}
+
+void FVoxelDebugRenderer::Draw(const AVoxelWorld& VoxelWorld)
+{
+    using namespace VoxelDebugRenderer;
+
+    UWorld* World = VoxelWorld.GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    const EVoxelDebugHeatmap Mode = GetHeatmapMode();
+    const double Now = FPlatformTime::Seconds();
+
+    struct FChunkEntry
+    {
+        const AVoxelChunk* Chunk;
+        float Value;
+    };
+
+    TArray<FChunkEntry> Entries;
+    float MaxValue = 0.0f;
+    bool bAnyChunkFlags = false;
+
+    for (const TPair<FIntVector, AVoxelChunk*>& Pair : VoxelWorld.ActiveChunks)
+    {
+        const AVoxelChunk* Chunk = Pair.Value;
+        if (!Chunk || !Chunk->ChunkComponent)
+        {
+            continue;
+        }
+
+        const bool bChunkFlags = Chunk->bShowChunkBounds || Chunk->bShowDebugInfo || Chunk->bShowVoxelGrid || Chunk->bShowPerformanceStats;
+        if (Mode == EVoxelDebugHeatmap::None && !bChunkFlags)
+        {
+            continue;
+        }
+
+        bAnyChunkFlags |= bChunkFlags;
+
+        const float Value = Mode != EVoxelDebugHeatmap::None ? GetHeatValue(*Chunk->ChunkComponent, Mode, Now) : -1.0f;
+        MaxValue = FMath::Max(MaxValue, Value);
+        Entries.Add({ Chunk, Value });
+    }
+
+    if (Entries.Num() == 0)
+    {
+        return;
+    }
+
+    VOXEL_TRACE_SCOPE(Voxel_DebugRenderer);
+
+    // Fixed scales where the metric has a natural range, otherwise relative to the worst chunk
+    float Range = FMath::Max(MaxValue, KINDA_SMALL_NUMBER);
+    if (Mode == EVoxelDebugHeatmap::LOD)
+    {
+        Range = (float)EVoxelChunkLOD::LOD0;
+    }
+    else if (Mode == EVoxelDebugHeatmap::EditAge)
+    {
+        Range = EditAgeRangeSeconds;
+    }
+
+    TArray<FBatchedLine> Lines;
+    Lines.Reserve(Entries.Num() * 12);
+    TArray<FBatchedPoint> Points;
+
+    for (const FChunkEntry& Entry : Entries)
+    {
+        const AVoxelChunk& Chunk = *Entry.Chunk;
+        const UVoxelChunkComponent& ChunkComp = *Chunk.ChunkComponent;
+        const FBox Box = GetChunkBox(Chunk);
+
+        if (Entry.Value >= 0.0f)
+        {
+            float Heat = FMath::Clamp(Entry.Value / Range, 0.0f, 1.0f);
+
+            // Recent edits are the hot ones
+            if (Mode == EVoxelDebugHeatmap::EditAge)
+            {
+                Heat = 1.0f - Heat;
+            }
+
+            AddBoxLines(Box, GetHeatColor(Heat), BoundsThickness, 0.0f, Lines);
+        }
+        else if (Chunk.bShowChunkBounds || Mode != EVoxelDebugHeatmap::None)
+        {
+            // No data for this metric (never edited, not meshed yet)
+            const FLinearColor Color = Mode != EVoxelDebugHeatmap::None ? FLinearColor(0.3f, 0.3f, 0.3f) : FLinearColor::Green;
+            AddBoxLines(Box, Color, BoundsThickness, 0.0f, Lines);
+        }
+
+        if (Chunk.bShowVoxelGrid && ChunkComp.GetCurrentLOD() == EVoxelChunkLOD::LOD0)
+        {
+            const FVoxelChunkSize ChunkSize = ChunkComp.GetChunkSize();
+            const int32 Step = FMath::Max(1, Chunk.GridDisplayStep);
+            const FLinearColor PointColor = ChunkComp.DebugDrawColor;
+
+            for (int32 Z = 0; Z < ChunkSize.Z; Z += Step)
+            {
+                for (int32 Y = 0; Y < ChunkSize.Y; Y += Step)
+                {
+                    for (int32 X = 0; X < ChunkSize.X; X += Step)
+                    {
+                        if (ChunkComp.GetVoxel(X, Y, Z) != EVoxelMaterial::Air)
+                        {
+                            Points.Emplace(Box.Min + FVector(X, Y, Z) * ChunkComp.ConfigurableVoxelSize, PointColor, GridPointSize, 0.0f, SDPG_World);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Text cannot be batched, so it stays opt-in per chunk
+        if (Chunk.bShowDebugInfo)
+        {
+            const FString InfoText = FString::Printf(
+                TEXT("Chunk: %s\nLOD: %d\nState: %d\nDistance: %.1fm"),
+                *ChunkComp.GetChunkPosition().ToString(),
+                (int32)ChunkComp.GetCurrentLOD(),
+                (int32)ChunkComp.GetState(),
+                Chunk.GetDistanceToPlayer() / 100.0f
+            );
+
+            DrawDebugString(World, FVector(Box.GetCenter().X, Box.GetCenter().Y, Box.Max.Z), InfoText, nullptr, FColor::White, 0.0f, true);
+        }
+
+        if (Chunk.bShowPerformanceStats)
+        {
+            const FString PerfText = FString::Printf(
+                TEXT("Verts: %d\nTris: %d\nGen Time: %.2fms\nQueue Wait: %.1fms\nMemory: %.2fMB\nReduction: %.1f%%"),
+                ChunkComp.RuntimeVertexCount,
+                ChunkComp.RuntimeTriangleCount,
+                ChunkComp.LastGenerationTimeMs,
+                ChunkComp.LastQueueWaitMs,
+                ChunkComp.MemoryUsageMB,
+                ChunkComp.TriangleReductionPercentage
+            );
+
+            DrawDebugString(World, Box.Min + FVector(0, 0, -20.0f), PerfText, nullptr, FColor::Yellow, 0.0f, true);
+        }
+    }
+
+    if (ULineBatchComponent* LineBatcher = World->GetLineBatcher(UWorld::ELineBatcherType::World))
+    {
+        if (Lines.Num() > 0)
+        {
+            LineBatcher->DrawLines(Lines);
+        }
+
+        if (Points.Num() > 0)
+        {
+            LineBatcher->BatchedPoints.Append(MoveTemp(Points));
+            LineBatcher->MarkRenderStateDirty();
+        }
+    }
+
+    if (Mode != EVoxelDebugHeatmap::None && GEngine)
+    {
+        const FString Legend = Mode == EVoxelDebugHeatmap::LOD || Mode == EVoxelDebugHeatmap::EditAge
+            ? FString::Printf(TEXT("Voxel heatmap: %s (green to red, %d chunks)"), GetHeatmapName(Mode), Entries.Num())
+            : FString::Printf(TEXT("Voxel heatmap: %s (green 0 to red %.2f, %d chunks)"), GetHeatmapName(Mode), MaxValue, Entries.Num());
+        GEngine->AddOnScreenDebugMessage((uint64)(UPTRINT)&VoxelWorld, 0.0f, FColor::White, Legend);
+    }
+}
+
+EVoxelDebugHeatmap FVoxelDebugRenderer::GetHeatmapMode()
+{
+    return (EVoxelDebugHeatmap)FMath::Clamp(CVarVoxelDebugHeatmap.GetValueOnGameThread(), 0, (int32)EVoxelDebugHeatmap::Count - 1);
+}
+
+void FVoxelDebugRenderer::SetHeatmapMode(EVoxelDebugHeatmap Mode)
+{
+    CVarVoxelDebugHeatmap->Set((int32)Mode, ECVF_SetByCode);
+}
+
+const TCHAR* FVoxelDebugRenderer::GetHeatmapName(EVoxelDebugHeatmap Mode)
+{
+    switch (Mode)
+    {
+        case EVoxelDebugHeatmap::None: return TEXT("None");
+        case EVoxelDebugHeatmap::MeshTime: return TEXT("Mesh time (ms)");
+        case EVoxelDebugHeatmap::Triangles: return TEXT("Triangles");
+        case EVoxelDebugHeatmap::QueueWait: return TEXT("Queue wait (ms)");
+        case EVoxelDebugHeatmap::Memory: return TEXT("Memory (MB)");
+        case EVoxelDebugHeatmap::LOD: return TEXT("LOD (red = LOD0)");
+        case EVoxelDebugHeatmap::EditAge: return TEXT("Last edit (red = just now)");
+        default: return TEXT("Unknown");
+    }
+}
+
+float FVoxelDebugRenderer::GetHeatValue(const UVoxelChunkComponent& Chunk, EVoxelDebugHeatmap Mode, double Now)
+{
+    switch (Mode)
+    {
+        case EVoxelDebugHeatmap::MeshTime:
+            return Chunk.HasBeenGenerated() ? Chunk.LastGenerationTimeMs : -1.0f;
+        case EVoxelDebugHeatmap::Triangles:
+            return Chunk.HasBeenGenerated() ? (float)Chunk.RuntimeTriangleCount : -1.0f;
+        case EVoxelDebugHeatmap::QueueWait:
+            return Chunk.LastQueueWaitMs;
+        case EVoxelDebugHeatmap::Memory:
+            // Cached by mesh applies and the world's memory check - walking every allocation per frame is too slow
+            return Chunk.MemoryUsageMB;
+        case EVoxelDebugHeatmap::LOD:
+            return Chunk.GetCurrentLOD() != EVoxelChunkLOD::Unloaded ? (float)Chunk.GetCurrentLOD() : -1.0f;
+        case EVoxelDebugHeatmap::EditAge:
+            return Chunk.LastEditTime > 0.0 ? (float)(Now - Chunk.LastEditTime) : -1.0f;
+        default:
+            return -1.0f;
+    }
+}
+
+FLinearColor FVoxelDebugRenderer::GetHeatColor(float Normalized)
+{
+    return FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, FMath::Clamp(Normalized, 0.0f, 1.0f));
+}
+
+void FVoxelDebugRenderer::DrawBoxes(UWorld* World, const TArray<FBox>& Boxes, const TArray<FLinearColor>& Colors, float Thickness, float LifeTime)
+{
+    if (!World || Boxes.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<FBatchedLine> Lines;
+    Lines.Reserve(Boxes.Num() * 12);
+    for (int32 i = 0; i < Boxes.Num(); i++)
+    {
+        const FLinearColor& Color = Colors.IsValidIndex(i) ? Colors[i] : (Colors.Num() > 0 ? Colors.Last() : FLinearColor::White);
+        VoxelDebugRenderer::AddBoxLines(Boxes[i], Color, Thickness, LifeTime, Lines);
+    }
+
+    const UWorld::ELineBatcherType Type = LifeTime > 0.0f ? UWorld::ELineBatcherType::WorldPersistent : UWorld::ELineBatcherType::World;
+    if (ULineBatchComponent* LineBatcher = World->GetLineBatcher(Type))
+    {
+        LineBatcher->DrawLines(Lines);
+    }
+}
@@ -0,0 +1,423 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelDetailScatter.h"
+#include "VoxelTrace.h"
+#include "VoxelWorld.h"
+#include "VoxelPerformanceStats.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Async/Async.h"
+#include "HearthshireVoxelModule.h"
+
+float FVoxelDetailLayer::GetLODScale(EVoxelChunkLOD LOD) const
+{
+    // Unloaded chunks mesh at LOD0, so scatter them the same way
+    const int32 LODIndex = LOD == EVoxelChunkLOD::Unloaded ? 0 : (int32)EVoxelChunkLOD::LOD0 - (int32)LOD;
+    return LODDensityScale.IsValidIndex(LODIndex) ? LODDensityScale[LODIndex] : 0.0f;
+}
+
+UVoxelDetailScatterComponent::UVoxelDetailScatterComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.TickInterval = 0.05f;
+    VoxelWorld = nullptr;
+}
+
+void UVoxelDetailScatterComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    VoxelWorld = Cast<AVoxelWorld>(GetOwner());
+    if (!VoxelWorld)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelDetailScatter: Owner is not a VoxelWorld, scatter disabled"));
+        return;
+    }
+
+    VoxelWorld->OnChunkLoaded.AddDynamic(this, &UVoxelDetailScatterComponent::HandleChunkLoaded);
+    VoxelWorld->OnChunkUnloaded.AddDynamic(this, &UVoxelDetailScatterComponent::HandleChunkUnloaded);
+    EditedHandle = VoxelWorld->OnVoxelEditedNative.AddUObject(this, &UVoxelDetailScatterComponent::HandleVoxelEdited);
+    ReplacedHandle = VoxelWorld->OnChunkReplacedNative.AddUObject(this, &UVoxelDetailScatterComponent::HandleChunkReplaced);
+
+    // Chunks preserved from the editor are already loaded
+    RebuildAll();
+}
+
+void UVoxelDetailScatterComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (VoxelWorld)
+    {
+        VoxelWorld->OnChunkLoaded.RemoveDynamic(this, &UVoxelDetailScatterComponent::HandleChunkLoaded);
+        VoxelWorld->OnChunkUnloaded.RemoveDynamic(this, &UVoxelDetailScatterComponent::HandleChunkUnloaded);
+        VoxelWorld->OnVoxelEditedNative.Remove(EditedHandle);
+        VoxelWorld->OnChunkReplacedNative.Remove(ReplacedHandle);
+    }
+
+    ClearAll();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UVoxelDetailScatterComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (PendingRebuilds.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<FIntVector> ReadyChunks;
+    for (TPair<FIntVector, float>& Pending : PendingRebuilds)
+    {
+        Pending.Value -= DeltaTime;
+        if (Pending.Value <= 0.0f)
+        {
+            ReadyChunks.Add(Pending.Key);
+        }
+    }
+
+    for (const FIntVector& ChunkPosition : ReadyChunks)
+    {
+        PendingRebuilds.Remove(ChunkPosition);
+        ScheduleChunk(ChunkPosition);
+    }
+}
+
+void UVoxelDetailScatterComponent::RebuildAll()
+{
+    if (!VoxelWorld)
+    {
+        return;
+    }
+
+    for (const TPair<FIntVector, AVoxelChunk*>& Pair : VoxelWorld->ActiveChunks)
+    {
+        ScheduleChunk(Pair.Key);
+    }
+}
+
+void UVoxelDetailScatterComponent::SetDensityScale(float NewScale)
+{
+    NewScale = FMath::Clamp(NewScale, 0.0f, 1.0f);
+    if (FMath::IsNearlyEqual(NewScale, DensityScale, 0.01f))
+    {
+        return;
+    }
+
+    DensityScale = NewScale;
+    RebuildAll();
+}
+
+void UVoxelDetailScatterComponent::ClearAll()
+{
+    TArray<FIntVector> ChunkPositions;
+    ChunkDetails.GetKeys(ChunkPositions);
+
+    for (const FIntVector& ChunkPosition : ChunkPositions)
+    {
+        ReleaseChunk(ChunkPosition);
+    }
+
+    PendingRebuilds.Empty();
+}
+
+int32 UVoxelDetailScatterComponent::GetInstanceCount() const
+{
+    int32 Count = 0;
+    for (const TPair<FIntVector, FChunkDetail>& Pair : ChunkDetails)
+    {
+        for (const UHierarchicalInstancedStaticMeshComponent* Component : Pair.Value.Components)
+        {
+            Count += Component ? Component->GetInstanceCount() : 0;
+        }
+    }
+    return Count;
+}
+
+void UVoxelDetailScatterComponent::BuildChunkInstances(const FVoxelChunkData& ChunkData, const TArray<uint8>& AboveLayer, const TArray<FVoxelDetailLayer>& InLayers,
+    EVoxelChunkLOD LOD, int32 Seed, TArray<TArray<FTransform>>& OutTransforms)
+{
+#if VOXEL_ENABLE_STATS
+    SCOPE_CYCLE_COUNTER(STAT_DetailScatter);
+#endif
+    VOXEL_TRACE_SCOPE(Voxel_BuildDetailInstances);
+
+    const FVoxelChunkSize& Size = ChunkData.ChunkSize;
+    const float VoxelSize = UVoxelChunkComponent::VoxelSize;
+    const FIntVector ChunkOrigin(ChunkData.ChunkPosition.X * Size.X, ChunkData.ChunkPosition.Y * Size.Y, ChunkData.ChunkPosition.Z * Size.Z);
+
+    OutTransforms.SetNum(InLayers.Num());
+
+    for (int32 LayerIndex = 0; LayerIndex < InLayers.Num(); LayerIndex++)
+    {
+        const FVoxelDetailLayer& Layer = InLayers[LayerIndex];
+        TArray<FTransform>& Transforms = OutTransforms[LayerIndex];
+        Transforms.Reset();
+
+        const float Density = Layer.Density * Layer.GetLODScale(LOD);
+        if (!Layer.Mesh || Density <= 0.0f || Layer.SurfaceMaterials.Num() == 0)
+        {
+            continue;
+        }
+
+        bool bSurfaceMaterial[256] = {};
+        for (EVoxelMaterial Material : Layer.SurfaceMaterials)
+        {
+            bSurfaceMaterial[(uint8)Material] = true;
+        }
+
+        const uint32 LayerSeed = HashCombine((uint32)Seed, (uint32)LayerIndex);
+
+        for (int32 Z = 0; Z < Size.Z; Z++)
+        {
+            for (int32 Y = 0; Y < Size.Y; Y++)
+            {
+                for (int32 X = 0; X < Size.X; X++)
+                {
+                    if (!bSurfaceMaterial[(uint8)ChunkData.GetVoxel(X, Y, Z).Material])
+                    {
+                        continue;
+                    }
+
+                    // Only exposed top faces - the top layer looks into the chunk above
+                    const bool bAirAbove = Z < Size.Z - 1
+                        ? ChunkData.GetVoxel(X, Y, Z + 1).IsAir()
+                        : !AboveLayer.IsValidIndex(X + Y * Size.X) || AboveLayer[X + Y * Size.X] == (uint8)EVoxelMaterial::Air;
+                    if (!bAirAbove)
+                    {
+                        continue;
+                    }
+
+                    // Seeded per global voxel: results don't depend on iteration order,
+                    // and lower LODs keep a subset of the higher LOD instances
+                    FRandomStream Random(HashCombine(LayerSeed, GetTypeHash(ChunkOrigin + FIntVector(X, Y, Z))));
+                    if (Random.FRand() >= Density)
+                    {
+                        continue;
+                    }
+
+                    const float OffsetX = Random.FRandRange(-Layer.PositionJitter, Layer.PositionJitter);
+                    const float OffsetY = Random.FRandRange(-Layer.PositionJitter, Layer.PositionJitter);
+                    const float Yaw = Layer.bRandomYaw ? Random.FRandRange(0.0f, 360.0f) : 0.0f;
+                    const float Scale = Random.FRandRange(Layer.MinScale, FMath::Max(Layer.MinScale, Layer.MaxScale));
+
+                    const FVector Location = FVector(X + 0.5f + OffsetX, Y + 0.5f + OffsetY, Z + 1.0f) * VoxelSize;
+                    Transforms.Add(FTransform(FRotator(0.0f, Yaw, 0.0f), Location, FVector(Scale)));
+                }
+            }
+        }
+    }
+}
+
+void UVoxelDetailScatterComponent::HandleChunkLoaded(const FIntVector& ChunkPosition)
+{
+    ScheduleChunk(ChunkPosition);
+
+    // The chunk below sees a new top neighbor
+    const FIntVector Below = ChunkPosition - FIntVector(0, 0, 1);
+    if (ChunkDetails.Contains(Below))
+    {
+        PendingRebuilds.FindOrAdd(Below) = 0.0f;
+    }
+}
+
+void UVoxelDetailScatterComponent::HandleChunkUnloaded(const FIntVector& ChunkPosition)
+{
+    ReleaseChunk(ChunkPosition);
+}
+
+void UVoxelDetailScatterComponent::HandleLODChanged(UVoxelChunkComponent* Chunk, EVoxelChunkLOD OldLOD, EVoxelChunkLOD NewLOD)
+{
+    if (!Chunk)
+    {
+        return;
+    }
+
+    for (const FVoxelDetailLayer& Layer : Layers)
+    {
+        if (Layer.GetLODScale(OldLOD) != Layer.GetLODScale(NewLOD))
+        {
+            ScheduleChunk(Chunk->GetChunkPosition());
+            return;
+        }
+    }
+}
+
+void UVoxelDetailScatterComponent::HandleVoxelEdited(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, EVoxelMaterial Material)
+{
+    PendingRebuilds.FindOrAdd(ChunkPosition) = EditRebuildDelay;
+
+    if (LocalVoxel.Z == 0)
+    {
+        const FIntVector Below = ChunkPosition - FIntVector(0, 0, 1);
+        if (ChunkDetails.Contains(Below))
+        {
+            PendingRebuilds.FindOrAdd(Below) = EditRebuildDelay;
+        }
+    }
+}
+
+void UVoxelDetailScatterComponent::HandleChunkReplaced(const FIntVector& ChunkPosition)
+{
+    PendingRebuilds.FindOrAdd(ChunkPosition) = EditRebuildDelay;
+}
+
+void UVoxelDetailScatterComponent::ScheduleChunk(const FIntVector& ChunkPosition)
+{
+    if (!VoxelWorld || Layers.Num() == 0)
+    {
+        return;
+    }
+
+    AVoxelChunk* Chunk = VoxelWorld->GetChunkAtPosition(ChunkPosition);
+    if (!Chunk || !Chunk->ChunkComponent)
+    {
+        return;
+    }
+
+    UVoxelChunkComponent* ChunkComp = Chunk->ChunkComponent;
+
+    FChunkDetail& Detail = ChunkDetails.FindOrAdd(ChunkPosition);
+    Detail.Generation++;
+
+    if (Detail.ChunkComponent.Get() != ChunkComp)
+    {
+        ChunkComp->OnLODChanged.AddUniqueDynamic(this, &UVoxelDetailScatterComponent::HandleLODChanged);
+        Detail.ChunkComponent = ChunkComp;
+    }
+
+    // Snapshot everything the worker needs
+    const FVoxelChunkData& ChunkData = ChunkComp->GetChunkData();
+
+    TArray<uint8> AboveLayer;
+    if (AVoxelChunk* AboveChunk = VoxelWorld->GetChunkAtPosition(ChunkPosition + FIntVector(0, 0, 1)))
+    {
+        if (AboveChunk->ChunkComponent)
+        {
+            const FVoxelChunkData& AboveData = AboveChunk->ChunkComponent->GetChunkData();
+            AboveLayer.SetNumUninitialized(ChunkData.ChunkSize.X * ChunkData.ChunkSize.Y);
+            for (int32 Y = 0; Y < ChunkData.ChunkSize.Y; Y++)
+            {
+                for (int32 X = 0; X < ChunkData.ChunkSize.X; X++)
+                {
+                    AboveLayer[X + Y * ChunkData.ChunkSize.X] = (uint8)AboveData.GetVoxel(X, Y, 0).Material;
+                }
+            }
+        }
+    }
+
+    const uint32 Generation = Detail.Generation;
+    const EVoxelChunkLOD LOD = ChunkComp->GetCurrentLOD();
+    const int32 Seed = VoxelWorld->WorldSeed;
+    TWeakObjectPtr<UVoxelDetailScatterComponent> WeakThis(this);
+
+    TArray<FVoxelDetailLayer> ScaledLayers = Layers;
+    for (FVoxelDetailLayer& Layer : ScaledLayers)
+    {
+        Layer.Density *= DensityScale;
+    }
+
+    Async(EAsyncExecution::ThreadPool, [WeakThis, ChunkPosition, Generation, LOD, Seed, ChunkData, AboveLayer = MoveTemp(AboveLayer), LayersCopy = MoveTemp(ScaledLayers)]()
+    {
+        TArray<TArray<FTransform>> Transforms;
+        BuildChunkInstances(ChunkData, AboveLayer, LayersCopy, LOD, Seed, Transforms);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, ChunkPosition, Generation, Transforms = MoveTemp(Transforms)]() mutable
+        {
+            if (UVoxelDetailScatterComponent* This = WeakThis.Get())
+            {
+                This->ApplyChunkInstances(ChunkPosition, Generation, MoveTemp(Transforms));
+            }
+        });
+    });
+}
+
+void UVoxelDetailScatterComponent::ApplyChunkInstances(const FIntVector& ChunkPosition, uint32 Generation, TArray<TArray<FTransform>>&& Transforms)
+{
+    FChunkDetail* Detail = ChunkDetails.Find(ChunkPosition);
+    if (!Detail || Detail->Generation != Generation || !Detail->ChunkComponent.IsValid())
+    {
+        return;
+    }
+
+    for (UHierarchicalInstancedStaticMeshComponent* Component : Detail->Components)
+    {
+        ReleaseComponent(Component);
+    }
+    Detail->Components.Reset();
+
+    const FTransform ChunkTransform(Detail->ChunkComponent->GetOwner()->GetActorLocation());
+
+    for (int32 LayerIndex = 0; LayerIndex < Transforms.Num() && LayerIndex < Layers.Num(); LayerIndex++)
+    {
+        if (Transforms[LayerIndex].Num() == 0 || !Layers[LayerIndex].Mesh)
+        {
+            continue;
+        }
+
+        UHierarchicalInstancedStaticMeshComponent* Component = AcquireComponent(Layers[LayerIndex]);
+        Component->SetWorldTransform(ChunkTransform);
+        Component->AddInstances(Transforms[LayerIndex], false);
+        Detail->Components.Add(Component);
+    }
+}
+
+void UVoxelDetailScatterComponent::ReleaseChunk(const FIntVector& ChunkPosition)
+{
+    FChunkDetail* Detail = ChunkDetails.Find(ChunkPosition);
+    if (!Detail)
+    {
+        return;
+    }
+
+    for (UHierarchicalInstancedStaticMeshComponent* Component : Detail->Components)
+    {
+        ReleaseComponent(Component);
+    }
+
+    if (UVoxelChunkComponent* ChunkComp = Detail->ChunkComponent.Get())
+    {
+        ChunkComp->OnLODChanged.RemoveDynamic(this, &UVoxelDetailScatterComponent::HandleLODChanged);
+    }
+
+    ChunkDetails.Remove(ChunkPosition);
+    PendingRebuilds.Remove(ChunkPosition);
+}
+
+UHierarchicalInstancedStaticMeshComponent* UVoxelDetailScatterComponent::AcquireComponent(const FVoxelDetailLayer& Layer)
+{
+    UHierarchicalInstancedStaticMeshComponent* Component = nullptr;
+
+    if (FreeComponents.Num() > 0)
+    {
+        Component = FreeComponents.Pop();
+    }
+    else
+    {
+        Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(GetOwner());
+        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        Component->SetCanEverAffectNavigation(false);
+        Component->RegisterComponent();
+        AllComponents.Add(Component);
+    }
+
+    Component->SetStaticMesh(Layer.Mesh);
+    Component->SetCastShadow(Layer.bCastShadow);
+    Component->SetCullDistances(Layer.CullStartDistance, Layer.CullEndDistance);
+    Component->SetVisibility(true);
+
+    return Component;
+}
+
+void UVoxelDetailScatterComponent::ReleaseComponent(UHierarchicalInstancedStaticMeshComponent* Component)
+{
+    if (!Component)
+    {
+        return;
+    }
+
+    Component->ClearInstances();
+    Component->SetVisibility(false);
+    FreeComponents.Add(Component);
+}
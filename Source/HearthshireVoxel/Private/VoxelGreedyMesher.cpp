@@ -1,225 +1,526 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VoxelGreedyMesher.h"
+#include "VoxelChunkKernels.h"
+#include "VoxelTrace.h"
 #include "VoxelMeshGenerator.h"
 #include "VoxelPerformanceStats.h"
 #include "HearthshireVoxelModule.h"
+#include "Algo/AnyOf.h"
 
 void FVoxelGreedyMesher::GenerateGreedyMesh(
     const FVoxelChunkData& ChunkData,
-    TArray<FGreedyQuad>& OutQuads)
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    EVoxelDataLayout Layout,
+    const FVoxelMaterialTraitTable* Traits)
 {
 #if VOXEL_ENABLE_STATS
     SCOPE_CYCLE_COUNTER(STAT_GreedyMeshing);
 #endif
+    VOXEL_TRACE_SCOPE(Voxel_GreedyQuads);
     
     OutQuads.Empty();
     
+    const FVoxelMaterialTraits* TraitData = (Traits ? *Traits : FVoxelMaterialTraitTable::GetDefault()).GetData();
     
-    // Count visible faces before optimization
-    int32 VisibleFaceCount = 0;
+    // Column-stored terrain is meshed straight from its spans
+    if (ChunkData.IsColumnStored())
+    {
+        GenerateColumnQuads(ChunkData, OutQuads, bMergeAcrossMaterials, TraitData);
+        UE_LOG(LogHearthshireVoxel, VeryVerbose, TEXT("  Chunk %s: Generated %d quads from columns"), *ChunkData.ChunkPosition.ToString(), OutQuads.Num());
+        return;
+    }
     
     // Process each of the 6 face directions
-    for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+    static constexpr EVoxelFace AllFaces[] = { EVoxelFace::Front, EVoxelFace::Back, EVoxelFace::Right, EVoxelFace::Left, EVoxelFace::Top, EVoxelFace::Bottom };
+    ProcessFaces(ChunkData, AllFaces, OutQuads, bMergeAcrossMaterials, false, Layout, TraitData);
+    
+    UE_LOG(LogHearthshireVoxel, VeryVerbose, TEXT("  Chunk %s: Generated %d quads"), *ChunkData.ChunkPosition.ToString(), OutQuads.Num());
+}
+
+void FVoxelGreedyMesher::GenerateTranslucentQuads(
+    const FVoxelChunkData& ChunkData,
+    TArray<FGreedyQuad>& OutQuads,
+    EVoxelDataLayout Layout,
+    const FVoxelMaterialTraitTable* Traits)
+{
+#if VOXEL_ENABLE_STATS
+    SCOPE_CYCLE_COUNTER(STAT_GreedyMeshing);
+#endif
+    VOXEL_TRACE_SCOPE(Voxel_TranslucentQuads);
+    
+    OutQuads.Reset();
+    
+    const FVoxelMaterialTraits* TraitData = (Traits ? *Traits : FVoxelMaterialTraitTable::GetDefault()).GetData();
+    
+    // Spans show whether there is any water without expanding the chunk
+    if (ChunkData.IsColumnStored() && !Algo::AnyOf(ChunkData.Columns.GetSpans(), [TraitData](const FVoxelColumnSpan& Span) { return TraitData[(uint8)Span.Material].bTranslucent; }))
     {
-        EVoxelFace Face = static_cast<EVoxelFace>(FaceIndex);
-        int32 QuadsBefore = OutQuads.Num();
-        ProcessFaceDirection(ChunkData, Face, OutQuads);
-        int32 QuadsAdded = OutQuads.Num() - QuadsBefore;
-        
-        UE_LOG(LogHearthshireVoxel, VeryVerbose, TEXT("  Face %d: Generated %d quads"), FaceIndex, QuadsAdded);
+        return;
     }
     
-    // Count faces by type for debugging
-    int32 FaceCounts[6] = {0};
-    for (const FGreedyQuad& Quad : OutQuads)
+    static constexpr EVoxelFace AllFaces[] = { EVoxelFace::Front, EVoxelFace::Back, EVoxelFace::Right, EVoxelFace::Left, EVoxelFace::Top, EVoxelFace::Bottom };
+    ProcessFaces(ChunkData, AllFaces, OutQuads, false, true, Layout, TraitData);
+    
+    // Static back-to-front approximation for a viewer above the water: lower surfaces first, tops last at each height
+    OutQuads.StableSort([](const FGreedyQuad& A, const FGreedyQuad& B)
     {
-        FaceCounts[(int32)Quad.Face]++;
+        const int32 TopA = A.Position.Z + (A.Face == EVoxelFace::Top ? 1 : 0);
+        const int32 TopB = B.Position.Z + (B.Face == EVoxelFace::Top ? 1 : 0);
+        if (TopA != TopB)
+        {
+            return TopA < TopB;
+        }
+        return A.Face != EVoxelFace::Top && B.Face == EVoxelFace::Top;
+    });
+}
+
+void FVoxelGreedyMesher::GenerateFaceQuads(
+    const FVoxelChunkData& ChunkData,
+    EVoxelFace Face,
+    TArray<FGreedyQuad>& OutQuads,
+    bool bTranslucentPass,
+    EVoxelDataLayout Layout,
+    const FVoxelMaterialTraitTable* Traits)
+{
+    OutQuads.Reset();
+    ProcessFaces(ChunkData, MakeArrayView(&Face, 1), OutQuads, false, bTranslucentPass, Layout, (Traits ? *Traits : FVoxelMaterialTraitTable::GetDefault()).GetData());
+}
+
+namespace VoxelGreedyKernels
+{
+    // Axis layout of each face, matching GetFaceAxes but usable as template constants
+    constexpr int32 GetPrimaryAxis(EVoxelFace Face)
+    {
+        return (Face == EVoxelFace::Front || Face == EVoxelFace::Back) ? 1 : ((Face == EVoxelFace::Right || Face == EVoxelFace::Left) ? 0 : 2);
+    }
+    
+    constexpr int32 GetUAxis(EVoxelFace Face)
+    {
+        return (Face == EVoxelFace::Right || Face == EVoxelFace::Left) ? 1 : 0;
+    }
+    
+    constexpr int32 GetVAxis(EVoxelFace Face)
+    {
+        return (Face == EVoxelFace::Top || Face == EVoxelFace::Bottom) ? 1 : 2;
     }
     
+    constexpr int32 GetFaceSign(EVoxelFace Face)
+    {
+        return (Face == EVoxelFace::Front || Face == EVoxelFace::Right || Face == EVoxelFace::Top) ? 1 : -1;
+    }
 }
 
-void FVoxelGreedyMesher::ProcessFaceDirection(
+void FVoxelGreedyMesher::ProcessFaces(
     const FVoxelChunkData& ChunkData,
-    EVoxelFace Face,
-    TArray<FGreedyQuad>& OutQuads)
+    TConstArrayView<EVoxelFace> Faces,
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    bool bTranslucentPass,
+    EVoxelDataLayout Layout,
+    const FVoxelMaterialTraits* Traits)
 {
-    int32 PrimaryAxis, UAxis, VAxis;
-    GetFaceAxes(Face, PrimaryAxis, UAxis, VAxis);
+    // Kernels index the flat array directly - column-stored chunks are expanded once for the pass
+    TArray<FVoxel> ExpandedVoxels;
+    const TArray<FVoxel>& LinearVoxels = ChunkData.GetDenseVoxels(ExpandedVoxels);
+    if (LinearVoxels.Num() != ChunkData.ChunkSize.GetVoxelCount())
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("GreedyMesher: Chunk %s has %d voxels, expected %d"),
+            *ChunkData.ChunkPosition.ToString(), LinearVoxels.Num(), ChunkData.ChunkSize.GetVoxelCount());
+        return;
+    }
     
-    const FIntVector ChunkSize = ChunkData.ChunkSize.ToIntVector();
-    const int32 SliceCount = ChunkSize[PrimaryAxis];
+    auto RunFaces = [&](const FVoxel* Voxels, const auto& Dims)
+    {
+        for (EVoxelFace Face : Faces)
+        {
+            switch (Face)
+            {
+                case EVoxelFace::Front:  ProcessFaceSlices<EVoxelFace::Front>(Voxels, Dims, OutQuads, bMergeAcrossMaterials, bTranslucentPass, Traits); break;
+                case EVoxelFace::Back:   ProcessFaceSlices<EVoxelFace::Back>(Voxels, Dims, OutQuads, bMergeAcrossMaterials, bTranslucentPass, Traits); break;
+                case EVoxelFace::Right:  ProcessFaceSlices<EVoxelFace::Right>(Voxels, Dims, OutQuads, bMergeAcrossMaterials, bTranslucentPass, Traits); break;
+                case EVoxelFace::Left:   ProcessFaceSlices<EVoxelFace::Left>(Voxels, Dims, OutQuads, bMergeAcrossMaterials, bTranslucentPass, Traits); break;
+                case EVoxelFace::Top:    ProcessFaceSlices<EVoxelFace::Top>(Voxels, Dims, OutQuads, bMergeAcrossMaterials, bTranslucentPass, Traits); break;
+                case EVoxelFace::Bottom: ProcessFaceSlices<EVoxelFace::Bottom>(Voxels, Dims, OutQuads, bMergeAcrossMaterials, bTranslucentPass, Traits); break;
+                default: break;
+            }
+        }
+    };
+    
+    // One conversion serves every face of the pass
+    TArray<FVoxel> TiledVoxels;
+    if (FVoxelMeshGenerator::ResolveLayout(Layout, EVoxelLayoutPass::Mesh, ChunkData.ChunkSize) == EVoxelDataLayout::Tiled &&
+        VoxelChunkKernels::ConvertToTiled(ChunkData, TiledVoxels))
+    {
+        DispatchVoxelTiledKernel(ChunkData.ChunkSize, [&](const auto& Dims) { RunFaces(TiledVoxels.GetData(), Dims); });
+        return;
+    }
+    
+    DispatchVoxelChunkKernel(ChunkData.ChunkSize, [&](const auto& Dims) { RunFaces(LinearVoxels.GetData(), Dims); });
+}
+
+template<EVoxelFace Face, typename DimsType>
+void FVoxelGreedyMesher::ProcessFaceSlices(
+    const FVoxel* Voxels,
+    const DimsType& Dims,
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    bool bTranslucentPass,
+    const FVoxelMaterialTraits* Traits)
+{
+    constexpr int32 PrimaryAxis = VoxelGreedyKernels::GetPrimaryAxis(Face);
+    constexpr int32 UAxis = VoxelGreedyKernels::GetUAxis(Face);
+    constexpr int32 VAxis = VoxelGreedyKernels::GetVAxis(Face);
+    
+    // One mask reused by every slice, on the stack up to 32x32
+    TArray<FFaceMask, TInlineAllocator<32 * 32>> Mask;
+    Mask.SetNumUninitialized(Dims.Size(UAxis) * Dims.Size(VAxis));
     
     // Process each slice perpendicular to the face normal
-    for (int32 Slice = 0; Slice < SliceCount; Slice++)
+    for (int32 Slice = 0; Slice < Dims.Size(PrimaryAxis); Slice++)
     {
-        TArray<FFaceMask> Mask;
-        FIntVector MaskDimensions;
-        
-        // Create visibility mask for this slice
-        CreateFaceMask(ChunkData, Face, Slice, Mask, MaskDimensions);
-        
-        // Extract greedy quads from the mask
-        ExtractQuadsFromMask(Mask, MaskDimensions, Face, Slice, OutQuads);
+        CreateFaceMask<Face>(Voxels, Dims, Slice, Mask.GetData(), bTranslucentPass, Traits);
+        ExtractQuadsFromMask<Face>(Mask.GetData(), Dims, Slice, OutQuads, bMergeAcrossMaterials, Traits);
     }
 }
 
+template<EVoxelFace Face, typename DimsType>
 void FVoxelGreedyMesher::CreateFaceMask(
-    const FVoxelChunkData& ChunkData,
-    EVoxelFace Face,
+    const FVoxel* Voxels,
+    const DimsType& Dims,
     int32 SliceIndex,
-    TArray<FFaceMask>& OutMask,
-    FIntVector& OutMaskDimensions)
+    FFaceMask* OutMask,
+    bool bTranslucentPass,
+    const FVoxelMaterialTraits* Traits)
 {
-    int32 PrimaryAxis, UAxis, VAxis;
-    GetFaceAxes(Face, PrimaryAxis, UAxis, VAxis);
+    constexpr int32 PrimaryAxis = VoxelGreedyKernels::GetPrimaryAxis(Face);
+    constexpr int32 UAxis = VoxelGreedyKernels::GetUAxis(Face);
+    constexpr int32 VAxis = VoxelGreedyKernels::GetVAxis(Face);
+    constexpr int32 Sign = VoxelGreedyKernels::GetFaceSign(Face);
     
-    const FIntVector ChunkSize = ChunkData.ChunkSize.ToIntVector();
-    OutMaskDimensions.X = ChunkSize[UAxis];
-    OutMaskDimensions.Y = ChunkSize[VAxis];
-    OutMaskDimensions.Z = 1;
+    const int32 SizeU = Dims.Size(UAxis);
+    const int32 SizeV = Dims.Size(VAxis);
     
-    const int32 MaskSize = OutMaskDimensions.X * OutMaskDimensions.Y;
-    OutMask.SetNum(MaskSize);
+    // The neighbor only moves along the primary axis, so the whole slice is either inside or on the border.
+    // Border faces are visible in both passes - the next chunk may hold air or be unloaded, not more water
+    const int32 NeighborSlice = SliceIndex + Sign;
+    const bool bNeighborOutside = NeighborSlice < 0 || NeighborSlice >= Dims.Size(PrimaryAxis);
     
-    // Fill the mask with face visibility data
-    for (int32 V = 0; V < OutMaskDimensions.Y; V++)
+    auto WriteCell = [Voxels, Traits, bNeighborOutside, bTranslucentPass](FFaceMask& Cell, int32 Index, int32 NeighborIndex)
     {
-        for (int32 U = 0; U < OutMaskDimensions.X; U++)
+        const EVoxelMaterial CurrentMaterial = Voxels[Index].Material;
+        const FVoxelMaterialTraits Current = Traits[(uint8)CurrentMaterial];
+        
+        // Each pass only sees its own voxels - translucent materials never enter the opaque mask
+        if (!Current.bSolid || (bool)Current.bTranslucent != bTranslucentPass)
         {
-            // Convert UV coordinates to 3D position
-            FIntVector VoxelPos = MaskToVoxelPosition(U, V, SliceIndex, Face);
-            
-            const FVoxel CurrentVoxel = ChunkData.GetVoxel(VoxelPos.X, VoxelPos.Y, VoxelPos.Z);
-            const int32 MaskIndex = GetMaskIndex(U, V, OutMaskDimensions);
-            
-            if (CurrentVoxel.IsAir())
+            Cell = FFaceMask(EVoxelMaterial::Air, false);
+            return;
+        }
+        
+        bool bFaceVisible = true;
+        if (!bNeighborOutside)
+        {
+            // Nothing shows through an opaque neighbor. Translucent faces are also hidden by other translucent
+            // materials so water against ice has no internal surface; same-material faces follow bCullSameMaterial
+            const EVoxelMaterial NeighborMaterial = Voxels[NeighborIndex].Material;
+            const FVoxelMaterialTraits Neighbor = Traits[(uint8)NeighborMaterial];
+            const bool bSameMaterial = CurrentMaterial == NeighborMaterial;
+            bFaceVisible = !Neighbor.bOpaque && (bTranslucentPass
+                ? (!Neighbor.bTranslucent || (bSameMaterial && !Current.bCullSameMaterial))
+                : (!bSameMaterial || !Current.bCullSameMaterial));
+        }
+        
+        Cell = FFaceMask(CurrentMaterial, bFaceVisible);
+    };
+    
+    int32 Position[3];
+    int32 NeighborPosition[3];
+    Position[PrimaryAxis] = SliceIndex;
+    NeighborPosition[PrimaryAxis] = bNeighborOutside ? SliceIndex : NeighborSlice;
+    
+    for (int32 V = 0; V < SizeV; V++)
+    {
+        Position[VAxis] = NeighborPosition[VAxis] = V;
+        FFaceMask* MaskRow = OutMask + V * SizeU;
+        
+        if constexpr (DimsType::bTiled)
+        {
+            // Tile coordinates are not affine in U - index every cell
+            for (int32 U = 0; U < SizeU; U++)
             {
-                OutMask[MaskIndex] = FFaceMask(EVoxelMaterial::Air, false);
+                Position[UAxis] = NeighborPosition[UAxis] = U;
+                WriteCell(MaskRow[U], Dims.Index(Position[0], Position[1], Position[2]), Dims.Index(NeighborPosition[0], NeighborPosition[1], NeighborPosition[2]));
             }
-            else
+        }
+        else
+        {
+            // Linear rows step by a constant stride, the neighbor is a constant offset away
+            Position[UAxis] = 0;
+            const int32 RowBase = Dims.Index(Position[0], Position[1], Position[2]);
+            const int32 StrideU = Dims.Stride(UAxis);
+            const int32 NeighborOffset = Sign * Dims.Stride(PrimaryAxis);
+            
+            for (int32 U = 0; U < SizeU; U++)
             {
-                bool bFaceVisible = IsFaceVisible(ChunkData, VoxelPos.X, VoxelPos.Y, VoxelPos.Z, Face);
-                OutMask[MaskIndex] = FFaceMask(CurrentVoxel.Material, bFaceVisible);
+                const int32 Index = RowBase + U * StrideU;
+                WriteCell(MaskRow[U], Index, Index + NeighborOffset);
             }
         }
     }
 }
 
+template<EVoxelFace Face, typename DimsType>
 void FVoxelGreedyMesher::ExtractQuadsFromMask(
-    TArray<FFaceMask>& Mask,
-    const FIntVector& MaskDimensions,
-    EVoxelFace Face,
+    FFaceMask* Mask,
+    const DimsType& Dims,
     int32 SliceIndex,
-    TArray<FGreedyQuad>& OutQuads)
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    const FVoxelMaterialTraits* Traits)
 {
+    const int32 SizeU = Dims.Size(VoxelGreedyKernels::GetUAxis(Face));
+    const int32 SizeV = Dims.Size(VoxelGreedyKernels::GetVAxis(Face));
+    
+    auto CanMerge = [bMergeAcrossMaterials, Traits](const FFaceMask& Start, const FFaceMask& Test)
+    {
+        return bMergeAcrossMaterials ? Start.CanMergeIgnoringMaterial(Test, Traits) : Start.CanMergeWith(Test);
+    };
+    
     // Iterate through the mask and find unprocessed visible faces
-    for (int32 V = 0; V < MaskDimensions.Y; V++)
+    for (int32 V = 0; V < SizeV; V++)
     {
-        for (int32 U = 0; U < MaskDimensions.X; U++)
+        for (int32 U = 0; U < SizeU; U++)
         {
-            const int32 MaskIndex = GetMaskIndex(U, V, MaskDimensions);
-            FFaceMask& CurrentMask = Mask[MaskIndex];
+            // Copy - the start cell is cleared below while still being compared against
+            const FFaceMask StartMask = Mask[U + V * SizeU];
             
             // Skip if not visible or already processed
-            if (!CurrentMask.bVisible)
+            if (!StartMask.bVisible)
             {
                 continue;
             }
             
-            // Found a visible face - extend it as far as possible
-            const EVoxelMaterial Material = CurrentMask.Material;
-            const FIntVector StartPos(U, V, 0);
-            
-            // Extend the quad to find optimal size
-            FIntVector QuadSize = ExtendQuad(Mask, MaskDimensions, StartPos, Material);
-            
-            // Create the greedy quad
-            FIntVector VoxelPos = MaskToVoxelPosition(U, V, SliceIndex, Face);
-            FGreedyQuad Quad(VoxelPos, QuadSize, Face, Material);
-            OutQuads.Add(Quad);
+            // First, extend along U axis
+            int32 MaxU = U + 1;
+            while (MaxU < SizeU && CanMerge(StartMask, Mask[MaxU + V * SizeU]))
+            {
+                MaxU++;
+            }
             
-            // Debug logging for large quads
-            if (QuadSize.X > 1 || QuadSize.Y > 1)
+            // Then, extend along V axis while entire rows can be added
+            int32 MaxV = V + 1;
+            for (; MaxV < SizeV; MaxV++)
             {
-                UE_LOG(LogHearthshireVoxel, VeryVerbose, TEXT("    Created greedy quad: Pos=%s, Size=%s, Face=%d, Material=%d"),
-                    *VoxelPos.ToString(), *QuadSize.ToString(), (int32)Face, (int32)Material);
+                const FFaceMask* Row = Mask + MaxV * SizeU;
+                int32 TestU = U;
+                while (TestU < MaxU && CanMerge(StartMask, Row[TestU]))
+                {
+                    TestU++;
+                }
+                
+                if (TestU < MaxU)
+                {
+                    break;
+                }
             }
             
+            const FIntVector QuadSize(MaxU - U, MaxV - V, 1);
+            OutQuads.Emplace(MaskToVoxelPosition(U, V, SliceIndex, Face), QuadSize, Face, StartMask.Material);
+            
             // Mark the area as processed
-            MarkQuadProcessed(Mask, MaskDimensions, StartPos, QuadSize);
+            for (int32 ClearV = V; ClearV < MaxV; ClearV++)
+            {
+                FFaceMask* Row = Mask + ClearV * SizeU;
+                for (int32 ClearU = U; ClearU < MaxU; ClearU++)
+                {
+                    Row[ClearU].bVisible = false;
+                }
+            }
         }
     }
 }
 
-FIntVector FVoxelGreedyMesher::ExtendQuad(
-    const TArray<FFaceMask>& Mask,
-    const FIntVector& MaskDimensions,
-    const FIntVector& StartPos,
-    EVoxelMaterial Material)
+void FVoxelGreedyMesher::GenerateColumnQuads(
+    const FVoxelChunkData& ChunkData,
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    const FVoxelMaterialTraits* Traits)
 {
-    FIntVector QuadSize(1, 1, 1);
+    VOXEL_TRACE_SCOPE(Voxel_ColumnQuads);
+    
+    const FVoxelRuntimeChunkDims Dims(ChunkData.ChunkSize);
     
-    // First, extend along U axis
-    int32 MaxU = StartPos.X + 1;
-    while (MaxU < MaskDimensions.X)
+    // Sized for the whole chunk so the cap faces can fill every slice in one sweep over the columns.
+    // Extraction clears each cell it covers, so the mask is blank again after every slice
+    TArray<FFaceMask> Mask;
+    Mask.SetNum(Dims.Count());
+    
+    ProcessColumnSideFaces<EVoxelFace::Front>(ChunkData.Columns, Dims, Mask.GetData(), OutQuads, bMergeAcrossMaterials, Traits);
+    ProcessColumnSideFaces<EVoxelFace::Back>(ChunkData.Columns, Dims, Mask.GetData(), OutQuads, bMergeAcrossMaterials, Traits);
+    ProcessColumnSideFaces<EVoxelFace::Right>(ChunkData.Columns, Dims, Mask.GetData(), OutQuads, bMergeAcrossMaterials, Traits);
+    ProcessColumnSideFaces<EVoxelFace::Left>(ChunkData.Columns, Dims, Mask.GetData(), OutQuads, bMergeAcrossMaterials, Traits);
+    ProcessColumnCapFaces<EVoxelFace::Top>(ChunkData.Columns, Dims, Mask.GetData(), OutQuads, bMergeAcrossMaterials, Traits);
+    ProcessColumnCapFaces<EVoxelFace::Bottom>(ChunkData.Columns, Dims, Mask.GetData(), OutQuads, bMergeAcrossMaterials, Traits);
+}
+
+namespace VoxelGreedyKernels
+{
+    // Same rule as CreateFaceMask's opaque pass, for a face whose neighbor is inside the chunk
+    FORCEINLINE bool IsOpaqueFaceVisible(EVoxelMaterial Material, EVoxelMaterial NeighborMaterial, const FVoxelMaterialTraits* Traits)
     {
-        const int32 TestIndex = GetMaskIndex(MaxU, StartPos.Y, MaskDimensions);
-        const FFaceMask& TestMask = Mask[TestIndex];
-        
-        if (!TestMask.bVisible || TestMask.Material != Material)
-        {
-            break;
-        }
-        
-        MaxU++;
+        return !Traits[(uint8)NeighborMaterial].bOpaque && (Material != NeighborMaterial || !Traits[(uint8)Material].bCullSameMaterial);
     }
-    QuadSize.X = MaxU - StartPos.X;
     
-    // Then, extend along V axis
-    int32 MaxV = StartPos.Y + 1;
-    while (MaxV < MaskDimensions.Y)
+    FORCEINLINE bool IsOpaqueMeshed(EVoxelMaterial Material, const FVoxelMaterialTraits* Traits)
     {
-        // Check if entire row can be added
-        bool bCanExtend = true;
-        for (int32 U = StartPos.X; U < StartPos.X + QuadSize.X; U++)
+        return Traits[(uint8)Material].bSolid && !Traits[(uint8)Material].bTranslucent;
+    }
+}
+
+template<EVoxelFace Face>
+void FVoxelGreedyMesher::ProcessColumnSideFaces(
+    const FVoxelColumnChunk& Columns,
+    const FVoxelRuntimeChunkDims& Dims,
+    FFaceMask* Mask,
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    const FVoxelMaterialTraits* Traits)
+{
+    constexpr int32 PrimaryAxis = VoxelGreedyKernels::GetPrimaryAxis(Face);
+    constexpr int32 UAxis = VoxelGreedyKernels::GetUAxis(Face);
+    constexpr int32 Sign = VoxelGreedyKernels::GetFaceSign(Face);
+    
+    const int32 SizeU = Dims.Size(UAxis);
+    
+    for (int32 Slice = 0; Slice < Dims.Size(PrimaryAxis); Slice++)
+    {
+        const int32 NeighborSlice = Slice + Sign;
+        const bool bNeighborOutside = NeighborSlice < 0 || NeighborSlice >= Dims.Size(PrimaryAxis);
+        bool bAnyVisible = false;
+        
+        for (int32 U = 0; U < SizeU; U++)
         {
-            const int32 TestIndex = GetMaskIndex(U, MaxV, MaskDimensions);
-            const FFaceMask& TestMask = Mask[TestIndex];
+            int32 Position[2];
+            Position[PrimaryAxis] = Slice;
+            Position[UAxis] = U;
+            const TConstArrayView<FVoxelColumnSpan> Column = Columns.GetColumn(Position[0], Position[1]);
             
-            if (!TestMask.bVisible || TestMask.Material != Material)
+            // Border faces are always visible, as in the dense kernels
+            TConstArrayView<FVoxelColumnSpan> Neighbor;
+            if (!bNeighborOutside)
             {
-                bCanExtend = false;
-                break;
+                Position[PrimaryAxis] = NeighborSlice;
+                Neighbor = Columns.GetColumn(Position[0], Position[1]);
+            }
+            
+            // Walk both columns together; each overlap of two spans is one run of identical faces
+            int32 NeighborIndex = 0;
+            int32 NeighborEnd = Neighbor.Num() > 0 ? Neighbor[0].Length : MAX_int32;
+            int32 Z = 0;
+            for (const FVoxelColumnSpan& Span : Column)
+            {
+                const int32 SpanEnd = Z + Span.Length;
+                if (!VoxelGreedyKernels::IsOpaqueMeshed(Span.Material, Traits))
+                {
+                    Z = SpanEnd;
+                    continue;
+                }
+                
+                while (Z < SpanEnd)
+                {
+                    while (NeighborEnd <= Z)
+                    {
+                        NeighborEnd += Neighbor[++NeighborIndex].Length;
+                    }
+                    
+                    const int32 RunEnd = FMath::Min(SpanEnd, NeighborEnd);
+                    if (Neighbor.Num() == 0 || VoxelGreedyKernels::IsOpaqueFaceVisible(Span.Material, Neighbor[NeighborIndex].Material, Traits))
+                    {
+                        for (int32 V = Z; V < RunEnd; V++)
+                        {
+                            Mask[U + V * SizeU] = FFaceMask(Span.Material, true);
+                        }
+                        bAnyVisible = true;
+                    }
+                    Z = RunEnd;
+                }
             }
         }
         
-        if (!bCanExtend)
+        if (bAnyVisible)
         {
-            break;
+            ExtractQuadsFromMask<Face>(Mask, Dims, Slice, OutQuads, bMergeAcrossMaterials, Traits);
         }
-        
-        MaxV++;
     }
-    QuadSize.Y = MaxV - StartPos.Y;
-    
-    return QuadSize;
 }
 
-void FVoxelGreedyMesher::MarkQuadProcessed(
-    TArray<FFaceMask>& Mask,
-    const FIntVector& MaskDimensions,
-    const FIntVector& StartPos,
-    const FIntVector& QuadSize)
+template<EVoxelFace Face>
+void FVoxelGreedyMesher::ProcessColumnCapFaces(
+    const FVoxelColumnChunk& Columns,
+    const FVoxelRuntimeChunkDims& Dims,
+    FFaceMask* Mask,
+    TArray<FGreedyQuad>& OutQuads,
+    bool bMergeAcrossMaterials,
+    const FVoxelMaterialTraits* Traits)
 {
-    for (int32 V = StartPos.Y; V < StartPos.Y + QuadSize.Y; V++)
+    constexpr bool bTop = Face == EVoxelFace::Top;
+    
+    const int32 SizeX = Dims.Size(0);
+    const int32 SliceSize = SizeX * Dims.Size(1);
+    
+    // Only span boundaries carry top and bottom faces, so most slices of a heightfield stay empty
+    TBitArray<> SlicesWithFaces(false, Dims.Size(2));
+    
+    for (int32 Y = 0; Y < Dims.Size(1); Y++)
     {
-        for (int32 U = StartPos.X; U < StartPos.X + QuadSize.X; U++)
+        for (int32 X = 0; X < SizeX; X++)
         {
-            const int32 MaskIndex = GetMaskIndex(U, V, MaskDimensions);
-            Mask[MaskIndex].bVisible = false;
+            const TConstArrayView<FVoxelColumnSpan> Column = Columns.GetColumn(X, Y);
+            FFaceMask* ColumnMask = Mask + X + Y * SizeX;
+            
+            auto MarkFace = [ColumnMask, SliceSize, &SlicesWithFaces](int32 Z, EVoxelMaterial Material)
+            {
+                ColumnMask[Z * SliceSize] = FFaceMask(Material, true);
+                SlicesWithFaces[Z] = true;
+            };
+            
+            int32 Z = 0;
+            for (int32 SpanIndex = 0; SpanIndex < Column.Num(); SpanIndex++)
+            {
+                const FVoxelColumnSpan& Span = Column[SpanIndex];
+                const int32 SpanEnd = Z + Span.Length;
+                
+                if (VoxelGreedyKernels::IsOpaqueMeshed(Span.Material, Traits))
+                {
+                    // Faces inside a run only show for see-through materials that keep their own faces
+                    const bool bInnerFaces = VoxelGreedyKernels::IsOpaqueFaceVisible(Span.Material, Span.Material, Traits);
+                    if (bInnerFaces)
+                    {
+                        for (int32 Inner = Z; Inner < SpanEnd - 1; Inner++)
+                        {
+                            MarkFace(bTop ? Inner : Inner + 1, Span.Material);
+                        }
+                    }
+                    
+                    // The face at the end of the run looks into the next span, or out of the chunk
+                    const int32 NextIndex = bTop ? SpanIndex + 1 : SpanIndex - 1;
+                    if (!Column.IsValidIndex(NextIndex) || VoxelGreedyKernels::IsOpaqueFaceVisible(Span.Material, Column[NextIndex].Material, Traits))
+                    {
+                        MarkFace(bTop ? SpanEnd - 1 : Z, Span.Material);
+                    }
+                }
+                
+                Z = SpanEnd;
+            }
         }
     }
+    
+    for (TConstSetBitIterator<> It(SlicesWithFaces); It; ++It)
+    {
+        ExtractQuadsFromMask<Face>(Mask + It.GetIndex() * SliceSize, Dims, It.GetIndex(), OutQuads, bMergeAcrossMaterials, Traits);
+    }
 }
 
 void FVoxelGreedyMesher::GetFaceAxes(EVoxelFace Face, int32& PrimaryAxis, int32& UAxis, int32& VAxis)
@@ -282,49 +583,6 @@ FIntVector FVoxelGreedyMesher::MaskToVoxelPosition(
     return Position;
 }
 
-bool FVoxelGreedyMesher::IsFaceVisible(
-    const FVoxelChunkData& ChunkData,
-    int32 X, int32 Y, int32 Z,
-    EVoxelFace Face)
-{
-    const FVoxel CurrentVoxel = ChunkData.GetVoxel(X, Y, Z);
-    if (CurrentVoxel.IsAir())
-    {
-        return false;
-    }
-    
-    // Get the direction offset for this face
-    FIntVector Offset;
-    switch (Face)
-    {
-        case EVoxelFace::Front:  Offset = FIntVector(0, 1, 0); break;   // +Y
-        case EVoxelFace::Back:   Offset = FIntVector(0, -1, 0); break;  // -Y
-        case EVoxelFace::Right:  Offset = FIntVector(1, 0, 0); break;   // +X
-        case EVoxelFace::Left:   Offset = FIntVector(-1, 0, 0); break;  // -X
-        case EVoxelFace::Top:    Offset = FIntVector(0, 0, 1); break;   // +Z
-        case EVoxelFace::Bottom: Offset = FIntVector(0, 0, -1); break;  // -Z
-        default: Offset = FIntVector::ZeroValue; break;
-    }
-    
-    int32 NeighborX = X + Offset.X;
-    int32 NeighborY = Y + Offset.Y;
-    int32 NeighborZ = Z + Offset.Z;
-    
-    // Check if neighbor is out of bounds - if so, face is visible
-    if (NeighborX < 0 || NeighborX >= ChunkData.ChunkSize.X ||
-        NeighborY < 0 || NeighborY >= ChunkData.ChunkSize.Y ||
-        NeighborZ < 0 || NeighborZ >= ChunkData.ChunkSize.Z)
-    {
-        return true; // Face is at chunk boundary, so it's visible
-    }
-    
-    const FVoxel NeighborVoxel = ChunkData.GetVoxel(NeighborX, NeighborY, NeighborZ);
-    
-    // Face is visible if neighbor is air or transparent with different material
-    return NeighborVoxel.IsAir() || 
-           (NeighborVoxel.IsTransparent() && CurrentVoxel.Material != NeighborVoxel.Material);
-}
-
 FVoxel FVoxelGreedyMesher::GetNeighborVoxel(
     const FVoxelChunkData& ChunkData,
     int32 X, int32 Y, int32 Z,
@@ -377,6 +635,8 @@ void FVoxelGreedyMesher::ConvertQuadsToMesh(
     FVoxelMeshData& OutMeshData,
     float VoxelSize)
 {
+    VOXEL_TRACE_SCOPE(Voxel_ConvertQuadsToMesh);
+    
     OutMeshData.Clear();
     
     // Vertex deduplication map: Position -> Vertex Index
@@ -691,8 +951,12 @@ void FVoxelGreedyMesher::GenerateGreedyMeshFromData(
     const TArray<EVoxelMaterial>& VoxelData,
     const FVoxelChunkSize& ChunkSize,
     float VoxelSize,
-    FVoxelMeshData& OutMeshData)
+    FVoxelMeshData& OutMeshData,
+    const FVoxelMaterialTraitTable* Traits,
+    bool bMergeAcrossMaterials)
 {
+    VOXEL_TRACE_SCOPE(Voxel_GreedyMeshFromData);
+    
     // Create a temporary chunk data structure
     FVoxelChunkData TempChunkData;
     TempChunkData.ChunkSize = ChunkSize;
@@ -707,8 +971,20 @@ void FVoxelGreedyMesher::GenerateGreedyMeshFromData(
     
     // Generate greedy quads
     TArray<FGreedyQuad> Quads;
-    GenerateGreedyMesh(TempChunkData, Quads);
+    GenerateGreedyMesh(TempChunkData, Quads, bMergeAcrossMaterials, EVoxelDataLayout::Preferred, Traits);
     
     // Convert quads to mesh
     ConvertQuadsToMesh(Quads, OutMeshData, VoxelSize);
+    
+    // Merged quads read their materials from the downsampled volume
+    if (bMergeAcrossMaterials)
+    {
+        OutMeshData.MaterialVolume.Build(TempChunkData, VoxelSize);
+    }
+    
+    // Water and ice for the translucent section
+    FVoxelMeshGenerator::FGenerationConfig Config;
+    Config.VoxelSize = VoxelSize;
+    Config.MaterialTraits = Traits;
+    FVoxelMeshGenerator::GenerateTranslucentMesh(TempChunkData, OutMeshData, Config);
 }
\ No newline at end of file
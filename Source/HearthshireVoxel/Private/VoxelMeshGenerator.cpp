@@ -1,25 +1,52 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VoxelMeshGenerator.h"
+#include "VoxelTrace.h"
 #include "VoxelGreedyMesher.h"
+#include "VoxelChunkKernels.h"
 #include "VoxelPerformanceStats.h"
 #include "ProceduralMeshComponent.h"
 #include "Logging/LogMacros.h"
 #include "HearthshireVoxelModule.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarVoxelMeshLayout(
+    TEXT("voxel.Layout.Mesh"),
+    0,
+    TEXT("Voxel order the greedy mesher reads. 0: linear, 1: 4x4x4 tiles (converted per chunk)"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarVoxelDownsampleLayout(
+    TEXT("voxel.Layout.Downsample"),
+    0,
+    TEXT("Voxel order LOD downsampling reads. 0: linear, 1: 4x4x4 tiles (converted per chunk)"),
+    ECVF_Default);
 
 // FVoxelMeshGenerator Implementation
 
 void FVoxelMeshGenerator::GenerateBasicMesh(
-    const FVoxelChunkData& ChunkData,
+    const FVoxelChunkData& SourceChunkData,
     FVoxelMeshData& OutMeshData,
     const FGenerationConfig& Config)
 {
 #if VOXEL_ENABLE_STATS
     SCOPE_CYCLE_COUNTER(STAT_VoxelMeshGeneration);
 #endif
+    VOXEL_TRACE_SCOPE(Voxel_GenerateBasicMesh);
     
     const double StartTime = FPlatformTime::Seconds();
     
+    // Every voxel reads six neighbors - expand column storage once instead of walking spans for each
+    TOptional<FVoxelChunkData> ExpandedData;
+    if (SourceChunkData.IsColumnStored())
+    {
+        ExpandedData.Emplace();
+        ExpandedData->ChunkSize = SourceChunkData.ChunkSize;
+        ExpandedData->ChunkPosition = SourceChunkData.ChunkPosition;
+        SourceChunkData.Columns.ToDense(ExpandedData->Voxels);
+    }
+    const FVoxelChunkData& ChunkData = ExpandedData.IsSet() ? ExpandedData.GetValue() : SourceChunkData;
+    
     OutMeshData.Clear();
     
     // Reserve space for worst case
@@ -31,6 +58,7 @@ void FVoxelMeshGenerator::GenerateBasicMesh(
     
     int32 SolidVoxelCount = 0;
     int32 FacesGenerated = 0;
+    const FVoxelMaterialTraitTable& Traits = Config.MaterialTraits ? *Config.MaterialTraits : FVoxelMaterialTraitTable::GetDefault();
     
     // Iterate through all voxels
     for (int32 Z = 0; Z < ChunkData.ChunkSize.Z; Z++)
@@ -41,8 +69,8 @@ void FVoxelMeshGenerator::GenerateBasicMesh(
             {
                 const FVoxel Voxel = ChunkData.GetVoxel(X, Y, Z);
                 
-                // Skip air voxels
-                if (Voxel.IsAir())
+                // Skip air voxels - translucent materials go to the translucent pass
+                if (!Traits[Voxel.Material].bSolid || Traits[Voxel.Material].bTranslucent)
                 {
                     continue;
                 }
@@ -55,7 +83,7 @@ void FVoxelMeshGenerator::GenerateBasicMesh(
                 {
                     EVoxelFace Face = static_cast<EVoxelFace>(FaceIndex);
                     
-                    if (IsFaceVisible(ChunkData, X, Y, Z, Face))
+                    if (IsFaceVisible(ChunkData, X, Y, Z, Face, Traits))
                     {
                         AddFace(OutMeshData, Position, Face, Voxel.Material, Config.VoxelSize);
                         FacesGenerated++;
@@ -68,6 +96,8 @@ void FVoxelMeshGenerator::GenerateBasicMesh(
     UE_LOG(LogHearthshireVoxel, Log, TEXT("GenerateBasicMesh: Solid voxels: %d, Faces generated: %d"), 
         SolidVoxelCount, FacesGenerated);
     
+    GenerateRefinedMesh(ChunkData, OutMeshData, Config);
+    
     // Post-processing
     if (Config.bOptimizeIndices)
     {
@@ -79,6 +109,8 @@ void FVoxelMeshGenerator::GenerateBasicMesh(
         CalculateTangents(OutMeshData);
     }
     
+    GenerateTranslucentMesh(ChunkData, OutMeshData, Config);
+    
     // Update stats
     OutMeshData.TriangleCount = OutMeshData.Triangles.Num() / 3;
     OutMeshData.VertexCount = OutMeshData.Vertices.Num();
@@ -93,16 +125,27 @@ void FVoxelMeshGenerator::GenerateGreedyMesh(
 #if VOXEL_ENABLE_STATS
     SCOPE_CYCLE_COUNTER(STAT_GreedyMeshing);
 #endif
+    VOXEL_TRACE_SCOPE(Voxel_GenerateGreedyMesh);
     
     const double StartTime = FPlatformTime::Seconds();
     
     // Generate greedy quads
     TArray<FVoxelGreedyMesher::FGreedyQuad> Quads;
-    FVoxelGreedyMesher::GenerateGreedyMesh(ChunkData, Quads);
+    FVoxelGreedyMesher::GenerateGreedyMesh(ChunkData, Quads, Config.bMergeAcrossMaterials, Config.Layout, Config.MaterialTraits);
     
     // Convert quads to mesh
     FVoxelGreedyMesher::ConvertQuadsToMesh(Quads, OutMeshData, Config.VoxelSize);
     
+    GenerateRefinedMesh(ChunkData, OutMeshData, Config);
+    
+    // Merged quads span several materials - pack them for per-pixel lookup
+    if (Config.bMergeAcrossMaterials)
+    {
+        OutMeshData.MaterialVolume.Build(ChunkData, Config.VoxelSize);
+    }
+    
+    GenerateTranslucentMesh(ChunkData, OutMeshData, Config);
+    
     
     // Post-processing
     if (Config.bGenerateTangents)
@@ -117,15 +160,281 @@ void FVoxelMeshGenerator::GenerateGreedyMesh(
     
 }
 
+void FVoxelMeshGenerator::GenerateTranslucentMesh(
+    const FVoxelChunkData& ChunkData,
+    FVoxelMeshData& OutMeshData,
+    const FGenerationConfig& Config)
+{
+    VOXEL_TRACE_SCOPE(Voxel_GenerateTranslucentMesh);
+    
+    OutMeshData.Translucent.Clear();
+    
+    // Always greedy - water surfaces are large and flat
+    TArray<FVoxelGreedyMesher::FGreedyQuad> Quads;
+    FVoxelGreedyMesher::GenerateTranslucentQuads(ChunkData, Quads, Config.Layout, Config.MaterialTraits);
+    if (Quads.Num() == 0)
+    {
+        return;
+    }
+    
+    FVoxelMeshData TranslucentData;
+    FVoxelGreedyMesher::ConvertQuadsToMesh(Quads, TranslucentData, Config.VoxelSize);
+    
+    FVoxelTranslucentMeshData& Translucent = OutMeshData.Translucent;
+    Translucent.Vertices = MoveTemp(TranslucentData.Vertices);
+    Translucent.Triangles = MoveTemp(TranslucentData.Triangles);
+    Translucent.Normals = MoveTemp(TranslucentData.Normals);
+    Translucent.UV0 = MoveTemp(TranslucentData.UV0);
+    Translucent.Tangents = MoveTemp(TranslucentData.Tangents);
+    Translucent.VertexColors = MoveTemp(TranslucentData.VertexColors);
+}
+
+void FVoxelMeshGenerator::GenerateRefinedMesh(
+    const FVoxelChunkData& ChunkData,
+    FVoxelMeshData& OutMeshData,
+    const FGenerationConfig& Config)
+{
+    if (ChunkData.Refinement.IsEmpty())
+    {
+        return;
+    }
+    
+    VOXEL_TRACE_SCOPE(Voxel_GenerateRefinedMesh);
+    
+    const FVoxelMaterialTraitTable& Traits = Config.MaterialTraits ? *Config.MaterialTraits : FVoxelMaterialTraitTable::GetDefault();
+    const int32 SizeXY = ChunkData.ChunkSize.X * ChunkData.ChunkSize.Y;
+    
+    // One sub-grid buffer reused by every cell
+    FVoxelChunkData SubGrid;
+    TArray<FVoxelGreedyMesher::FGreedyQuad> Quads;
+    FVoxelMeshData CellMesh;
+    
+    for (const TPair<int32, FVoxelRefinedCell>& Pair : ChunkData.Refinement.GetCells())
+    {
+        const FVoxelRefinedCell& Cell = Pair.Value;
+        const int32 R = Cell.Resolution;
+        const FIntVector CellCoord(Pair.Key % ChunkData.ChunkSize.X, (Pair.Key / ChunkData.ChunkSize.X) % ChunkData.ChunkSize.Y, Pair.Key / SizeXY);
+        
+        SubGrid.ChunkSize = FVoxelChunkSize(R);
+        SubGrid.Voxels.SetNumUninitialized(Cell.GetSubVoxelCount());
+        for (int32 SubIndex = 0; SubIndex < Cell.GetSubVoxelCount(); SubIndex++)
+        {
+            SubGrid.Voxels[SubIndex] = FVoxel(Cell.Get(SubIndex));
+        }
+        
+        Quads.Reset();
+        FVoxelGreedyMesher::GenerateGreedyMesh(SubGrid, Quads, false, EVoxelDataLayout::Linear, Config.MaterialTraits);
+        
+        // Faces on the cell border are hidden by an opaque voxel next to it
+        Quads.RemoveAllSwap([&](const FVoxelGreedyMesher::FGreedyQuad& Quad)
+        {
+            const FIntVector Direction = GetFaceDirection(Quad.Face);
+            const int32 Axis = Direction.X != 0 ? 0 : (Direction.Y != 0 ? 1 : 2);
+            const bool bOnBorder = Direction[Axis] > 0 ? Quad.Position[Axis] == R - 1 : Quad.Position[Axis] == 0;
+            if (!bOnBorder)
+            {
+                return false;
+            }
+            
+            const FIntVector Neighbor = CellCoord + Direction;
+            return Traits[ChunkData.GetVoxel(Neighbor.X, Neighbor.Y, Neighbor.Z).Material].bOpaque != 0;
+        });
+        
+        if (Quads.Num() == 0)
+        {
+            continue;
+        }
+        
+        FVoxelGreedyMesher::ConvertQuadsToMesh(Quads, CellMesh, Config.VoxelSize / R);
+        
+        // Cell-local to chunk space; UVs keep the whole-voxel tiling of the surrounding faces
+        const FVector Offset = FVector(CellCoord) * Config.VoxelSize;
+        const int32 BaseVertex = OutMeshData.Vertices.Num();
+        for (int32 Index = 0; Index < CellMesh.Vertices.Num(); Index++)
+        {
+            const FVector& Normal = CellMesh.Normals[Index];
+            const FVector2D UVOffset = FMath::Abs(Normal.Y) > 0.5f ? FVector2D(CellCoord.X, CellCoord.Z)
+                : (FMath::Abs(Normal.X) > 0.5f ? FVector2D(CellCoord.Y, CellCoord.Z) : FVector2D(CellCoord.X, CellCoord.Y));
+            
+            OutMeshData.Vertices.Add(CellMesh.Vertices[Index] + Offset);
+            OutMeshData.Normals.Add(Normal);
+            OutMeshData.UV0.Add(CellMesh.UV0[Index] / R + UVOffset);
+            OutMeshData.Tangents.Add(CellMesh.Tangents[Index]);
+            OutMeshData.VertexColors.Add(CellMesh.VertexColors[Index]);
+        }
+        
+        OutMeshData.Triangles.Reserve(OutMeshData.Triangles.Num() + CellMesh.Triangles.Num());
+        for (const int32 VertexIndex : CellMesh.Triangles)
+        {
+            OutMeshData.Triangles.Add(BaseVertex + VertexIndex);
+        }
+        
+        for (const TPair<EVoxelMaterial, int32>& Section : CellMesh.MaterialSections)
+        {
+            GetOrCreateMaterialSection(OutMeshData, Section.Key);
+        }
+    }
+}
+
 void FVoxelMeshGenerator::GenerateLODMesh(
     const FVoxelChunkData& ChunkData,
     FVoxelMeshData& OutMeshData,
     int32 LODLevel,
     const FGenerationConfig& Config)
 {
-    // TODO: Implement LOD generation
-    // For now, just use basic mesh generation
-    GenerateBasicMesh(ChunkData, OutMeshData, Config);
+    if (LODLevel <= 0)
+    {
+        GenerateGreedyMesh(ChunkData, OutMeshData, Config);
+        return;
+    }
+    
+    const int32 BlockSize = 1 << FMath::Min(LODLevel, 2);
+    
+    TArray<EVoxelMaterial> LODVoxels;
+    FVoxelChunkSize LODSize;
+    DownsampleVoxels(ChunkData, BlockSize, LODVoxels, LODSize, Config.Layout);
+    
+    FVoxelGreedyMesher::GenerateGreedyMeshFromData(LODVoxels, LODSize, Config.VoxelSize * BlockSize, OutMeshData, Config.MaterialTraits,
+        Config.bMergeAcrossMaterials);
+}
+
+namespace VoxelMeshKernels
+{
+    // Majority vote per block. Block rows are contiguous in both layouts for blocks of up to 4
+    template<typename DimsType>
+    void DownsampleVoxels(const FVoxel* Voxels, const DimsType& Dims, int32 BlockSize, const FVoxelChunkSize& OutSize, EVoxelMaterial* OutVoxels)
+    {
+        // Materials in first-seen order so ties resolve the same way every time
+        TArray<EVoxelMaterial, TInlineAllocator<64>> Seen;
+        TArray<int32, TInlineAllocator<64>> Counts;
+        
+        for (int32 LODz = 0; LODz < OutSize.Z; LODz++)
+        {
+            for (int32 LODy = 0; LODy < OutSize.Y; LODy++)
+            {
+                for (int32 LODx = 0; LODx < OutSize.X; LODx++)
+                {
+                    Seen.Reset();
+                    Counts.Reset();
+                    
+                    for (int32 bz = 0; bz < BlockSize; bz++)
+                    {
+                        for (int32 by = 0; by < BlockSize; by++)
+                        {
+                            const FVoxel* Row = Voxels + Dims.Index(LODx * BlockSize, LODy * BlockSize + by, LODz * BlockSize + bz);
+                            for (int32 bx = 0; bx < BlockSize; bx++)
+                            {
+                                const EVoxelMaterial Mat = Row[bx].Material;
+                                
+                                const int32 SeenIndex = Seen.Find(Mat);
+                                if (SeenIndex == INDEX_NONE)
+                                {
+                                    Seen.Add(Mat);
+                                    Counts.Add(1);
+                                }
+                                else
+                                {
+                                    Counts[SeenIndex]++;
+                                }
+                            }
+                        }
+                    }
+                    
+                    // Most common non-air material; air only when the block is empty
+                    EVoxelMaterial MostCommon = EVoxelMaterial::Air;
+                    int32 MaxCount = 0;
+                    for (int32 i = 0; i < Seen.Num(); i++)
+                    {
+                        if (Counts[i] > MaxCount && Seen[i] != EVoxelMaterial::Air)
+                        {
+                            MaxCount = Counts[i];
+                            MostCommon = Seen[i];
+                        }
+                    }
+                    
+                    OutVoxels[LODx + LODy * OutSize.X + LODz * OutSize.X * OutSize.Y] = MostCommon;
+                }
+            }
+        }
+    }
+}
+
+void FVoxelMeshGenerator::DownsampleVoxels(
+    const FVoxelChunkData& ChunkData,
+    int32 BlockSize,
+    TArray<EVoxelMaterial>& OutVoxels,
+    FVoxelChunkSize& OutSize,
+    EVoxelDataLayout Layout)
+{
+    VOXEL_TRACE_SCOPE(Voxel_DownsampleVoxels);
+    
+    BlockSize = FMath::Max(BlockSize, 1);
+    const FVoxelChunkSize& OriginalSize = ChunkData.ChunkSize;
+    OutSize = FVoxelChunkSize(OriginalSize.X / BlockSize, OriginalSize.Y / BlockSize, OriginalSize.Z / BlockSize);
+    OutVoxels.SetNum(OutSize.GetVoxelCount());
+    
+    if (!ChunkData.HasVoxelData())
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("DownsampleVoxels: Chunk %s has %d voxels, expected %d"),
+            *ChunkData.ChunkPosition.ToString(), ChunkData.Voxels.Num(), OriginalSize.GetVoxelCount());
+        return;
+    }
+    
+    // Refined voxels vote as their representative material and column storage is expanded - both on a copy
+    // so the common case reads in place
+    TOptional<FVoxelChunkData> ResolvedData;
+    if (!ChunkData.Refinement.IsEmpty() || ChunkData.IsColumnStored())
+    {
+        ResolvedData.Emplace();
+        ResolvedData->ChunkSize = OriginalSize;
+        ResolvedData->ChunkPosition = ChunkData.ChunkPosition;
+        if (ChunkData.IsColumnStored())
+        {
+            ChunkData.Columns.ToDense(ResolvedData->Voxels);
+        }
+        else
+        {
+            ResolvedData->Voxels = ChunkData.Voxels;
+        }
+        ChunkData.Refinement.ResolveRepresentatives(ResolvedData->Voxels);
+    }
+    const FVoxelChunkData& SourceData = ResolvedData.IsSet() ? ResolvedData.GetValue() : ChunkData;
+    
+    // Blocks must not straddle tiles
+    TArray<FVoxel> TiledVoxels;
+    if ((BlockSize == 2 || BlockSize == 4) &&
+        ResolveLayout(Layout, EVoxelLayoutPass::Downsample, OriginalSize) == EVoxelDataLayout::Tiled &&
+        VoxelChunkKernels::ConvertToTiled(SourceData, TiledVoxels))
+    {
+        DispatchVoxelTiledKernel(OriginalSize, [&](const auto& Dims)
+        {
+            VoxelMeshKernels::DownsampleVoxels(TiledVoxels.GetData(), Dims, BlockSize, OutSize, OutVoxels.GetData());
+        });
+        return;
+    }
+    
+    DispatchVoxelChunkKernel(OriginalSize, [&](const auto& Dims)
+    {
+        VoxelMeshKernels::DownsampleVoxels(SourceData.Voxels.GetData(), Dims, BlockSize, OutSize, OutVoxels.GetData());
+    });
+}
+
+EVoxelDataLayout FVoxelMeshGenerator::ResolveLayout(EVoxelDataLayout Layout, EVoxelLayoutPass Pass, const FVoxelChunkSize& ChunkSize)
+{
+    if (Layout == EVoxelDataLayout::Preferred)
+    {
+        const int32 Preferred = Pass == EVoxelLayoutPass::Mesh
+            ? CVarVoxelMeshLayout.GetValueOnAnyThread()
+            : CVarVoxelDownsampleLayout.GetValueOnAnyThread();
+        Layout = Preferred == 1 ? EVoxelDataLayout::Tiled : EVoxelDataLayout::Linear;
+    }
+    
+    // Other chunk sizes have no tiled form
+    if (Layout == EVoxelDataLayout::Tiled && !VoxelChunkKernels::SupportsTiledLayout(ChunkSize))
+    {
+        return EVoxelDataLayout::Linear;
+    }
+    return Layout;
 }
 
 void FVoxelMeshGenerator::ApplyMeshToComponent(
@@ -133,6 +442,8 @@ void FVoxelMeshGenerator::ApplyMeshToComponent(
     const FVoxelMeshData& MeshData,
     UVoxelMaterialSet* MaterialSet)
 {
+    VOXEL_TRACE_SCOPE(Voxel_ApplyMeshToComponent);
+    
     if (!Component)
     {
         UE_LOG(LogHearthshireVoxel, Error, TEXT("ApplyMeshToComponent: Component is null"));
@@ -141,9 +452,15 @@ void FVoxelMeshGenerator::ApplyMeshToComponent(
     
     Component->ClearAllMeshSections();
     
+    // Water and ice first - a chunk may be nothing but water
+    ApplyTranslucentSection(Component, MeshData, MaterialSet);
+    
     if (MeshData.Vertices.Num() == 0)
     {
-        UE_LOG(LogHearthshireVoxel, Warning, TEXT("ApplyMeshToComponent: No vertices to apply"));
+        if (MeshData.Translucent.IsEmpty())
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ApplyMeshToComponent: No vertices to apply"));
+        }
         return;
     }
     
@@ -171,6 +488,8 @@ void FVoxelMeshGenerator::ApplyMeshToComponent(
         }
         
         // Create a single mesh section with all data (fallback for basic visibility)
+        // The opaque section cooks collision, so its body setup is tagged as collision memory
+        VOXEL_LLM_SCOPE(Collision);
         Component->CreateMeshSection(
             0, // Section index
             MeshData.Vertices,
@@ -211,6 +530,7 @@ void FVoxelMeshGenerator::ApplyMeshToComponent(
         }
         
         // Create a single mesh section with all geometry
+        VOXEL_LLM_SCOPE(Collision);
         Component->CreateMeshSection(
             0, // Single section index
             MeshData.Vertices,
@@ -242,6 +562,39 @@ void FVoxelMeshGenerator::ApplyMeshToComponent(
     Component->MarkRenderStateDirty();
 }
 
+void FVoxelMeshGenerator::ApplyTranslucentSection(
+    UProceduralMeshComponent* Component,
+    const FVoxelMeshData& MeshData,
+    UVoxelMaterialSet* MaterialSet)
+{
+    const FVoxelTranslucentMeshData& Translucent = MeshData.Translucent;
+    if (Translucent.IsEmpty())
+    {
+        return;
+    }
+    
+    // No collision - characters pass through water
+    Component->CreateMeshSection(
+        TranslucentSectionIndex,
+        Translucent.Vertices,
+        Translucent.Triangles,
+        Translucent.Normals,
+        Translucent.UV0,
+        Translucent.VertexColors,
+        Translucent.Tangents,
+        false
+    );
+    
+    if (MaterialSet)
+    {
+        UMaterialInterface* Material = MaterialSet->TranslucentMaterial ? MaterialSet->TranslucentMaterial : MaterialSet->GetMaterial(EVoxelMaterial::Water);
+        if (Material)
+        {
+            Component->SetMaterial(TranslucentSectionIndex, Material);
+        }
+    }
+}
+
 void FVoxelMeshGenerator::AddFace(
     FVoxelMeshData& MeshData,
     const FVector& Position,
@@ -335,11 +688,12 @@ int32 FVoxelMeshGenerator::AddVertex(
 bool FVoxelMeshGenerator::IsFaceVisible(
     const FVoxelChunkData& ChunkData,
     int32 X, int32 Y, int32 Z,
-    EVoxelFace Face)
+    EVoxelFace Face,
+    const FVoxelMaterialTraitTable& Traits)
 {
     // First check if the current voxel is solid
     FVoxel CurrentVoxel = ChunkData.GetVoxel(X, Y, Z);
-    if (CurrentVoxel.IsAir())
+    if (!Traits[CurrentVoxel.Material].bSolid)
     {
         return false; // Air voxels don't generate faces
     }
@@ -361,9 +715,9 @@ bool FVoxelMeshGenerator::IsFaceVisible(
     // Get the neighbor voxel
     FVoxel Neighbor = ChunkData.GetVoxel(NeighborX, NeighborY, NeighborZ);
     
-    // Face is visible if neighbor is air or transparent with different material
-    return Neighbor.IsAir() || 
-           (Neighbor.IsTransparent() && CurrentVoxel.Material != Neighbor.Material);
+    // Face is visible if the neighbor lets light through, unless it is the same material and that material culls itself
+    return !Traits[Neighbor.Material].bOpaque &&
+           (CurrentVoxel.Material != Neighbor.Material || !Traits[CurrentVoxel.Material].bCullSameMaterial);
 }
 
 FVoxel FVoxelMeshGenerator::GetNeighborVoxel(
@@ -4,20 +4,156 @@
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "HAL/IConsoleManager.h"
+#include "HearthshireVoxelModule.h"
 
 // Define stats
 DEFINE_STAT(STAT_VoxelMeshGeneration);
 DEFINE_STAT(STAT_GreedyMeshing);
 DEFINE_STAT(STAT_ChunkUpdate);
 DEFINE_STAT(STAT_VoxelMemory);
+DEFINE_STAT(STAT_DetailScatter);
 DEFINE_STAT(STAT_ActiveChunks);
 DEFINE_STAT(STAT_TotalTriangles);
 DEFINE_STAT(STAT_TotalVertices);
 DEFINE_STAT(STAT_TriangleReduction);
 
+LLM_DEFINE_TAG(Voxel);
+LLM_DEFINE_TAG(Voxel_Data, TEXT("Voxel/Data"), TEXT("Voxel"));
+LLM_DEFINE_TAG(Voxel_MeshCPU, TEXT("Voxel/MeshCPU"), TEXT("Voxel"));
+LLM_DEFINE_TAG(Voxel_MeshGPU, TEXT("Voxel/MeshGPU"), TEXT("Voxel"));
+LLM_DEFINE_TAG(Voxel_Collision, TEXT("Voxel/Collision"), TEXT("Voxel"));
+LLM_DEFINE_TAG(Voxel_Cache, TEXT("Voxel/Cache"), TEXT("Voxel"));
+LLM_DEFINE_TAG(Voxel_Templates, TEXT("Voxel/Templates"), TEXT("Voxel"));
+LLM_DEFINE_TAG(Voxel_Scratch, TEXT("Voxel/Scratch"), TEXT("Voxel"));
+
 // Singleton instance
 static FVoxelPerformanceMonitor* GVoxelPerformanceMonitor = nullptr;
 
+static FAutoConsoleCommand VoxelLatencyCommand(
+    TEXT("voxel.latency"),
+    TEXT("Print chunk streaming latency percentiles. 'voxel.latency reset' clears them, 'voxel.latency csv <File>' exports them."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        FVoxelPerformanceMonitor& Monitor = FVoxelPerformanceMonitor::Get();
+        
+        if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+        {
+            Monitor.ResetLatency();
+            UE_LOG(LogHearthshireVoxel, Display, TEXT("Voxel latency histograms reset"));
+        }
+        else if (Args.Num() > 0 && Args[0] == TEXT("csv"))
+        {
+            const FString FilePath = Args.Num() > 1 ? Args[1] :
+                FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Profiling"), TEXT("VoxelLatency.csv"));
+            Monitor.DumpLatencyCSV(FilePath);
+        }
+        else
+        {
+            UE_LOG(LogHearthshireVoxel, Display, TEXT("%s"), *Monitor.GetLatencyReport());
+        }
+    }));
+
+// FVoxelLatencyHistogram Implementation
+
+FVoxelLatencyHistogram::FVoxelLatencyHistogram()
+{
+    Reset();
+}
+
+void FVoxelLatencyHistogram::Record(double Milliseconds)
+{
+    const uint64 Microseconds = (uint64)FMath::Max(Milliseconds * 1000.0, 0.0);
+    
+    Buckets[GetBucketIndex(Microseconds)].fetch_add(1, std::memory_order_relaxed);
+    TotalCount.fetch_add(1, std::memory_order_relaxed);
+    TotalMicroseconds.fetch_add(Microseconds, std::memory_order_relaxed);
+    
+    uint64 PreviousMax = MaxMicroseconds.load(std::memory_order_relaxed);
+    while (Microseconds > PreviousMax &&
+        !MaxMicroseconds.compare_exchange_weak(PreviousMax, Microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+void FVoxelLatencyHistogram::Reset()
+{
+    for (std::atomic<uint64>& Bucket : Buckets)
+    {
+        Bucket.store(0, std::memory_order_relaxed);
+    }
+    
+    TotalCount.store(0, std::memory_order_relaxed);
+    TotalMicroseconds.store(0, std::memory_order_relaxed);
+    MaxMicroseconds.store(0, std::memory_order_relaxed);
+}
+
+double FVoxelLatencyHistogram::GetMeanMs() const
+{
+    const uint64 Count = GetCount();
+    return Count > 0 ? TotalMicroseconds.load(std::memory_order_relaxed) / (Count * 1000.0) : 0.0;
+}
+
+double FVoxelLatencyHistogram::GetMaxMs() const
+{
+    return MaxMicroseconds.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double FVoxelLatencyHistogram::GetPercentileMs(double Percentile) const
+{
+    const uint64 Count = GetCount();
+    if (Count == 0)
+    {
+        return 0.0;
+    }
+    
+    const uint64 Target = FMath::Max<uint64>(1, (uint64)FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 1.0) * Count));
+    
+    uint64 Seen = 0;
+    for (int32 Index = 0; Index < NumBuckets; Index++)
+    {
+        Seen += Buckets[Index].load(std::memory_order_relaxed);
+        if (Seen >= Target)
+        {
+            return FMath::Min(GetBucketUpperBound(Index) / 1000.0, GetMaxMs());
+        }
+    }
+    
+    return GetMaxMs();
+}
+
+int32 FVoxelLatencyHistogram::GetBucketIndex(uint64 Microseconds)
+{
+    if (Microseconds < LinearBucketCount)
+    {
+        return (int32)Microseconds;
+    }
+    
+    // Power of two picks the octave, the next SubBucketBits bits pick the bucket inside it
+    const int32 Exponent = (int32)FMath::FloorLog2_64(Microseconds);
+    const int32 SubBucket = (int32)(Microseconds >> (Exponent - SubBucketBits)) & (SubBucketCount - 1);
+    const int32 Index = LinearBucketCount + (Exponent - SubBucketBits - 1) * SubBucketCount + SubBucket;
+    
+    return FMath::Min(Index, NumBuckets - 1);
+}
+
+uint64 FVoxelLatencyHistogram::GetBucketUpperBound(int32 BucketIndex)
+{
+    if (BucketIndex < LinearBucketCount)
+    {
+        return (uint64)BucketIndex + 1;
+    }
+    
+    const int32 Octave = (BucketIndex - LinearBucketCount) / SubBucketCount;
+    const int32 SubBucket = (BucketIndex - LinearBucketCount) % SubBucketCount;
+    const int32 Exponent = Octave + SubBucketBits + 1;
+    
+    return (uint64)(SubBucketCount + SubBucket + 1) << (Exponent - SubBucketBits);
+}
+
+// FVoxelPerformanceMonitor Implementation
+
 FVoxelPerformanceMonitor& FVoxelPerformanceMonitor::Get()
 {
     if (!GVoxelPerformanceMonitor)
@@ -31,13 +167,24 @@ FVoxelPerformanceMonitor::FVoxelPerformanceMonitor()
 {
     bIsMonitoring = false;
     bCSVLoggingEnabled = false;
+    MonitoringStartCycles = 0;
     
     AverageMeshGenerationMs = 0.0f;
     AverageGreedyMeshingMs = 0.0f;
     AverageTriangleReduction = 0.0f;
     PeakMemoryUsageMB = 0.0f;
     
-    CurrentFrame = FPerformanceFrame();
+    PerformanceHistory.SetNumZeroed(MaxHistoryFrames);
+    HistoryHead = 0;
+    HistoryCount = 0;
+    
+    CurrentFrame.MeshGenerationMicroseconds = 0;
+    CurrentFrame.MeshGenerationCount = 0;
+    CurrentFrame.TriangleCount = 0;
+    CurrentFrame.VertexCount = 0;
+    CurrentFrame.GreedyMeshingMicroseconds = 0;
+    CurrentFrame.GreedyMeshingCount = 0;
+    CurrentFrame.ReductionHundredths = 0;
 }
 
 FVoxelPerformanceMonitor::~FVoxelPerformanceMonitor()
@@ -48,30 +195,49 @@ void FVoxelPerformanceMonitor::StartMonitoring()
 {
     FScopeLock Lock(&HistoryLock);
     
-    bIsMonitoring = true;
-    PerformanceHistory.Empty();
-    CurrentFrame = FPerformanceFrame();
+    HistoryHead = 0;
+    HistoryCount = 0;
+    PeakMemoryUsageMB = 0.0f;
+    
+    CurrentFrame.MeshGenerationMicroseconds.store(0, std::memory_order_relaxed);
+    CurrentFrame.MeshGenerationCount.store(0, std::memory_order_relaxed);
+    CurrentFrame.TriangleCount.store(0, std::memory_order_relaxed);
+    CurrentFrame.VertexCount.store(0, std::memory_order_relaxed);
+    CurrentFrame.GreedyMeshingMicroseconds.store(0, std::memory_order_relaxed);
+    CurrentFrame.GreedyMeshingCount.store(0, std::memory_order_relaxed);
+    CurrentFrame.ReductionHundredths.store(0, std::memory_order_relaxed);
+    
+    // Thread rings are owned by their writers, so older samples are filtered out instead of cleared
+    MonitoringStartCycles.store(FPlatformTime::Cycles64(), std::memory_order_relaxed);
+    bIsMonitoring.store(true, std::memory_order_release);
 }
 
 void FVoxelPerformanceMonitor::StopMonitoring()
 {
     FScopeLock Lock(&HistoryLock);
     
-    bIsMonitoring = false;
+    bIsMonitoring.store(false, std::memory_order_release);
     UpdateStatistics();
 }
 
 void FVoxelPerformanceMonitor::RecordMeshGeneration(float TimeMs, int32 TriangleCount, int32 VertexCount)
 {
-    if (!bIsMonitoring)
+    if (!IsMonitoring())
         return;
     
-    FScopeLock Lock(&HistoryLock);
+    CurrentFrame.MeshGenerationMicroseconds.fetch_add((uint64)FMath::Max(TimeMs * 1000.0f, 0.0f), std::memory_order_relaxed);
+    CurrentFrame.MeshGenerationCount.fetch_add(1, std::memory_order_relaxed);
+    CurrentFrame.TriangleCount.fetch_add(FMath::Max(TriangleCount, 0), std::memory_order_relaxed);
+    CurrentFrame.VertexCount.fetch_add(FMath::Max(VertexCount, 0), std::memory_order_relaxed);
     
-    CurrentFrame.MeshGenerationMs = TimeMs;
-    CurrentFrame.TriangleCount = TriangleCount;
-    CurrentFrame.VertexCount = VertexCount;
-    CurrentFrame.Timestamp = FPlatformTime::Seconds();
+    FSample Sample;
+    Sample.Cycles = FPlatformTime::Cycles64();
+    Sample.TimeMs = TimeMs;
+    Sample.Value = 0.0f;
+    Sample.TriangleCount = TriangleCount;
+    Sample.VertexCount = VertexCount;
+    Sample.Type = ESampleType::MeshGeneration;
+    PushSample(Sample);
     
     SET_FLOAT_STAT(STAT_VoxelMeshGeneration, TimeMs);
     SET_DWORD_STAT(STAT_TotalTriangles, TriangleCount);
@@ -80,13 +246,21 @@ void FVoxelPerformanceMonitor::RecordMeshGeneration(float TimeMs, int32 Triangle
 
 void FVoxelPerformanceMonitor::RecordGreedyMeshing(float TimeMs, float ReductionPercent)
 {
-    if (!bIsMonitoring)
+    if (!IsMonitoring())
         return;
     
-    FScopeLock Lock(&HistoryLock);
+    CurrentFrame.GreedyMeshingMicroseconds.fetch_add((uint64)FMath::Max(TimeMs * 1000.0f, 0.0f), std::memory_order_relaxed);
+    CurrentFrame.GreedyMeshingCount.fetch_add(1, std::memory_order_relaxed);
+    CurrentFrame.ReductionHundredths.fetch_add((uint64)FMath::Max(ReductionPercent * 100.0f, 0.0f), std::memory_order_relaxed);
     
-    CurrentFrame.GreedyMeshingMs = TimeMs;
-    CurrentFrame.TriangleReductionPercent = ReductionPercent;
+    FSample Sample;
+    Sample.Cycles = FPlatformTime::Cycles64();
+    Sample.TimeMs = TimeMs;
+    Sample.Value = ReductionPercent;
+    Sample.TriangleCount = 0;
+    Sample.VertexCount = 0;
+    Sample.Type = ESampleType::GreedyMeshing;
+    PushSample(Sample);
     
     SET_FLOAT_STAT(STAT_GreedyMeshing, TimeMs);
     SET_FLOAT_STAT(STAT_TriangleReduction, ReductionPercent);
@@ -94,34 +268,138 @@ void FVoxelPerformanceMonitor::RecordGreedyMeshing(float TimeMs, float Reduction
 
 void FVoxelPerformanceMonitor::RecordChunkUpdate(int32 ActiveChunks, float MemoryMB)
 {
-    if (!bIsMonitoring)
+    if (!IsMonitoring())
         return;
     
-    FScopeLock Lock(&HistoryLock);
+    // Swap out this frame's totals, anything recorded after the exchange lands in the next frame
+    const uint64 MeshMicroseconds = CurrentFrame.MeshGenerationMicroseconds.exchange(0, std::memory_order_relaxed);
+    const uint64 MeshCount = CurrentFrame.MeshGenerationCount.exchange(0, std::memory_order_relaxed);
+    const uint64 Triangles = CurrentFrame.TriangleCount.exchange(0, std::memory_order_relaxed);
+    const uint64 Vertices = CurrentFrame.VertexCount.exchange(0, std::memory_order_relaxed);
+    const uint64 GreedyMicroseconds = CurrentFrame.GreedyMeshingMicroseconds.exchange(0, std::memory_order_relaxed);
+    const uint64 GreedyCount = CurrentFrame.GreedyMeshingCount.exchange(0, std::memory_order_relaxed);
+    const uint64 Reduction = CurrentFrame.ReductionHundredths.exchange(0, std::memory_order_relaxed);
+    
+    FPerformanceFrame Frame;
+    Frame.Timestamp = FPlatformTime::Seconds();
+    Frame.MeshGenerationMs = MeshCount > 0 ? MeshMicroseconds / (MeshCount * 1000.0f) : 0.0f;
+    Frame.GreedyMeshingMs = GreedyCount > 0 ? GreedyMicroseconds / (GreedyCount * 1000.0f) : 0.0f;
+    Frame.TriangleCount = (int32)FMath::Min<uint64>(Triangles, MAX_int32);
+    Frame.VertexCount = (int32)FMath::Min<uint64>(Vertices, MAX_int32);
+    Frame.TriangleReductionPercent = GreedyCount > 0 ? Reduction / (GreedyCount * 100.0f) : 0.0f;
+    Frame.ActiveChunks = ActiveChunks;
+    Frame.MemoryUsageMB = MemoryMB;
     
-    CurrentFrame.ActiveChunks = ActiveChunks;
-    CurrentFrame.MemoryUsageMB = MemoryMB;
+    {
+        FScopeLock Lock(&HistoryLock);
+        
+        // Overwrite the oldest frame once full
+        PerformanceHistory[HistoryHead] = Frame;
+        HistoryHead = (HistoryHead + 1) % MaxHistoryFrames;
+        HistoryCount = FMath::Min(HistoryCount + 1, MaxHistoryFrames);
+        
+        PeakMemoryUsageMB = FMath::Max(PeakMemoryUsageMB, MemoryMB);
+    }
     
-    // Add frame to history
-    PerformanceHistory.Add(CurrentFrame);
+    SET_DWORD_STAT(STAT_ActiveChunks, ActiveChunks);
+    SET_FLOAT_STAT(STAT_VoxelMemory, MemoryMB);
+}
+
+FVoxelPerformanceMonitor::FThreadSampleRing& FVoxelPerformanceMonitor::GetThreadRing()
+{
+    static thread_local FThreadSampleRing* ThreadRing = nullptr;
+    
+    if (!ThreadRing)
+    {
+        TUniquePtr<FThreadSampleRing> NewRing = MakeUnique<FThreadSampleRing>();
+        ThreadRing = NewRing.Get();
+        
+        FScopeLock Lock(&ThreadRingsLock);
+        ThreadRings.Add(MoveTemp(NewRing));
+    }
     
-    // Keep only last 1000 frames
-    if (PerformanceHistory.Num() > 1000)
+    return *ThreadRing;
+}
+
+void FVoxelPerformanceMonitor::PushSample(const FSample& Sample)
+{
+    // Single writer per ring. The odd sequence marks the slot busy before any word changes, the even one
+    // publishes it once every word is written
+    FThreadSampleRing& Ring = GetThreadRing();
+    const uint64 Index = Ring.WriteCount.load(std::memory_order_relaxed);
+    FSampleSlot& Slot = Ring.Slots[Index % FThreadSampleRing::Capacity];
+    
+    uint64 Words[FSampleSlot::NumWords] = {};
+    FMemory::Memcpy(Words, &Sample, sizeof(FSample));
+    
+    Slot.Sequence.store(2 * Index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int32 Word = 0; Word < FSampleSlot::NumWords; Word++)
     {
-        PerformanceHistory.RemoveAt(0);
+        Slot.Words[Word].store(Words[Word], std::memory_order_relaxed);
     }
+    Slot.Sequence.store(2 * Index + 2, std::memory_order_release);
+    Ring.WriteCount.store(Index + 1, std::memory_order_release);
+}
+
+int32 FVoxelPerformanceMonitor::GatherSamples(TArray<FSample>& OutSamples) const
+{
+    OutSamples.Reset();
+    
+    const uint64 StartCycles = MonitoringStartCycles.load(std::memory_order_relaxed);
+    
+    FScopeLock Lock(&ThreadRingsLock);
     
-    // Update peak memory
-    if (MemoryMB > PeakMemoryUsageMB)
+    for (const TUniquePtr<FThreadSampleRing>& Ring : ThreadRings)
     {
-        PeakMemoryUsageMB = MemoryMB;
+        const uint64 End = Ring->WriteCount.load(std::memory_order_acquire);
+        const uint64 Begin = End > FThreadSampleRing::Capacity ? End - FThreadSampleRing::Capacity : 0;
+        
+        for (uint64 Index = Begin; Index < End; Index++)
+        {
+            const FSampleSlot& Slot = Ring->Slots[Index % FThreadSampleRing::Capacity];
+            
+            // Skip slots the writer has lapped or is rewriting, and slots it touched while we copied
+            const uint64 Expected = 2 * Index + 2;
+            if (Slot.Sequence.load(std::memory_order_acquire) != Expected)
+            {
+                continue;
+            }
+            
+            uint64 Words[FSampleSlot::NumWords];
+            for (int32 Word = 0; Word < FSampleSlot::NumWords; Word++)
+            {
+                Words[Word] = Slot.Words[Word].load(std::memory_order_relaxed);
+            }
+            
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Slot.Sequence.load(std::memory_order_relaxed) != Expected)
+            {
+                continue;
+            }
+            
+            FMemory::Memcpy(&OutSamples.AddUninitialized_GetRef(), Words, sizeof(FSample));
+        }
     }
     
-    SET_DWORD_STAT(STAT_ActiveChunks, ActiveChunks);
-    SET_FLOAT_STAT(STAT_VoxelMemory, MemoryMB);
+    OutSamples.RemoveAllSwap([StartCycles](const FSample& Sample) { return Sample.Cycles < StartCycles; }, EAllowShrinking::No);
+    
+    // Merged, oldest first
+    OutSamples.Sort([](const FSample& A, const FSample& B) { return A.Cycles < B.Cycles; });
     
-    // Reset current frame
-    CurrentFrame = FPerformanceFrame();
+    return ThreadRings.Num();
+}
+
+void FVoxelPerformanceMonitor::CopyHistory(TArray<FPerformanceFrame>& OutFrames) const
+{
+    // Caller holds HistoryLock
+    OutFrames.Reset(HistoryCount);
+    
+    const int32 Oldest = HistoryCount < MaxHistoryFrames ? 0 : HistoryHead;
+    for (int32 Offset = 0; Offset < HistoryCount; Offset++)
+    {
+        OutFrames.Add(PerformanceHistory[(Oldest + Offset) % MaxHistoryFrames]);
+    }
 }
 
 FString FVoxelPerformanceMonitor::GetPerformanceReport() const
@@ -130,11 +408,18 @@ FString FVoxelPerformanceMonitor::GetPerformanceReport() const
     
     const_cast<FVoxelPerformanceMonitor*>(this)->UpdateStatistics();
     
+    TArray<FPerformanceFrame> History;
+    CopyHistory(History);
+    
+    TArray<FSample> Samples;
+    const int32 ThreadCount = GatherSamples(Samples);
+    
     FString Report;
     Report += TEXT("=== Voxel Performance Report ===\n");
     Report += FString::Printf(TEXT("Monitoring Duration: %.1f seconds\n"), 
-        PerformanceHistory.Num() > 0 ? PerformanceHistory.Last().Timestamp - PerformanceHistory[0].Timestamp : 0.0);
-    Report += FString::Printf(TEXT("Frames Recorded: %d\n\n"), PerformanceHistory.Num());
+        History.Num() > 0 ? History.Last().Timestamp - History[0].Timestamp : 0.0);
+    Report += FString::Printf(TEXT("Frames Recorded: %d\n"), History.Num());
+    Report += FString::Printf(TEXT("Samples Recorded: %d (%d threads)\n\n"), Samples.Num(), ThreadCount);
     
     Report += TEXT("Average Performance:\n");
     Report += FString::Printf(TEXT("  Mesh Generation: %.2f ms\n"), AverageMeshGenerationMs);
@@ -144,31 +429,34 @@ FString FVoxelPerformanceMonitor::GetPerformanceReport() const
     
     Report += TEXT("Memory Usage:\n");
     Report += FString::Printf(TEXT("  Current: %.1f MB\n"), 
-        PerformanceHistory.Num() > 0 ? PerformanceHistory.Last().MemoryUsageMB : 0.0f);
+        History.Num() > 0 ? History.Last().MemoryUsageMB : 0.0f);
     Report += FString::Printf(TEXT("  Peak: %.1f MB\n"), PeakMemoryUsageMB);
     Report += FString::Printf(TEXT("\n"));
     
-    // Find best and worst frames
-    if (PerformanceHistory.Num() > 0)
+    // Find best and worst individual meshes across all threads
+    float BestMeshTime = FLT_MAX;
+    float WorstMeshTime = 0.0f;
+    
+    for (const FSample& Sample : Samples)
     {
-        float BestMeshTime = FLT_MAX;
-        float WorstMeshTime = 0.0f;
-        
-        for (const FPerformanceFrame& Frame : PerformanceHistory)
+        if (Sample.Type == ESampleType::MeshGeneration)
         {
-            if (Frame.MeshGenerationMs > 0)
-            {
-                BestMeshTime = FMath::Min(BestMeshTime, Frame.MeshGenerationMs);
-                WorstMeshTime = FMath::Max(WorstMeshTime, Frame.MeshGenerationMs);
-            }
+            BestMeshTime = FMath::Min(BestMeshTime, Sample.TimeMs);
+            WorstMeshTime = FMath::Max(WorstMeshTime, Sample.TimeMs);
         }
-        
+    }
+    
+    if (WorstMeshTime > 0.0f)
+    {
         Report += TEXT("Mesh Generation Times:\n");
         Report += FString::Printf(TEXT("  Best: %.2f ms\n"), BestMeshTime);
         Report += FString::Printf(TEXT("  Worst: %.2f ms\n"), WorstMeshTime);
         Report += FString::Printf(TEXT("\n"));
     }
     
+    Report += GetLatencyReport();
+    Report += FString::Printf(TEXT("\n"));
+    
     // Platform-specific targets
 #if VOXEL_MOBILE_PLATFORM
     Report += TEXT("Platform: MOBILE\n");
@@ -187,6 +475,86 @@ FString FVoxelPerformanceMonitor::GetPerformanceReport() const
     return Report;
 }
 
+void FVoxelPerformanceMonitor::RecordLatency(EVoxelLatencyStage Stage, double Milliseconds)
+{
+    if (Stage < EVoxelLatencyStage::Count)
+    {
+        LatencyHistograms[(int32)Stage].Record(Milliseconds);
+    }
+}
+
+void FVoxelPerformanceMonitor::ResetLatency()
+{
+    for (FVoxelLatencyHistogram& Histogram : LatencyHistograms)
+    {
+        Histogram.Reset();
+    }
+}
+
+const TCHAR* FVoxelPerformanceMonitor::GetLatencyStageName(EVoxelLatencyStage Stage)
+{
+    switch (Stage)
+    {
+        case EVoxelLatencyStage::QueueWait: return TEXT("QueueWait");
+        case EVoxelLatencyStage::Generate: return TEXT("Generate");
+        case EVoxelLatencyStage::Mesh: return TEXT("Mesh");
+        case EVoxelLatencyStage::Apply: return TEXT("Apply");
+        case EVoxelLatencyStage::RequestToVisible: return TEXT("RequestToVisible");
+        default: return TEXT("Unknown");
+    }
+}
+
+FString FVoxelPerformanceMonitor::GetLatencyReport() const
+{
+    FString Report;
+    Report += TEXT("Streaming Latency (ms):\n");
+    Report += FString::Printf(TEXT("  %-18s %8s %9s %9s %9s %9s\n"), TEXT("Stage"), TEXT("Count"), TEXT("P50"), TEXT("P95"), TEXT("P99"), TEXT("Max"));
+    
+    for (int32 Index = 0; Index < (int32)EVoxelLatencyStage::Count; Index++)
+    {
+        const FVoxelLatencyHistogram& Histogram = LatencyHistograms[Index];
+        Report += FString::Printf(TEXT("  %-18s %8llu %9.2f %9.2f %9.2f %9.2f\n"),
+            GetLatencyStageName((EVoxelLatencyStage)Index),
+            Histogram.GetCount(),
+            Histogram.GetPercentileMs(0.5),
+            Histogram.GetPercentileMs(0.95),
+            Histogram.GetPercentileMs(0.99),
+            Histogram.GetMaxMs()
+        );
+    }
+    
+    return Report;
+}
+
+bool FVoxelPerformanceMonitor::DumpLatencyCSV(const FString& FilePath) const
+{
+    FString CSVContent;
+    CSVContent += TEXT("Stage,Count,MeanMs,P50Ms,P95Ms,P99Ms,MaxMs\n");
+    
+    for (int32 Index = 0; Index < (int32)EVoxelLatencyStage::Count; Index++)
+    {
+        const FVoxelLatencyHistogram& Histogram = LatencyHistograms[Index];
+        CSVContent += FString::Printf(TEXT("%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+            GetLatencyStageName((EVoxelLatencyStage)Index),
+            Histogram.GetCount(),
+            Histogram.GetMeanMs(),
+            Histogram.GetPercentileMs(0.5),
+            Histogram.GetPercentileMs(0.95),
+            Histogram.GetPercentileMs(0.99),
+            Histogram.GetMaxMs()
+        );
+    }
+    
+    if (!FFileHelper::SaveStringToFile(CSVContent, *FilePath))
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("DumpLatencyCSV: Failed to write %s"), *FilePath);
+        return false;
+    }
+    
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("DumpLatencyCSV: Wrote %s"), *FilePath);
+    return true;
+}
+
 void FVoxelPerformanceMonitor::EnableCSVLogging(bool bEnable)
 {
     bCSVLoggingEnabled = bEnable;
@@ -194,12 +562,16 @@ void FVoxelPerformanceMonitor::EnableCSVLogging(bool bEnable)
 
 void FVoxelPerformanceMonitor::DumpCSVData(const FString& FilePath) const
 {
-    FScopeLock Lock(&HistoryLock);
+    TArray<FPerformanceFrame> History;
+    {
+        FScopeLock Lock(&HistoryLock);
+        CopyHistory(History);
+    }
     
     FString CSVContent;
     CSVContent += TEXT("Timestamp,MeshGenerationMs,GreedyMeshingMs,TriangleCount,VertexCount,TriangleReduction%,ActiveChunks,MemoryMB\n");
     
-    for (const FPerformanceFrame& Frame : PerformanceHistory)
+    for (const FPerformanceFrame& Frame : History)
     {
         CSVContent += FString::Printf(TEXT("%.3f,%.2f,%.2f,%d,%d,%.1f,%d,%.1f\n"),
             Frame.Timestamp,
@@ -214,11 +586,13 @@ void FVoxelPerformanceMonitor::DumpCSVData(const FString& FilePath) const
     }
     
     FFileHelper::SaveStringToFile(CSVContent, *FilePath);
+    
+    DumpLatencyCSV(FPaths::Combine(FPaths::GetPath(FilePath), FPaths::GetBaseFilename(FilePath) + TEXT("_Latency.csv")));
 }
 
 void FVoxelPerformanceMonitor::UpdateStatistics()
 {
-    if (PerformanceHistory.Num() == 0)
+    if (HistoryCount == 0)
         return;
     
     float TotalMeshGen = 0.0f;
@@ -226,8 +600,10 @@ void FVoxelPerformanceMonitor::UpdateStatistics()
     float TotalReduction = 0.0f;
     int32 ValidFrames = 0;
     
-    for (const FPerformanceFrame& Frame : PerformanceHistory)
+    // Order doesn't matter for averages, the first HistoryCount slots are all valid
+    for (int32 Index = 0; Index < HistoryCount; Index++)
     {
+        const FPerformanceFrame& Frame = PerformanceHistory[Index];
         if (Frame.MeshGenerationMs > 0)
         {
             TotalMeshGen += Frame.MeshGenerationMs;
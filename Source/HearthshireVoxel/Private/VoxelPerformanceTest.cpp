@@ -6,6 +6,7 @@
 #include "VoxelMeshGenerator.h"
 #include "VoxelGreedyMesher.h"
 #include "VoxelPerformanceStats.h"
+#include "VoxelBenchmark.h"
 #include "Engine/World.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
@@ -169,47 +170,18 @@ FVoxelTestResult UVoxelPerformanceTest::TestMultithreadedGeneration(UObject* Wor
     Result.TestName = TEXT("Multithreaded Generation");
     Result.TargetValue = 20.0f; // Target: <20ms for 4 chunks
     
-    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
-    if (!World)
-    {
-        Result.bPassed = false;
-        Result.Details = TEXT("No world context");
-        return Result;
-    }
-    
-    // Create temporary voxel world
-    AVoxelWorld* TestWorld = World->SpawnActor<AVoxelWorld>(AVoxelWorld::StaticClass());
-    if (!TestWorld)
-    {
-        Result.bPassed = false;
-        Result.Details = TEXT("Failed to create test world");
-        return Result;
-    }
-    
-    TestWorld->Config.bUseMultithreading = true;
-    TestWorld->Config.MaxConcurrentChunkGenerations = 4;
+    // Generate and mesh 4 chunks on 4 worker threads and wait for all of them
+    TArray<FVoxelBenchmarkFixture> Fixtures;
+    FVoxelBenchmarkRunner::BuildSyntheticFixtures(FVoxelChunkSize(), Fixtures);
     
-    // Generate 4 chunks simultaneously
-    double StartTime = FPlatformTime::Seconds();
+    const FVoxelScalingSample Sample = FVoxelBenchmarkRunner::RunConcurrentBatch(Fixtures, 4, 4, EVoxelScalingStage::GenerateAndMesh);
     
-    for (int32 i = 0; i < 4; i++)
-    {
-        FIntVector ChunkPos(i, 0, 0);
-        TestWorld->GetOrCreateChunk(ChunkPos);
-    }
-    
-    // Wait for generation to complete (simplified - in real test would properly wait)
-    FPlatformProcess::Sleep(0.1f);
-    
-    double EndTime = FPlatformTime::Seconds();
-    double TotalTimeMs = (EndTime - StartTime) * 1000.0;
-    
-    Result.MeasuredValue = TotalTimeMs;
+    Result.MeasuredValue = Sample.WallMs;
     Result.bPassed = Result.MeasuredValue < Result.TargetValue;
-    Result.Details = TEXT("4 chunks generated concurrently");
-    
-    // Cleanup
-    TestWorld->Destroy();
+    Result.Details = FString::Printf(TEXT("4 chunks on 4 threads, %.1fms of work (%.1fx parallel)"),
+        Sample.BusyMs,
+        Sample.WallMs > 0.0 ? Sample.BusyMs / Sample.WallMs : 0.0
+    );
     
     return Result;
 }
@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelQualityGovernor.h"
+#include "VoxelWorld.h"
+#include "VoxelDetailScatter.h"
+#include "VoxelTrace.h"
+#include "HearthshireVoxelModule.h"
+#include "RenderCore.h"
+
+UVoxelQualityGovernorComponent::UVoxelQualityGovernorComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    VoxelWorld = nullptr;
+    DetailScatter = nullptr;
+}
+
+void UVoxelQualityGovernorComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    VoxelWorld = Cast<AVoxelWorld>(GetOwner());
+    if (!VoxelWorld)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelQualityGovernor: Owner is not a VoxelWorld, governor disabled"));
+        return;
+    }
+
+    DetailScatter = VoxelWorld->FindComponentByClass<UVoxelDetailScatterComponent>();
+
+    QualityLevel = QualityLevels - 1;
+    SmoothedFrameMs = GetTargetFrameMs();
+
+    // The world starts its components before it calibrates, so its settings aren't final yet
+    if (VoxelWorld->HasActorBegunPlay())
+    {
+        HandleWorldInitialized();
+    }
+    else
+    {
+        VoxelWorld->OnWorldInitialized.AddDynamic(this, &UVoxelQualityGovernorComponent::HandleWorldInitialized);
+    }
+}
+
+void UVoxelQualityGovernorComponent::HandleWorldInitialized()
+{
+    if (!VoxelWorld || bHasBaseSettings)
+    {
+        return;
+    }
+
+    // Calibration has been applied by now, so this is the device's best quality
+    BaseViewDistanceInChunks = VoxelWorld->Config.ViewDistanceInChunks;
+    BaseChunksPerFrame = VoxelWorld->Config.MaxChunksPerFrame;
+    bHasBaseSettings = true;
+
+    // A level pinned before the world was ready takes effect now
+    if (QualityLevel != QualityLevels - 1)
+    {
+        ApplyQualityLevel();
+    }
+}
+
+void UVoxelQualityGovernorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // Leave the world as configured
+    if (VoxelWorld)
+    {
+        VoxelWorld->OnWorldInitialized.RemoveDynamic(this, &UVoxelQualityGovernorComponent::HandleWorldInitialized);
+    }
+
+    if (VoxelWorld && bHasBaseSettings)
+    {
+        VoxelWorld->Config.ViewDistanceInChunks = BaseViewDistanceInChunks;
+        VoxelWorld->Config.MaxChunksPerFrame = BaseChunksPerFrame;
+        VoxelWorld->SetLODDistanceScale(1.0f);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+float UVoxelQualityGovernorComponent::GetTargetFrameMs() const
+{
+    int32 FPS = TargetFPS;
+    if (FPS <= 0)
+    {
+#if VOXEL_MOBILE_PLATFORM
+        FPS = 30;
+#else
+        FPS = 60;
+#endif
+    }
+    return 1000.0f / FPS;
+}
+
+void UVoxelQualityGovernorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (!bEnabled || !VoxelWorld || !bHasBaseSettings || DeltaTime <= 0.0f)
+    {
+        return;
+    }
+
+    VOXEL_TRACE_SCOPE(Voxel_QualityGovernor);
+
+    // Thread times are zero without a renderer (-nullrhi), fall back to the frame time
+    const float GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    const float RenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+    float FrameMs = FMath::Max(GameThreadMs, RenderThreadMs);
+    if (FrameMs <= 0.0f)
+    {
+        FrameMs = DeltaTime * 1000.0f;
+    }
+
+    // Exponential moving average with a fixed time constant regardless of frame rate
+    const float Alpha = 1.0f - FMath::Exp(-DeltaTime / SmoothingTime);
+    SmoothedFrameMs = FMath::Lerp(SmoothedFrameMs, FrameMs, Alpha);
+
+    const float TargetFrameMs = GetTargetFrameMs();
+    if (SmoothedFrameMs > TargetFrameMs)
+    {
+        OverBudgetTime += DeltaTime;
+        UnderBudgetTime = 0.0f;
+    }
+    else if (SmoothedFrameMs < TargetFrameMs * UpgradeThreshold)
+    {
+        UnderBudgetTime += DeltaTime;
+        OverBudgetTime = 0.0f;
+    }
+    else
+    {
+        // Inside the hysteresis band - hold the current level
+        OverBudgetTime = 0.0f;
+        UnderBudgetTime = 0.0f;
+    }
+
+    if (OverBudgetTime >= DowngradeDelay && QualityLevel > 0)
+    {
+        SetQualityLevel(QualityLevel - 1);
+    }
+    else if (UnderBudgetTime >= UpgradeDelay && QualityLevel < QualityLevels - 1)
+    {
+        SetQualityLevel(QualityLevel + 1);
+    }
+}
+
+void UVoxelQualityGovernorComponent::SetQualityLevel(int32 NewLevel)
+{
+    NewLevel = FMath::Clamp(NewLevel, 0, QualityLevels - 1);
+
+    // Each change restarts both timers so the next one waits for the effect of this one
+    OverBudgetTime = 0.0f;
+    UnderBudgetTime = 0.0f;
+
+    if (NewLevel == QualityLevel)
+    {
+        return;
+    }
+
+    const int32 OldLevel = QualityLevel;
+    QualityLevel = NewLevel;
+    ApplyQualityLevel();
+
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("VoxelQualityGovernor: Quality %d -> %d (%.1fms smoothed, %.1fms target)"),
+        OldLevel, NewLevel, SmoothedFrameMs, GetTargetFrameMs());
+
+    OnQualityLevelChanged.Broadcast(NewLevel, OldLevel);
+}
+
+void UVoxelQualityGovernorComponent::ApplyQualityLevel()
+{
+    if (!VoxelWorld || !bHasBaseSettings)
+    {
+        return;
+    }
+
+    const float Quality = QualityLevels > 1 ? (float)QualityLevel / (QualityLevels - 1) : 1.0f;
+
+    VoxelWorld->Config.ViewDistanceInChunks = FMath::RoundToInt(FMath::Lerp((float)FMath::Min(MinViewDistanceInChunks, BaseViewDistanceInChunks), (float)BaseViewDistanceInChunks, Quality));
+    VoxelWorld->Config.MaxChunksPerFrame = FMath::RoundToInt(FMath::Lerp((float)FMath::Min(MinChunksPerFrame, BaseChunksPerFrame), (float)BaseChunksPerFrame, Quality));
+    VoxelWorld->SetLODDistanceScale(FMath::Lerp(MinLODDistanceScale, 1.0f, Quality));
+
+    if (DetailScatter)
+    {
+        DetailScatter->SetDensityScale(FMath::Lerp(MinDetailDensityScale, 1.0f, Quality));
+    }
+}
@@ -0,0 +1,360 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelRefinement.h"
+#include "VoxelTypes.h"
+#include "HearthshireVoxelModule.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace VoxelRefinement
+{
+    // Bumped when the Save layout changes
+    static constexpr uint8 StreamVersion = 1;
+
+    static int32 GetIndexByteCount(int32 SubVoxelCount, int32 BitsPerIndex)
+    {
+        return (SubVoxelCount * BitsPerIndex + 7) / 8;
+    }
+
+    static bool IsValidBitsPerIndex(int32 BitsPerIndex)
+    {
+        return BitsPerIndex == 1 || BitsPerIndex == 2 || BitsPerIndex == 4 || BitsPerIndex == 8;
+    }
+}
+
+// FVoxelRefinedCell
+
+void FVoxelRefinedCell::Init(int32 InResolution, EVoxelMaterial Material)
+{
+    Resolution = (uint8)InResolution;
+    BitsPerIndex = 1;
+    Palette.Reset();
+    Palette.Add(Material);
+    PaletteCounts.Reset();
+    PaletteCounts.Add((uint16)GetSubVoxelCount());
+    Indices.Reset();
+    Indices.SetNumZeroed(VoxelRefinement::GetIndexByteCount(GetSubVoxelCount(), BitsPerIndex));
+}
+
+void FVoxelRefinedCell::Set(int32 SubIndex, EVoxelMaterial Material)
+{
+    const int32 Bit = SubIndex * BitsPerIndex;
+    const int32 OldPaletteIndex = (Indices[Bit >> 3] >> (Bit & 7)) & ((1 << BitsPerIndex) - 1);
+    if (Palette[OldPaletteIndex] == Material)
+    {
+        return;
+    }
+
+    int32 PaletteIndex = Palette.IndexOfByKey(Material);
+    if (PaletteIndex == INDEX_NONE)
+    {
+        // Reuse an entry nothing points at before growing
+        PaletteIndex = PaletteCounts.IndexOfByKey(0);
+        if (PaletteIndex != INDEX_NONE)
+        {
+            Palette[PaletteIndex] = Material;
+        }
+        else
+        {
+            PaletteIndex = Palette.Add(Material);
+            PaletteCounts.Add(0);
+            if (Palette.Num() > (1 << BitsPerIndex))
+            {
+                Repack(BitsPerIndex * 2);
+            }
+        }
+    }
+
+    PaletteCounts[OldPaletteIndex]--;
+    PaletteCounts[PaletteIndex]++;
+    WriteIndex(SubIndex, PaletteIndex);
+}
+
+void FVoxelRefinedCell::Repack(int32 NewBitsPerIndex)
+{
+    const int32 Count = GetSubVoxelCount();
+
+    TArray<uint8, TInlineAllocator<512>> Unpacked;
+    Unpacked.SetNumUninitialized(Count);
+    for (int32 SubIndex = 0; SubIndex < Count; SubIndex++)
+    {
+        const int32 Bit = SubIndex * BitsPerIndex;
+        Unpacked[SubIndex] = (Indices[Bit >> 3] >> (Bit & 7)) & ((1 << BitsPerIndex) - 1);
+    }
+
+    BitsPerIndex = (uint8)NewBitsPerIndex;
+    Indices.Reset();
+    Indices.SetNumZeroed(VoxelRefinement::GetIndexByteCount(Count, BitsPerIndex));
+    for (int32 SubIndex = 0; SubIndex < Count; SubIndex++)
+    {
+        WriteIndex(SubIndex, Unpacked[SubIndex]);
+    }
+}
+
+bool FVoxelRefinedCell::IsUniform(EVoxelMaterial& OutMaterial) const
+{
+    for (int32 PaletteIndex = 0; PaletteIndex < Palette.Num(); PaletteIndex++)
+    {
+        if (PaletteCounts[PaletteIndex] == GetSubVoxelCount())
+        {
+            OutMaterial = Palette[PaletteIndex];
+            return true;
+        }
+    }
+    return false;
+}
+
+EVoxelMaterial FVoxelRefinedCell::GetRepresentativeMaterial() const
+{
+    EVoxelMaterial Best = EVoxelMaterial::Air;
+    int32 BestCount = 0;
+    int32 SolidCount = 0;
+
+    for (int32 PaletteIndex = 0; PaletteIndex < Palette.Num(); PaletteIndex++)
+    {
+        if (Palette[PaletteIndex] == EVoxelMaterial::Air)
+        {
+            continue;
+        }
+
+        SolidCount += PaletteCounts[PaletteIndex];
+        if (PaletteCounts[PaletteIndex] > BestCount)
+        {
+            Best = Palette[PaletteIndex];
+            BestCount = PaletteCounts[PaletteIndex];
+        }
+    }
+
+    return SolidCount * 2 >= GetSubVoxelCount() ? Best : EVoxelMaterial::Air;
+}
+
+int64 FVoxelRefinedCell::GetAllocatedSize() const
+{
+    return Palette.GetAllocatedSize() + PaletteCounts.GetAllocatedSize() + Indices.GetAllocatedSize();
+}
+
+// FVoxelRefinementLayer
+
+bool FVoxelRefinementLayer::Refine(int32 VoxelIndex, int32 Resolution, FVoxel& InOutVoxel)
+{
+    if (!FVoxelRefinedCell::IsValidResolution(Resolution))
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelRefinement: Unsupported resolution %d (expected 4 or 8)"), Resolution);
+        return false;
+    }
+
+    if (InOutVoxel.Material == EVoxelMaterial::Refined)
+    {
+        return Cells.Contains(VoxelIndex);
+    }
+
+    Cells.FindOrAdd(VoxelIndex).Init(Resolution, InOutVoxel.Material);
+    InOutVoxel.Material = EVoxelMaterial::Refined;
+    return true;
+}
+
+bool FVoxelRefinementLayer::SetSubVoxel(int32 VoxelIndex, const FIntVector& SubVoxel, EVoxelMaterial Material, FVoxel& InOutVoxel)
+{
+    FVoxelRefinedCell* Cell = InOutVoxel.Material == EVoxelMaterial::Refined ? Cells.Find(VoxelIndex) : nullptr;
+    if (!Cell || Material == EVoxelMaterial::Refined)
+    {
+        return false;
+    }
+
+    const int32 R = Cell->Resolution;
+    if (SubVoxel.X < 0 || SubVoxel.X >= R || SubVoxel.Y < 0 || SubVoxel.Y >= R || SubVoxel.Z < 0 || SubVoxel.Z >= R)
+    {
+        return false;
+    }
+
+    const int32 SubIndex = Cell->GetSubIndex(SubVoxel.X, SubVoxel.Y, SubVoxel.Z);
+    if (Cell->Get(SubIndex) == Material)
+    {
+        return false;
+    }
+    Cell->Set(SubIndex, Material);
+
+    // Uniform again - back to a plain voxel
+    EVoxelMaterial UniformMaterial;
+    if (Cell->IsUniform(UniformMaterial))
+    {
+        InOutVoxel.Material = UniformMaterial;
+        Cells.Remove(VoxelIndex);
+    }
+    return true;
+}
+
+EVoxelMaterial FVoxelRefinementLayer::GetSubVoxel(int32 VoxelIndex, const FIntVector& SubVoxel, const FVoxel& Voxel) const
+{
+    const FVoxelRefinedCell* Cell = Voxel.Material == EVoxelMaterial::Refined ? Cells.Find(VoxelIndex) : nullptr;
+    if (!Cell)
+    {
+        return Voxel.Material;
+    }
+
+    const int32 R = Cell->Resolution;
+    if (SubVoxel.X < 0 || SubVoxel.X >= R || SubVoxel.Y < 0 || SubVoxel.Y >= R || SubVoxel.Z < 0 || SubVoxel.Z >= R)
+    {
+        return EVoxelMaterial::Air;
+    }
+    return Cell->Get(Cell->GetSubIndex(SubVoxel.X, SubVoxel.Y, SubVoxel.Z));
+}
+
+void FVoxelRefinementLayer::ResolveRepresentatives(TArray<FVoxel>& InOutVoxels) const
+{
+    for (const TPair<int32, FVoxelRefinedCell>& Pair : Cells)
+    {
+        if (InOutVoxels.IsValidIndex(Pair.Key))
+        {
+            InOutVoxels[Pair.Key].Material = Pair.Value.GetRepresentativeMaterial();
+        }
+    }
+}
+
+void FVoxelRefinementLayer::Reconcile(TArray<FVoxel>& InOutVoxels)
+{
+    for (auto It = Cells.CreateIterator(); It; ++It)
+    {
+        if (!InOutVoxels.IsValidIndex(It.Key()) || InOutVoxels[It.Key()].Material != EVoxelMaterial::Refined)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (int32 Index = 0; Index < InOutVoxels.Num(); Index++)
+    {
+        if (InOutVoxels[Index].Material == EVoxelMaterial::Refined && !Cells.Contains(Index))
+        {
+            InOutVoxels[Index].Material = EVoxelMaterial::Air;
+        }
+    }
+}
+
+int64 FVoxelRefinementLayer::GetAllocatedSize() const
+{
+    int64 Size = Cells.GetAllocatedSize();
+    for (const TPair<int32, FVoxelRefinedCell>& Pair : Cells)
+    {
+        Size += Pair.Value.GetAllocatedSize();
+    }
+    return Size;
+}
+
+void FVoxelRefinementLayer::Save(int32 VoxelCount, TArray<uint8>& OutBytes) const
+{
+    OutBytes.Reset();
+    if (Cells.Num() == 0)
+    {
+        return;
+    }
+
+    FMemoryWriter Writer(OutBytes);
+
+    uint8 Version = VoxelRefinement::StreamVersion;
+    uint32 PackedVoxelCount = VoxelCount;
+    uint32 CellCount = Cells.Num();
+    Writer << Version;
+    Writer.SerializeIntPacked(PackedVoxelCount);
+    Writer.SerializeIntPacked(CellCount);
+
+    for (const TPair<int32, FVoxelRefinedCell>& Pair : Cells)
+    {
+        const FVoxelRefinedCell& Cell = Pair.Value;
+
+        uint32 VoxelIndex = Pair.Key;
+        uint8 Resolution = Cell.Resolution;
+        uint8 BitsPerIndex = Cell.BitsPerIndex;
+        uint8 PaletteSize = (uint8)(Cell.Palette.Num() - 1);
+        Writer.SerializeIntPacked(VoxelIndex);
+        Writer << Resolution;
+        Writer << BitsPerIndex;
+        Writer << PaletteSize;
+        Writer.Serialize(const_cast<EVoxelMaterial*>(Cell.Palette.GetData()), Cell.Palette.Num());
+        Writer.Serialize(const_cast<uint8*>(Cell.Indices.GetData()), Cell.Indices.Num());
+    }
+}
+
+bool FVoxelRefinementLayer::Load(const TArray<uint8>& Bytes, int32 VoxelCount)
+{
+    Cells.Empty();
+    if (Bytes.Num() == 0)
+    {
+        return true;
+    }
+
+    FMemoryReader Reader(Bytes);
+
+    uint8 Version = 0;
+    uint32 StoredVoxelCount = 0;
+    uint32 CellCount = 0;
+    Reader << Version;
+    Reader.SerializeIntPacked(StoredVoxelCount);
+    Reader.SerializeIntPacked(CellCount);
+
+    if (Reader.IsError() || Version != VoxelRefinement::StreamVersion || (int32)StoredVoxelCount != VoxelCount || CellCount > (uint32)VoxelCount)
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelRefinement: Malformed refinement header (version %d, %u voxels, %u cells)"),
+            Version, StoredVoxelCount, CellCount);
+        return false;
+    }
+
+    Cells.Reserve(CellCount);
+    for (uint32 EntryIndex = 0; EntryIndex < CellCount; EntryIndex++)
+    {
+        uint32 VoxelIndex = 0;
+        uint8 Resolution = 0;
+        uint8 BitsPerIndex = 0;
+        uint8 PaletteSize = 0;
+        Reader.SerializeIntPacked(VoxelIndex);
+        Reader << Resolution;
+        Reader << BitsPerIndex;
+        Reader << PaletteSize;
+
+        const int32 PaletteCount = PaletteSize + 1;
+        if (Reader.IsError() || VoxelIndex >= (uint32)VoxelCount || Cells.Contains(VoxelIndex)
+            || !FVoxelRefinedCell::IsValidResolution(Resolution) || !VoxelRefinement::IsValidBitsPerIndex(BitsPerIndex)
+            || PaletteCount > (1 << BitsPerIndex))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelRefinement: Malformed cell entry %u"), EntryIndex);
+            Cells.Empty();
+            return false;
+        }
+
+        FVoxelRefinedCell Cell;
+        Cell.Resolution = Resolution;
+        Cell.BitsPerIndex = BitsPerIndex;
+
+        const int32 IndexBytes = VoxelRefinement::GetIndexByteCount(Cell.GetSubVoxelCount(), BitsPerIndex);
+        if (PaletteCount + IndexBytes > Reader.TotalSize() - Reader.Tell())
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelRefinement: Cell %u is truncated"), VoxelIndex);
+            Cells.Empty();
+            return false;
+        }
+
+        Cell.Palette.SetNumUninitialized(PaletteCount);
+        Reader.Serialize(Cell.Palette.GetData(), PaletteCount);
+        Cell.Indices.SetNumUninitialized(IndexBytes);
+        Reader.Serialize(Cell.Indices.GetData(), IndexBytes);
+
+        // Counts aren't stored - rebuild them, rejecting indices past the palette
+        Cell.PaletteCounts.SetNumZeroed(PaletteCount);
+        const int32 Mask = (1 << BitsPerIndex) - 1;
+        for (int32 SubIndex = 0; SubIndex < Cell.GetSubVoxelCount(); SubIndex++)
+        {
+            const int32 Bit = SubIndex * BitsPerIndex;
+            const int32 PaletteIndex = (Cell.Indices[Bit >> 3] >> (Bit & 7)) & Mask;
+            if (PaletteIndex >= PaletteCount || Cell.Palette[PaletteIndex] == EVoxelMaterial::Refined)
+            {
+                UE_LOG(LogHearthshireVoxel, Warning, TEXT("VoxelRefinement: Cell %u has an invalid palette index"), VoxelIndex);
+                Cells.Empty();
+                return false;
+            }
+            Cell.PaletteCounts[PaletteIndex]++;
+        }
+
+        Cells.Add(VoxelIndex, MoveTemp(Cell));
+    }
+
+    return !Reader.IsError();
+}
@@ -0,0 +1,874 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelReplication.h"
+#include "VoxelWorld.h"
+#include "VoxelChunk.h"
+#include "VoxelWorldTemplate.h"
+#include "HearthshireVoxelModule.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace VoxelReplication
+{
+    // Upper bound for a single chunk dimension accepted from the wire
+    static constexpr int32 MaxChunkDimension = 256;
+
+    static void SerializePacked(FArchive& Ar, int32& Value)
+    {
+        // Zigzag so small negative chunk coordinates stay small
+        uint32 Encoded = Ar.IsSaving() ? (((uint32)Value << 1) ^ (uint32)(Value >> 31)) : 0;
+        Ar.SerializeIntPacked(Encoded);
+        if (Ar.IsLoading())
+        {
+            Value = (int32)(Encoded >> 1) ^ -(int32)(Encoded & 1);
+        }
+    }
+
+    static void SerializeHeader(FArchive& Ar, EVoxelReplicationMessage& Type, FIntVector& ChunkPosition, uint32& Sequence)
+    {
+        uint8 TypeByte = (uint8)Type;
+        Ar << TypeByte;
+        Type = (EVoxelReplicationMessage)TypeByte;
+
+        SerializePacked(Ar, ChunkPosition.X);
+        SerializePacked(Ar, ChunkPosition.Y);
+        SerializePacked(Ar, ChunkPosition.Z);
+        Ar.SerializeIntPacked(Sequence);
+    }
+
+    static FIntVector IndexToLocal(int32 Index, const FVoxelChunkSize& ChunkSize)
+    {
+        const int32 SliceSize = ChunkSize.X * ChunkSize.Y;
+        return FIntVector(Index % ChunkSize.X, (Index / ChunkSize.X) % ChunkSize.Y, Index / SliceSize);
+    }
+}
+
+// FVoxelEditDelta
+
+void FVoxelEditDelta::BuildRuns(const TMap<int32, EVoxelMaterial>& Edits)
+{
+    Runs.Reset();
+
+    TArray<int32> Indices;
+    Edits.GetKeys(Indices);
+    Indices.Sort();
+
+    for (int32 Index : Indices)
+    {
+        const EVoxelMaterial Material = Edits.FindChecked(Index);
+
+        // Extend the previous run when contiguous and same material
+        if (Runs.Num() > 0)
+        {
+            FVoxelEditRun& LastRun = Runs.Last();
+            if (LastRun.Material == Material && LastRun.StartIndex + LastRun.Length == Index)
+            {
+                LastRun.Length++;
+                continue;
+            }
+        }
+
+        Runs.Add(FVoxelEditRun(Index, 1, Material));
+    }
+}
+
+// FVoxelLoopbackTransport
+
+FVoxelLoopbackTransport::FVoxelLoopbackTransport()
+{
+    TotalBytesSent = 0;
+    TotalPacketsSent = 0;
+}
+
+void FVoxelLoopbackTransport::SendPacket(TArray<uint8>&& Packet)
+{
+    TotalBytesSent += Packet.Num();
+    TotalPacketsSent++;
+    Packets.Enqueue(MoveTemp(Packet));
+}
+
+bool FVoxelLoopbackTransport::ReceivePacket(TArray<uint8>& OutPacket)
+{
+    return Packets.Dequeue(OutPacket);
+}
+
+// FVoxelReplicationSerializer
+
+bool FVoxelReplicationSerializer::WriteFullChunk(const FVoxelChunkData& ChunkData, uint32 Sequence, TArray<uint8>& OutPacket)
+{
+    TArray<uint8> UncompressedData;
+    ChunkData.GetMaterialBytes(UncompressedData);
+
+    TArray<uint8> CompressedData;
+    if (!UVoxelTemplateUtility::CompressVoxelData(UncompressedData, CompressedData))
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("WriteFullChunk: Failed to compress chunk %s"), *ChunkData.ChunkPosition.ToString());
+        return false;
+    }
+
+    OutPacket.Reset();
+    FMemoryWriter Writer(OutPacket);
+
+    EVoxelReplicationMessage Type = EVoxelReplicationMessage::FullChunk;
+    FIntVector ChunkPosition = ChunkData.ChunkPosition;
+    VoxelReplication::SerializeHeader(Writer, Type, ChunkPosition, Sequence);
+
+    uint32 SizeX = ChunkData.ChunkSize.X;
+    uint32 SizeY = ChunkData.ChunkSize.Y;
+    uint32 SizeZ = ChunkData.ChunkSize.Z;
+    uint32 CompressedSize = CompressedData.Num();
+    Writer.SerializeIntPacked(SizeX);
+    Writer.SerializeIntPacked(SizeY);
+    Writer.SerializeIntPacked(SizeZ);
+    Writer.SerializeIntPacked(CompressedSize);
+    Writer.Serialize(CompressedData.GetData(), CompressedData.Num());
+
+    // Auxiliary channels follow the materials - a single zero when the chunk has none
+    TArray<uint8> ChannelData;
+    TArray<uint8> CompressedChannelData;
+    ChunkData.Channels.Save(ChunkData.ChunkSize.GetVoxelCount(), ChannelData);
+    if (ChannelData.Num() > 0 && !UVoxelTemplateUtility::CompressVoxelData(ChannelData, CompressedChannelData))
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("WriteFullChunk: Failed to compress channels of chunk %s"), *ChunkData.ChunkPosition.ToString());
+        return false;
+    }
+
+    uint32 ChannelSize = ChannelData.Num();
+    Writer.SerializeIntPacked(ChannelSize);
+    if (ChannelSize > 0)
+    {
+        uint32 CompressedChannelSize = CompressedChannelData.Num();
+        Writer.SerializeIntPacked(CompressedChannelSize);
+        Writer.Serialize(CompressedChannelData.GetData(), CompressedChannelData.Num());
+    }
+
+    // Sub-voxel grids last, same layout
+    TArray<uint8> RefinementData;
+    TArray<uint8> CompressedRefinementData;
+    ChunkData.Refinement.Save(ChunkData.ChunkSize.GetVoxelCount(), RefinementData);
+    if (RefinementData.Num() > 0 && !UVoxelTemplateUtility::CompressVoxelData(RefinementData, CompressedRefinementData))
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("WriteFullChunk: Failed to compress refined voxels of chunk %s"), *ChunkData.ChunkPosition.ToString());
+        return false;
+    }
+
+    uint32 RefinementSize = RefinementData.Num();
+    Writer.SerializeIntPacked(RefinementSize);
+    if (RefinementSize > 0)
+    {
+        uint32 CompressedRefinementSize = CompressedRefinementData.Num();
+        Writer.SerializeIntPacked(CompressedRefinementSize);
+        Writer.Serialize(CompressedRefinementData.GetData(), CompressedRefinementData.Num());
+    }
+
+    // Block entities after the sub-voxels, same layout
+    TArray<uint8> BlockEntityData;
+    TArray<uint8> CompressedBlockEntityData;
+    ChunkData.BlockEntities.Save(ChunkData.ChunkSize.GetVoxelCount(), BlockEntityData);
+    if (BlockEntityData.Num() > 0 && !UVoxelTemplateUtility::CompressVoxelData(BlockEntityData, CompressedBlockEntityData))
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("WriteFullChunk: Failed to compress block entities of chunk %s"), *ChunkData.ChunkPosition.ToString());
+        return false;
+    }
+
+    uint32 BlockEntitySize = BlockEntityData.Num();
+    Writer.SerializeIntPacked(BlockEntitySize);
+    if (BlockEntitySize > 0)
+    {
+        uint32 CompressedBlockEntitySize = CompressedBlockEntityData.Num();
+        Writer.SerializeIntPacked(CompressedBlockEntitySize);
+        Writer.Serialize(CompressedBlockEntityData.GetData(), CompressedBlockEntityData.Num());
+    }
+
+    return true;
+}
+
+void FVoxelReplicationSerializer::WriteEditDelta(const FVoxelEditDelta& Delta, TArray<uint8>& OutPacket)
+{
+    OutPacket.Reset();
+    FMemoryWriter Writer(OutPacket);
+
+    EVoxelReplicationMessage Type = EVoxelReplicationMessage::EditDelta;
+    FIntVector ChunkPosition = Delta.ChunkPosition;
+    uint32 Sequence = Delta.Sequence;
+    VoxelReplication::SerializeHeader(Writer, Type, ChunkPosition, Sequence);
+
+    uint32 RunCount = Delta.Runs.Num();
+    Writer.SerializeIntPacked(RunCount);
+
+    int32 PreviousEnd = 0;
+    for (const FVoxelEditRun& Run : Delta.Runs)
+    {
+        uint32 Skip = Run.StartIndex - PreviousEnd;
+        uint32 Length = Run.Length;
+        uint8 Material = (uint8)Run.Material;
+        Writer.SerializeIntPacked(Skip);
+        Writer.SerializeIntPacked(Length);
+        Writer << Material;
+        PreviousEnd = Run.StartIndex + Run.Length;
+    }
+}
+
+void FVoxelReplicationSerializer::WriteChunkRelease(const FIntVector& ChunkPosition, TArray<uint8>& OutPacket)
+{
+    OutPacket.Reset();
+    FMemoryWriter Writer(OutPacket);
+
+    EVoxelReplicationMessage Type = EVoxelReplicationMessage::ChunkRelease;
+    FIntVector Position = ChunkPosition;
+    uint32 Sequence = 0;
+    VoxelReplication::SerializeHeader(Writer, Type, Position, Sequence);
+}
+
+bool FVoxelReplicationSerializer::ReadHeader(FArchive& Ar, EVoxelReplicationMessage& OutType, FIntVector& OutChunkPosition, uint32& OutSequence)
+{
+    VoxelReplication::SerializeHeader(Ar, OutType, OutChunkPosition, OutSequence);
+    return !Ar.IsError() && OutType <= EVoxelReplicationMessage::ChunkRelease;
+}
+
+bool FVoxelReplicationSerializer::ReadFullChunkPayload(FArchive& Ar, FVoxelChunkData& OutChunkData)
+{
+    uint32 SizeX = 0;
+    uint32 SizeY = 0;
+    uint32 SizeZ = 0;
+    uint32 CompressedSize = 0;
+    Ar.SerializeIntPacked(SizeX);
+    Ar.SerializeIntPacked(SizeY);
+    Ar.SerializeIntPacked(SizeZ);
+    Ar.SerializeIntPacked(CompressedSize);
+
+    if (Ar.IsError() || SizeX == 0 || SizeY == 0 || SizeZ == 0 ||
+        SizeX > VoxelReplication::MaxChunkDimension || SizeY > VoxelReplication::MaxChunkDimension || SizeZ > VoxelReplication::MaxChunkDimension ||
+        (int64)CompressedSize > Ar.TotalSize() - Ar.Tell())
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Malformed chunk header"));
+        return false;
+    }
+
+    TArray<uint8> CompressedData;
+    CompressedData.SetNumUninitialized(CompressedSize);
+    Ar.Serialize(CompressedData.GetData(), CompressedSize);
+
+    const FVoxelChunkSize ChunkSize(SizeX, SizeY, SizeZ);
+    TArray<uint8> UncompressedData;
+    if (Ar.IsError() || !UVoxelTemplateUtility::DecompressVoxelData(CompressedData, UncompressedData, ChunkSize.GetVoxelCount()))
+    {
+        UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Failed to decompress chunk data"));
+        return false;
+    }
+
+    OutChunkData.ChunkSize = ChunkSize;
+    OutChunkData.Columns.Reset();
+    OutChunkData.Voxels.SetNum(UncompressedData.Num());
+    for (int32 i = 0; i < UncompressedData.Num(); i++)
+    {
+        OutChunkData.Voxels[i] = FVoxel(static_cast<EVoxelMaterial>(UncompressedData[i]));
+    }
+    OutChunkData.bIsDirty = true;
+
+    uint32 ChannelSize = 0;
+    Ar.SerializeIntPacked(ChannelSize);
+    OutChunkData.Channels.Reset();
+    if (ChannelSize > 0)
+    {
+        // A varying 16-bit channel per voxel is the most a chunk can hold, plus headers
+        uint32 CompressedChannelSize = 0;
+        Ar.SerializeIntPacked(CompressedChannelSize);
+        if (Ar.IsError() || ChannelSize > (uint32)ChunkSize.GetVoxelCount() * 2 * (uint32)EVoxelChannel::Count + 256 ||
+            (int64)CompressedChannelSize > Ar.TotalSize() - Ar.Tell())
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Malformed channel header"));
+            return false;
+        }
+
+        TArray<uint8> CompressedChannelData;
+        CompressedChannelData.SetNumUninitialized(CompressedChannelSize);
+        Ar.Serialize(CompressedChannelData.GetData(), CompressedChannelSize);
+
+        TArray<uint8> ChannelData;
+        if (Ar.IsError() || !UVoxelTemplateUtility::DecompressVoxelData(CompressedChannelData, ChannelData, ChannelSize) ||
+            !OutChunkData.Channels.Load(ChannelData, ChunkSize.GetVoxelCount()))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Failed to decode channel data"));
+            return false;
+        }
+    }
+
+    uint32 RefinementSize = 0;
+    Ar.SerializeIntPacked(RefinementSize);
+    OutChunkData.Refinement.Reset();
+    if (RefinementSize > 0)
+    {
+        // Every voxel refined at 8^3 with a full palette is the most a chunk can hold, plus headers
+        uint32 CompressedRefinementSize = 0;
+        Ar.SerializeIntPacked(CompressedRefinementSize);
+        if (Ar.IsError() || RefinementSize > (uint32)ChunkSize.GetVoxelCount() * (512 + 256 + 8) + 16 ||
+            (int64)CompressedRefinementSize > Ar.TotalSize() - Ar.Tell())
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Malformed refinement header"));
+            return false;
+        }
+
+        TArray<uint8> CompressedRefinementData;
+        CompressedRefinementData.SetNumUninitialized(CompressedRefinementSize);
+        Ar.Serialize(CompressedRefinementData.GetData(), CompressedRefinementSize);
+
+        TArray<uint8> RefinementData;
+        if (Ar.IsError() || !UVoxelTemplateUtility::DecompressVoxelData(CompressedRefinementData, RefinementData, RefinementSize) ||
+            !OutChunkData.Refinement.Load(RefinementData, ChunkSize.GetVoxelCount()))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Failed to decode refinement data"));
+            return false;
+        }
+    }
+    OutChunkData.Refinement.Reconcile(OutChunkData.Voxels);
+
+    uint32 BlockEntitySize = 0;
+    Ar.SerializeIntPacked(BlockEntitySize);
+    OutChunkData.BlockEntities.Reset();
+    if (BlockEntitySize > 0)
+    {
+        // A full entity on every voxel is the most a chunk can hold, plus headers
+        uint32 CompressedBlockEntitySize = 0;
+        Ar.SerializeIntPacked(CompressedBlockEntitySize);
+        if (Ar.IsError() || BlockEntitySize > (uint32)ChunkSize.GetVoxelCount() * (FVoxelBlockEntity::MaxPayloadSize + 7) + 16 ||
+            (int64)CompressedBlockEntitySize > Ar.TotalSize() - Ar.Tell())
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Malformed block entity header"));
+            return false;
+        }
+
+        TArray<uint8> CompressedBlockEntityData;
+        CompressedBlockEntityData.SetNumUninitialized(CompressedBlockEntitySize);
+        Ar.Serialize(CompressedBlockEntityData.GetData(), CompressedBlockEntitySize);
+
+        TArray<uint8> BlockEntityData;
+        if (Ar.IsError() || !UVoxelTemplateUtility::DecompressVoxelData(CompressedBlockEntityData, BlockEntityData, BlockEntitySize) ||
+            !OutChunkData.BlockEntities.Load(BlockEntityData, ChunkSize.GetVoxelCount()))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ReadFullChunkPayload: Failed to decode block entity data"));
+            return false;
+        }
+    }
+
+    return !Ar.IsError();
+}
+
+bool FVoxelReplicationSerializer::ReadEditDeltaPayload(FArchive& Ar, FVoxelEditDelta& OutDelta)
+{
+    uint32 RunCount = 0;
+    Ar.SerializeIntPacked(RunCount);
+
+    // Each run takes at least three bytes on the wire
+    if (Ar.IsError() || (int64)RunCount * 3 > Ar.TotalSize() - Ar.Tell())
+    {
+        return false;
+    }
+
+    OutDelta.Runs.Reset(RunCount);
+
+    int32 PreviousEnd = 0;
+    for (uint32 i = 0; i < RunCount; i++)
+    {
+        uint32 Skip = 0;
+        uint32 Length = 0;
+        uint8 Material = 0;
+        Ar.SerializeIntPacked(Skip);
+        Ar.SerializeIntPacked(Length);
+        Ar << Material;
+
+        const int32 StartIndex = PreviousEnd + (int32)Skip;
+        OutDelta.Runs.Add(FVoxelEditRun(StartIndex, (int32)Length, static_cast<EVoxelMaterial>(Material)));
+        PreviousEnd = StartIndex + (int32)Length;
+    }
+
+    return !Ar.IsError();
+}
+
+// FVoxelReplicationServer
+
+FVoxelReplicationServer::FVoxelReplicationServer(AVoxelWorld* InWorld)
+    : World(InWorld)
+    , NextClientId(1)
+{
+    if (InWorld)
+    {
+        EditHandle = InWorld->OnVoxelEditedNative.AddRaw(this, &FVoxelReplicationServer::HandleVoxelEdited);
+        ReplacedHandle = InWorld->OnChunkReplacedNative.AddRaw(this, &FVoxelReplicationServer::HandleChunkReplaced);
+    }
+}
+
+FVoxelReplicationServer::~FVoxelReplicationServer()
+{
+    if (AVoxelWorld* ServerWorld = World.Get())
+    {
+        ServerWorld->OnVoxelEditedNative.Remove(EditHandle);
+        ServerWorld->OnChunkReplacedNative.Remove(ReplacedHandle);
+    }
+}
+
+int32 FVoxelReplicationServer::AddClient(IVoxelReplicationTransport* Transport, const FVoxelReplicationSettings& Settings)
+{
+    if (!Transport)
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("FVoxelReplicationServer::AddClient: Invalid transport"));
+        return INDEX_NONE;
+    }
+
+    const int32 ClientId = NextClientId++;
+    FClientState& Client = Clients.Add(ClientId);
+    Client.Transport = Transport;
+    Client.Settings = Settings;
+    Client.AvailableBytes = Settings.MaxBurstBytes;
+
+    return ClientId;
+}
+
+void FVoxelReplicationServer::RemoveClient(int32 ClientId)
+{
+    Clients.Remove(ClientId);
+}
+
+void FVoxelReplicationServer::SetClientFocus(int32 ClientId, const FVector& WorldPosition)
+{
+    FClientState* Client = Clients.Find(ClientId);
+    AVoxelWorld* ServerWorld = World.Get();
+    if (Client && ServerWorld)
+    {
+        Client->FocusChunk = ServerWorld->WorldToChunkPosition(WorldPosition);
+    }
+}
+
+void FVoxelReplicationServer::RequestResync(int32 ClientId, const FIntVector& ChunkPosition)
+{
+    if (FClientState* Client = Clients.Find(ClientId))
+    {
+        // Forgetting the chunk makes it a candidate for a full snapshot again
+        Client->ReplicatedChunks.Remove(ChunkPosition);
+    }
+}
+
+void FVoxelReplicationServer::HandleVoxelEdited(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, EVoxelMaterial Material)
+{
+    RecordEdit(ChunkPosition, LocalVoxel, Material);
+}
+
+void FVoxelReplicationServer::HandleChunkReplaced(const FIntVector& ChunkPosition)
+{
+    RecordChunkReplaced(ChunkPosition);
+}
+
+void FVoxelReplicationServer::RecordChunkReplaced(const FIntVector& ChunkPosition)
+{
+    // The snapshot is read when it is sent, so it already carries these edits
+    PendingEdits.Remove(ChunkPosition);
+    PendingResyncs.Add(ChunkPosition);
+}
+
+void FVoxelReplicationServer::RecordEdit(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, EVoxelMaterial Material)
+{
+    AVoxelWorld* ServerWorld = World.Get();
+    if (!ServerWorld || PendingResyncs.Contains(ChunkPosition))
+    {
+        return;
+    }
+
+    AVoxelChunk* Chunk = ServerWorld->GetChunkAtPosition(ChunkPosition);
+    if (!Chunk || !Chunk->ChunkComponent)
+    {
+        return;
+    }
+
+    const FVoxelChunkData& ChunkData = Chunk->ChunkComponent->GetChunkData();
+    const FVoxelChunkSize& ChunkSize = ChunkData.ChunkSize;
+    if (LocalVoxel.X < 0 || LocalVoxel.X >= ChunkSize.X ||
+        LocalVoxel.Y < 0 || LocalVoxel.Y >= ChunkSize.Y ||
+        LocalVoxel.Z < 0 || LocalVoxel.Z >= ChunkSize.Z)
+    {
+        return;
+    }
+
+    PendingEdits.FindOrAdd(ChunkPosition).Add(ChunkData.GetIndex(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z), Material);
+}
+
+void FVoxelReplicationServer::Tick(float DeltaTime)
+{
+    if (!World.IsValid())
+    {
+        return;
+    }
+
+    TArray<FVoxelEditDelta> Deltas;
+    FlushPendingEdits(Deltas);
+
+    // Serialize each delta once and share it between clients
+    TArray<TArray<uint8>> DeltaPackets;
+    DeltaPackets.SetNum(Deltas.Num());
+    for (int32 i = 0; i < Deltas.Num(); i++)
+    {
+        FVoxelReplicationSerializer::WriteEditDelta(Deltas[i], DeltaPackets[i]);
+    }
+
+    for (auto& ClientPair : Clients)
+    {
+        FClientState& Client = ClientPair.Value;
+
+        // Refill the bucket; a deficit from an oversized chunk is paid back first
+        Client.AvailableBytes = FMath::Min(Client.AvailableBytes + Client.Settings.MaxBytesPerSecond * DeltaTime, (float)Client.Settings.MaxBurstBytes);
+
+        // Edits go out every tick regardless of the budget so players see each other's changes within a frame
+        SendEditDeltas(Client, Deltas, DeltaPackets);
+        UpdateInterest(Client);
+        SendPendingChunks(Client);
+    }
+}
+
+void FVoxelReplicationServer::FlushPendingEdits(TArray<FVoxelEditDelta>& OutDeltas)
+{
+    OutDeltas.Reset(PendingEdits.Num());
+
+    // Rewritten chunks go out as fresh snapshots to the clients holding them
+    for (const FIntVector& ChunkPosition : PendingResyncs)
+    {
+        ++ChunkSequences.FindOrAdd(ChunkPosition);
+        for (auto& ClientPair : Clients)
+        {
+            ClientPair.Value.ReplicatedChunks.Remove(ChunkPosition);
+        }
+    }
+    PendingResyncs.Reset();
+
+    for (const auto& EditPair : PendingEdits)
+    {
+        const uint32 Sequence = ++ChunkSequences.FindOrAdd(EditPair.Key);
+
+        // Sub-voxel edits have no delta encoding - clients holding the chunk get a fresh snapshot instead
+        bool bHasRefinedEdit = false;
+        for (const auto& Edit : EditPair.Value)
+        {
+            bHasRefinedEdit |= Edit.Value == EVoxelMaterial::Refined;
+        }
+        if (bHasRefinedEdit)
+        {
+            for (auto& ClientPair : Clients)
+            {
+                ClientPair.Value.ReplicatedChunks.Remove(EditPair.Key);
+            }
+            continue;
+        }
+
+        FVoxelEditDelta& Delta = OutDeltas.AddDefaulted_GetRef();
+        Delta.ChunkPosition = EditPair.Key;
+        Delta.Sequence = Sequence;
+        Delta.BuildRuns(EditPair.Value);
+    }
+
+    PendingEdits.Reset();
+}
+
+void FVoxelReplicationServer::SendEditDeltas(FClientState& Client, const TArray<FVoxelEditDelta>& Deltas, const TArray<TArray<uint8>>& Packets)
+{
+    for (int32 i = 0; i < Deltas.Num(); i++)
+    {
+        // Chunks the client doesn't hold yet will carry the edit in their snapshot
+        if (!Client.ReplicatedChunks.Contains(Deltas[i].ChunkPosition))
+        {
+            continue;
+        }
+
+        TArray<uint8> Packet = Packets[i];
+        Client.AvailableBytes -= Packet.Num();
+        Stats.EditDeltaBytes += Packet.Num();
+        Stats.EditDeltasSent++;
+        Client.Transport->SendPacket(MoveTemp(Packet));
+    }
+}
+
+void FVoxelReplicationServer::UpdateInterest(FClientState& Client)
+{
+    AVoxelWorld* ServerWorld = World.Get();
+
+    TArray<FIntVector> ChunksToRelease;
+    for (const FIntVector& ChunkPosition : Client.ReplicatedChunks)
+    {
+        if (!IsInInterest(Client, ChunkPosition) || !ServerWorld->GetChunkAtPosition(ChunkPosition))
+        {
+            ChunksToRelease.Add(ChunkPosition);
+        }
+    }
+
+    for (const FIntVector& ChunkPosition : ChunksToRelease)
+    {
+        TArray<uint8> Packet;
+        FVoxelReplicationSerializer::WriteChunkRelease(ChunkPosition, Packet);
+        Client.Transport->SendPacket(MoveTemp(Packet));
+        Client.ReplicatedChunks.Remove(ChunkPosition);
+        Stats.ChunksReleased++;
+    }
+}
+
+void FVoxelReplicationServer::SendPendingChunks(FClientState& Client)
+{
+    if (Client.AvailableBytes <= 0.0f)
+    {
+        return;
+    }
+
+    AVoxelWorld* ServerWorld = World.Get();
+
+    // Gather chunks in the interest region the client doesn't have, nearest first
+    TArray<TPair<int32, FIntVector>> Candidates;
+    for (const auto& ChunkPair : ServerWorld->ActiveChunks)
+    {
+        if (!ChunkPair.Value || Client.ReplicatedChunks.Contains(ChunkPair.Key) || !IsInInterest(Client, ChunkPair.Key))
+        {
+            continue;
+        }
+
+        const FIntVector Offset = ChunkPair.Key - Client.FocusChunk;
+        const int32 DistanceSq = Offset.X * Offset.X + Offset.Y * Offset.Y + Offset.Z * Offset.Z;
+        Candidates.Add(TPair<int32, FIntVector>(DistanceSq, ChunkPair.Key));
+    }
+
+    Candidates.Sort([](const TPair<int32, FIntVector>& A, const TPair<int32, FIntVector>& B)
+    {
+        return A.Key < B.Key;
+    });
+
+    for (const TPair<int32, FIntVector>& Candidate : Candidates)
+    {
+        if (Client.AvailableBytes <= 0.0f)
+        {
+            break;
+        }
+
+        AVoxelChunk* Chunk = ServerWorld->GetChunkAtPosition(Candidate.Value);
+        if (!Chunk || !Chunk->ChunkComponent)
+        {
+            continue;
+        }
+
+        TArray<uint8> Packet;
+        const uint32 Sequence = ChunkSequences.FindRef(Candidate.Value);
+        if (!FVoxelReplicationSerializer::WriteFullChunk(Chunk->ChunkComponent->GetChunkData(), Sequence, Packet))
+        {
+            continue;
+        }
+
+        Client.AvailableBytes -= Packet.Num();
+        Stats.FullChunkBytes += Packet.Num();
+        Stats.FullChunksSent++;
+        Client.Transport->SendPacket(MoveTemp(Packet));
+        Client.ReplicatedChunks.Add(Candidate.Value);
+    }
+}
+
+bool FVoxelReplicationServer::IsInInterest(const FClientState& Client, const FIntVector& ChunkPosition) const
+{
+    const FIntVector Offset = ChunkPosition - Client.FocusChunk;
+    const int32 Radius = Client.Settings.InterestRadiusInChunks;
+    return FMath::Abs(Offset.X) <= Radius && FMath::Abs(Offset.Y) <= Radius && FMath::Abs(Offset.Z) <= Radius;
+}
+
+// FVoxelReplicationClient
+
+FVoxelReplicationClient::FVoxelReplicationClient(AVoxelWorld* InWorld)
+    : World(InWorld)
+    , AppliedDeltaCount(0)
+{
+}
+
+void FVoxelReplicationClient::ProcessPackets(IVoxelReplicationTransport& Transport)
+{
+    TArray<uint8> Packet;
+    while (Transport.ReceivePacket(Packet))
+    {
+        if (!ApplyPacket(Packet))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("FVoxelReplicationClient: Dropped malformed packet (%d bytes)"), Packet.Num());
+        }
+    }
+}
+
+void FVoxelReplicationClient::ConsumeResyncRequests(TArray<FIntVector>& OutChunkPositions)
+{
+    OutChunkPositions = ResyncRequests.Array();
+    ResyncRequests.Reset();
+}
+
+bool FVoxelReplicationClient::ApplyPacket(const TArray<uint8>& Packet)
+{
+    if (!World.IsValid())
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Packet);
+
+    EVoxelReplicationMessage Type = EVoxelReplicationMessage::FullChunk;
+    FIntVector ChunkPosition = FIntVector::ZeroValue;
+    uint32 Sequence = 0;
+    if (!FVoxelReplicationSerializer::ReadHeader(Reader, Type, ChunkPosition, Sequence))
+    {
+        return false;
+    }
+
+    switch (Type)
+    {
+        case EVoxelReplicationMessage::FullChunk:
+        {
+            FVoxelChunkData ChunkData;
+            if (!FVoxelReplicationSerializer::ReadFullChunkPayload(Reader, ChunkData))
+            {
+                return false;
+            }
+            ChunkData.ChunkPosition = ChunkPosition;
+            ApplyFullChunk(ChunkData, Sequence);
+            return true;
+        }
+
+        case EVoxelReplicationMessage::EditDelta:
+        {
+            FVoxelEditDelta Delta;
+            if (!FVoxelReplicationSerializer::ReadEditDeltaPayload(Reader, Delta))
+            {
+                return false;
+            }
+            Delta.ChunkPosition = ChunkPosition;
+            Delta.Sequence = Sequence;
+            ApplyEditDelta(Delta);
+            return true;
+        }
+
+        case EVoxelReplicationMessage::ChunkRelease:
+            ChunkSequences.Remove(ChunkPosition);
+            ResyncRequests.Remove(ChunkPosition);
+            World->UnloadChunk(ChunkPosition);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void FVoxelReplicationClient::ApplyFullChunk(const FVoxelChunkData& ChunkData, uint32 Sequence)
+{
+    if (World->AdoptChunkData(ChunkData))
+    {
+        ChunkSequences.Add(ChunkData.ChunkPosition, Sequence);
+        ResyncRequests.Remove(ChunkData.ChunkPosition);
+    }
+}
+
+void FVoxelReplicationClient::ApplyEditDelta(const FVoxelEditDelta& Delta)
+{
+    uint32* LastSequence = ChunkSequences.Find(Delta.ChunkPosition);
+    if (!LastSequence || Delta.Sequence <= *LastSequence)
+    {
+        // Unknown chunk or already covered by a newer snapshot
+        return;
+    }
+
+    if (Delta.Sequence != *LastSequence + 1)
+    {
+        ResyncRequests.Add(Delta.ChunkPosition);
+        return;
+    }
+
+    AVoxelChunk* Chunk = World->GetChunkAtPosition(Delta.ChunkPosition);
+    if (!Chunk || !Chunk->ChunkComponent)
+    {
+        ResyncRequests.Add(Delta.ChunkPosition);
+        return;
+    }
+
+    UVoxelChunkComponent* ChunkComp = Chunk->ChunkComponent;
+    const FVoxelChunkSize ChunkSize = ChunkComp->GetChunkSize();
+    const int32 VoxelCount = ChunkSize.GetVoxelCount();
+
+    for (const FVoxelEditRun& Run : Delta.Runs)
+    {
+        if (Run.StartIndex < 0 || Run.Length <= 0 || Run.StartIndex + Run.Length > VoxelCount)
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("ApplyEditDelta: Run out of range for chunk %s, requesting resync"), *Delta.ChunkPosition.ToString());
+            ResyncRequests.Add(Delta.ChunkPosition);
+            return;
+        }
+
+        for (int32 Index = Run.StartIndex; Index < Run.StartIndex + Run.Length; Index++)
+        {
+            const FIntVector Local = VoxelReplication::IndexToLocal(Index, ChunkSize);
+            ChunkComp->SetVoxel(Local.X, Local.Y, Local.Z, Run.Material);
+        }
+    }
+
+    *LastSequence = Delta.Sequence;
+    AppliedDeltaCount++;
+
+    World->RegenerateChunk(Delta.ChunkPosition);
+}
+
+// FVoxelReplicationLoopback
+
+FVoxelReplicationLoopback::FVoxelReplicationLoopback(AVoxelWorld* ServerWorld, AVoxelWorld* ClientWorld, const FVoxelReplicationSettings& Settings)
+    : Server(ServerWorld)
+    , Client(ClientWorld)
+{
+    ClientId = Server.AddClient(&Transport, Settings);
+}
+
+void FVoxelReplicationLoopback::SetClientFocus(const FVector& WorldPosition)
+{
+    Server.SetClientFocus(ClientId, WorldPosition);
+}
+
+void FVoxelReplicationLoopback::Tick(float DeltaTime)
+{
+    Server.Tick(DeltaTime);
+    Client.ProcessPackets(Transport);
+
+    TArray<FIntVector> ResyncChunks;
+    Client.ConsumeResyncRequests(ResyncChunks);
+    for (const FIntVector& ChunkPosition : ResyncChunks)
+    {
+        Server.RequestResync(ClientId, ChunkPosition);
+    }
+}
+
+bool FVoxelReplicationLoopback::CompareWorlds(const AVoxelWorld* ServerWorld, const AVoxelWorld* ClientWorld, TArray<FIntVector>* OutMismatchedChunks)
+{
+    if (!ServerWorld || !ClientWorld)
+    {
+        return false;
+    }
+
+    bool bMatches = true;
+
+    for (const auto& ChunkPair : ClientWorld->ActiveChunks)
+    {
+        const AVoxelChunk* ClientChunk = ChunkPair.Value;
+        const AVoxelChunk* ServerChunk = ServerWorld->GetChunkAtPosition(ChunkPair.Key);
+
+        bool bChunkMatches = ClientChunk && ClientChunk->ChunkComponent && ServerChunk && ServerChunk->ChunkComponent;
+        if (bChunkMatches)
+        {
+            const FVoxelChunkData& ClientData = ClientChunk->ChunkComponent->GetChunkData();
+            const FVoxelChunkData& ServerData = ServerChunk->ChunkComponent->GetChunkData();
+            TArray<FVoxel> ClientScratch;
+            TArray<FVoxel> ServerScratch;
+            bChunkMatches = ClientData.ChunkSize.ToIntVector() == ServerData.ChunkSize.ToIntVector() &&
+                            ClientData.GetDenseVoxels(ClientScratch) == ServerData.GetDenseVoxels(ServerScratch);
+        }
+
+        if (!bChunkMatches)
+        {
+            bMatches = false;
+            if (OutMismatchedChunks)
+            {
+                OutMismatchedChunks->Add(ChunkPair.Key);
+            }
+        }
+    }
+
+    return bMatches;
+}
@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelTerrainGenerator.h"
+#include "VoxelTrace.h"
+
+int32 FVoxelTerrainGenerator::GetRollingHillsHeight(int32 GlobalX, int32 GlobalY)
+{
+    const float NoiseScale = 0.03f; // Adjust for hill frequency
+    const float HeightScale = 10.0f; // Max height variation
+    const float BaseHeight = 10.0f; // Base terrain height
+
+    // Generate height using 2D Perlin noise, converted from [-1, 1] to [0, 1]
+    float NoiseValue = FMath::PerlinNoise2D(FVector2D(GlobalX * NoiseScale, GlobalY * NoiseScale));
+    NoiseValue = (NoiseValue + 1.0f) * 0.5f;
+
+    // Terrain height is 5-15 voxels
+    const int32 TerrainHeight = FMath::FloorToInt(BaseHeight + NoiseValue * HeightScale);
+    return FMath::Clamp(TerrainHeight, 5, 15);
+}
+
+EVoxelMaterial FVoxelTerrainGenerator::GetSurfaceMaterial(int32 Z, int32 TerrainHeight)
+{
+    if (Z >= TerrainHeight)
+    {
+        return EVoxelMaterial::Air;
+    }
+
+    // Top layer is grass
+    if (Z == TerrainHeight - 1)
+    {
+        return EVoxelMaterial::Grass;
+    }
+
+    // Next 3 layers are dirt
+    if (Z >= TerrainHeight - 4)
+    {
+        return EVoxelMaterial::Dirt;
+    }
+
+    return EVoxelMaterial::Stone;
+}
+
+void FVoxelTerrainGenerator::GenerateRollingHills(FVoxelChunkData& ChunkData)
+{
+    VOXEL_TRACE_SCOPE(Voxel_GenerateRollingHills);
+
+    const FVoxelChunkSize& Size = ChunkData.ChunkSize;
+    ChunkData.Voxels.SetNum(Size.GetVoxelCount());
+
+    for (int32 Y = 0; Y < Size.Y; Y++)
+    {
+        for (int32 X = 0; X < Size.X; X++)
+        {
+            const int32 TerrainHeight = GetRollingHillsHeight(
+                ChunkData.ChunkPosition.X * Size.X + X,
+                ChunkData.ChunkPosition.Y * Size.Y + Y);
+
+            for (int32 Z = 0; Z < Size.Z; Z++)
+            {
+                ChunkData.Voxels[ChunkData.GetIndex(X, Y, Z)] = FVoxel(GetSurfaceMaterial(Z, TerrainHeight));
+            }
+        }
+    }
+
+    ChunkData.bIsDirty = true;
+}
+
+void FVoxelTerrainGenerator::GenerateFlat(FVoxelChunkData& ChunkData, int32 SurfaceHeight)
+{
+    VOXEL_TRACE_SCOPE(Voxel_GenerateFlat);
+
+    const FVoxelChunkSize& Size = ChunkData.ChunkSize;
+    ChunkData.Voxels.SetNum(Size.GetVoxelCount());
+
+    for (int32 Z = 0; Z < Size.Z; Z++)
+    {
+        const FVoxel Voxel(GetSurfaceMaterial(Z, SurfaceHeight));
+        for (int32 Y = 0; Y < Size.Y; Y++)
+        {
+            for (int32 X = 0; X < Size.X; X++)
+            {
+                ChunkData.Voxels[ChunkData.GetIndex(X, Y, Z)] = Voxel;
+            }
+        }
+    }
+
+    ChunkData.bIsDirty = true;
+}
+
+void FVoxelTerrainGenerator::GenerateCaves(FVoxelChunkData& ChunkData, float CaveThreshold)
+{
+    VOXEL_TRACE_SCOPE(Voxel_GenerateCaves);
+
+    const FVoxelChunkSize& Size = ChunkData.ChunkSize;
+    const float CaveScale = 0.08f;
+    ChunkData.Voxels.SetNum(Size.GetVoxelCount());
+
+    for (int32 Y = 0; Y < Size.Y; Y++)
+    {
+        for (int32 X = 0; X < Size.X; X++)
+        {
+            const int32 GlobalX = ChunkData.ChunkPosition.X * Size.X + X;
+            const int32 GlobalY = ChunkData.ChunkPosition.Y * Size.Y + Y;
+
+            // Stretch the hills so the surface sits near the top of the chunk
+            const int32 TerrainHeight = Size.Z - 15 + GetRollingHillsHeight(GlobalX, GlobalY);
+
+            for (int32 Z = 0; Z < Size.Z; Z++)
+            {
+                EVoxelMaterial Material = GetSurfaceMaterial(Z, TerrainHeight);
+
+                // Keep a solid floor and crust so tunnels stay enclosed
+                if (Material != EVoxelMaterial::Air && Z > 0 && Z < TerrainHeight - 4)
+                {
+                    const int32 GlobalZ = ChunkData.ChunkPosition.Z * Size.Z + Z;
+                    const float Noise = FMath::PerlinNoise3D(FVector(GlobalX, GlobalY, GlobalZ) * CaveScale);
+                    if (FMath::Abs(Noise) < CaveThreshold * 0.5f)
+                    {
+                        Material = EVoxelMaterial::Air;
+                    }
+                }
+
+                ChunkData.Voxels[ChunkData.GetIndex(X, Y, Z)] = FVoxel(Material);
+            }
+        }
+    }
+
+    ChunkData.bIsDirty = true;
+}
+
+void FVoxelTerrainGenerator::GenerateCheckerboard(FVoxelChunkData& ChunkData, EVoxelMaterial Material)
+{
+    VOXEL_TRACE_SCOPE(Voxel_GenerateCheckerboard);
+
+    const FVoxelChunkSize& Size = ChunkData.ChunkSize;
+    ChunkData.Voxels.SetNum(Size.GetVoxelCount());
+
+    for (int32 Z = 0; Z < Size.Z; Z++)
+    {
+        for (int32 Y = 0; Y < Size.Y; Y++)
+        {
+            for (int32 X = 0; X < Size.X; X++)
+            {
+                const bool bSolid = ((X + Y + Z) & 1) == 0;
+                ChunkData.Voxels[ChunkData.GetIndex(X, Y, Z)] = FVoxel(bSolid ? Material : EVoxelMaterial::Air);
+            }
+        }
+    }
+
+    ChunkData.bIsDirty = true;
+}
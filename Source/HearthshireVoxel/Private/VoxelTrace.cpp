@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelTrace.h"
+#include "VoxelChunk.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#if VOXEL_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(VoxelChannel)
+
+UE_TRACE_EVENT_BEGIN(Voxel, ChunkLifecycle)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(int32, X)
+    UE_TRACE_EVENT_FIELD(int32, Y)
+    UE_TRACE_EVENT_FIELD(int32, Z)
+    UE_TRACE_EVENT_FIELD(uint8, LOD)
+    UE_TRACE_EVENT_FIELD(uint8, Event)
+UE_TRACE_EVENT_END()
+
+TRACE_DECLARE_INT_COUNTER(VoxelQueueDepth, TEXT("Voxel/Queue Depth"));
+TRACE_DECLARE_INT_COUNTER(VoxelActiveGenerations, TEXT("Voxel/Active Generations"));
+TRACE_DECLARE_INT_COUNTER(VoxelMeshWorkers, TEXT("Voxel/Mesh Workers"));
+
+namespace VoxelTrace
+{
+    // Chunks with an open timing region
+    TSet<FIntVector> OpenRegions;
+    FCriticalSection OpenRegionsLock;
+
+    FThreadSafeCounter MeshWorkers;
+
+    FString GetRegionName(const FIntVector& ChunkPosition)
+    {
+        return FString::Printf(TEXT("Voxel Chunk %d,%d,%d"), ChunkPosition.X, ChunkPosition.Y, ChunkPosition.Z);
+    }
+}
+
+#endif
+
+void FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent Event, const FIntVector& ChunkPosition, EVoxelChunkLOD LOD)
+{
+#if VOXEL_TRACE_ENABLED
+    if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(VoxelChannel))
+    {
+        return;
+    }
+
+    UE_TRACE_LOG(Voxel, ChunkLifecycle, VoxelChannel)
+        << ChunkLifecycle.Cycle(FPlatformTime::Cycles64())
+        << ChunkLifecycle.X(ChunkPosition.X)
+        << ChunkLifecycle.Y(ChunkPosition.Y)
+        << ChunkLifecycle.Z(ChunkPosition.Z)
+        << ChunkLifecycle.LOD((uint8)LOD)
+        << ChunkLifecycle.Event((uint8)Event);
+
+    // One region per chunk from the first request until it is on screen or gone
+    const bool bOpens = Event == EVoxelChunkTraceEvent::Requested || Event == EVoxelChunkTraceEvent::DataReady;
+    const bool bCloses = Event == EVoxelChunkTraceEvent::Applied || Event == EVoxelChunkTraceEvent::Evicted;
+    if (bOpens || bCloses)
+    {
+        FScopeLock Lock(&VoxelTrace::OpenRegionsLock);
+
+        if (bOpens && !VoxelTrace::OpenRegions.Contains(ChunkPosition))
+        {
+            VoxelTrace::OpenRegions.Add(ChunkPosition);
+            TRACE_BEGIN_REGION(*VoxelTrace::GetRegionName(ChunkPosition));
+        }
+        else if (bCloses && VoxelTrace::OpenRegions.Remove(ChunkPosition) > 0)
+        {
+            TRACE_END_REGION(*VoxelTrace::GetRegionName(ChunkPosition));
+        }
+    }
+#endif
+}
+
+void FVoxelTrace::SetQueueDepth(int32 Depth)
+{
+#if VOXEL_TRACE_ENABLED
+    TRACE_COUNTER_SET(VoxelQueueDepth, Depth);
+#endif
+}
+
+void FVoxelTrace::SetActiveGenerations(int32 Count)
+{
+#if VOXEL_TRACE_ENABLED
+    TRACE_COUNTER_SET(VoxelActiveGenerations, Count);
+#endif
+}
+
+void FVoxelTrace::MeshWorkerStarted()
+{
+#if VOXEL_TRACE_ENABLED
+    TRACE_COUNTER_SET(VoxelMeshWorkers, VoxelTrace::MeshWorkers.Increment());
+#endif
+}
+
+void FVoxelTrace::MeshWorkerFinished()
+{
+#if VOXEL_TRACE_ENABLED
+    TRACE_COUNTER_SET(VoxelMeshWorkers, VoxelTrace::MeshWorkers.Decrement());
+#endif
+}
@@ -1,53 +1,389 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VoxelTypes.h"
+#include "VoxelTrace.h"
+#include "HearthshireVoxelModule.h"
 #include "Materials/MaterialInterface.h"
+#include "Engine/Texture2D.h"
+
+bool FVoxelChunkData::RefineVoxel(int32 X, int32 Y, int32 Z, int32 Resolution)
+{
+    if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+    {
+        return false;
+    }
+    
+    ExpandColumns();
+    
+    const int32 Index = GetIndex(X, Y, Z);
+    const bool bWasRefined = Voxels[Index].Material == EVoxelMaterial::Refined;
+    if (!Refinement.Refine(Index, Resolution, Voxels[Index]))
+    {
+        return false;
+    }
+    
+    // A fresh cell has the same shape as the voxel, but the mesh and collision now come from the sub-grid
+    bIsDirty |= !bWasRefined;
+    return true;
+}
+
+bool FVoxelChunkData::SetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel, EVoxelMaterial Material)
+{
+    if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+    {
+        return false;
+    }
+    
+    // Column storage never holds refined voxels
+    if (IsColumnStored())
+    {
+        return false;
+    }
+    
+    const int32 Index = GetIndex(X, Y, Z);
+    if (!Refinement.SetSubVoxel(Index, SubVoxel, Material, Voxels[Index]))
+    {
+        return false;
+    }
+    
+    // Refining keeps a voxel's entity; carving the whole cell away doesn't
+    if (Voxels[Index].Material == EVoxelMaterial::Air)
+    {
+        BlockEntities.Remove(Index);
+    }
+    
+    bIsDirty = true;
+    return true;
+}
+
+EVoxelMaterial FVoxelChunkData::GetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel) const
+{
+    if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+    {
+        return EVoxelMaterial::Air;
+    }
+    
+    if (IsColumnStored())
+    {
+        return Columns.GetMaterial(X, Y, Z);
+    }
+    
+    const int32 Index = GetIndex(X, Y, Z);
+    return Refinement.GetSubVoxel(Index, SubVoxel, Voxels[Index]);
+}
+
+bool FVoxelChunkData::SetBlockEntity(int32 X, int32 Y, int32 Z, const FVoxelBlockEntity& Entity)
+{
+    if (Entity.Type == EVoxelBlockEntityType::None || GetVoxel(X, Y, Z).Material == EVoxelMaterial::Air)
+    {
+        return false;
+    }
+    
+    // Entities don't affect the mesh, and column storage stays as it is
+    BlockEntities.Add(GetIndex(X, Y, Z), Entity);
+    return true;
+}
+
+bool FVoxelChunkData::RemoveBlockEntity(int32 X, int32 Y, int32 Z)
+{
+    if (BlockEntities.IsEmpty() || X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+    {
+        return false;
+    }
+    return BlockEntities.Remove(GetIndex(X, Y, Z));
+}
+
+bool FVoxelChunkData::CompactToColumns(int32 MaxSpansPerColumn)
+{
+    if (IsColumnStored())
+    {
+        return true;
+    }
+    
+    // Refined voxels keep their marker in the dense array
+    if (!Refinement.IsEmpty() || Voxels.Num() != ChunkSize.GetVoxelCount())
+    {
+        return false;
+    }
+    
+    VOXEL_TRACE_SCOPE(Voxel_CompactToColumns);
+    if (!Columns.Build(ChunkSize.ToIntVector(), Voxels, MaxSpansPerColumn))
+    {
+        return false;
+    }
+    
+    Voxels.Empty();
+    return true;
+}
+
+void FVoxelChunkData::ExpandColumns()
+{
+    if (!IsColumnStored())
+    {
+        return;
+    }
+    
+    VOXEL_TRACE_SCOPE(Voxel_ExpandColumns);
+    Columns.ToDense(Voxels);
+    Columns.Reset();
+}
+
+const TArray<FVoxel>& FVoxelChunkData::GetDenseVoxels(TArray<FVoxel>& Scratch) const
+{
+    if (!IsColumnStored())
+    {
+        return Voxels;
+    }
+    
+    Columns.ToDense(Scratch);
+    return Scratch;
+}
+
+void FVoxelChunkData::GetMaterialBytes(TArray<uint8>& OutBytes) const
+{
+    TArray<FVoxel> Scratch;
+    const TArray<FVoxel>& DenseVoxels = GetDenseVoxels(Scratch);
+    
+    OutBytes.SetNumUninitialized(DenseVoxels.Num());
+    for (int32 Index = 0; Index < DenseVoxels.Num(); Index++)
+    {
+        OutBytes[Index] = (uint8)DenseVoxels[Index].Material;
+    }
+}
+
+int32 FVoxelChunkData::GetColumnTop(int32 X, int32 Y) const
+{
+    if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (IsColumnStored())
+    {
+        return Columns.GetColumnTop(X, Y);
+    }
+    
+    for (int32 Z = ChunkSize.Z - 1; Z >= 0; Z--)
+    {
+        if (!GetVoxel(X, Y, Z).IsAir())
+        {
+            return Z;
+        }
+    }
+    return INDEX_NONE;
+}
+
+int32 FVoxelChunkData::GetColumnBottom(int32 X, int32 Y) const
+{
+    if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y)
+    {
+        return INDEX_NONE;
+    }
+    
+    if (IsColumnStored())
+    {
+        return Columns.GetColumnBottom(X, Y);
+    }
+    
+    for (int32 Z = 0; Z < ChunkSize.Z; Z++)
+    {
+        if (!GetVoxel(X, Y, Z).IsAir())
+        {
+            return Z;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FVoxelMaterialVolume::Build(const FVoxelChunkData& ChunkData, float InVoxelSize)
+{
+    VOXEL_TRACE_SCOPE(Voxel_BuildMaterialVolume);
+    
+    VoxelSize = InVoxelSize;
+    Dimensions = ChunkData.ChunkSize.ToIntVector();
+    TilesPerRow = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt((float)Dimensions.Z)));
+    AtlasWidth = TilesPerRow * Dimensions.X;
+    AtlasHeight = FMath::DivideAndRoundUp(Dimensions.Z, TilesPerRow) * Dimensions.Y;
+    
+    Texels.SetNumZeroed(AtlasWidth * AtlasHeight);
+    
+    for (int32 Z = 0; Z < Dimensions.Z; Z++)
+    {
+        for (int32 Y = 0; Y < Dimensions.Y; Y++)
+        {
+            for (int32 X = 0; X < Dimensions.X; X++)
+            {
+                // Refined voxels shade as their most common sub-voxel material
+                EVoxelMaterial Material = ChunkData.GetVoxel(X, Y, Z).Material;
+                if (Material == EVoxelMaterial::Refined)
+                {
+                    const FVoxelRefinedCell* Cell = ChunkData.FindRefinedCell(X, Y, Z);
+                    Material = Cell ? Cell->GetRepresentativeMaterial() : EVoxelMaterial::Air;
+                }
+                
+                const FIntPoint Coord = GetAtlasCoord(X, Y, Z);
+                Texels[Coord.X + Coord.Y * AtlasWidth] = (uint8)Material;
+            }
+        }
+    }
+}
+
+FVoxelMaterialTraits FVoxelMaterialTraitTable::GetBuiltInTraits(EVoxelMaterial Material)
+{
+    // The refined marker has no shape of its own - its sub-voxels are meshed and collided separately
+    FVoxelMaterialTraits Traits;
+    if (Material == EVoxelMaterial::Air || Material == EVoxelMaterial::Refined)
+    {
+        return Traits;
+    }
+    
+    Traits.bSolid = 1;
+    Traits.bCullSameMaterial = 1;
+    
+    switch (Material)
+    {
+        case EVoxelMaterial::Water:
+            Traits.bTranslucent = 1;
+            Traits.LightOpacity = 2;
+            break;
+            
+        case EVoxelMaterial::Ice:
+            Traits.bTranslucent = 1;
+            Traits.bCollidable = 1;
+            Traits.bWalkable = 1;
+            Traits.LightOpacity = 1;
+            break;
+            
+        default:
+            Traits.bOpaque = 1;
+            Traits.bCollidable = 1;
+            Traits.bWalkable = 1;
+            Traits.LightOpacity = 15;
+            break;
+    }
+    
+    return Traits;
+}
+
+void FVoxelMaterialTraitTable::Bake(const UVoxelMaterialSet* MaterialSet)
+{
+    for (int32 Index = 0; Index < 256; Index++)
+    {
+        Entries[Index] = GetBuiltInTraits(static_cast<EVoxelMaterial>(Index));
+    }
+    
+    if (!MaterialSet)
+    {
+        return;
+    }
+    
+    for (const TPair<uint8, FVoxelMaterialConfig>& Pair : MaterialSet->MaterialConfigs)
+    {
+        // Air and the reserved IDs stay empty whatever the set says
+        const FVoxelMaterialConfig& Config = Pair.Value;
+        if (!Config.bOverrideTraits || Pair.Key == (uint8)EVoxelMaterial::Air || Pair.Key >= (uint8)EVoxelMaterial::Refined)
+        {
+            continue;
+        }
+        
+        FVoxelMaterialTraits& Traits = Entries[Pair.Key];
+        Traits.bSolid = 1;
+        Traits.bOpaque = Config.bOpaque && !Config.bTranslucent;
+        Traits.bTranslucent = Config.bTranslucent;
+        Traits.bCullSameMaterial = Config.bCullSameMaterial;
+        Traits.bCollidable = Config.bCollidable;
+        Traits.bWalkable = Config.bWalkable && Config.bCollidable;
+        Traits.bTickEnabled = Config.bTickEnabled;
+        Traits.LightEmission = FMath::Clamp(Config.LightEmission, 0, 15);
+        Traits.LightOpacity = FMath::Clamp(Config.LightOpacity, 0, 15);
+    }
+}
+
+const FVoxelMaterialTraitTable& FVoxelMaterialTraitTable::GetDefault()
+{
+    static const FVoxelMaterialTraitTable DefaultTable = []()
+    {
+        FVoxelMaterialTraitTable Table;
+        Table.Bake(nullptr);
+        return Table;
+    }();
+    return DefaultTable;
+}
 
 UVoxelMaterialSet::UVoxelMaterialSet()
 {
     DefaultMaterial = nullptr;
+    VolumeMaterial = nullptr;
+    TranslucentMaterial = nullptr;
+    PaletteTexture = nullptr;
     
     // Initialize default material configurations
-    Materials.Add(EVoxelMaterial::Grass, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Grass].BaseColor = FLinearColor(0.2f, 0.8f, 0.2f);
-    Materials[EVoxelMaterial::Grass].Roughness = 0.8f;
-    
-    Materials.Add(EVoxelMaterial::Dirt, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Dirt].BaseColor = FLinearColor(0.4f, 0.3f, 0.2f);
-    Materials[EVoxelMaterial::Dirt].Roughness = 0.9f;
+    auto AddDefault = [this](EVoxelMaterial VoxelMaterial, const TCHAR* Name, const FLinearColor& BaseColor, float Roughness)
+    {
+        FVoxelMaterialConfig& Config = MaterialConfigs.Add((uint8)VoxelMaterial);
+        Config.Name = Name;
+        Config.BaseColor = BaseColor;
+        Config.Roughness = Roughness;
+    };
     
-    Materials.Add(EVoxelMaterial::Stone, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Stone].BaseColor = FLinearColor(0.5f, 0.5f, 0.5f);
-    Materials[EVoxelMaterial::Stone].Roughness = 0.7f;
+    AddDefault(EVoxelMaterial::Grass, TEXT("Grass"), FLinearColor(0.2f, 0.8f, 0.2f), 0.8f);
+    AddDefault(EVoxelMaterial::Dirt, TEXT("Dirt"), FLinearColor(0.4f, 0.3f, 0.2f), 0.9f);
+    AddDefault(EVoxelMaterial::Stone, TEXT("Stone"), FLinearColor(0.5f, 0.5f, 0.5f), 0.7f);
+    AddDefault(EVoxelMaterial::Wood, TEXT("Wood"), FLinearColor(0.4f, 0.25f, 0.1f), 0.6f);
+    AddDefault(EVoxelMaterial::Leaves, TEXT("Leaves"), FLinearColor(0.1f, 0.6f, 0.1f), 0.5f);
+    AddDefault(EVoxelMaterial::Sand, TEXT("Sand"), FLinearColor(0.9f, 0.8f, 0.6f), 0.9f);
+    AddDefault(EVoxelMaterial::Water, TEXT("Water"), FLinearColor(0.2f, 0.5f, 0.8f, 0.8f), 0.1f);
+    AddDefault(EVoxelMaterial::Snow, TEXT("Snow"), FLinearColor(0.95f, 0.95f, 1.0f), 0.3f);
+    AddDefault(EVoxelMaterial::Ice, TEXT("Ice"), FLinearColor(0.8f, 0.9f, 1.0f, 0.9f), 0.05f);
     
-    Materials.Add(EVoxelMaterial::Wood, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Wood].BaseColor = FLinearColor(0.4f, 0.25f, 0.1f);
-    Materials[EVoxelMaterial::Wood].Roughness = 0.6f;
+    TraitTable.Bake(this);
+}
+
+void UVoxelMaterialSet::PostLoad()
+{
+    Super::PostLoad();
     
-    Materials.Add(EVoxelMaterial::Leaves, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Leaves].BaseColor = FLinearColor(0.1f, 0.6f, 0.1f);
-    Materials[EVoxelMaterial::Leaves].Roughness = 0.5f;
+    // Sets saved with enum keys replace the constructor defaults wholesale, so removed entries stay removed
+    if (Materials_DEPRECATED.Num() > 0)
+    {
+        MaterialConfigs.Reset();
+        for (TPair<EVoxelMaterial, FVoxelMaterialConfig>& Pair : Materials_DEPRECATED)
+        {
+            if (Pair.Value.Name.IsNone())
+            {
+                Pair.Value.Name = FName(*StaticEnum<EVoxelMaterial>()->GetNameStringByValue((int64)Pair.Key));
+            }
+            MaterialConfigs.Add((uint8)Pair.Key, MoveTemp(Pair.Value));
+        }
+        Materials_DEPRECATED.Empty();
+    }
     
-    Materials.Add(EVoxelMaterial::Sand, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Sand].BaseColor = FLinearColor(0.9f, 0.8f, 0.6f);
-    Materials[EVoxelMaterial::Sand].Roughness = 0.9f;
+    TraitTable.Bake(this);
+}
+
+#if WITH_EDITOR
+void UVoxelMaterialSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
     
-    Materials.Add(EVoxelMaterial::Water, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Water].BaseColor = FLinearColor(0.2f, 0.5f, 0.8f, 0.8f);
-    Materials[EVoxelMaterial::Water].Roughness = 0.1f;
+    for (const TPair<uint8, FVoxelMaterialConfig>& Pair : MaterialConfigs)
+    {
+        if (Pair.Key == (uint8)EVoxelMaterial::Air || Pair.Key >= (uint8)EVoxelMaterial::Refined)
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("%s: Material ID %d is reserved, its entry is ignored"), *GetName(), Pair.Key);
+        }
+    }
     
-    Materials.Add(EVoxelMaterial::Snow, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Snow].BaseColor = FLinearColor(0.95f, 0.95f, 1.0f);
-    Materials[EVoxelMaterial::Snow].Roughness = 0.3f;
+    TraitTable.Bake(this);
     
-    Materials.Add(EVoxelMaterial::Ice, FVoxelMaterialConfig());
-    Materials[EVoxelMaterial::Ice].BaseColor = FLinearColor(0.8f, 0.9f, 1.0f, 0.9f);
-    Materials[EVoxelMaterial::Ice].Roughness = 0.05f;
+    // Base colors may have changed - rebuilt on the next request
+    PaletteTexture = nullptr;
 }
+#endif
 
 UMaterialInterface* UVoxelMaterialSet::GetMaterial(EVoxelMaterial VoxelMaterial) const
 {
-    if (const FVoxelMaterialConfig* Config = Materials.Find(VoxelMaterial))
+    if (const FVoxelMaterialConfig* Config = FindConfig(VoxelMaterial))
     {
         return Config->Material ? Config->Material : DefaultMaterial;
     }
@@ -57,10 +393,51 @@ UMaterialInterface* UVoxelMaterialSet::GetMaterial(EVoxelMaterial VoxelMaterial)
 
 FLinearColor UVoxelMaterialSet::GetBaseColor(EVoxelMaterial VoxelMaterial) const
 {
-    if (const FVoxelMaterialConfig* Config = Materials.Find(VoxelMaterial))
+    if (const FVoxelMaterialConfig* Config = FindConfig(VoxelMaterial))
     {
         return Config->BaseColor;
     }
     
     return FLinearColor::White;
-}
\ No newline at end of file
+}
+
+EVoxelMaterial UVoxelMaterialSet::FindMaterialByName(FName MaterialName) const
+{
+    for (const TPair<uint8, FVoxelMaterialConfig>& Pair : MaterialConfigs)
+    {
+        if (!MaterialName.IsNone() && Pair.Value.Name == MaterialName)
+        {
+            return static_cast<EVoxelMaterial>(Pair.Key);
+        }
+    }
+    
+    return EVoxelMaterial::Max;
+}
+
+UTexture2D* UVoxelMaterialSet::GetPaletteTexture()
+{
+    if (PaletteTexture)
+    {
+        return PaletteTexture;
+    }
+    
+    PaletteTexture = UTexture2D::CreateTransient(256, 1, PF_B8G8R8A8);
+    if (!PaletteTexture)
+    {
+        return nullptr;
+    }
+    
+    PaletteTexture->Filter = TF_Nearest;
+    PaletteTexture->SRGB = true;
+    
+    FTexture2DMipMap& Mip = PaletteTexture->GetPlatformData()->Mips[0];
+    FColor* Colors = static_cast<FColor*>(Mip.BulkData.Lock(LOCK_READ_WRITE));
+    for (int32 Index = 0; Index < 256; Index++)
+    {
+        Colors[Index] = GetBaseColor(static_cast<EVoxelMaterial>(Index)).ToFColor(true);
+    }
+    Mip.BulkData.Unlock();
+    
+    PaletteTexture->UpdateResource();
+    return PaletteTexture;
+}
@@ -10,17 +10,50 @@
 #include "VoxelPerformanceTest.h"
 #include "VoxelBlueprintLibrary.h"
 #include "VoxelWorldTemplate.h"
+#include "VoxelWorldSnapshot.h"
+#include "VoxelTerrainGenerator.h"
+#include "VoxelTrace.h"
+#include "VoxelPerformanceStats.h"
+#include "VoxelCalibration.h"
+#include "VoxelDebugRenderer.h"
 #include "Engine/AssetManager.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "UObject/SavePackage.h"
 #include "Misc/PackageName.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Hash/CityHash.h"
 
 #if WITH_EDITOR
+#include "Editor.h"
 #include "Misc/MessageDialog.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #endif
 
+static FAutoConsoleCommandWithWorldAndArgs VoxelMemReportCommand(
+    TEXT("voxel.memreport"),
+    TEXT("Print voxel memory per subsystem, LOD and chunk state for every voxel world."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World)
+        {
+            return;
+        }
+        
+        int32 WorldCount = 0;
+        for (TActorIterator<AVoxelWorld> It(World); It; ++It)
+        {
+            UE_LOG(LogHearthshireVoxel, Display, TEXT("%s"), *It->GetMemoryReport());
+            WorldCount++;
+        }
+        
+        if (WorldCount == 0)
+        {
+            UE_LOG(LogHearthshireVoxel, Display, TEXT("voxel.memreport: No voxel world in %s"), *World->GetName());
+        }
+    }));
+
 AVoxelWorld::AVoxelWorld()
 {
     PrimaryActorTick.bCanEverTick = true;
@@ -44,6 +77,18 @@ void AVoxelWorld::BeginPlay()
     UE_LOG(LogHearthshireVoxel, Warning, TEXT("  bFlatWorldMode = %s"), bFlatWorldMode ? TEXT("TRUE") : TEXT("FALSE"));
     UE_LOG(LogHearthshireVoxel, Warning, TEXT("  ActiveChunks.Num() = %d"), ActiveChunks.Num());
     
+    // Template chunks are stored at the size they were saved with
+    if (bUseTemplate && WorldTemplate)
+    {
+        const FVoxelChunkSize TemplateSize = WorldTemplate->GetChunkDimensions();
+        if (TemplateSize.ToIntVector() != Config.GetChunkDimensions().ToIntVector())
+        {
+            UE_LOG(LogHearthshireVoxel, Log, TEXT("Using template chunk size %dx%dx%d"), TemplateSize.X, TemplateSize.Y, TemplateSize.Z);
+            Config.ChunkSize = TemplateSize.X;
+            Config.ChunkHeight = TemplateSize.Z == TemplateSize.X ? 0 : TemplateSize.Z;
+        }
+    }
+    
     // Find all chunk actors that exist in the world (created in editor)
     if (bPreserveEditorChunks)
     {
@@ -95,7 +140,7 @@ void AVoxelWorld::BeginPlay()
                         }
                         
                         // Ensure chunk is properly initialized
-                        Chunk->InitializeChunk(ChunkPos, FVoxelChunkSize(Config.ChunkSize), this);
+                        Chunk->InitializeChunk(ChunkPos, Config.GetChunkDimensions(), this);
                         
                         // Mark as generated to prevent regeneration
                         ChunkComp->MarkAsGenerated();
@@ -134,6 +179,18 @@ void AVoxelWorld::BeginPlay()
         }
     }
     
+    // Device-specific streaming settings, measured on first launch
+    if (bAutoCalibrate)
+    {
+        // Preserved chunks and templates were built with the configured chunk size, and column chunks are a deliberate choice
+        const bool bChunkSizeFixed = bUseTemplate || ActiveChunks.Num() > 0 || Config.ChunkHeight > 0;
+        const FVoxelCalibrationResult Calibration = FVoxelCalibration::GetOrRun(CalibrationTargetFPS);
+        FVoxelCalibration::ApplyToConfig(Calibration, Config, !bChunkSizeFixed);
+        
+        UE_LOG(LogHearthshireVoxel, Log, TEXT("Applied voxel calibration: ChunkSize %d, Workers %d, ChunksPerFrame %d, ViewDistance %d"),
+            Config.ChunkSize, Config.MaxConcurrentChunkGenerations, Config.MaxChunksPerFrame, Config.ViewDistanceInChunks);
+    }
+    
     // Find player to track
     if (UWorld* World = GetWorld())
     {
@@ -146,6 +203,7 @@ void AVoxelWorld::BeginPlay()
     // Pre-allocate chunk pool
     UE_LOG(LogHearthshireVoxel, Log, TEXT("Pre-allocating %d chunks for pool"), Config.ChunkPoolSize);
     
+    VOXEL_LLM_SCOPE(Cache);
     for (int32 i = 0; i < Config.ChunkPoolSize; i++)
     {
         if (AVoxelChunk* NewChunk = GetWorld()->SpawnActor<AVoxelChunk>(AVoxelChunk::StaticClass()))
@@ -160,6 +218,17 @@ void AVoxelWorld::BeginPlay()
     
     UE_LOG(LogHearthshireVoxel, Log, TEXT("VoxelWorld initialized with %d pooled chunks"), ChunkPool.Num());
     
+    // Chunks built by the previous Play-In-Editor session, where nothing changed since
+    if (bUsePIESnapshot && GetWorld()->IsPlayInEditor())
+    {
+        RestorePIESnapshot();
+        
+#if WITH_EDITOR
+        // Chunks clear their meshes in their own EndPlay, so capture before PIE teardown reaches any actor
+        FEditorDelegates::PrePIEEnded.AddUObject(this, &AVoxelWorld::HandlePrePIEEnded);
+#endif
+    }
+    
     // If we have preserved chunks and dynamic generation is disabled, we're done
     if (ActiveChunks.Num() > 0 && bDisableDynamicGeneration)
     {
@@ -172,6 +241,10 @@ void AVoxelWorld::BeginPlay()
 
 void AVoxelWorld::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+#if WITH_EDITOR
+    FEditorDelegates::PrePIEEnded.RemoveAll(this);
+#endif
+    
     // Clean up all chunks
     for (auto& ChunkPair : ActiveChunks)
     {
@@ -230,6 +303,17 @@ void AVoxelWorld::Tick(float DeltaTime)
         ProcessChunkTasks();
     }
     
+#if ENABLE_DRAW_DEBUG
+    FVoxelDebugRenderer::Draw(*this);
+#endif
+    
+    // Close this frame's performance totals
+    FVoxelPerformanceMonitor& PerformanceMonitor = FVoxelPerformanceMonitor::Get();
+    if (PerformanceMonitor.IsMonitoring())
+    {
+        PerformanceMonitor.RecordChunkUpdate(ActiveChunks.Num(), WorldStats.MemoryUsageMB);
+    }
+    
     // Memory management
     MemoryCheckTimer += DeltaTime;
     if (MemoryCheckTimer >= MemoryCheckInterval)
@@ -282,18 +366,22 @@ AVoxelChunk* AVoxelWorld::GetOrCreateChunk(const FIntVector& ChunkPosition)
     }
     
     // Initialize chunk
-    FVoxelChunkSize ChunkSize(Config.ChunkSize);
+    const FVoxelChunkSize ChunkSize = Config.GetChunkDimensions();
     NewChunk->InitializeChunk(ChunkPosition, ChunkSize, this);
     
     // Set up chunk component
     if (UVoxelChunkComponent* ChunkComp = NewChunk->ChunkComponent)
     {
         ChunkComp->OnChunkGenerated.AddDynamic(this, &AVoxelWorld::OnChunkGenerated);
+        ChunkComp->MarkStreamingRequest();
+        
+        const double GenerateStartTime = FPlatformTime::Seconds();
         
         // Check if we should load from template
         bool bLoadedFromTemplate = false;
         if (bUseTemplate && WorldTemplate)
         {
+            VOXEL_LLM_SCOPE(Templates);
             FVoxelChunkData TemplateChunkData;
             if (LoadChunkFromTemplate(ChunkPosition, TemplateChunkData))
             {
@@ -306,60 +394,33 @@ AVoxelChunk* AVoxelWorld::GetOrCreateChunk(const FIntVector& ChunkPosition)
         // If not loaded from template and chunk hasn't been manually generated, generate procedurally
         if (!bLoadedFromTemplate && !ChunkComp->HasBeenGenerated())
         {
-            // Generate smooth rolling hills using Perlin noise
-            const float NoiseScale = 0.03f; // Adjust for hill frequency
-            const float HeightScale = 10.0f; // Max height variation
-            const float BaseHeight = 10.0f; // Base terrain height
+            VOXEL_TRACE_SCOPE(Voxel_GenerateTerrain);
+            VOXEL_LLM_SCOPE(Data);
             
+            // Generate smooth rolling hills using Perlin noise
             for (int32 Y = 0; Y < ChunkSize.Y; Y++)
             {
                 for (int32 X = 0; X < ChunkSize.X; X++)
                 {
-                    // Calculate world position for seamless noise across chunks
-                    float WorldX = (ChunkPosition.X * ChunkSize.X + X) * NoiseScale;
-                    float WorldY = (ChunkPosition.Y * ChunkSize.Y + Y) * NoiseScale;
+                    // World position keeps the noise seamless across chunks
+                    const int32 TerrainHeight = FVoxelTerrainGenerator::GetRollingHillsHeight(
+                        ChunkPosition.X * ChunkSize.X + X,
+                        ChunkPosition.Y * ChunkSize.Y + Y);
                     
-                    // Generate height using 2D Perlin noise
-                    float NoiseValue = FMath::PerlinNoise2D(FVector2D(WorldX, WorldY));
-                    // Convert from [-1, 1] to [0, 1]
-                    NoiseValue = (NoiseValue + 1.0f) * 0.5f;
-                    
-                    // Calculate terrain height (5-15 voxels)
-                    int32 TerrainHeight = FMath::FloorToInt(BaseHeight + NoiseValue * HeightScale);
-                    TerrainHeight = FMath::Clamp(TerrainHeight, 5, 15);
-                    
-                    // Fill voxels from bottom to height
-                    for (int32 Z = 0; Z < ChunkSize.Z; Z++)
+                    // Fill voxels from bottom to height, leaving air above
+                    for (int32 Z = 0; Z < TerrainHeight && Z < ChunkSize.Z; Z++)
                     {
-                        if (Z < TerrainHeight)
-                        {
-                            EVoxelMaterial Material;
-                            
-                            // Top layer is grass
-                            if (Z == TerrainHeight - 1)
-                            {
-                                Material = EVoxelMaterial::Grass;
-                            }
-                            // Next 3 layers are dirt
-                            else if (Z >= TerrainHeight - 4)
-                            {
-                                Material = EVoxelMaterial::Dirt;
-                            }
-                            // Everything else is stone
-                            else
-                            {
-                                Material = EVoxelMaterial::Stone;
-                            }
-                            
-                            ChunkComp->SetVoxel(X, Y, Z, Material);
-                        }
-                        // else leave as air
+                        ChunkComp->SetGeneratedVoxel(X, Y, Z, FVoxelTerrainGenerator::GetSurfaceMaterial(Z, TerrainHeight));
                     }
                 }
             }
             
             // Don't generate mesh here - let QueueChunkGeneration handle it
         }
+        
+        FVoxelPerformanceMonitor::Get().RecordLatency(EVoxelLatencyStage::Generate,
+            (FPlatformTime::Seconds() - GenerateStartTime) * 1000.0);
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::DataReady, ChunkPosition, ChunkComp->GetCurrentLOD());
     }
     
     // Add to active chunks
@@ -386,6 +447,15 @@ void AVoxelWorld::UnloadChunk(const FIntVector& ChunkPosition)
     
     AVoxelChunk* Chunk = *ChunkPtr;
     
+    FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::Evicted, ChunkPosition,
+        Chunk->ChunkComponent ? Chunk->ChunkComponent->GetCurrentLOD() : EVoxelChunkLOD::Unloaded);
+    
+    // Never became visible, so it does not count towards request latency
+    if (Chunk->ChunkComponent)
+    {
+        Chunk->ChunkComponent->ClearStreamingRequest();
+    }
+    
     // Remove from active chunks
     ActiveChunks.Remove(ChunkPosition);
     
@@ -418,36 +488,121 @@ void AVoxelWorld::SetVoxel(const FVector& WorldPosition, EVoxelMaterial Material
     if (Chunk && Chunk->ChunkComponent)
     {
         Chunk->ChunkComponent->SetVoxel(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z, Material);
-        
-        // Check if we need to update neighboring chunks
-        bool bNeedsNeighborUpdate = false;
-        if (LocalVoxel.X == 0 || LocalVoxel.X == Config.ChunkSize - 1) bNeedsNeighborUpdate = true;
-        if (LocalVoxel.Y == 0 || LocalVoxel.Y == Config.ChunkSize - 1) bNeedsNeighborUpdate = true;
-        if (LocalVoxel.Z == 0 || LocalVoxel.Z == Config.ChunkSize - 1) bNeedsNeighborUpdate = true;
-        
-        if (bNeedsNeighborUpdate)
+        QueueBorderNeighbors(ChunkPos, LocalVoxel);
+    }
+}
+
+void AVoxelWorld::QueueBorderNeighbors(const FIntVector& ChunkPos, const FIntVector& LocalVoxel)
+{
+    // Check if we need to update neighboring chunks
+    const FVoxelChunkSize ChunkSize = Config.GetChunkDimensions();
+    bool bNeedsNeighborUpdate = false;
+    if (LocalVoxel.X == 0 || LocalVoxel.X == ChunkSize.X - 1) bNeedsNeighborUpdate = true;
+    if (LocalVoxel.Y == 0 || LocalVoxel.Y == ChunkSize.Y - 1) bNeedsNeighborUpdate = true;
+    if (LocalVoxel.Z == 0 || LocalVoxel.Z == ChunkSize.Z - 1) bNeedsNeighborUpdate = true;
+    
+    if (!bNeedsNeighborUpdate)
+    {
+        return;
+    }
+    
+    // Queue neighbor chunks for regeneration
+    for (int32 DX = -1; DX <= 1; DX++)
+    {
+        for (int32 DY = -1; DY <= 1; DY++)
         {
-            // Queue neighbor chunks for regeneration
-            for (int32 DX = -1; DX <= 1; DX++)
+            for (int32 DZ = -1; DZ <= 1; DZ++)
             {
-                for (int32 DY = -1; DY <= 1; DY++)
+                if (DX == 0 && DY == 0 && DZ == 0) continue;
+                
+                FIntVector NeighborPos = ChunkPos + FIntVector(DX, DY, DZ);
+                if (ActiveChunks.Contains(NeighborPos))
                 {
-                    for (int32 DZ = -1; DZ <= 1; DZ++)
-                    {
-                        if (DX == 0 && DY == 0 && DZ == 0) continue;
-                        
-                        FIntVector NeighborPos = ChunkPos + FIntVector(DX, DY, DZ);
-                        if (ActiveChunks.Contains(NeighborPos))
-                        {
-                            QueueChunkGeneration(NeighborPos, 1, true);
-                        }
-                    }
+                    QueueChunkGeneration(NeighborPos, 1, true);
                 }
             }
         }
     }
 }
 
+bool AVoxelWorld::RefineVoxel(const FVector& WorldPosition, int32 Resolution)
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    AVoxelChunk* Chunk = GetOrCreateChunk(ChunkPos);
+    if (!Chunk || !Chunk->ChunkComponent)
+    {
+        return false;
+    }
+    
+    const bool bWasRefined = Chunk->ChunkComponent->GetVoxel(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z) == EVoxelMaterial::Refined;
+    if (!Chunk->ChunkComponent->RefineVoxel(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z, Resolution))
+    {
+        return false;
+    }
+    
+    if (!bWasRefined)
+    {
+        QueueBorderNeighbors(ChunkPos, LocalVoxel);
+    }
+    return true;
+}
+
+bool AVoxelWorld::SetSubVoxel(const FVector& WorldPosition, EVoxelMaterial Material)
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos);
+    UVoxelChunkComponent* ChunkComp = (ChunkPtr && *ChunkPtr) ? (*ChunkPtr)->ChunkComponent : nullptr;
+    const FVoxelRefinedCell* Cell = ChunkComp ? ChunkComp->GetChunkData().FindRefinedCell(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z) : nullptr;
+    if (!Cell)
+    {
+        return false;
+    }
+    
+    const FIntVector SubVoxel = WorldToSubVoxel(WorldPosition, ChunkPos, LocalVoxel, Cell->Resolution);
+    if (!ChunkComp->SetSubVoxel(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z, SubVoxel, Material))
+    {
+        return false;
+    }
+    
+    QueueBorderNeighbors(ChunkPos, LocalVoxel);
+    return true;
+}
+
+EVoxelMaterial AVoxelWorld::GetSubVoxel(const FVector& WorldPosition) const
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos);
+    const UVoxelChunkComponent* ChunkComp = (ChunkPtr && *ChunkPtr) ? (*ChunkPtr)->ChunkComponent : nullptr;
+    if (!ChunkComp)
+    {
+        return EVoxelMaterial::Air;
+    }
+    
+    const FVoxelRefinedCell* Cell = ChunkComp->GetChunkData().FindRefinedCell(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z);
+    if (!Cell)
+    {
+        return ChunkComp->GetVoxel(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z);
+    }
+    return ChunkComp->GetSubVoxel(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z, WorldToSubVoxel(WorldPosition, ChunkPos, LocalVoxel, Cell->Resolution));
+}
+
+FIntVector AVoxelWorld::WorldToSubVoxel(const FVector& WorldPosition, const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, int32 Resolution) const
+{
+    const FVector InVoxel = WorldPosition - ChunkToWorldPosition(ChunkPosition) - FVector(LocalVoxel) * VoxelSize;
+    const float SubSize = VoxelSize / Resolution;
+    return FIntVector(
+        FMath::Clamp(FMath::FloorToInt(InVoxel.X / SubSize), 0, Resolution - 1),
+        FMath::Clamp(FMath::FloorToInt(InVoxel.Y / SubSize), 0, Resolution - 1),
+        FMath::Clamp(FMath::FloorToInt(InVoxel.Z / SubSize), 0, Resolution - 1)
+    );
+}
+
 EVoxelMaterial AVoxelWorld::GetVoxel(const FVector& WorldPosition) const
 {
     FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
@@ -467,6 +622,86 @@ EVoxelMaterial AVoxelWorld::GetVoxel(const FVector& WorldPosition) const
     return EVoxelMaterial::Air;
 }
 
+uint16 AVoxelWorld::GetVoxelChannel(const FVector& WorldPosition, EVoxelChannel Channel) const
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    if (AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos))
+    {
+        if (*ChunkPtr && (*ChunkPtr)->ChunkComponent)
+        {
+            return (*ChunkPtr)->ChunkComponent->GetChannelValue(Channel, LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z);
+        }
+    }
+    
+    return 0;
+}
+
+bool AVoxelWorld::SetVoxelChannel(const FVector& WorldPosition, EVoxelChannel Channel, uint16 Value)
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    if (AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos))
+    {
+        if (*ChunkPtr && (*ChunkPtr)->ChunkComponent)
+        {
+            return (*ChunkPtr)->ChunkComponent->SetChannelValue(Channel, LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z, Value);
+        }
+    }
+    
+    return false;
+}
+
+const FVoxelBlockEntity* AVoxelWorld::FindBlockEntity(const FVector& WorldPosition) const
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    if (AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos))
+    {
+        if (*ChunkPtr && (*ChunkPtr)->ChunkComponent)
+        {
+            return (*ChunkPtr)->ChunkComponent->FindBlockEntity(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z);
+        }
+    }
+    
+    return nullptr;
+}
+
+bool AVoxelWorld::SetBlockEntity(const FVector& WorldPosition, const FVoxelBlockEntity& Entity)
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    if (AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos))
+    {
+        if (*ChunkPtr && (*ChunkPtr)->ChunkComponent)
+        {
+            return (*ChunkPtr)->ChunkComponent->SetBlockEntity(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z, Entity);
+        }
+    }
+    
+    return false;
+}
+
+bool AVoxelWorld::RemoveBlockEntity(const FVector& WorldPosition)
+{
+    const FIntVector ChunkPos = WorldToChunkPosition(WorldPosition);
+    const FIntVector LocalVoxel = WorldToLocalVoxel(WorldPosition, ChunkPos);
+    
+    if (AVoxelChunk* const* ChunkPtr = ActiveChunks.Find(ChunkPos))
+    {
+        if (*ChunkPtr && (*ChunkPtr)->ChunkComponent)
+        {
+            return (*ChunkPtr)->ChunkComponent->RemoveBlockEntity(LocalVoxel.X, LocalVoxel.Y, LocalVoxel.Z);
+        }
+    }
+    
+    return false;
+}
+
 void AVoxelWorld::SetVoxelSphere(const FVector& Center, float Radius, EVoxelMaterial Material)
 {
     // Calculate affected chunks
@@ -474,6 +709,7 @@ void AVoxelWorld::SetVoxelSphere(const FVector& Center, float Radius, EVoxelMate
     FIntVector MaxChunk = WorldToChunkPosition(Center + FVector(Radius));
     
     TArray<FIntVector> AffectedChunks;
+    const FVoxelChunkSize ChunkSize = Config.GetChunkDimensions();
     
     for (int32 X = MinChunk.X; X <= MaxChunk.X; X++)
     {
@@ -489,13 +725,14 @@ void AVoxelWorld::SetVoxelSphere(const FVector& Center, float Radius, EVoxelMate
                     bool bChunkModified = false;
                     
                     // Modify voxels within sphere
-                    for (int32 VX = 0; VX < Config.ChunkSize; VX++)
+                    const FVector ChunkWorldPos = ChunkToWorldPosition(ChunkPos);
+                    for (int32 VX = 0; VX < ChunkSize.X; VX++)
                     {
-                        for (int32 VY = 0; VY < Config.ChunkSize; VY++)
+                        for (int32 VY = 0; VY < ChunkSize.Y; VY++)
                         {
-                            for (int32 VZ = 0; VZ < Config.ChunkSize; VZ++)
+                            for (int32 VZ = 0; VZ < ChunkSize.Z; VZ++)
                             {
-                                FVector VoxelWorldPos = FVector(ChunkPos * Config.ChunkSize + FIntVector(VX, VY, VZ)) * VoxelSize;
+                                FVector VoxelWorldPos = ChunkWorldPos + FVector(VX, VY, VZ) * VoxelSize;
                                 float Distance = FVector::Dist(VoxelWorldPos + FVector(VoxelSize * 0.5f), Center);
                                 
                                 if (Distance <= Radius)
@@ -525,16 +762,17 @@ void AVoxelWorld::SetVoxelSphere(const FVector& Center, float Radius, EVoxelMate
 
 FIntVector AVoxelWorld::WorldToChunkPosition(const FVector& WorldPosition) const
 {
+    const FVector ChunkWorldSize = Config.GetChunkWorldSize(VoxelSize);
     return FIntVector(
-        FMath::FloorToInt(WorldPosition.X / (Config.ChunkSize * VoxelSize)),
-        FMath::FloorToInt(WorldPosition.Y / (Config.ChunkSize * VoxelSize)),
-        FMath::FloorToInt(WorldPosition.Z / (Config.ChunkSize * VoxelSize))
+        FMath::FloorToInt(WorldPosition.X / ChunkWorldSize.X),
+        FMath::FloorToInt(WorldPosition.Y / ChunkWorldSize.Y),
+        FMath::FloorToInt(WorldPosition.Z / ChunkWorldSize.Z)
     );
 }
 
 FIntVector AVoxelWorld::WorldToLocalVoxel(const FVector& WorldPosition, const FIntVector& ChunkPosition) const
 {
-    FVector ChunkWorldPos = FVector(ChunkPosition) * Config.ChunkSize * VoxelSize;
+    FVector ChunkWorldPos = ChunkToWorldPosition(ChunkPosition);
     FVector LocalPos = WorldPosition - ChunkWorldPos;
     
     return FIntVector(
@@ -544,6 +782,11 @@ FIntVector AVoxelWorld::WorldToLocalVoxel(const FVector& WorldPosition, const FI
     );
 }
 
+FVector AVoxelWorld::ChunkToWorldPosition(const FIntVector& ChunkPosition) const
+{
+    return FVector(ChunkPosition) * Config.GetChunkWorldSize(VoxelSize);
+}
+
 FVoxelPerformanceStats AVoxelWorld::GetWorldStats() const
 {
     return WorldStats;
@@ -551,7 +794,13 @@ FVoxelPerformanceStats AVoxelWorld::GetWorldStats() const
 
 void AVoxelWorld::UpdateChunks()
 {
-    if (!TrackedPlayer || bDisableDynamicGeneration)
+#if VOXEL_ENABLE_STATS
+    SCOPE_CYCLE_COUNTER(STAT_ChunkUpdate);
+#endif
+    VOXEL_TRACE_SCOPE(Voxel_UpdateChunks);
+    
+    FVector PlayerPosition;
+    if (!GetStreamingSourcePosition(PlayerPosition) || bDisableDynamicGeneration)
     {
         UE_LOG(LogHearthshireVoxel, VeryVerbose, TEXT("UpdateChunks: Skipping - TrackedPlayer=%p, bDisableDynamicGeneration=%d"), 
             TrackedPlayer, bDisableDynamicGeneration ? 1 : 0);
@@ -562,23 +811,26 @@ void AVoxelWorld::UpdateChunks()
     UE_LOG(LogHearthshireVoxel, Warning, TEXT("  bFlatWorldMode = %s"), bFlatWorldMode ? TEXT("TRUE") : TEXT("FALSE"));
     UE_LOG(LogHearthshireVoxel, Warning, TEXT("  bDisableDynamicGeneration = %s (should be TRUE!)"), bDisableDynamicGeneration ? TEXT("TRUE") : TEXT("FALSE"));
     
-    FVector PlayerPosition = TrackedPlayer->GetActorLocation();
     FIntVector PlayerChunk = WorldToChunkPosition(PlayerPosition);
     
     // Load chunks around player
     int32 ViewDistance = Config.ViewDistanceInChunks;
     
+    // Determine Z range based on flat world mode
+    int32 MinZ = 0;
+    int32 MaxZ = 0;
+    if (!bFlatWorldMode)
+    {
+        GetVerticalChunkRange(PlayerPosition, MinZ, MaxZ);
+    }
+    
     for (int32 X = -ViewDistance; X <= ViewDistance; X++)
     {
         for (int32 Y = -ViewDistance; Y <= ViewDistance; Y++)
         {
-            // Determine Z range based on flat world mode
-            int32 MinZ = bFlatWorldMode ? 0 : -2;
-            int32 MaxZ = bFlatWorldMode ? 0 : 2;
-            
             for (int32 Z = MinZ; Z <= MaxZ; Z++)
             {
-                FIntVector ChunkPos = PlayerChunk + FIntVector(X, Y, Z);
+                FIntVector ChunkPos = FIntVector(PlayerChunk.X + X, PlayerChunk.Y + Y, Z);
                 
                 if (ShouldLoadChunk(ChunkPos) && !ActiveChunks.Contains(ChunkPos))
                 {
@@ -614,9 +866,11 @@ void AVoxelWorld::ProcessChunkTasks()
         return;
     }
     
+    VOXEL_TRACE_SCOPE(Voxel_ProcessChunkTasks);
+    
     int32 TasksProcessed = 0;
     
-    while (ActiveGenerations.GetValue() < Config.MaxConcurrentChunkGenerations && TasksProcessed < MaxChunksPerFrame)
+    while (ActiveGenerations.GetValue() < Config.MaxConcurrentChunkGenerations && TasksProcessed < Config.MaxChunksPerFrame)
     {
         FVoxelChunkTask Task;
         
@@ -626,8 +880,14 @@ void AVoxelWorld::ProcessChunkTasks()
             {
                 break;
             }
+            
+            QueuedTaskCount--;
+            FVoxelTrace::SetQueueDepth(QueuedTaskCount);
         }
         
+        const float QueueWaitMs = (FPlatformTime::Seconds() - Task.QueuedTime) * 1000.0;
+        FVoxelPerformanceMonitor::Get().RecordLatency(EVoxelLatencyStage::QueueWait, QueueWaitMs);
+        
         // Check if chunk still exists and needs generation
         if (AVoxelChunk** ChunkPtr = ActiveChunks.Find(Task.ChunkPosition))
         {
@@ -643,6 +903,7 @@ void AVoxelWorld::ProcessChunkTasks()
                     
                     if (ChunkComp->GetState() != EVoxelChunkState::Ready || Task.bIsRegeneration)
                     {
+                        ChunkComp->LastQueueWaitMs = QueueWaitMs;
                         ActiveGenerations.Increment();
                         ChunkComp->GenerateMesh(true);
                     }
@@ -652,11 +913,15 @@ void AVoxelWorld::ProcessChunkTasks()
         
         TasksProcessed++;
     }
+    
+    FVoxelTrace::SetActiveGenerations(ActiveGenerations.GetValue());
 }
 
 void AVoxelWorld::UpdateMemoryUsage()
 {
-    float TotalMemoryMB = 0.0f;
+    VOXEL_TRACE_SCOPE(Voxel_UpdateMemoryUsage);
+    
+    FVoxelMemoryUsage TotalMemory;
     int32 TotalTriangles = 0;
     int32 TotalVertices = 0;
     
@@ -664,16 +929,19 @@ void AVoxelWorld::UpdateMemoryUsage()
     {
         if (ChunkPair.Value && ChunkPair.Value->ChunkComponent)
         {
-            FVoxelPerformanceStats ChunkStats = ChunkPair.Value->ChunkComponent->GetPerformanceStats();
+            UVoxelChunkComponent* ChunkComp = ChunkPair.Value->ChunkComponent;
+            FVoxelPerformanceStats ChunkStats = ChunkComp->GetPerformanceStats();
             TotalTriangles += ChunkStats.TriangleCount;
             TotalVertices += ChunkStats.VertexCount;
+            
+            // Refreshed here too, so compaction and channel writes since the last mesh apply show up
+            const FVoxelMemoryUsage ChunkMemory = ChunkComp->GetMemoryUsage();
+            ChunkComp->MemoryUsageMB = ChunkMemory.GetTotal() / (1024.0f * 1024.0f);
+            TotalMemory += ChunkMemory;
         }
     }
     
-    // Estimate memory usage
-    TotalMemoryMB = (ActiveChunks.Num() * 0.1f) + // Chunk overhead
-                    (TotalVertices * 32.0f / 1024.0f / 1024.0f) + // Vertex data
-                    (TotalTriangles * 12.0f / 1024.0f / 1024.0f); // Index data
+    const float TotalMemoryMB = TotalMemory.GetTotal() / (1024.0f * 1024.0f);
     
     WorldStats.ActiveChunks = ActiveChunks.Num();
     WorldStats.MemoryUsageMB = TotalMemoryMB;
@@ -681,6 +949,86 @@ void AVoxelWorld::UpdateMemoryUsage()
     WorldStats.VertexCount = TotalVertices;
 }
 
+FString AVoxelWorld::GetMemoryReport() const
+{
+    auto ToMB = [](int64 Bytes) { return Bytes / (1024.0 * 1024.0); };
+    
+    FVoxelMemoryUsage ActiveTotal;
+    FVoxelMemoryUsage PooledTotal;
+    
+    // Indexed by EVoxelChunkLOD and EVoxelChunkState
+    int32 LODChunks[5] = {};
+    int64 LODBytes[5] = {};
+    int32 StateChunks[6] = {};
+    int64 StateBytes[6] = {};
+    
+    for (const auto& ChunkPair : ActiveChunks)
+    {
+        if (ChunkPair.Value && ChunkPair.Value->ChunkComponent)
+        {
+            const UVoxelChunkComponent* ChunkComp = ChunkPair.Value->ChunkComponent;
+            const FVoxelMemoryUsage Usage = ChunkComp->GetMemoryUsage();
+            ActiveTotal += Usage;
+            
+            const int32 LODIndex = FMath::Clamp((int32)ChunkComp->GetCurrentLOD(), 0, 4);
+            LODChunks[LODIndex]++;
+            LODBytes[LODIndex] += Usage.GetTotal();
+            
+            const int32 StateIndex = FMath::Clamp((int32)ChunkComp->GetState(), 0, 5);
+            StateChunks[StateIndex]++;
+            StateBytes[StateIndex] += Usage.GetTotal();
+        }
+    }
+    
+    for (const AVoxelChunk* PooledChunk : ChunkPool)
+    {
+        if (PooledChunk && PooledChunk->ChunkComponent)
+        {
+            PooledTotal += PooledChunk->ChunkComponent->GetMemoryUsage();
+        }
+    }
+    
+    int64 TemplateBytes = 0;
+    if (WorldTemplate)
+    {
+        TemplateBytes += WorldTemplate->ChunkData.GetAllocatedSize();
+        for (const FVoxelTemplateChunk& TemplateChunk : WorldTemplate->ChunkData)
+        {
+            TemplateBytes += TemplateChunk.CompressedVoxelData.GetAllocatedSize();
+        }
+    }
+    
+    FString Report;
+    Report += FString::Printf(TEXT("=== Voxel Memory: %s ===\n"), *GetName());
+    Report += FString::Printf(TEXT("Active chunks: %d, pooled: %d\n\n"), ActiveChunks.Num(), ChunkPool.Num());
+    
+    Report += TEXT("Per subsystem (MB):\n");
+    Report += FString::Printf(TEXT("  Voxel Data:      %8.2f\n"), ToMB(ActiveTotal.VoxelData));
+    Report += FString::Printf(TEXT("  Mesh CPU:        %8.2f\n"), ToMB(ActiveTotal.MeshCPU));
+    Report += FString::Printf(TEXT("  Mesh GPU (est):  %8.2f\n"), ToMB(ActiveTotal.MeshGPU));
+    Report += FString::Printf(TEXT("  Collision:       %8.2f\n"), ToMB(ActiveTotal.Collision));
+    Report += FString::Printf(TEXT("  Material Volume: %8.2f\n"), ToMB(ActiveTotal.MaterialVolume));
+    Report += FString::Printf(TEXT("  Chunk Pool:      %8.2f\n"), ToMB(PooledTotal.GetTotal()));
+    Report += FString::Printf(TEXT("  Templates:       %8.2f\n"), ToMB(TemplateBytes));
+    Report += FString::Printf(TEXT("  Total:           %8.2f\n\n"), ToMB(ActiveTotal.GetTotal() + PooledTotal.GetTotal() + TemplateBytes));
+    
+    Report += TEXT("Per LOD:\n");
+    const TCHAR* LODNames[] = { TEXT("Unloaded"), TEXT("LOD3"), TEXT("LOD2"), TEXT("LOD1"), TEXT("LOD0") };
+    for (int32 Index = 4; Index >= 0; Index--)
+    {
+        Report += FString::Printf(TEXT("  %-14s %5d chunks %8.2f MB\n"), LODNames[Index], LODChunks[Index], ToMB(LODBytes[Index]));
+    }
+    
+    Report += TEXT("\nPer state:\n");
+    const TCHAR* StateNames[] = { TEXT("Uninitialized"), TEXT("Generating"), TEXT("Generated"), TEXT("Meshing"), TEXT("Ready"), TEXT("Unloading") };
+    for (int32 Index = 0; Index < 6; Index++)
+    {
+        Report += FString::Printf(TEXT("  %-14s %5d chunks %8.2f MB\n"), StateNames[Index], StateChunks[Index], ToMB(StateBytes[Index]));
+    }
+    
+    return Report;
+}
+
 void AVoxelWorld::EnforceMemoryBudget()
 {
     float CurrentMemoryMB = WorldStats.MemoryUsageMB;
@@ -705,11 +1053,12 @@ void AVoxelWorld::EnforceMemoryBudget()
         
         // Sort chunks by distance from player and unload furthest
         TArray<TPair<float, FIntVector>> ChunkDistances;
-        FVector PlayerPos = TrackedPlayer ? TrackedPlayer->GetActorLocation() : FVector::ZeroVector;
+        FVector PlayerPos = FVector::ZeroVector;
+        GetStreamingSourcePosition(PlayerPos);
         
         for (const auto& ChunkPair : ActiveChunks)
         {
-            FVector ChunkWorldPos = FVector(ChunkPair.Key) * Config.ChunkSize * VoxelSize;
+            FVector ChunkWorldPos = ChunkToWorldPosition(ChunkPair.Key);
             float Distance = FVector::Dist(ChunkWorldPos, PlayerPos);
             ChunkDistances.Add(TPair<float, FIntVector>(Distance, ChunkPair.Key));
         }
@@ -763,22 +1112,34 @@ void AVoxelWorld::QueueChunkGeneration(const FIntVector& ChunkPosition, int32 Pr
     Task.ChunkPosition = ChunkPosition;
     Task.Priority = Priority;
     Task.bIsRegeneration = bRegeneration;
+    Task.QueuedTime = FPlatformTime::Seconds();
     
     FScopeLock Lock(&TaskQueueLock);
     ChunkTaskQueue.Enqueue(Task);
+    QueuedTaskCount++;
+    FVoxelTrace::SetQueueDepth(QueuedTaskCount);
+    
+    const AVoxelChunk* Chunk = GetChunkAtPosition(ChunkPosition);
+    FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::Requested, ChunkPosition,
+        Chunk && Chunk->ChunkComponent ? Chunk->ChunkComponent->GetCurrentLOD() : EVoxelChunkLOD::Unloaded);
+    
+    if (Chunk && Chunk->ChunkComponent)
+    {
+        Chunk->ChunkComponent->MarkStreamingRequest();
+    }
     
     OnChunkGenerationQueued.Broadcast(ChunkPosition, Priority);
 }
 
 bool AVoxelWorld::ShouldLoadChunk(const FIntVector& ChunkPosition) const
 {
-    if (!TrackedPlayer)
+    FVector PlayerPos;
+    if (!GetStreamingSourcePosition(PlayerPos))
     {
         return false;
     }
     
-    FVector ChunkWorldPos = FVector(ChunkPosition) * Config.ChunkSize * VoxelSize;
-    FVector PlayerPos = TrackedPlayer->GetActorLocation();
+    FVector ChunkWorldPos = ChunkToWorldPosition(ChunkPosition);
     
     float Distance = FVector::Dist2D(ChunkWorldPos, PlayerPos);
     float MaxDistance = Config.ViewDistanceInChunks * Config.ChunkSize * VoxelSize;
@@ -788,21 +1149,59 @@ bool AVoxelWorld::ShouldLoadChunk(const FIntVector& ChunkPosition) const
 
 int32 AVoxelWorld::CalculateChunkPriority(const FIntVector& ChunkPosition) const
 {
-    if (!TrackedPlayer)
+    FVector PlayerPos;
+    if (!GetStreamingSourcePosition(PlayerPos))
     {
         return 999;
     }
     
-    FVector ChunkWorldPos = FVector(ChunkPosition) * Config.ChunkSize * VoxelSize;
-    FVector PlayerPos = TrackedPlayer->GetActorLocation();
+    FVector ChunkWorldPos = ChunkToWorldPosition(ChunkPosition);
     
     float Distance = FVector::Dist(ChunkWorldPos, PlayerPos);
     return FMath::Clamp(FMath::FloorToInt(Distance / 1000.0f), 0, 999);
 }
 
+void AVoxelWorld::GetVerticalChunkRange(const FVector& SourcePosition, int32& OutMinZ, int32& OutMaxZ) const
+{
+    // A 128 voxel column chunk covers the band in one or two layers where cubes need five
+    const float ChunkWorldHeight = Config.GetChunkWorldSize(VoxelSize).Z;
+    const float VerticalExtent = Config.VerticalViewDistanceInVoxels * VoxelSize;
+    OutMinZ = FMath::FloorToInt((SourcePosition.Z - VerticalExtent) / ChunkWorldHeight);
+    OutMaxZ = FMath::FloorToInt((SourcePosition.Z + VerticalExtent) / ChunkWorldHeight);
+}
+
+void AVoxelWorld::SetStreamingSourceOverride(const FVector& WorldPosition)
+{
+    bHasStreamingSourceOverride = true;
+    StreamingSourceOverride = WorldPosition;
+}
+
+void AVoxelWorld::ClearStreamingSourceOverride()
+{
+    bHasStreamingSourceOverride = false;
+}
+
+bool AVoxelWorld::GetStreamingSourcePosition(FVector& OutPosition) const
+{
+    if (bHasStreamingSourceOverride)
+    {
+        OutPosition = StreamingSourceOverride;
+        return true;
+    }
+    
+    if (TrackedPlayer)
+    {
+        OutPosition = TrackedPlayer->GetActorLocation();
+        return true;
+    }
+    
+    return false;
+}
+
 void AVoxelWorld::OnChunkGenerated(UVoxelChunkComponent* ChunkComponent)
 {
     ActiveGenerations.Decrement();
+    FVoxelTrace::SetActiveGenerations(ActiveGenerations.GetValue());
     
     if (ChunkComponent)
     {
@@ -811,6 +1210,12 @@ void AVoxelWorld::OnChunkGenerated(UVoxelChunkComponent* ChunkComponent)
         // Update world stats
         WorldStats.MeshGenerationTimeMs = FMath::Max(WorldStats.MeshGenerationTimeMs, ChunkStats.MeshGenerationTimeMs);
         WorldStats.GreedyMeshingTimeMs = FMath::Max(WorldStats.GreedyMeshingTimeMs, ChunkStats.GreedyMeshingTimeMs);
+        
+        // Terrain nobody has touched drops to column spans until its first edit
+        if (Config.bUseColumnStorage && ChunkComponent->LastEditTime <= 0.0)
+        {
+            ChunkComponent->CompactToColumns(Config.MaxColumnSpans);
+        }
     }
 }
 
@@ -863,6 +1268,239 @@ AVoxelChunk* AVoxelWorld::GetChunkAtPosition(const FIntVector& ChunkPosition) co
     return nullptr;
 }
 
+AVoxelChunk* AVoxelWorld::AdoptChunkData(const FVoxelChunkData& ChunkData)
+{
+    if (!ChunkData.HasVoxelData())
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("AdoptChunkData: Invalid voxel data for chunk %s"), *ChunkData.ChunkPosition.ToString());
+        return nullptr;
+    }
+    
+    AVoxelChunk* Chunk = GetChunkAtPosition(ChunkData.ChunkPosition);
+    const bool bIsNewChunk = (Chunk == nullptr);
+    
+    if (bIsNewChunk)
+    {
+        Chunk = GetChunkFromPool();
+        if (!Chunk)
+        {
+            Chunk = GetWorld()->SpawnActor<AVoxelChunk>(AVoxelChunk::StaticClass());
+            if (!Chunk)
+            {
+                UE_LOG(LogHearthshireVoxel, Error, TEXT("AdoptChunkData: Failed to spawn chunk at %s"), *ChunkData.ChunkPosition.ToString());
+                return nullptr;
+            }
+            Chunk->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+        }
+        
+        Chunk->InitializeChunk(ChunkData.ChunkPosition, ChunkData.ChunkSize, this);
+        ActiveChunks.Add(ChunkData.ChunkPosition, Chunk);
+    }
+    
+    if (UVoxelChunkComponent* ChunkComp = Chunk->ChunkComponent)
+    {
+        if (Config.MaterialSet)
+        {
+            ChunkComp->SetMaterialSet(Config.MaterialSet);
+        }
+        
+        ChunkComp->SetChunkData(ChunkData);
+        FVoxelTrace::ChunkEvent(EVoxelChunkTraceEvent::DataReady, ChunkData.ChunkPosition, ChunkComp->GetCurrentLOD());
+        ChunkComp->GenerateMesh(Config.bUseMultithreading);
+    }
+    
+    if (bIsNewChunk)
+    {
+        OnChunkLoaded.Broadcast(ChunkData.ChunkPosition);
+    }
+    
+    return Chunk;
+}
+
+FString AVoxelWorld::GetSnapshotKey() const
+{
+    return UWorld::RemovePIEPrefix(GetPackage()->GetName()) + TEXT(".") + GetName();
+}
+
+uint64 AVoxelWorld::GetSnapshotFingerprint() const
+{
+    // Only what shapes chunk content - streaming budgets change at runtime (quality governor) and don't.
+    // Template content is checked per chunk on restore, so only which template counts here
+    const FVoxelChunkSize ChunkSize = Config.GetChunkDimensions();
+    const UVoxelMaterialSet* MaterialSet = Config.MaterialSet;
+    const FString Settings = FString::Printf(TEXT("%d|%d|%d|%.3f|%s|%s|%s|%d|%s|%d|%d"),
+        ChunkSize.X, ChunkSize.Y, ChunkSize.Z, VoxelSize, *GetPathNameSafe(MaterialSet),
+        MaterialSet ? *GetPathNameSafe(MaterialSet->VolumeMaterial) : TEXT(""),
+        MaterialSet ? *GetPathNameSafe(MaterialSet->TranslucentMaterial) : TEXT(""),
+        bUseTemplate ? 1 : 0, *GetPathNameSafe(WorldTemplate), WorldSeed, bFlatWorldMode ? 1 : 0);
+    const uint64 SettingsHash = CityHash64(reinterpret_cast<const char*>(*Settings), Settings.Len() * sizeof(TCHAR));
+    
+    // Traits decide culling and which section a face lands in, and can change without the set's path changing.
+    // Packed field by field - the bitfield's unused bits are not initialized
+    const FVoxelMaterialTraitTable& Traits = MaterialSet ? MaterialSet->GetTraitTable() : FVoxelMaterialTraitTable::GetDefault();
+    uint32 PackedTraits[256];
+    for (int32 Index = 0; Index < 256; Index++)
+    {
+        const FVoxelMaterialTraits& Entry = Traits.Entries[Index];
+        PackedTraits[Index] = Entry.bSolid | (Entry.bOpaque << 1) | (Entry.bTranslucent << 2) | (Entry.bCullSameMaterial << 3)
+            | (Entry.bCollidable << 4) | (Entry.bWalkable << 5) | (Entry.bTickEnabled << 6)
+            | (Entry.LightEmission << 7) | (Entry.LightOpacity << 11);
+    }
+    return CityHash64WithSeed(reinterpret_cast<const char*>(PackedTraits), sizeof(PackedTraits), SettingsHash);
+}
+
+void AVoxelWorld::CapturePIESnapshot()
+{
+    VOXEL_TRACE_SCOPE(Voxel_CapturePIESnapshot);
+    
+    FVoxelWorldSnapshot Snapshot;
+    Snapshot.Fingerprint = GetSnapshotFingerprint();
+    Snapshot.CaptureTime = FPlatformTime::Seconds();
+    Snapshot.Chunks.Reserve(ActiveChunks.Num());
+    
+    int32 SkippedChunks = 0;
+    for (const auto& ChunkPair : ActiveChunks)
+    {
+        const UVoxelChunkComponent* ChunkComp = ChunkPair.Value ? ChunkPair.Value->ChunkComponent : nullptr;
+        
+        // Play-time edits stay in this session - edited and half-built chunks are rebuilt next time
+        if (!ChunkComp || !ChunkComp->IsReady() || ChunkComp->LastEditTime > 0.0 || ChunkComp->GetChunkData().bIsDirty)
+        {
+            SkippedChunks++;
+            continue;
+        }
+        
+        FVoxelChunkSnapshot& Chunk = Snapshot.Chunks.AddDefaulted_GetRef();
+        Chunk.ChunkData = ChunkComp->GetChunkData();
+        Chunk.MeshData = ChunkComp->GetMeshData();
+        Chunk.LOD = ChunkComp->GetCurrentLOD();
+        Chunk.bWasGenerated = ChunkComp->HasBeenGenerated();
+        Chunk.ContentHash = FVoxelWorldSnapshot::HashChunkContent(Chunk.ChunkData);
+        
+        // Channel values and block entities are play state that doesn't mark the chunk edited. Procedural
+        // generation writes neither, and template chunks are reloaded from the template on restore
+        Chunk.ChunkData.Channels.Reset();
+        Chunk.ChunkData.BlockEntities.Reset();
+    }
+    
+    const FString Key = GetSnapshotKey();
+    if (Snapshot.Chunks.Num() == 0)
+    {
+        FVoxelWorldSnapshot::Discard(Key);
+        return;
+    }
+    
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("CapturePIESnapshot: Captured %d chunks, skipped %d edited or unfinished"), Snapshot.Chunks.Num(), SkippedChunks);
+    FVoxelWorldSnapshot::Store(Key, MoveTemp(Snapshot));
+}
+
+#if WITH_EDITOR
+void AVoxelWorld::HandlePrePIEEnded(const bool bIsSimulating)
+{
+    // Built chunks outlive the session so the next one can skip rebuilding them
+    CapturePIESnapshot();
+}
+#endif
+
+int32 AVoxelWorld::RestorePIESnapshot()
+{
+    const FString Key = GetSnapshotKey();
+    const FVoxelWorldSnapshot* Snapshot = FVoxelWorldSnapshot::Find(Key);
+    if (!Snapshot)
+    {
+        return 0;
+    }
+    
+    if (Snapshot->Fingerprint != GetSnapshotFingerprint())
+    {
+        UE_LOG(LogHearthshireVoxel, Log, TEXT("RestorePIESnapshot: World settings changed since the last session, rebuilding all chunks"));
+        FVoxelWorldSnapshot::Discard(Key);
+        return 0;
+    }
+    
+    VOXEL_TRACE_SCOPE(Voxel_RestorePIESnapshot);
+    const double StartTime = FPlatformTime::Seconds();
+    
+    int32 RestoredChunks = 0;
+    int32 StaleChunks = 0;
+    for (const FVoxelChunkSnapshot& Entry : Snapshot->Chunks)
+    {
+        const FIntVector ChunkPosition = Entry.ChunkData.ChunkPosition;
+        if (bFlatWorldMode && ChunkPosition.Z != 0)
+        {
+            continue;
+        }
+        
+        // Preserved editor chunks keep their own data; the old mesh is only good for the data it was built from
+        if (AVoxelChunk* ExistingChunk = GetChunkAtPosition(ChunkPosition))
+        {
+            UVoxelChunkComponent* ChunkComp = ExistingChunk->ChunkComponent;
+            if (ChunkComp && ChunkComp->GetChunkData().HasVoxelData() &&
+                FVoxelWorldSnapshot::HashChunkContent(ChunkComp->GetChunkData()) == Entry.ContentHash)
+            {
+                ChunkComp->ApplyPrebuiltMesh(Entry.MeshData, Entry.LOD, ChunkComp->HasBeenGenerated());
+                RestoredChunks++;
+            }
+            else
+            {
+                StaleChunks++;
+            }
+            continue;
+        }
+        
+        // Template chunks take their data from the template - channels and block entities included - and
+        // only the mesh from the snapshot. A template edited between sessions invalidates the chunks it changed
+        FVoxelChunkData TemplateChunkData;
+        const bool bFromTemplate = bUseTemplate && WorldTemplate;
+        if (bFromTemplate)
+        {
+            if (!LoadChunkFromTemplate(ChunkPosition, TemplateChunkData) ||
+                FVoxelWorldSnapshot::HashChunkContent(TemplateChunkData) != Entry.ContentHash)
+            {
+                StaleChunks++;
+                continue;
+            }
+        }
+        
+        AVoxelChunk* Chunk = GetChunkFromPool();
+        if (!Chunk)
+        {
+            Chunk = GetWorld()->SpawnActor<AVoxelChunk>(AVoxelChunk::StaticClass());
+            if (!Chunk)
+            {
+                UE_LOG(LogHearthshireVoxel, Error, TEXT("RestorePIESnapshot: Failed to spawn chunk at %s"), *ChunkPosition.ToString());
+                break;
+            }
+            Chunk->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+        }
+        
+        Chunk->InitializeChunk(ChunkPosition, Entry.ChunkData.ChunkSize, this);
+        ActiveChunks.Add(ChunkPosition, Chunk);
+        
+        if (UVoxelChunkComponent* ChunkComp = Chunk->ChunkComponent)
+        {
+            ChunkComp->SetChunkData(bFromTemplate ? TemplateChunkData : Entry.ChunkData);
+            ChunkComp->ApplyPrebuiltMesh(Entry.MeshData, Entry.LOD, Entry.bWasGenerated);
+            
+            // Template data arrives dense, as it would from GetOrCreateChunk before meshing
+            if (bFromTemplate && Config.bUseColumnStorage)
+            {
+                ChunkComp->CompactToColumns(Config.MaxColumnSpans);
+            }
+            
+            // Bound after the mesh is applied - OnChunkGenerated settles generations this world queued itself
+            ChunkComp->OnChunkGenerated.AddDynamic(this, &AVoxelWorld::OnChunkGenerated);
+        }
+        
+        OnChunkLoaded.Broadcast(ChunkPosition);
+        RestoredChunks++;
+    }
+    
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("RestorePIESnapshot: Restored %d chunks in %.1f ms, %d changed since the last session"),
+        RestoredChunks, (FPlatformTime::Seconds() - StartTime) * 1000.0, StaleChunks);
+    return RestoredChunks;
+}
+
 void AVoxelWorld::GenerateTestTerrain()
 {
     // Generate a 5x5 grid of chunks around origin
@@ -908,6 +1546,8 @@ void AVoxelWorld::GenerateFlatWorld()
             FVoxelChunkTask Task;
             ChunkTaskQueue.Dequeue(Task);
         }
+        QueuedTaskCount = 0;
+        FVoxelTrace::SetQueueDepth(0);
     }
     GeneratingChunks.Empty();
     
@@ -964,7 +1604,7 @@ void AVoxelWorld::GenerateFlatWorld()
                 {
                     for (int32 LocalZ = 0; LocalZ < ChunkSize.Z; LocalZ++)
                     {
-                        ChunkComp->SetVoxel(LocalX, LocalY, LocalZ, EVoxelMaterial::Air);
+                        ChunkComp->SetGeneratedVoxel(LocalX, LocalY, LocalZ, EVoxelMaterial::Air);
                     }
                 }
             }
@@ -989,10 +1629,11 @@ void AVoxelWorld::GenerateFlatWorld()
                             Material = EVoxelMaterial::Dirt;
                         }
                         
-                        ChunkComp->SetVoxel(LocalX, LocalY, LocalZ, Material);
+                        ChunkComp->SetGeneratedVoxel(LocalX, LocalY, LocalZ, Material);
                     }
                 }
             }
+            ChunkComp->NotifyVoxelsReplaced();
             
             // Log voxel count for debugging
             int32 VoxelCount = ChunkComp->GetVoxelCount();
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VoxelWorldSnapshot.h"
+#include "HearthshireVoxelModule.h"
+#include "Hash/CityHash.h"
+#include "HAL/IConsoleManager.h"
+
+namespace VoxelWorldSnapshot
+{
+    static TMap<FString, FVoxelWorldSnapshot>& GetSnapshots()
+    {
+        static TMap<FString, FVoxelWorldSnapshot> Snapshots;
+        return Snapshots;
+    }
+}
+
+static FAutoConsoleCommand VoxelClearSnapshotsCommand(
+    TEXT("voxel.snapshot.clear"),
+    TEXT("Drop every stored Play-In-Editor voxel world snapshot, so the next session rebuilds all chunks."),
+    FConsoleCommandDelegate::CreateStatic(&FVoxelWorldSnapshot::DiscardAll));
+
+int64 FVoxelWorldSnapshot::GetAllocatedSize() const
+{
+    int64 Size = Chunks.GetAllocatedSize();
+    for (const FVoxelChunkSnapshot& Chunk : Chunks)
+    {
+        Size += Chunk.ChunkData.Voxels.GetAllocatedSize() + Chunk.ChunkData.Columns.GetAllocatedSize() +
+            Chunk.ChunkData.Channels.GetAllocatedSize() + Chunk.ChunkData.Refinement.GetAllocatedSize() +
+            Chunk.ChunkData.BlockEntities.GetAllocatedSize() + Chunk.MeshData.GetAllocatedSize();
+    }
+    return Size;
+}
+
+uint64 FVoxelWorldSnapshot::HashChunkContent(const FVoxelChunkData& ChunkData)
+{
+    const FIntVector Size = ChunkData.ChunkSize.ToIntVector();
+    uint64 Hash = CityHash64(reinterpret_cast<const char*>(&Size), sizeof(Size));
+
+    TArray<uint8> Bytes;
+    ChunkData.GetMaterialBytes(Bytes);
+    Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Bytes.GetData()), Bytes.Num(), Hash);
+
+    ChunkData.Refinement.Save(ChunkData.ChunkSize.GetVoxelCount(), Bytes);
+    return Bytes.Num() > 0 ? CityHash64WithSeed(reinterpret_cast<const char*>(Bytes.GetData()), Bytes.Num(), Hash) : Hash;
+}
+
+void FVoxelWorldSnapshot::Store(const FString& Key, FVoxelWorldSnapshot&& Snapshot)
+{
+    check(IsInGameThread());
+    UE_LOG(LogHearthshireVoxel, Log, TEXT("VoxelWorldSnapshot: Stored %d chunks for %s (%.1f MB)"),
+        Snapshot.Chunks.Num(), *Key, Snapshot.GetAllocatedSize() / (1024.0 * 1024.0));
+    VoxelWorldSnapshot::GetSnapshots().Add(Key, MoveTemp(Snapshot));
+}
+
+const FVoxelWorldSnapshot* FVoxelWorldSnapshot::Find(const FString& Key)
+{
+    check(IsInGameThread());
+    return VoxelWorldSnapshot::GetSnapshots().Find(Key);
+}
+
+void FVoxelWorldSnapshot::Discard(const FString& Key)
+{
+    check(IsInGameThread());
+    VoxelWorldSnapshot::GetSnapshots().Remove(Key);
+}
+
+void FVoxelWorldSnapshot::DiscardAll()
+{
+    check(IsInGameThread());
+    VoxelWorldSnapshot::GetSnapshots().Empty();
+}
@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "VoxelWorldTemplate.h"
+#include "VoxelTrace.h"
+#include "VoxelPerformanceStats.h"
 #include "VoxelWorld.h"
 #include "VoxelChunk.h"
 #include "Compression/OodleDataCompression.h"
@@ -16,6 +18,7 @@ UVoxelWorldTemplate::UVoxelWorldTemplate()
     CreationDate = FDateTime::Now();
     CreatorName = "Unknown";
     ChunkSize = 32;
+    ChunkHeight = 0;
     MinChunkPosition = FIntVector::ZeroValue;
     MaxChunkPosition = FIntVector::ZeroValue;
     bAllowSeedVariations = true;
@@ -24,7 +27,7 @@ UVoxelWorldTemplate::UVoxelWorldTemplate()
 FVector UVoxelWorldTemplate::GetWorldSize() const
 {
     FIntVector SizeInChunks = MaxChunkPosition - MinChunkPosition + FIntVector(1, 1, 1);
-    return FVector(SizeInChunks) * ChunkSize * 25.0f; // 25cm voxel size
+    return FVector(SizeInChunks) * FVector(GetChunkDimensions().ToIntVector()) * 25.0f; // 25cm voxel size
 }
 
 bool UVoxelWorldTemplate::HasChunkData(const FIntVector& ChunkPosition) const
@@ -89,6 +92,8 @@ void UVoxelWorldTemplate::PostEditChangeProperty(FPropertyChangedEvent& Property
 
 bool UVoxelTemplateUtility::CompressVoxelData(const TArray<uint8>& UncompressedData, TArray<uint8>& OutCompressedData)
 {
+    VOXEL_TRACE_SCOPE(Voxel_CompressVoxelData);
+    
     // Use Oodle compression (built into UE5)
     // Get worst-case compressed size
     int32 CompressedSizeBound = FOodleDataCompression::CompressedBufferSizeNeeded(UncompressedData.Num());
@@ -114,6 +119,8 @@ bool UVoxelTemplateUtility::CompressVoxelData(const TArray<uint8>& UncompressedD
 
 bool UVoxelTemplateUtility::DecompressVoxelData(const TArray<uint8>& CompressedData, TArray<uint8>& OutUncompressedData, int32 UncompressedSize)
 {
+    VOXEL_TRACE_SCOPE(Voxel_DecompressVoxelData);
+    
     OutUncompressedData.SetNum(UncompressedSize);
     
     bool bSuccess = FOodleDataCompression::Decompress(
@@ -128,6 +135,8 @@ bool UVoxelTemplateUtility::DecompressVoxelData(const TArray<uint8>& CompressedD
 
 bool UVoxelTemplateUtility::SaveWorldAsTemplate(AVoxelWorld* World, UVoxelWorldTemplate* Template, const FString& TemplateName)
 {
+    VOXEL_LLM_SCOPE(Templates);
+    
     if (!World || !Template)
     {
         UE_LOG(LogHearthshireVoxel, Error, TEXT("SaveWorldAsTemplate: Invalid World or Template"));
@@ -174,6 +183,7 @@ bool UVoxelTemplateUtility::SaveWorldAsTemplate(AVoxelWorld* World, UVoxelWorldT
     Template->MinChunkPosition = MinPos;
     Template->MaxChunkPosition = MaxPos;
     Template->ChunkSize = World->Config.ChunkSize;
+    Template->ChunkHeight = World->Config.ChunkHeight;
     
     // Save each chunk
     int32 SavedChunks = 0;
@@ -189,18 +199,49 @@ bool UVoxelTemplateUtility::SaveWorldAsTemplate(AVoxelWorld* World, UVoxelWorldT
         
         // Serialize voxel data
         TArray<uint8> UncompressedData;
-        UncompressedData.SetNum(ChunkData.Voxels.Num());
-        
-        for (int32 i = 0; i < ChunkData.Voxels.Num(); i++)
-        {
-            UncompressedData[i] = (uint8)ChunkData.Voxels[i].Material;
-        }
+        ChunkData.GetMaterialBytes(UncompressedData);
         
         // Compress the data
         FVoxelTemplateChunk TemplateChunk;
         TemplateChunk.ChunkPosition = ChunkComp->GetChunkPosition();
         TemplateChunk.UncompressedSize = UncompressedData.Num();
         
+        // Channels are stored beside the materials so chunks without any cost nothing
+        TArray<uint8> ChannelData;
+        ChunkData.Channels.Save(ChunkData.ChunkSize.GetVoxelCount(), ChannelData);
+        if (ChannelData.Num() > 0 && !CompressVoxelData(ChannelData, TemplateChunk.CompressedChannelData))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("SaveWorldAsTemplate: Failed to compress channels of chunk %s, saving materials only"),
+                *TemplateChunk.ChunkPosition.ToString());
+            TemplateChunk.CompressedChannelData.Reset();
+        }
+        TemplateChunk.UncompressedChannelSize = TemplateChunk.CompressedChannelData.Num() > 0 ? ChannelData.Num() : 0;
+        
+        // Refined voxels the same way; if their grids can't be stored they fall back to whole voxels
+        TArray<uint8> RefinementData;
+        ChunkData.Refinement.Save(ChunkData.ChunkSize.GetVoxelCount(), RefinementData);
+        if (RefinementData.Num() > 0 && !CompressVoxelData(RefinementData, TemplateChunk.CompressedRefinementData))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("SaveWorldAsTemplate: Failed to compress refined voxels of chunk %s, saving them as whole voxels"),
+                *TemplateChunk.ChunkPosition.ToString());
+            TemplateChunk.CompressedRefinementData.Reset();
+            for (const TPair<int32, FVoxelRefinedCell>& Pair : ChunkData.Refinement.GetCells())
+            {
+                UncompressedData[Pair.Key] = (uint8)Pair.Value.GetRepresentativeMaterial();
+            }
+        }
+        TemplateChunk.UncompressedRefinementSize = TemplateChunk.CompressedRefinementData.Num() > 0 ? RefinementData.Num() : 0;
+        
+        TArray<uint8> BlockEntityData;
+        ChunkData.BlockEntities.Save(ChunkData.ChunkSize.GetVoxelCount(), BlockEntityData);
+        if (BlockEntityData.Num() > 0 && !CompressVoxelData(BlockEntityData, TemplateChunk.CompressedBlockEntityData))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("SaveWorldAsTemplate: Failed to compress block entities of chunk %s, saving voxels only"),
+                *TemplateChunk.ChunkPosition.ToString());
+            TemplateChunk.CompressedBlockEntityData.Reset();
+        }
+        TemplateChunk.UncompressedBlockEntitySize = TemplateChunk.CompressedBlockEntityData.Num() > 0 ? BlockEntityData.Num() : 0;
+        
         if (CompressVoxelData(UncompressedData, TemplateChunk.CompressedVoxelData))
         {
             TemplateChunk.bHasData = true;
@@ -225,6 +266,9 @@ bool UVoxelTemplateUtility::SaveWorldAsTemplate(AVoxelWorld* World, UVoxelWorldT
 
 bool UVoxelTemplateUtility::LoadChunkFromTemplate(UVoxelWorldTemplate* Template, const FIntVector& ChunkPosition, FVoxelChunkData& OutChunkData)
 {
+    VOXEL_TRACE_SCOPE(Voxel_LoadChunkFromTemplate);
+    VOXEL_LLM_SCOPE(Templates);
+    
     if (!Template)
     {
         return false;
@@ -256,7 +300,14 @@ bool UVoxelTemplateUtility::LoadChunkFromTemplate(UVoxelWorldTemplate* Template,
     
     // Convert back to voxel data
     OutChunkData.ChunkPosition = ChunkPosition;
-    OutChunkData.ChunkSize = FVoxelChunkSize(Template->ChunkSize);
+    OutChunkData.ChunkSize = Template->GetChunkDimensions();
+    if (UncompressedData.Num() != OutChunkData.ChunkSize.GetVoxelCount())
+    {
+        UE_LOG(LogHearthshireVoxel, Error, TEXT("LoadChunkFromTemplate: Chunk %s has %d voxels, template size is %dx%dx%d"),
+            *ChunkPosition.ToString(), UncompressedData.Num(), OutChunkData.ChunkSize.X, OutChunkData.ChunkSize.Y, OutChunkData.ChunkSize.Z);
+        return false;
+    }
+    OutChunkData.Columns.Reset();
     OutChunkData.Voxels.SetNum(UncompressedData.Num());
     
     for (int32 i = 0; i < UncompressedData.Num(); i++)
@@ -264,6 +315,45 @@ bool UVoxelTemplateUtility::LoadChunkFromTemplate(UVoxelWorldTemplate* Template,
         OutChunkData.Voxels[i] = FVoxel(static_cast<EVoxelMaterial>(UncompressedData[i]));
     }
     
+    // Bad channel data loses the channels, not the chunk
+    OutChunkData.Channels.Reset();
+    if (TemplateChunk->UncompressedChannelSize > 0)
+    {
+        TArray<uint8> ChannelData;
+        if (!DecompressVoxelData(TemplateChunk->CompressedChannelData, ChannelData, TemplateChunk->UncompressedChannelSize) ||
+            !OutChunkData.Channels.Load(ChannelData, OutChunkData.Voxels.Num()))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("LoadChunkFromTemplate: Dropped unreadable channel data of chunk %s"), *ChunkPosition.ToString());
+            OutChunkData.Channels.Reset();
+        }
+    }
+    
+    // Unreadable sub-voxel grids leave their voxels empty rather than failing the chunk
+    OutChunkData.Refinement.Reset();
+    if (TemplateChunk->UncompressedRefinementSize > 0)
+    {
+        TArray<uint8> RefinementData;
+        if (!DecompressVoxelData(TemplateChunk->CompressedRefinementData, RefinementData, TemplateChunk->UncompressedRefinementSize) ||
+            !OutChunkData.Refinement.Load(RefinementData, OutChunkData.Voxels.Num()))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("LoadChunkFromTemplate: Dropped unreadable refinement data of chunk %s"), *ChunkPosition.ToString());
+            OutChunkData.Refinement.Reset();
+        }
+    }
+    OutChunkData.Refinement.Reconcile(OutChunkData.Voxels);
+    
+    OutChunkData.BlockEntities.Reset();
+    if (TemplateChunk->UncompressedBlockEntitySize > 0)
+    {
+        TArray<uint8> BlockEntityData;
+        if (!DecompressVoxelData(TemplateChunk->CompressedBlockEntityData, BlockEntityData, TemplateChunk->UncompressedBlockEntitySize) ||
+            !OutChunkData.BlockEntities.Load(BlockEntityData, OutChunkData.Voxels.Num()))
+        {
+            UE_LOG(LogHearthshireVoxel, Warning, TEXT("LoadChunkFromTemplate: Dropped unreadable block entities of chunk %s"), *ChunkPosition.ToString());
+            OutChunkData.BlockEntities.Reset();
+        }
+    }
+    
     OutChunkData.bIsDirty = true;
     
     UE_LOG(LogHearthshireVoxel, Log, TEXT("LoadChunkFromTemplate: Loaded chunk %s"), *ChunkPosition.ToString());
@@ -281,8 +371,9 @@ void UVoxelTemplateUtility::ApplySeedVariations(FVoxelChunkData& ChunkData, UVox
     const FVoxelVariationParams& Params = Template->VariationParams;
     
     // Get landmarks in this chunk
-    FVector ChunkWorldPos = FVector(ChunkPosition) * ChunkData.ChunkSize.X * 25.0f;
-    float ChunkRadius = ChunkData.ChunkSize.X * 25.0f * 1.5f; // Check slightly beyond chunk bounds
+    const FVector ChunkWorldSize = FVector(ChunkData.ChunkSize.ToIntVector()) * 25.0f;
+    FVector ChunkWorldPos = FVector(ChunkPosition) * ChunkWorldSize;
+    float ChunkRadius = ChunkWorldSize.GetMax() * 1.5f; // Check slightly beyond chunk bounds
     TArray<FVoxelLandmark> NearbyLandmarks = Template->GetLandmarksInRadius(ChunkWorldPos, ChunkRadius);
     
     // Apply variations in order
@@ -318,8 +409,9 @@ void UVoxelTemplateUtility::ApplyGrassVariation(FVoxelChunkData& ChunkData, cons
                         FVoxel AboveVoxel = ChunkData.GetVoxel(X, Y, Z + 1);
                         if (AboveVoxel.IsAir())
                         {
-                            // Randomly add flowers or tall grass
-                            if (Random.FRand() < Params.FlowerDensity)
+                            // Randomly add flowers or tall grass. The roll happens even without flower voxels so
+                            // tree variation, which shares the stream, places the same trees either way
+                            if (Random.FRand() < Params.FlowerDensity && Params.bPlaceFlowerVoxels)
                             {
                                 // Add a flower (using Leaves material as placeholder)
                                 ChunkData.SetVoxel(X, Y, Z + 1, FVoxel(EVoxelMaterial::Leaves));
@@ -353,7 +445,7 @@ void UVoxelTemplateUtility::ApplyTreeVariation(FVoxelChunkData& ChunkData, const
         int32 Y = Random.RandRange(3, Size.Y - 4);
         
         // Check if position is protected by landmark
-        FVector WorldPos = FVector(ChunkWorldPosition) * Size.X * VoxelSize + FVector(X, Y, 0) * VoxelSize;
+        FVector WorldPos = FVector(ChunkWorldPosition) * FVector(Size.ToIntVector()) * VoxelSize + FVector(X, Y, 0) * VoxelSize;
         bool bProtected = false;
         
         for (const FVoxelLandmark& Landmark : Landmarks)
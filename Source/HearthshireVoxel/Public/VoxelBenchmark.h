@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelTypes.h"
+#include "VoxelChunkKernels.h"
+
+// Forward declarations
+class UVoxelWorldTemplate;
+
+/**
+ * Timing summary of one benchmark case (stage run on one fixture)
+ */
+struct HEARTHSHIREVOXEL_API FVoxelBenchmarkResult
+{
+    FString Stage;
+    FString Fixture;
+
+    // Timed iterations, warm-up excluded
+    int32 Iterations = 0;
+
+    double MedianMs = 0.0;
+    double P95Ms = 0.0;
+    double P99Ms = 0.0;
+    double MeanMs = 0.0;
+    double MinMs = 0.0;
+    double MaxMs = 0.0;
+
+    // Stage outputs such as triangle or byte counts - identical every iteration
+    TMap<FString, double> Counters;
+
+    FString GetName() const { return Stage + TEXT("/") + Fixture; }
+};
+
+/**
+ * Named chunk used as benchmark input
+ */
+struct HEARTHSHIREVOXEL_API FVoxelBenchmarkFixture
+{
+    FString Name;
+    FVoxelChunkData ChunkData;
+
+    // Rebuilds ChunkData from scratch - timed as the generation stage, unset for template chunks
+    TFunction<void(FVoxelChunkData&)> Generator;
+};
+
+/**
+ * Work done per chunk by the thread scaling benchmark
+ */
+enum class EVoxelScalingStage : uint8
+{
+    Control,            // Arithmetic only, no allocation or shared data - slowdown from clocks and SMT alone
+    Generate,           // Terrain generator into a fresh chunk
+    GreedyMesh,         // Greedy mesh into fresh output, as the world does
+    GenerateAndMesh     // Both, the full worker path of a streamed chunk
+};
+
+/**
+ * Timing of one batch of chunks spread over a fixed number of worker threads
+ */
+struct HEARTHSHIREVOXEL_API FVoxelScalingSample
+{
+    // From releasing the workers until the last one finished
+    double WallMs = 0.0;
+
+    // Summed over workers, time spent inside the per-chunk work
+    double BusyMs = 0.0;
+
+    int32 Chunks = 0;
+};
+
+/**
+ * Faster layout of each pass, by medians summed over the fixtures
+ */
+struct HEARTHSHIREVOXEL_API FVoxelLayoutRecommendation
+{
+    EVoxelDataLayout Mesh = EVoxelDataLayout::Linear;
+    EVoxelDataLayout Downsample = EVoxelDataLayout::Linear;
+};
+
+/**
+ * Repeatable micro-benchmarks of the voxel pipeline.
+ * Every case runs warm-up iterations first, then reports median/p95/p99 of the timed ones,
+ * and the whole run serializes to JSON so results can be compared between commits.
+ */
+class HEARTHSHIREVOXEL_API FVoxelBenchmarkRunner
+{
+public:
+    FVoxelBenchmarkRunner(int32 InWarmupIterations = 3, int32 InIterations = 30);
+
+    // Comma separated terms - only cases whose "Stage/Fixture" name contains one are run (empty runs everything)
+    FString Filter;
+
+    // Time Body; the returned result may be given counters. Null when filtered out
+    FVoxelBenchmarkResult* Run(const FString& Stage, const FString& Fixture, TFunctionRef<void()> Body);
+
+    // Generation, basic and greedy meshing, LOD downsampling, compression and decompression per fixture
+    void RunPipeline(const TArray<FVoxelBenchmarkFixture>& Fixtures);
+
+    // Chunks per second, speed-up and efficiency of each scaling stage at 1, 2, 4... MaxWorkers threads
+    // (0 = all hardware threads), for a batch of BatchSize chunks cycled from the fixtures.
+    // Per-chunk time growing faster than in the control stage points at allocator, lock or memory contention
+    void RunThreadScaling(const TArray<FVoxelBenchmarkFixture>& Fixtures, int32 BatchSize = 64, int32 MaxWorkers = 0);
+
+    // Each greedy face pass, the full greedy mesh and 2x/4x downsampling on the linear and the tiled layout,
+    // plus the conversion itself. Tiled cases include converting the chunk, as the pipeline would.
+    // Also adds "Layout<Pass>/Total" results with both sums, and returns the faster layout per pass
+    FVoxelLayoutRecommendation RunLayoutComparison(const TArray<FVoxelBenchmarkFixture>& Fixtures);
+
+    // Result measured elsewhere, such as a camera path replay
+    void AddResult(const FVoxelBenchmarkResult& Result) { Results.Add(Result); }
+
+    const TArray<FVoxelBenchmarkResult>& GetResults() const { return Results; }
+
+    // Human readable table for the log
+    FString GetSummary() const;
+
+    FString ToJson() const;
+    bool SaveJson(const FString& FilePath) const;
+
+    // Flat, hills, caves and checkerboard chunks - deterministic so runs stay comparable
+    static void BuildSyntheticFixtures(const FVoxelChunkSize& ChunkSize, TArray<FVoxelBenchmarkFixture>& OutFixtures);
+
+    // Up to MaxChunks populated chunks of a world template, returns how many were added
+    static int32 AddTemplateFixtures(UVoxelWorldTemplate* Template, int32 MaxChunks, TArray<FVoxelBenchmarkFixture>& OutFixtures);
+
+    // Sorts SamplesMs and fills the timing fields of OutResult
+    static void ComputeStatistics(TArray<double>& SamplesMs, FVoxelBenchmarkResult& OutResult);
+
+    // Runs Stage on BatchSize chunks using exactly Workers dedicated threads
+    static FVoxelScalingSample RunConcurrentBatch(const TArray<FVoxelBenchmarkFixture>& Fixtures, int32 BatchSize, int32 Workers, EVoxelScalingStage Stage);
+
+    static const TCHAR* GetScalingStageName(EVoxelScalingStage Stage);
+
+    // Saved/Benchmarks/VoxelBenchmark-<timestamp>.json
+    static FString GetDefaultOutputPath();
+
+private:
+    bool PassesFilter(const FString& Name) const;
+
+    int32 WarmupIterations;
+    int32 Iterations;
+
+    TArray<FVoxelBenchmarkResult> Results;
+
+    struct FFixtureInfo
+    {
+        FString Name;
+        FVoxelChunkSize Size;
+        int32 SolidVoxels = 0;
+    };
+
+    // Every fixture the pipeline ran on, written alongside the results
+    TArray<FFixtureInfo> FixtureInfo;
+};
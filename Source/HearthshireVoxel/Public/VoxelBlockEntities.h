@@ -0,0 +1,204 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+#include <type_traits>
+
+/**
+ * Kind of state attached to a voxel. Game code may use values from Custom up for its own payloads.
+ */
+enum class EVoxelBlockEntityType : uint8
+{
+    None = 0,
+    Crop,
+    Container,
+    Machine,
+    Custom = 64
+};
+
+/**
+ * Planted crop - growth itself lives in EVoxelChannel::Growth, this is what the channel can't hold
+ */
+struct FVoxelCropEntity
+{
+    static constexpr EVoxelBlockEntityType Type = EVoxelBlockEntityType::Crop;
+
+    uint16 CropId = 0;
+    uint8 Stage = 0;
+    uint8 Flags = 0;
+
+    // Game time in seconds
+    float PlantedTime = 0.0f;
+    float LastWateredTime = 0.0f;
+};
+
+/**
+ * Chest, barrel, ... - the items live in the game's inventory system under InventoryId
+ */
+struct FVoxelContainerEntity
+{
+    static constexpr EVoxelBlockEntityType Type = EVoxelBlockEntityType::Container;
+
+    uint32 InventoryId = 0;
+    uint16 Capacity = 0;
+    uint8 Flags = 0;
+};
+
+/**
+ * Workbench, kiln, mill, ...
+ */
+struct FVoxelMachineEntity
+{
+    static constexpr EVoxelBlockEntityType Type = EVoxelBlockEntityType::Machine;
+
+    uint16 MachineId = 0;
+    uint8 Facing = 0;
+    uint8 Flags = 0;
+
+    // 0..1 through the current job
+    float Progress = 0.0f;
+    uint32 State = 0;
+};
+
+/**
+ * Type tag plus up to 16 bytes of trivially copyable payload, stored inline
+ */
+struct FVoxelBlockEntity
+{
+    static constexpr int32 MaxPayloadSize = 16;
+
+    alignas(8) uint8 Data[MaxPayloadSize];
+    EVoxelBlockEntityType Type;
+    uint8 PayloadSize;
+
+    FVoxelBlockEntity() : Type(EVoxelBlockEntityType::None), PayloadSize(0) { FMemory::Memzero(Data); }
+
+    template<typename T>
+    static constexpr bool IsValidPayload()
+    {
+        return std::is_trivially_copyable_v<T> && sizeof(T) <= MaxPayloadSize && alignof(T) <= 8;
+    }
+
+    template<typename T>
+    static FVoxelBlockEntity Make(const T& Payload)
+    {
+        static_assert(IsValidPayload<T>(), "Block entity payloads must be trivially copyable and at most 16 bytes");
+        FVoxelBlockEntity Entity;
+        Entity.Type = T::Type;
+        Entity.PayloadSize = sizeof(T);
+        FMemory::Memcpy(Entity.Data, &Payload, sizeof(T));
+        return Entity;
+    }
+
+    // Payload when the entity is of T's type, else null
+    template<typename T>
+    FORCEINLINE const T* As() const
+    {
+        static_assert(IsValidPayload<T>(), "Block entity payloads must be trivially copyable and at most 16 bytes");
+        return Type == T::Type ? reinterpret_cast<const T*>(Data) : nullptr;
+    }
+
+    template<typename T>
+    FORCEINLINE T* As()
+    {
+        static_assert(IsValidPayload<T>(), "Block entity payloads must be trivially copyable and at most 16 bytes");
+        return Type == T::Type ? reinterpret_cast<T*>(Data) : nullptr;
+    }
+};
+
+/**
+ * Block entities of one chunk, keyed by voxel index. Plain data - nothing here is a UObject or ticks,
+ * so a field of crops costs 24 bytes plus a map slot per plant. Systems that advance entities walk the
+ * store with ForEach on their own schedule.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelBlockEntityStore
+{
+    FORCEINLINE const FVoxelBlockEntity* Find(int32 VoxelIndex) const { return Entities.Find(VoxelIndex); }
+    FORCEINLINE FVoxelBlockEntity* Find(int32 VoxelIndex) { return Entities.Find(VoxelIndex); }
+
+    // Payload of the given type, null when there is no entity or it is of another type
+    template<typename T>
+    FORCEINLINE const T* Find(int32 VoxelIndex) const
+    {
+        const FVoxelBlockEntity* Entity = Entities.Find(VoxelIndex);
+        return Entity ? Entity->As<T>() : nullptr;
+    }
+
+    template<typename T>
+    FORCEINLINE T* Find(int32 VoxelIndex)
+    {
+        FVoxelBlockEntity* Entity = Entities.Find(VoxelIndex);
+        return Entity ? Entity->As<T>() : nullptr;
+    }
+
+    // Adds or replaces the entity of a voxel
+    template<typename T>
+    T& Add(int32 VoxelIndex, const T& Payload)
+    {
+        AddSortedIndex(VoxelIndex);
+        FVoxelBlockEntity& Entity = Entities.Add(VoxelIndex, FVoxelBlockEntity::Make(Payload));
+        return *Entity.As<T>();
+    }
+
+    void Add(int32 VoxelIndex, const FVoxelBlockEntity& Entity)
+    {
+        AddSortedIndex(VoxelIndex);
+        Entities.Add(VoxelIndex, Entity);
+    }
+
+    // False when the voxel had no entity
+    bool Remove(int32 VoxelIndex)
+    {
+        if (Entities.Remove(VoxelIndex) == 0)
+        {
+            return false;
+        }
+        SortedIndices.RemoveAt(Algo::LowerBound(SortedIndices, VoxelIndex), EAllowShrinking::No);
+        return true;
+    }
+
+    bool IsEmpty() const { return Entities.Num() == 0; }
+    int32 Num() const { return Entities.Num(); }
+
+    void Reset()
+    {
+        Entities.Empty();
+        SortedIndices.Empty();
+    }
+
+    // Visits every entity in ascending voxel index order - Func(int32 VoxelIndex, const FVoxelBlockEntity&)
+    template<typename FuncType>
+    void ForEach(FuncType&& Func) const
+    {
+        for (const int32 VoxelIndex : SortedIndices)
+        {
+            Func(VoxelIndex, Entities.FindChecked(VoxelIndex));
+        }
+    }
+
+    int64 GetAllocatedSize() const { return Entities.GetAllocatedSize() + SortedIndices.GetAllocatedSize(); }
+
+    // Byte stream of every entity in index order, empty when there are none
+    void Save(int32 VoxelCount, TArray<uint8>& OutBytes) const;
+
+    // Replaces all entities, false on malformed data or a voxel count mismatch
+    bool Load(const TArray<uint8>& Bytes, int32 VoxelCount);
+
+private:
+    // Keeps SortedIndices ascending - replacing a voxel's entity leaves it unchanged
+    void AddSortedIndex(int32 VoxelIndex)
+    {
+        const int32 Position = Algo::LowerBound(SortedIndices, VoxelIndex);
+        if (!SortedIndices.IsValidIndex(Position) || SortedIndices[Position] != VoxelIndex)
+        {
+            SortedIndices.Insert(VoxelIndex, Position);
+        }
+    }
+
+    TMap<int32, FVoxelBlockEntity> Entities;
+
+    // Keys of Entities in ascending order, so ForEach and Save visit them without sorting
+    TArray<int32> SortedIndices;
+};
@@ -6,6 +6,7 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "VoxelTypes.h"
 #include "VoxelPerformanceStats.h"
+#include "VoxelCalibration.h"
 #include "VoxelBlueprintLibrary.generated.h"
 
 // Forward declarations
@@ -138,7 +139,8 @@ public:
     static FIntVector WorldToChunkPosition(
         const FVector& WorldPosition,
         int32 ChunkSize = 32,
-        float VoxelSize = 25.0f
+        float VoxelSize = 25.0f,
+        int32 ChunkHeight = 0
     );
     
     UFUNCTION(BlueprintPure, Category = "Voxel|Coordinates")
@@ -193,6 +195,14 @@ public:
         bool bForceMobileSettings = false
     );
     
+    // Applies settings measured on this device (stored after the first run) instead of the fixed presets
+    UFUNCTION(BlueprintCallable, Category = "Voxel|Utility")
+    static FVoxelCalibrationResult CalibrateVoxelWorld(
+        AVoxelWorld* VoxelWorld,
+        int32 TargetFPS = 0,
+        bool bForceRecalibrate = false
+    );
+    
     // Debug visualization
     UFUNCTION(BlueprintCallable, Category = "Voxel|Debug", meta = (WorldContext = "WorldContextObject"))
     static void DrawDebugVoxel(
@@ -210,7 +220,8 @@ public:
         int32 ChunkSize = 32,
         float VoxelSize = 25.0f,
         const FLinearColor& Color = FLinearColor::Green,
-        float Duration = 0.0f
+        float Duration = 0.0f,
+        int32 ChunkHeight = 0
     );
     
     // Analysis functions
@@ -0,0 +1,92 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelCalibration.generated.h"
+
+struct FVoxelWorldConfig;
+
+/**
+ * Streaming settings measured for this device, plus the timings they were derived from
+ */
+USTRUCT(BlueprintType)
+struct HEARTHSHIREVOXEL_API FVoxelCalibrationResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    bool bValid = false;
+
+    // Chosen settings
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    int32 ChunkSize = 32;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    int32 MaxConcurrentChunkGenerations = 4;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    int32 MaxChunksPerFrame = 5;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    int32 ViewDistanceInChunks = 10;
+
+    // Measurements
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    float TargetFrameMs = 16.7f;
+
+    // Generate and greedy mesh one chunk on one worker
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    float WorkerMsPerChunk16 = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    float WorkerMsPerChunk32 = 0.0f;
+
+    // Copying one mesh into a procedural mesh component on the game thread
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    float ApplyMsPerChunk16 = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    float ApplyMsPerChunk32 = 0.0f;
+
+    // Sustained chunks per second of the chosen size and worker count
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    float ChunksPerSecond = 0.0f;
+
+    // CPU brand and thread count - a stored result from other hardware is ignored
+    UPROPERTY(BlueprintReadOnly, Category = "Calibration")
+    FString DeviceId;
+
+    FString ToString() const;
+};
+
+/**
+ * First-launch calibration of voxel streaming settings.
+ * Times generation, meshing and mesh apply on this device for 16 and 32 voxel chunks, then picks
+ * the chunk size, worker count, chunks per frame and view distance that fit the frame target.
+ * Results are stored in GameUserSettings.ini so the measurement only runs once per device.
+ */
+class HEARTHSHIREVOXEL_API FVoxelCalibration
+{
+public:
+    // Stored result for this device if there is one, otherwise measures and stores a new one
+    static FVoxelCalibrationResult GetOrRun(int32 TargetFPS = 0);
+
+    // Measures now (a few hundred milliseconds), 0 FPS picks 30 on mobile and 60 elsewhere
+    static FVoxelCalibrationResult Run(int32 TargetFPS = 0);
+
+    static bool Load(FVoxelCalibrationResult& OutResult);
+    static void Save(const FVoxelCalibrationResult& Result);
+
+    // Forget the stored result so the next GetOrRun measures again
+    static void Clear();
+
+    // ChunkSize is left alone when existing chunks or a template already fix it
+    static void ApplyToConfig(const FVoxelCalibrationResult& Result, FVoxelWorldConfig& Config, bool bAllowChunkSizeChange = true);
+
+    static FString GetDeviceId();
+
+private:
+    // Bumped whenever the selection rules change, invalidating stored results
+    static constexpr int32 Version = 1;
+};
@@ -0,0 +1,140 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Containers/Ticker.h"
+#include "VoxelBenchmark.h"
+#include "VoxelCameraPath.generated.h"
+
+class AVoxelWorld;
+
+/**
+ * Streaming source transform at a point in time
+ */
+USTRUCT(BlueprintType)
+struct HEARTHSHIREVOXEL_API FVoxelCameraPathKey
+{
+    GENERATED_BODY()
+
+    // Seconds since the recording started
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Path")
+    float Time = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Path")
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Path")
+    FRotator Rotation = FRotator::ZeroRotator;
+};
+
+/**
+ * Recorded fly-through used as a repeatable streaming benchmark
+ */
+UCLASS(BlueprintType)
+class HEARTHSHIREVOXEL_API UVoxelCameraPath : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Path")
+    TArray<FVoxelCameraPathKey> Keys;
+
+    // Applied as the world seed on replay so template variations match between runs
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Path")
+    int32 Seed = 12345;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Path")
+    float SampleInterval = 0.1f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Path")
+    FString RecordedMap;
+
+    float GetDuration() const { return Keys.Num() > 0 ? Keys.Last().Time : 0.0f; }
+
+    // Interpolated transform, clamped to the ends of the path
+    bool Sample(float Time, FVector& OutLocation, FRotator& OutRotation) const;
+};
+
+/**
+ * Samples a voxel world's streaming source into a camera path.
+ * Uses the local player's camera when there is one, otherwise the world's streaming source.
+ */
+class HEARTHSHIREVOXEL_API FVoxelCameraPathRecorder
+{
+public:
+    ~FVoxelCameraPathRecorder();
+
+    void Start(AVoxelWorld* InWorld, float InSampleInterval = 0.1f);
+
+    // Ends the recording and writes it into a new path owned by Outer
+    UVoxelCameraPath* Stop(UObject* Outer, FName Name);
+
+    bool IsRecording() const { return TickHandle.IsValid(); }
+    int32 GetKeyCount() const { return Keys.Num(); }
+
+private:
+    bool Tick(float DeltaTime);
+    bool GetSourceTransform(FVector& OutLocation, FRotator& OutRotation) const;
+
+    TWeakObjectPtr<AVoxelWorld> World;
+    TArray<FVoxelCameraPathKey> Keys;
+    float SampleInterval = 0.1f;
+    float ElapsedTime = 0.0f;
+    float TimeSinceSample = 0.0f;
+    FTSTicker::FDelegateHandle TickHandle;
+};
+
+/**
+ * Camera path replay options
+ */
+struct HEARTHSHIREVOXEL_API FVoxelPathReplaySettings
+{
+    // Simulated seconds per step, 0 uses the real frame time
+    float FixedDeltaTime = 1.0f / 30.0f;
+
+    // INDEX_NONE uses the path's seed
+    int32 Seed = INDEX_NONE;
+
+    // Keeps stepping after the last key so queued chunks finish and are counted
+    float SettleTime = 2.0f;
+};
+
+/**
+ * Drives an AVoxelWorld's streaming source along a recorded path and measures each frame.
+ * The report is a benchmark result (Stage "Replay", Fixture = path name) with frame time
+ * percentiles and streaming latency counters, so runs can be compared across builds.
+ */
+class HEARTHSHIREVOXEL_API FVoxelCameraPathPlayer
+{
+public:
+    FVoxelCameraPathPlayer(AVoxelWorld* InWorld, const UVoxelCameraPath* InPath, const FVoxelPathReplaySettings& InSettings);
+
+    // Seeds the world, resets the latency histograms and moves the source to the first key
+    void Begin();
+
+    // Time step to simulate for a frame that took FrameDeltaTime
+    float GetStepDeltaTime(float FrameDeltaTime) const;
+
+    // Moves the streaming source, false once the path and the settle time are done
+    bool Advance(float StepDeltaTime);
+
+    void RecordFrameTime(double FrameMs);
+
+    // Clears the streaming override and builds the report
+    FVoxelBenchmarkResult Finish();
+
+    // Creates a throwaway game world, replays the path with fixed steps and tears it down again.
+    // Needs no renderer or player, so it runs under -nullrhi in automation
+    static bool RunHeadless(const UVoxelCameraPath* Path, const FVoxelPathReplaySettings& Settings, FVoxelBenchmarkResult& OutResult);
+
+private:
+    TWeakObjectPtr<AVoxelWorld> World;
+    const UVoxelCameraPath* Path;
+    FVoxelPathReplaySettings Settings;
+
+    float PathTime = 0.0f;
+    int32 PeakActiveChunks = 0;
+    TArray<double> FrameTimesMs;
+};
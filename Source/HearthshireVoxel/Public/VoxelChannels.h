@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Per-voxel state stored alongside the material - one value per voxel, 0 when never written
+ */
+enum class EVoxelChannel : uint8
+{
+    Light = 0,      // 4-bit light level
+    WaterLevel,     // 4-bit, 0 = dry, 15 = full voxel
+    Moisture,       // 8-bit soil moisture
+    Growth,         // 8-bit crop growth progress
+    Damage,         // 16-bit accumulated damage
+    Count
+};
+
+/**
+ * Bits per voxel of a channel
+ */
+enum class EVoxelChannelFormat : uint8
+{
+    Bits4,
+    Bits8,
+    Bits16
+};
+
+namespace VoxelChannels
+{
+    constexpr EVoxelChannelFormat GetFormat(EVoxelChannel Channel)
+    {
+        return (Channel == EVoxelChannel::Light || Channel == EVoxelChannel::WaterLevel) ? EVoxelChannelFormat::Bits4
+            : (Channel == EVoxelChannel::Damage ? EVoxelChannelFormat::Bits16 : EVoxelChannelFormat::Bits8);
+    }
+
+    constexpr uint16 GetMaxValue(EVoxelChannelFormat Format)
+    {
+        return Format == EVoxelChannelFormat::Bits4 ? 0xF : (Format == EVoxelChannelFormat::Bits8 ? 0xFF : 0xFFFF);
+    }
+
+    // Bytes of a varying channel - 4-bit channels pack two voxels per byte
+    constexpr int32 GetByteCount(EVoxelChannelFormat Format, int32 VoxelCount)
+    {
+        return Format == EVoxelChannelFormat::Bits4 ? (VoxelCount + 1) / 2 : (Format == EVoxelChannelFormat::Bits8 ? VoxelCount : VoxelCount * 2);
+    }
+
+    HEARTHSHIREVOXEL_API const TCHAR* GetName(EVoxelChannel Channel);
+}
+
+/**
+ * One channel of a chunk in SoA form.
+ * Holds a single uniform value until a write differs from it, then a packed array; the array is released
+ * again as soon as every voxel is back to the uniform value.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelChannelData
+{
+    EVoxelChannel Channel;
+    EVoxelChannelFormat Format;
+    uint16 UniformValue;
+
+    // Voxels whose value differs from UniformValue - the array is freed when this reaches zero
+    int32 DivergentCount;
+
+    // Packed values, empty while uniform
+    TArray<uint8> Data;
+
+    FVoxelChannelData()
+        : Channel(EVoxelChannel::Light), Format(EVoxelChannelFormat::Bits4), UniformValue(0), DivergentCount(0)
+    {}
+
+    explicit FVoxelChannelData(EVoxelChannel InChannel)
+        : Channel(InChannel), Format(VoxelChannels::GetFormat(InChannel)), UniformValue(0), DivergentCount(0)
+    {}
+
+    FORCEINLINE bool IsUniform() const { return Data.Num() == 0; }
+
+    FORCEINLINE uint16 Get(int32 Index) const
+    {
+        if (IsUniform())
+        {
+            return UniformValue;
+        }
+
+        switch (Format)
+        {
+            case EVoxelChannelFormat::Bits4:  return (Data[Index >> 1] >> ((Index & 1) << 2)) & 0xF;
+            case EVoxelChannelFormat::Bits8:  return Data[Index];
+            default:                          return reinterpret_cast<const uint16*>(Data.GetData())[Index];
+        }
+    }
+
+    // False when the voxel already had this value; values are clamped to the format
+    bool Set(int32 Index, uint16 Value, int32 VoxelCount);
+
+    // Every voxel to one value, releasing the array
+    void Fill(uint16 Value);
+
+    // Scans a varying channel and releases it if all values match, even when they differ from UniformValue
+    bool Compact(int32 VoxelCount);
+
+private:
+    FORCEINLINE void Write(int32 Index, uint16 Value)
+    {
+        switch (Format)
+        {
+            case EVoxelChannelFormat::Bits4:
+            {
+                const int32 Shift = (Index & 1) << 2;
+                Data[Index >> 1] = (uint8)((Data[Index >> 1] & ~(0xF << Shift)) | (Value << Shift));
+                break;
+            }
+            case EVoxelChannelFormat::Bits8:  Data[Index] = (uint8)Value; break;
+            default:                          reinterpret_cast<uint16*>(Data.GetData())[Index] = Value; break;
+        }
+    }
+
+    void Allocate(int32 VoxelCount);
+};
+
+/**
+ * Optional channels owned by one chunk.
+ * Channels a chunk never wrote, or that are back to all zero, take no memory beyond this struct's empty array.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelChunkChannels
+{
+    FORCEINLINE uint16 Get(EVoxelChannel Channel, int32 Index) const
+    {
+        const FVoxelChannelData* Data = Find(Channel);
+        return Data ? Data->Get(Index) : 0;
+    }
+
+    // False when the voxel already had this value
+    bool Set(EVoxelChannel Channel, int32 Index, uint16 Value, int32 VoxelCount);
+
+    // Whole chunk to one value - 0 removes the channel
+    void Fill(EVoxelChannel Channel, uint16 Value);
+
+    FORCEINLINE const FVoxelChannelData* Find(EVoxelChannel Channel) const
+    {
+        for (const FVoxelChannelData& Data : Channels)
+        {
+            if (Data.Channel == Channel)
+            {
+                return &Data;
+            }
+        }
+        return nullptr;
+    }
+
+    bool HasChannel(EVoxelChannel Channel) const { return Find(Channel) != nullptr; }
+    bool IsEmpty() const { return Channels.Num() == 0; }
+    int32 Num() const { return Channels.Num(); }
+
+    void Reset() { Channels.Empty(); }
+
+    // Collapses uniform channels and drops all-zero ones - for systems that rewrite whole chunks
+    void Compact(int32 VoxelCount);
+
+    int64 GetAllocatedSize() const;
+
+    // Every channel as one byte stream, uniform channels as a single value; empty when there are none
+    void Save(int32 VoxelCount, TArray<uint8>& OutBytes) const;
+
+    // Replaces all channels, false on malformed data or a voxel count mismatch
+    bool Load(const TArray<uint8>& Bytes, int32 VoxelCount);
+
+private:
+    void RemoveEntry(int32 EntryIndex);
+
+    // Sparse - at most one entry per channel, only for channels that are not all zero
+    TArray<FVoxelChannelData> Channels;
+};
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "VoxelCharacterMovement.generated.h"
+
+// Forward declarations
+class AVoxelWorld;
+
+/**
+ * Custom movement modes provided by the voxel system
+ */
+UENUM(BlueprintType)
+enum class EVoxelCustomMovementMode : uint8
+{
+    None = 0            UMETA(Hidden),
+    VoxelWalking = 1    UMETA(DisplayName = "Voxel Walking")
+};
+
+/**
+ * Character movement that collides against voxel occupancy instead of cooked mesh collision.
+ * Walking and falling both run in the VoxelWalking custom mode, so movement is correct
+ * as soon as chunk data exists - before meshing or physics cooking has finished.
+ */
+UCLASS(ClassGroup=(Voxel), meta=(BlueprintSpawnableComponent))
+class HEARTHSHIREVOXEL_API UVoxelCharacterMovementComponent : public UCharacterMovementComponent
+{
+    GENERATED_BODY()
+
+public:
+    UVoxelCharacterMovementComponent();
+
+    // Movement component overrides
+    virtual void SetDefaultMovementMode() override;
+    virtual bool IsMovingOnGround() const override;
+    virtual bool IsFalling() const override;
+    virtual float GetMaxSpeed() const override;
+
+    // World to collide against - found automatically when unset
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Movement")
+    AVoxelWorld* VoxelWorld;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Movement", meta = (DisplayName = "Use Voxel Walking"))
+    bool bUseVoxelWalking = true;
+
+    // Treat unloaded chunks as solid so characters never fall into unstreamed terrain
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Movement", meta = (DisplayName = "Block On Unloaded Terrain"))
+    bool bBlockOnUnloadedTerrain = true;
+
+    // Highest ledge climbed without jumping (one voxel by default)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Movement", meta = (DisplayName = "Voxel Step Height", ClampMin = "0.0", ClampMax = "100.0"))
+    float VoxelStepHeight = 26.0f;
+
+    UFUNCTION(BlueprintCallable, Category = "Voxel|Movement")
+    void SetVoxelWalking(bool bEnable);
+
+    UFUNCTION(BlueprintPure, Category = "Voxel|Movement")
+    bool IsVoxelWalking() const;
+
+    UFUNCTION(BlueprintPure, Category = "Voxel|Movement")
+    bool IsVoxelGrounded() const { return bVoxelGrounded; }
+
+protected:
+    virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+    virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+
+    void PhysVoxelWalking(float DeltaTime, int32 Iterations);
+
+    AVoxelWorld* ResolveVoxelWorld();
+
+private:
+    // Resting on a voxel after the last move
+    bool bVoxelGrounded;
+};
@@ -12,6 +12,8 @@
 class UProceduralMeshComponent;
 class AVoxelWorld;
 class UVoxelMaterialSet;
+class UTexture2D;
+class UMaterialInstanceDynamic;
 
 /**
  * Chunk LOD state
@@ -64,16 +66,48 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     void Initialize(const FIntVector& InChunkPosition, const FVoxelChunkSize& InChunkSize);
     
-    // Voxel manipulation
+    // World whose OnVoxelEditedNative hears this chunk's edits
+    void SetOwnerWorld(AVoxelWorld* InOwnerWorld) { OwnerWorld = InOwnerWorld; }
+    
+    // Voxel manipulation - material changes are raised on the owner world's OnVoxelEditedNative, so they replicate
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     void SetVoxel(int32 X, int32 Y, int32 Z, EVoxelMaterial Material);
     
+    // Writes a voxel without raising any change or edit event - for generation and bulk fills
+    void SetGeneratedVoxel(int32 X, int32 Y, int32 Z, EVoxelMaterial Material) { ChunkData.SetVoxel(X, Y, Z, FVoxel(Material)); }
+    
+    // Call once after rewriting the chunk with SetGeneratedVoxel outside of generation - raises the owner world's
+    // OnChunkReplacedNative, which replicates as one full-chunk snapshot instead of an edit per voxel
+    void NotifyVoxelsReplaced();
+    
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     EVoxelMaterial GetVoxel(int32 X, int32 Y, int32 Z) const;
     
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     void SetVoxelBatch(const TArray<FIntVector>& Positions, const TArray<EVoxelMaterial>& Materials);
     
+    // Auxiliary channels - no remesh, the owning system reacts to its own changes
+    uint16 GetChannelValue(EVoxelChannel Channel, int32 X, int32 Y, int32 Z) const { return ChunkData.GetChannel(Channel, X, Y, Z); }
+    bool SetChannelValue(EVoxelChannel Channel, int32 X, int32 Y, int32 Z, uint16 Value) { return ChunkData.SetChannel(Channel, X, Y, Z, Value); }
+    void FillChannel(EVoxelChannel Channel, uint16 Value) { ChunkData.Channels.Fill(Channel, Value); }
+    
+    // Sub-voxel detail - splits a voxel into Resolution^3 (4 or 8) sub-voxels, then edits them individually
+    bool RefineVoxel(int32 X, int32 Y, int32 Z, int32 Resolution);
+    bool SetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel, EVoxelMaterial Material);
+    EVoxelMaterial GetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel) const { return ChunkData.GetSubVoxel(X, Y, Z, SubVoxel); }
+    
+    // Block entities - per-voxel state for crops, containers and machines; no remesh, no events
+    const FVoxelBlockEntity* FindBlockEntity(int32 X, int32 Y, int32 Z) const { return ChunkData.FindBlockEntity(X, Y, Z); }
+    bool SetBlockEntity(int32 X, int32 Y, int32 Z, const FVoxelBlockEntity& Entity) { return ChunkData.SetBlockEntity(X, Y, Z, Entity); }
+    bool RemoveBlockEntity(int32 X, int32 Y, int32 Z) { return ChunkData.RemoveBlockEntity(X, Y, Z); }
+    const FVoxelBlockEntityStore& GetBlockEntities() const { return ChunkData.BlockEntities; }
+    
+    // Column storage - unedited terrain as run-length spans per column, expanded again by the first edit
+    bool CompactToColumns(int32 MaxSpansPerColumn) { return ChunkData.CompactToColumns(MaxSpansPerColumn); }
+    bool IsColumnStored() const { return ChunkData.IsColumnStored(); }
+    int32 GetColumnTop(int32 X, int32 Y) const { return ChunkData.GetColumnTop(X, Y); }
+    int32 GetColumnBottom(int32 X, int32 Y) const { return ChunkData.GetColumnBottom(X, Y); }
+    
     // Mesh generation
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     void GenerateMesh(bool bAsync = true);
@@ -112,6 +146,16 @@ public:
     // Set chunk data (for loading from templates) - Not exposed to Blueprint
     void SetChunkData(const FVoxelChunkData& NewChunkData);
     
+    // Mesh built for the current chunk data - valid once the chunk is Ready
+    const FVoxelMeshData& GetMeshData() const { return MeshData; }
+    
+    // Shows a mesh built earlier for this exact chunk data (PIE snapshots) instead of meshing again.
+    // bWasGenerated restores HasBeenGenerated as it was when the mesh was built
+    void ApplyPrebuiltMesh(const FVoxelMeshData& InMeshData, EVoxelChunkLOD LOD, bool bWasGenerated);
+    
+    // Bytes held by this chunk per subsystem
+    FVoxelMemoryUsage GetMemoryUsage() const;
+    
     // Check if chunk has been generated
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     bool HasBeenGenerated() const { return bHasBeenGenerated; }
@@ -123,6 +167,13 @@ public:
     // Set material set
     void SetMaterialSet(UVoxelMaterialSet* InMaterialSet) { MaterialSet = InMaterialSet; }
     
+    // Baked traits of the active material set, the built-in table without one
+    const FVoxelMaterialTraitTable& GetMaterialTraits() const;
+    
+    // Start of the request-to-visible latency window, the earliest pending request wins
+    void MarkStreamingRequest() { if (StreamingRequestTime <= 0.0) { StreamingRequestTime = FPlatformTime::Seconds(); } }
+    void ClearStreamingRequest() { StreamingRequestTime = 0.0; }
+    
     // Additional utility functions
     UFUNCTION(BlueprintCallable, Category = "Voxel", meta = (DisplayName = "Get Voxel Count"))
     int32 GetVoxelCount() const;
@@ -286,6 +337,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Performance", meta = (DisplayName = "Enable Greedy Meshing"))
     bool bEnableGreedyMeshing = true;
     
+    // Merge faces on occupancy only and shade from a per-chunk material volume (needs a material set VolumeMaterial)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Performance", meta = (DisplayName = "Merge Across Materials", EditCondition = "bEnableGreedyMeshing"))
+    bool bMergeAcrossMaterials = false;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Performance", meta = (DisplayName = "Enable Mobile Optimizations"))
     bool bEnableMobileOptimizations = false;
     
@@ -326,6 +381,13 @@ public:
     UPROPERTY(BlueprintReadOnly, Category = "Voxel|Stats", meta = (DisplayName = "Is Generating"))
     bool bIsCurrentlyGenerating = false;
     
+    // Time the last mesh request waited in the world's task queue
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Stats", meta = (DisplayName = "Last Queue Wait (ms)"))
+    float LastQueueWaitMs = 0.0f;
+    
+    // FPlatformTime::Seconds() of the last voxel change made through this component, 0 when never edited
+    double LastEditTime = 0.0;
+    
 protected:
     // Chunk data
     UPROPERTY()
@@ -363,9 +425,17 @@ protected:
     UPROPERTY()
     AVoxelWorld* OwnerWorld;
     
+    // Material volume texture and the material instance sampling it
+    UPROPERTY(Transient)
+    UTexture2D* MaterialVolumeTexture;
+    
+    UPROPERTY(Transient)
+    UMaterialInstanceDynamic* VolumeMaterialInstance;
+    
     // Async mesh generation
     void GenerateMeshAsync();
     void ApplyMeshData();
+    void ApplyMaterialVolume(UVoxelMaterialSet* ActiveMaterialSet);
     
     // LOD mesh generation
     void GenerateLOD0Mesh();
@@ -384,6 +454,20 @@ private:
     // Thread-safe mesh generation flag
     FThreadSafeBool bIsGeneratingMesh;
     
+    // FPlatformTime::Seconds() of the pending streaming request, 0 when none
+    double StreamingRequestTime;
+    
+    // Record apply and request-to-visible latency once the mesh is on screen
+    void RecordApplyLatency(double ApplyStartTime);
+    
+    // Writes one voxel and, when its material really changed, raises OnVoxelChanged and the owner world's
+    // OnVoxelEditedNative. False when the write was out of range, refused or a no-op
+    bool WriteVoxel(int32 X, int32 Y, int32 Z, EVoxelMaterial Material);
+    
+    // bMergeAcrossMaterials, unless the material set has no VolumeMaterial to shade merged quads with
+    bool ShouldMergeAcrossMaterials();
+    bool bWarnedMissingVolumeMaterial = false;
+    
     // Cached world position
     FVector WorldPosition;
 };
@@ -466,9 +550,11 @@ protected:
     AVoxelWorld* OwnerWorld;
     
     // Helper functions
-    void DrawDebugInfo() const;
     void UpdateLODBasedOnDistance();
     
+    // Draws the debug flags above as part of the world's batched overlay
+    friend class FVoxelDebugRenderer;
+    
 private:
     // Cached player reference
     APawn* CachedPlayerPawn;
@@ -0,0 +1,221 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelTypes.h"
+#include "Algo/Count.h"
+
+/**
+ * Voxel order of a kernel's input
+ */
+enum class EVoxelDataLayout : uint8
+{
+    Preferred,      // Whatever the pass's voxel.Layout.* console variable selects
+    Linear,         // X fastest, then Y, then Z - FVoxelChunkData's own order
+    Tiled           // 4x4x4 tiles of 64 voxels, tiles in linear order - vertical neighbors stay within a tile
+};
+
+/**
+ * Passes that can pick their own layout
+ */
+enum class EVoxelLayoutPass : uint8
+{
+    Mesh,           // Greedy face masks, opaque and translucent
+    Downsample      // LOD block gathers
+};
+
+/**
+ * Chunk dimensions known at compile time.
+ * Kernels written against this get constant strides and trip counts, so the compiler can unroll,
+ * vectorise and strength-reduce the index math that FVoxelChunkData::GetVoxel does at runtime.
+ */
+template<int32 N>
+struct TVoxelFixedChunkDims
+{
+    static constexpr bool bTiled = false;
+
+    static constexpr int32 Size(int32 Axis) { return N; }
+    static constexpr int32 Stride(int32 Axis) { return Axis == 0 ? 1 : (Axis == 1 ? N : N * N); }
+    static constexpr int32 Count() { return N * N * N; }
+    static FORCEINLINE int32 Index(int32 X, int32 Y, int32 Z) { return X + Y * N + Z * N * N; }
+};
+
+/**
+ * Fixed dimensions over tiled data (see VoxelChunkKernels::ConvertToTiled).
+ * A voxel's Z neighbor is 16 entries away inside its tile instead of N * N.
+ */
+template<int32 N>
+struct TVoxelTiledChunkDims
+{
+    static_assert(N % 4 == 0, "Tiled chunks must be a multiple of the tile size");
+
+    static constexpr bool bTiled = true;
+    static constexpr int32 TilesPerAxis = N / 4;
+
+    static constexpr int32 Size(int32 Axis) { return N; }
+    static constexpr int32 Count() { return N * N * N; }
+    static FORCEINLINE int32 Index(int32 X, int32 Y, int32 Z)
+    {
+        const int32 Tile = (X >> 2) + (Y >> 2) * TilesPerAxis + (Z >> 2) * TilesPerAxis * TilesPerAxis;
+        return (Tile << 6) | (X & 3) | ((Y & 3) << 2) | ((Z & 3) << 4);
+    }
+};
+
+/**
+ * Fallback for any other chunk size - same interface, values read at runtime
+ */
+struct FVoxelRuntimeChunkDims
+{
+    FIntVector Dimensions;
+
+    static constexpr bool bTiled = false;
+
+    explicit FVoxelRuntimeChunkDims(const FVoxelChunkSize& ChunkSize) : Dimensions(ChunkSize.ToIntVector()) {}
+
+    FORCEINLINE int32 Size(int32 Axis) const { return Dimensions[Axis]; }
+    FORCEINLINE int32 Stride(int32 Axis) const { return Axis == 0 ? 1 : (Axis == 1 ? Dimensions.X : Dimensions.X * Dimensions.Y); }
+    FORCEINLINE int32 Count() const { return Dimensions.X * Dimensions.Y * Dimensions.Z; }
+    FORCEINLINE int32 Index(int32 X, int32 Y, int32 Z) const { return X + Y * Dimensions.X + Z * Dimensions.X * Dimensions.Y; }
+};
+
+/**
+ * Calls Kernel(Dims) with the 32^3 or 16^3 instantiation when the chunk matches one, otherwise with runtime dims.
+ * Kernel is a generic lambda taking (const auto& Dims).
+ */
+template<typename KernelType>
+FORCEINLINE decltype(auto) DispatchVoxelChunkKernel(const FVoxelChunkSize& ChunkSize, KernelType&& Kernel)
+{
+    if (ChunkSize.X == 32 && ChunkSize.Y == 32 && ChunkSize.Z == 32)
+    {
+        return Kernel(TVoxelFixedChunkDims<32>());
+    }
+    if (ChunkSize.X == 16 && ChunkSize.Y == 16 && ChunkSize.Z == 16)
+    {
+        return Kernel(TVoxelFixedChunkDims<16>());
+    }
+    return Kernel(FVoxelRuntimeChunkDims(ChunkSize));
+}
+
+/**
+ * Same for data already converted to the tiled layout - only 32^3 and 16^3 chunks have one
+ */
+template<typename KernelType>
+FORCEINLINE decltype(auto) DispatchVoxelTiledKernel(const FVoxelChunkSize& ChunkSize, KernelType&& Kernel)
+{
+    check(ChunkSize.X == ChunkSize.Y && ChunkSize.Y == ChunkSize.Z && (ChunkSize.X == 32 || ChunkSize.X == 16));
+    if (ChunkSize.X == 32)
+    {
+        return Kernel(TVoxelTiledChunkDims<32>());
+    }
+    return Kernel(TVoxelTiledChunkDims<16>());
+}
+
+namespace VoxelChunkKernels
+{
+    // Non-air voxels - branchless so the fixed-size loops vectorise
+    template<typename DimsType>
+    FORCEINLINE int32 CountSolidVoxels(const FVoxel* Voxels, const DimsType& Dims)
+    {
+        int32 Count = 0;
+        for (int32 Index = 0; Index < Dims.Count(); Index++)
+        {
+            Count += Voxels[Index].Material != EVoxelMaterial::Air ? 1 : 0;
+        }
+        return Count;
+    }
+
+    // Solid voxel count of a chunk, dispatched on its size
+    inline int32 CountSolidVoxels(const FVoxelChunkData& ChunkData)
+    {
+        if (ChunkData.IsColumnStored())
+        {
+            return ChunkData.Columns.CountSolidVoxels();
+        }
+
+        // Array out of step with the size - count what is there
+        if (ChunkData.Voxels.Num() != ChunkData.ChunkSize.GetVoxelCount())
+        {
+            return Algo::CountIf(ChunkData.Voxels, [](const FVoxel& Voxel) { return !Voxel.IsAir(); });
+        }
+
+        const FVoxel* Voxels = ChunkData.Voxels.GetData();
+        return DispatchVoxelChunkKernel(ChunkData.ChunkSize, [Voxels](const auto& Dims)
+        {
+            return CountSolidVoxels(Voxels, Dims);
+        });
+    }
+
+    FORCEINLINE bool SupportsTiledLayout(const FVoxelChunkSize& ChunkSize)
+    {
+        return ChunkSize.X == ChunkSize.Y && ChunkSize.Y == ChunkSize.Z && (ChunkSize.X == 32 || ChunkSize.X == 16);
+    }
+
+    // Reorders whole 4-voxel rows between the two layouts; bToTiled picks the direction
+    template<int32 N>
+    void ConvertLayout(const FVoxel* Source, FVoxel* Dest, bool bToTiled)
+    {
+        using FTiledDims = TVoxelTiledChunkDims<N>;
+        using FLinearDims = TVoxelFixedChunkDims<N>;
+
+        for (int32 Z = 0; Z < N; Z++)
+        {
+            for (int32 Y = 0; Y < N; Y++)
+            {
+                for (int32 X = 0; X < N; X += 4)
+                {
+                    const int32 LinearIndex = FLinearDims::Index(X, Y, Z);
+                    const int32 TiledIndex = FTiledDims::Index(X, Y, Z);
+                    if (bToTiled)
+                    {
+                        FMemory::Memcpy(Dest + TiledIndex, Source + LinearIndex, 4 * sizeof(FVoxel));
+                    }
+                    else
+                    {
+                        FMemory::Memcpy(Dest + LinearIndex, Source + TiledIndex, 4 * sizeof(FVoxel));
+                    }
+                }
+            }
+        }
+    }
+
+    // Copy of a chunk's voxels in the tiled layout, false when its size has none
+    inline bool ConvertToTiled(const FVoxelChunkData& ChunkData, TArray<FVoxel>& OutTiled)
+    {
+        if (!SupportsTiledLayout(ChunkData.ChunkSize) || ChunkData.Voxels.Num() != ChunkData.ChunkSize.GetVoxelCount())
+        {
+            return false;
+        }
+
+        OutTiled.SetNumUninitialized(ChunkData.Voxels.Num());
+        if (ChunkData.ChunkSize.X == 32)
+        {
+            ConvertLayout<32>(ChunkData.Voxels.GetData(), OutTiled.GetData(), true);
+        }
+        else
+        {
+            ConvertLayout<16>(ChunkData.Voxels.GetData(), OutTiled.GetData(), true);
+        }
+        return true;
+    }
+
+    // Back to FVoxelChunkData order
+    inline bool ConvertToLinear(const TArray<FVoxel>& Tiled, const FVoxelChunkSize& ChunkSize, TArray<FVoxel>& OutLinear)
+    {
+        if (!SupportsTiledLayout(ChunkSize) || Tiled.Num() != ChunkSize.GetVoxelCount())
+        {
+            return false;
+        }
+
+        OutLinear.SetNumUninitialized(Tiled.Num());
+        if (ChunkSize.X == 32)
+        {
+            ConvertLayout<32>(Tiled.GetData(), OutLinear.GetData(), false);
+        }
+        else
+        {
+            ConvertLayout<16>(Tiled.GetData(), OutLinear.GetData(), false);
+        }
+        return true;
+    }
+}
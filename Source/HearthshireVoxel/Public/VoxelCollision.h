@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelTypes.h"
+#include "VoxelCollision.generated.h"
+
+// Forward declarations
+class AVoxelWorld;
+
+/**
+ * Result of a shape sweep against voxel occupancy
+ */
+USTRUCT(BlueprintType)
+struct HEARTHSHIREVOXEL_API FVoxelSweepResult
+{
+    GENERATED_BODY()
+
+    // Any axis was clamped by a voxel
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    bool bBlockingHit;
+
+    // Downward movement was stopped - shape is resting on a voxel
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    bool bHitFloor;
+
+    // The floor voxel's material is walkable - false when landing on e.g. a non-walkable override material
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    bool bWalkableFloor;
+
+    // Upward movement was stopped
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    bool bHitCeiling;
+
+    // Final shape center after the sweep
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FVector Location;
+
+    // Movement actually applied
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FVector AppliedDelta;
+
+    // Axis normal of the first blocking voxel face
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FVector ImpactNormal;
+
+    // Global voxel coordinate of the first blocking voxel
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FIntVector HitVoxel;
+
+    FVoxelSweepResult()
+    {
+        bBlockingHit = false;
+        bHitFloor = false;
+        bWalkableFloor = false;
+        bHitCeiling = false;
+        Location = FVector::ZeroVector;
+        AppliedDelta = FVector::ZeroVector;
+        ImpactNormal = FVector::ZeroVector;
+        HitVoxel = FIntVector::ZeroValue;
+    }
+};
+
+/**
+ * Result of a ray trace against voxel occupancy
+ */
+USTRUCT(BlueprintType)
+struct HEARTHSHIREVOXEL_API FVoxelRaycastResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    bool bHit;
+
+    // World position where the ray entered the hit voxel or sub-voxel
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FVector Location;
+
+    // Axis normal of the face the ray entered through, zero when it started inside
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FVector ImpactNormal;
+
+    // Distance from the start along the ray
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    float Distance;
+
+    // Global voxel coordinate of the hit voxel
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FIntVector HitVoxel;
+
+    // Sub-voxel inside HitVoxel when it is refined, -1 otherwise
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    FIntVector HitSubVoxel;
+
+    // Material of the hit voxel or sub-voxel
+    UPROPERTY(BlueprintReadOnly, Category = "Voxel|Collision")
+    EVoxelMaterial Material;
+
+    FVoxelRaycastResult()
+    {
+        bHit = false;
+        Location = FVector::ZeroVector;
+        ImpactNormal = FVector::ZeroVector;
+        Distance = 0.0f;
+        HitVoxel = FIntVector::ZeroValue;
+        HitSubVoxel = FIntVector(-1);
+        Material = EVoxelMaterial::Air;
+    }
+};
+
+/**
+ * Collision queries that run directly on voxel data - no cooked mesh collision required.
+ * Sweeps are axis-separated (Z, then X, then Y), so results are stable for grid-aligned worlds.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelCollisionQuery
+{
+    // Gap kept between shapes and voxel faces to avoid re-penetration from float error
+    static constexpr float ContactOffset = 0.1f;
+
+    // Whether a material blocks movement, by its built-in traits - sweeps use the world's material set
+    static bool IsCollidableMaterial(EVoxelMaterial Material);
+
+    // Global voxel coordinate containing a world position
+    static FIntVector WorldToGlobalVoxel(const AVoxelWorld* World, const FVector& WorldPosition);
+
+    // Occupancy at a global voxel coordinate; unloaded chunks report bUnloadedIsSolid
+    static bool IsVoxelSolid(const AVoxelWorld* World, const FIntVector& GlobalVoxel, bool bUnloadedIsSolid = false);
+
+    // True if any collidable voxel overlaps the box
+    static bool OverlapBox(const AVoxelWorld* World, const FBox& Box, bool bUnloadedIsSolid = false);
+
+    // First collidable voxel or sub-voxel along the segment - refined voxels are traced through their sub-grid
+    static FVoxelRaycastResult Raycast(const AVoxelWorld* World, const FVector& Start, const FVector& End, bool bUnloadedIsSolid = false);
+
+    // Sweep an axis-aligned box
+    static FVoxelSweepResult SweepBox(const AVoxelWorld* World, const FVector& Center, const FVector& HalfExtent, const FVector& Delta, bool bUnloadedIsSolid = false);
+
+    // Sweep a Z-aligned capsule - corners are rounded, so capsules slide off voxel edges
+    static FVoxelSweepResult SweepCapsule(const AVoxelWorld* World, const FVector& Center, float Radius, float HalfHeight, const FVector& Delta, bool bUnloadedIsSolid = false);
+};
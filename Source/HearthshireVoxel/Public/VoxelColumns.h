@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EVoxelMaterial : uint8;
+struct FVoxel;
+
+/**
+ * Run of one material up a column. Runs longer than 255 voxels are split into several spans.
+ */
+struct FVoxelColumnSpan
+{
+    EVoxelMaterial Material;
+    uint8 Length;
+};
+
+/**
+ * Chunk voxels as run-length spans per (X, Y) column, bottom to top - heightfield terrain is a handful of
+ * spans per column instead of a full column of voxels, and a chunk whose columns are all alike (all air,
+ * all stone) stores a single column. Read-only: edits expand the chunk back to its dense array.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelColumnChunk
+{
+    FVoxelColumnChunk() : Size(FIntVector::ZeroValue) {}
+
+    FORCEINLINE bool IsEmpty() const { return Spans.Num() == 0; }
+
+    // Spans of one column, together always covering the full chunk height
+    FORCEINLINE TConstArrayView<FVoxelColumnSpan> GetColumn(int32 X, int32 Y) const
+    {
+        if (ColumnStarts.Num() == 0)
+        {
+            return Spans;
+        }
+        const int32 Column = X + Y * Size.X;
+        return MakeArrayView(Spans.GetData() + ColumnStarts[Column], ColumnStarts[Column + 1] - ColumnStarts[Column]);
+    }
+
+    FORCEINLINE EVoxelMaterial GetMaterial(int32 X, int32 Y, int32 Z) const
+    {
+        const TConstArrayView<FVoxelColumnSpan> Column = GetColumn(X, Y);
+        int32 SpanEnd = 0;
+        for (const FVoxelColumnSpan& Span : Column)
+        {
+            SpanEnd += Span.Length;
+            if (Z < SpanEnd)
+            {
+                return Span.Material;
+            }
+        }
+        return Column.Last().Material;
+    }
+
+    // Every stored span - for scans over the materials a chunk holds
+    TConstArrayView<FVoxelColumnSpan> GetSpans() const { return Spans; }
+
+    // Highest and lowest non-air voxel of a column, INDEX_NONE when it is all air.
+    // Walks the column's spans from that end, at most MaxSpansPerColumn of them - no voxel is read
+    int32 GetColumnTop(int32 X, int32 Y) const;
+    int32 GetColumnBottom(int32 X, int32 Y) const;
+
+    // Compacts dense voxels in FVoxelChunkData order. False, leaving this empty, when a column needs more
+    // than MaxSpansPerColumn spans or the chunk has too many to index
+    bool Build(const FIntVector& InSize, TConstArrayView<FVoxel> Voxels, int32 MaxSpansPerColumn);
+
+    // Dense voxels in FVoxelChunkData order
+    void ToDense(TArray<FVoxel>& OutVoxels) const;
+
+    int32 CountSolidVoxels() const;
+
+    void Reset();
+
+    int64 GetAllocatedSize() const;
+
+private:
+    FIntVector Size;
+
+    // All columns back to back, X fastest
+    TArray<FVoxelColumnSpan> Spans;
+
+    // First span of each column plus one past the last, empty when every column shares Spans
+    TArray<uint16> ColumnStarts;
+};
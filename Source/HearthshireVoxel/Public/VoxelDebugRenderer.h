@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelDebugRenderer.generated.h"
+
+// Forward declarations
+class AVoxelWorld;
+class UVoxelChunkComponent;
+
+/**
+ * What the chunk bounds overlay is coloured by
+ */
+UENUM(BlueprintType)
+enum class EVoxelDebugHeatmap : uint8
+{
+    None = 0        UMETA(DisplayName = "None"),
+    MeshTime        UMETA(DisplayName = "Mesh Time"),
+    Triangles       UMETA(DisplayName = "Triangle Count"),
+    QueueWait       UMETA(DisplayName = "Queue Wait"),
+    Memory          UMETA(DisplayName = "Memory"),
+    LOD             UMETA(DisplayName = "LOD"),
+    EditAge         UMETA(DisplayName = "Last Edit Age"),
+    Count           UMETA(Hidden)
+};
+
+/**
+ * World-level chunk debug overlay.
+ * Collects every chunk's bounds, heatmap colour and voxel grid points and submits them as a single
+ * line batch and point batch per frame, instead of each chunk issuing its own draw calls from Tick.
+ * Select the heatmap with voxel.debug.heatmap <0-6> (or SetHeatmapMode).
+ */
+class HEARTHSHIREVOXEL_API FVoxelDebugRenderer
+{
+public:
+    // Called once per frame by AVoxelWorld
+    static void Draw(const AVoxelWorld& VoxelWorld);
+
+    static EVoxelDebugHeatmap GetHeatmapMode();
+    static void SetHeatmapMode(EVoxelDebugHeatmap Mode);
+    static const TCHAR* GetHeatmapName(EVoxelDebugHeatmap Mode);
+
+    // Chunk value in the mode's units (ms, triangles, MB, LOD index, seconds), negative when it has none
+    static float GetHeatValue(const UVoxelChunkComponent& Chunk, EVoxelDebugHeatmap Mode, double Now);
+
+    // 0 = cold (green) to 1 = hot (red)
+    static FLinearColor GetHeatColor(float Normalized);
+
+    // Box outlines in one batch, LifeTime > 0 keeps them in the persistent batcher
+    static void DrawBoxes(UWorld* World, const TArray<FBox>& Boxes, const TArray<FLinearColor>& Colors, float Thickness, float LifeTime = 0.0f);
+};
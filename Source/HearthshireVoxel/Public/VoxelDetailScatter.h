@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "VoxelTypes.h"
+#include "VoxelChunk.h"
+#include "VoxelDetailScatter.generated.h"
+
+// Forward declarations
+class AVoxelWorld;
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * One kind of scattered detail (grass tufts, flowers, pebbles)
+ */
+USTRUCT(BlueprintType)
+struct HEARTHSHIREVOXEL_API FVoxelDetailLayer
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail")
+    UStaticMesh* Mesh;
+
+    // Top faces of these materials receive instances
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail")
+    TArray<EVoxelMaterial> SurfaceMaterials;
+
+    // Chance of an instance per exposed surface voxel at LOD0
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail", meta = (ClampMin = "0", ClampMax = "1"))
+    float Density;
+
+    // Density multiplier per chunk LOD (index 0 = LOD0)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail", meta = (DisplayName = "LOD Density Scale"))
+    TArray<float> LODDensityScale;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail", meta = (ClampMin = "0.1", ClampMax = "10"))
+    float MinScale;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail", meta = (ClampMin = "0.1", ClampMax = "10"))
+    float MaxScale;
+
+    // Fraction of a voxel instances may drift from the voxel center
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail", meta = (ClampMin = "0", ClampMax = "0.5"))
+    float PositionJitter;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail")
+    bool bRandomYaw;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail|Rendering")
+    bool bCastShadow;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail|Rendering", meta = (ClampMin = "0"))
+    int32 CullStartDistance;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Detail|Rendering", meta = (ClampMin = "0"))
+    int32 CullEndDistance;
+
+    FVoxelDetailLayer()
+    {
+        Mesh = nullptr;
+        SurfaceMaterials.Add(EVoxelMaterial::Grass);
+        Density = 0.3f;
+        LODDensityScale = { 1.0f, 0.5f, 0.15f, 0.0f };
+        MinScale = 0.8f;
+        MaxScale = 1.2f;
+        PositionJitter = 0.4f;
+        bRandomYaw = true;
+        bCastShadow = false;
+        CullStartDistance = 3000;
+        CullEndDistance = 5000;
+    }
+
+    // Density multiplier for a chunk LOD
+    float GetLODScale(EVoxelChunkLOD LOD) const;
+};
+
+/**
+ * Scatters instanced detail meshes on exposed voxel surfaces of a voxel world.
+ * Add to an AVoxelWorld actor. Transforms are built on worker threads from the world seed,
+ * so the same terrain always produces the same instances, and follow chunk streaming, edits and LOD.
+ */
+UCLASS(ClassGroup=(Voxel), meta=(BlueprintSpawnableComponent))
+class HEARTHSHIREVOXEL_API UVoxelDetailScatterComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UVoxelDetailScatterComponent();
+
+    // Component overrides
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Detail")
+    TArray<FVoxelDetailLayer> Layers;
+
+    // Seconds an edited chunk waits before being rescattered, so brush strokes rebuild once
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Detail", meta = (ClampMin = "0", ClampMax = "2"))
+    float EditRebuildDelay = 0.25f;
+
+    // Rebuild every loaded chunk (after changing layers)
+    UFUNCTION(BlueprintCallable, Category = "Voxel|Detail")
+    void RebuildAll();
+
+    // Runtime multiplier on every layer's density (quality settings, governor), rebuilds when it changes
+    UFUNCTION(BlueprintCallable, Category = "Voxel|Detail")
+    void SetDensityScale(float NewScale);
+
+    UFUNCTION(BlueprintPure, Category = "Voxel|Detail")
+    float GetDensityScale() const { return DensityScale; }
+
+    UFUNCTION(BlueprintCallable, Category = "Voxel|Detail")
+    void ClearAll();
+
+    UFUNCTION(BlueprintPure, Category = "Voxel|Detail")
+    int32 GetInstanceCount() const;
+
+    // Build instance transforms for one chunk - thread safe, relative to the chunk origin
+    static void BuildChunkInstances(const FVoxelChunkData& ChunkData, const TArray<uint8>& AboveLayer, const TArray<FVoxelDetailLayer>& InLayers,
+        EVoxelChunkLOD LOD, int32 Seed, TArray<TArray<FTransform>>& OutTransforms);
+
+protected:
+    UFUNCTION()
+    void HandleChunkLoaded(const FIntVector& ChunkPosition);
+
+    UFUNCTION()
+    void HandleChunkUnloaded(const FIntVector& ChunkPosition);
+
+    UFUNCTION()
+    void HandleLODChanged(UVoxelChunkComponent* Chunk, EVoxelChunkLOD OldLOD, EVoxelChunkLOD NewLOD);
+
+    void HandleVoxelEdited(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, EVoxelMaterial Material);
+    void HandleChunkReplaced(const FIntVector& ChunkPosition);
+
+    void ScheduleChunk(const FIntVector& ChunkPosition);
+    void ApplyChunkInstances(const FIntVector& ChunkPosition, uint32 Generation, TArray<TArray<FTransform>>&& Transforms);
+    void ReleaseChunk(const FIntVector& ChunkPosition);
+
+    UHierarchicalInstancedStaticMeshComponent* AcquireComponent(const FVoxelDetailLayer& Layer);
+    void ReleaseComponent(UHierarchicalInstancedStaticMeshComponent* Component);
+
+    UPROPERTY()
+    AVoxelWorld* VoxelWorld;
+
+    // Every component ever created - keeps pooled ones referenced
+    UPROPERTY()
+    TArray<UHierarchicalInstancedStaticMeshComponent*> AllComponents;
+
+    UPROPERTY()
+    TArray<UHierarchicalInstancedStaticMeshComponent*> FreeComponents;
+
+private:
+    struct FChunkDetail
+    {
+        // Bumped on every rebuild so stale worker results are dropped
+        uint32 Generation = 0;
+        TArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+        TWeakObjectPtr<UVoxelChunkComponent> ChunkComponent;
+    };
+
+    TMap<FIntVector, FChunkDetail> ChunkDetails;
+
+    // Edited chunks waiting for EditRebuildDelay
+    TMap<FIntVector, float> PendingRebuilds;
+
+    float DensityScale = 1.0f;
+
+    FDelegateHandle EditedHandle;
+    FDelegateHandle ReplacedHandle;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "VoxelTypes.h"
+#include "VoxelChunkKernels.h"
 
 /**
  * High-performance greedy meshing implementation
@@ -33,9 +34,34 @@ public:
     };
     
     // Main greedy meshing function - generates optimized quads
+    // bMergeAcrossMaterials merges opaque faces on occupancy alone; quad materials are then only
+    // representative and shading must read FVoxelMaterialVolume
+    // Traits decide which voxels are meshed and which faces they hide - null uses the built-in table
+    // Column-stored chunks are meshed from their spans, whatever Layout asks for
     static void GenerateGreedyMesh(
         const FVoxelChunkData& ChunkData,
-        TArray<FGreedyQuad>& OutQuads
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials = false,
+        EVoxelDataLayout Layout = EVoxelDataLayout::Preferred,
+        const FVoxelMaterialTraitTable* Traits = nullptr
+    );
+    
+    // Merged translucent quads - only faces against non-translucent space, sorted bottom to top for blending
+    static void GenerateTranslucentQuads(
+        const FVoxelChunkData& ChunkData,
+        TArray<FGreedyQuad>& OutQuads,
+        EVoxelDataLayout Layout = EVoxelDataLayout::Preferred,
+        const FVoxelMaterialTraitTable* Traits = nullptr
+    );
+    
+    // Quads of a single face direction - lets benchmarks time each pass on each layout
+    static void GenerateFaceQuads(
+        const FVoxelChunkData& ChunkData,
+        EVoxelFace Face,
+        TArray<FGreedyQuad>& OutQuads,
+        bool bTranslucentPass,
+        EVoxelDataLayout Layout,
+        const FVoxelMaterialTraitTable* Traits = nullptr
     );
     
     // Convert greedy quads to renderable mesh data
@@ -45,12 +71,14 @@ public:
         float VoxelSize = 25.0f
     );
     
-    // Generate greedy mesh from raw voxel array
+    // Generate greedy mesh from raw voxel array. Merging across materials also builds the material volume at VoxelSize
     static void GenerateGreedyMeshFromData(
         const TArray<EVoxelMaterial>& VoxelData,
         const FVoxelChunkSize& ChunkSize,
         float VoxelSize,
-        FVoxelMeshData& OutMeshData
+        FVoxelMeshData& OutMeshData,
+        const FVoxelMaterialTraitTable* Traits = nullptr,
+        bool bMergeAcrossMaterials = false
     );
     
     // Get mesh reduction statistics
@@ -73,54 +101,89 @@ private:
         {
             return bVisible && Other.bVisible && Material == Other.Material;
         }
+        
+        // Occupancy-only merge - translucent faces still merge per material so they stay separable
+        bool CanMergeIgnoringMaterial(const FFaceMask& Other, const FVoxelMaterialTraits* Traits) const
+        {
+            return bVisible && Other.bVisible &&
+                (Material == Other.Material || (!Traits[(uint8)Material].bTranslucent && !Traits[(uint8)Other.Material].bTranslucent));
+        }
     };
     
-    // Process a single face direction with greedy algorithm
-    static void ProcessFaceDirection(
+    // Runs the slice kernels of each face, converting to the tiled layout first when it applies
+    static void ProcessFaces(
         const FVoxelChunkData& ChunkData,
-        EVoxelFace Face,
-        TArray<FGreedyQuad>& OutQuads
+        TConstArrayView<EVoxelFace> Faces,
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials,
+        bool bTranslucentPass,
+        EVoxelDataLayout Layout,
+        const FVoxelMaterialTraits* Traits
     );
     
-    // Create face visibility mask for a slice
-    static void CreateFaceMask(
+    // Opaque quads of a column-stored chunk - masks are filled from span boundaries and span overlaps
+    // between neighboring columns instead of per-voxel neighbor reads, then merged like the dense masks
+    static void GenerateColumnQuads(
         const FVoxelChunkData& ChunkData,
-        EVoxelFace Face,
-        int32 SliceIndex,
-        TArray<FFaceMask>& OutMask,
-        FIntVector& OutMaskDimensions
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials,
+        const FVoxelMaterialTraits* Traits
     );
     
-    // Extract greedy quads from face mask
-    static void ExtractQuadsFromMask(
-        TArray<FFaceMask>& Mask,
-        const FIntVector& MaskDimensions,
-        EVoxelFace Face,
-        int32 SliceIndex,
-        TArray<FGreedyQuad>& OutQuads
+    // Side faces, one slice at a time
+    template<EVoxelFace Face>
+    static void ProcessColumnSideFaces(
+        const FVoxelColumnChunk& Columns,
+        const FVoxelRuntimeChunkDims& Dims,
+        FFaceMask* Mask,
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials,
+        const FVoxelMaterialTraits* Traits
     );
     
-    // Try to extend a quad in the given direction
-    static FIntVector ExtendQuad(
-        const TArray<FFaceMask>& Mask,
-        const FIntVector& MaskDimensions,
-        const FIntVector& StartPos,
-        EVoxelMaterial Material
+    // Top or bottom faces of every slice in one pass over the columns; Mask covers the whole chunk
+    template<EVoxelFace Face>
+    static void ProcessColumnCapFaces(
+        const FVoxelColumnChunk& Columns,
+        const FVoxelRuntimeChunkDims& Dims,
+        FFaceMask* Mask,
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials,
+        const FVoxelMaterialTraits* Traits
     );
     
-    // Mark quad area as processed in mask
-    static void MarkQuadProcessed(
-        TArray<FFaceMask>& Mask,
-        const FIntVector& MaskDimensions,
-        const FIntVector& StartPos,
-        const FIntVector& QuadSize
+    // Slice kernels, instantiated per face and per chunk dimension and layout (see VoxelChunkKernels.h)
+    template<EVoxelFace Face, typename DimsType>
+    static void ProcessFaceSlices(
+        const FVoxel* Voxels,
+        const DimsType& Dims,
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials,
+        bool bTranslucentPass,
+        const FVoxelMaterialTraits* Traits
     );
     
-    // Helper to convert 2D mask coordinates to 1D array index
-    static FORCEINLINE int32 GetMaskIndex(int32 U, int32 V, const FIntVector& MaskDimensions)
-    {
-        return U + V * MaskDimensions.X;
-    }
+    // Create face visibility mask for a slice
+    template<EVoxelFace Face, typename DimsType>
+    static void CreateFaceMask(
+        const FVoxel* Voxels,
+        const DimsType& Dims,
+        int32 SliceIndex,
+        FFaceMask* OutMask,
+        bool bTranslucentPass,
+        const FVoxelMaterialTraits* Traits
+    );
+    
+    // Extract greedy quads from face mask, clearing the cells they cover
+    template<EVoxelFace Face, typename DimsType>
+    static void ExtractQuadsFromMask(
+        FFaceMask* Mask,
+        const DimsType& Dims,
+        int32 SliceIndex,
+        TArray<FGreedyQuad>& OutQuads,
+        bool bMergeAcrossMaterials,
+        const FVoxelMaterialTraits* Traits
+    );
     
     // Get the axis indices for a given face (returns primary axis, U axis, V axis)
     static void GetFaceAxes(EVoxelFace Face, int32& PrimaryAxis, int32& UAxis, int32& VAxis);
@@ -131,13 +194,6 @@ private:
         EVoxelFace Face
     );
     
-    // Check if a voxel face is visible (needs to be rendered)
-    static bool IsFaceVisible(
-        const FVoxelChunkData& ChunkData,
-        int32 X, int32 Y, int32 Z,
-        EVoxelFace Face
-    );
-    
     // Get neighbor voxel in the direction of the face
     static FVoxel GetNeighborVoxel(
         const FVoxelChunkData& ChunkData,
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "VoxelTypes.h"
+#include "VoxelChunkKernels.h"
 #include "ProceduralMeshComponent.h"
 
 /**
@@ -20,6 +21,9 @@ public:
         bool bSmoothNormals = false;
         bool bGenerateTangents = true;
         bool bOptimizeIndices = true;
+        bool bMergeAcrossMaterials = false; // Greedy only - also builds the material volume
+        EVoxelDataLayout Layout = EVoxelDataLayout::Preferred; // Voxel order of greedy masks and LOD downsampling
+        const FVoxelMaterialTraitTable* MaterialTraits = nullptr; // Baked table of the chunk's material set, null = built-in
         
         FGenerationConfig() = default;
     };
@@ -38,7 +42,36 @@ public:
         const FGenerationConfig& Config = FGenerationConfig()
     );
     
-    // Generate LOD mesh
+    // Generate the translucent buffers of an already meshed chunk
+    static void GenerateTranslucentMesh(
+        const FVoxelChunkData& ChunkData,
+        FVoxelMeshData& OutMeshData,
+        const FGenerationConfig& Config = FGenerationConfig()
+    );
+    
+    // Sub-voxel geometry of refined voxels, appended to the opaque buffers. Each cell is greedy meshed on its own,
+    // and cell-border faces against an opaque neighbour voxel are dropped
+    static void GenerateRefinedMesh(
+        const FVoxelChunkData& ChunkData,
+        FVoxelMeshData& OutMeshData,
+        const FGenerationConfig& Config = FGenerationConfig()
+    );
+    
+    // Majority vote of each BlockSize^3 cell, preferring solid over air - input of LOD meshes.
+    // Refined voxels vote with their representative material
+    static void DownsampleVoxels(
+        const FVoxelChunkData& ChunkData,
+        int32 BlockSize,
+        TArray<EVoxelMaterial>& OutVoxels,
+        FVoxelChunkSize& OutSize,
+        EVoxelDataLayout Layout = EVoxelDataLayout::Preferred
+    );
+    
+    // Layout a pass actually runs on - Preferred reads voxel.Layout.Mesh / voxel.Layout.Downsample,
+    // and chunk sizes without a tiled form always get Linear
+    static EVoxelDataLayout ResolveLayout(EVoxelDataLayout Layout, EVoxelLayoutPass Pass, const FVoxelChunkSize& ChunkSize);
+    
+    // Generate LOD mesh (level 1 = 2x2x2 blocks, level 2 = 4x4x4 blocks)
     static void GenerateLODMesh(
         const FVoxelChunkData& ChunkData,
         FVoxelMeshData& OutMeshData,
@@ -46,6 +79,9 @@ public:
         const FGenerationConfig& Config = FGenerationConfig()
     );
     
+    // Procedural mesh section holding water and ice
+    static constexpr int32 TranslucentSectionIndex = 1;
+    
     // Apply mesh data to procedural mesh component
     static void ApplyMeshToComponent(
         UProceduralMeshComponent* Component,
@@ -69,18 +105,27 @@ public:
     );
     
     static FVector GetFaceNormal(EVoxelFace Face);
+    static FIntVector GetFaceDirection(EVoxelFace Face);
     static void GetFaceVertices(EVoxelFace Face, const FVector& Position, float Size, FVector OutVertices[4]);
     static void GetFaceUVs(EVoxelFace Face, FVector2D OutUVs[4]);
     static bool IsFaceVisible(
         const FVoxelChunkData& ChunkData,
         int32 X, int32 Y, int32 Z,
-        EVoxelFace Face
+        EVoxelFace Face,
+        const FVoxelMaterialTraitTable& Traits = FVoxelMaterialTraitTable::GetDefault()
     );
     
     // Material section management - made public for greedy mesher
     static int32 GetOrCreateMaterialSection(FVoxelMeshData& MeshData, EVoxelMaterial Material);
     
 private:
+    // Create the translucent section with its own material
+    static void ApplyTranslucentSection(
+        UProceduralMeshComponent* Component,
+        const FVoxelMeshData& MeshData,
+        UVoxelMaterialSet* MaterialSet
+    );
+    
     // Face generation helpers
     static void AddFace(
         FVoxelMeshData& MeshData,
@@ -107,9 +152,6 @@ private:
         EVoxelFace Face
     );
     
-    // Face direction helpers
-    static FIntVector GetFaceDirection(EVoxelFace Face);
-    
     // Optimization helpers
     static void OptimizeMeshData(FVoxelMeshData& MeshData);
     static void CalculateTangents(FVoxelMeshData& MeshData);
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Stats/Stats.h"
+#include "ProfilingDebugging/LowLevelMemTracker.h"
+#include <atomic>
 #include "VoxelPerformanceStats.generated.h"
 
 // Stat group for voxel performance
@@ -14,14 +16,80 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("Voxel Mesh Generation"), STAT_VoxelMeshGeneratio
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Greedy Meshing"), STAT_GreedyMeshing, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Chunk Update"), STAT_ChunkUpdate, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Voxel Memory"), STAT_VoxelMemory, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Detail Scatter"), STAT_DetailScatter, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Chunks"), STAT_ActiveChunks, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Total Triangles"), STAT_TotalTriangles, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Total Vertices"), STAT_TotalVertices, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Triangle Reduction %"), STAT_TriangleReduction, STATGROUP_VoxelSystem, HEARTHSHIREVOXEL_API);
 
+// Low-level memory tracker tags, shown under Voxel in "stat llmfull" and Insights (-llm)
+LLM_DECLARE_TAG_API(Voxel, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_Data, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_MeshCPU, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_MeshGPU, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_Collision, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_Cache, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_Templates, HEARTHSHIREVOXEL_API);
+LLM_DECLARE_TAG_API(Voxel_Scratch, HEARTHSHIREVOXEL_API);
+
+#define VOXEL_LLM_SCOPE(Tag) LLM_SCOPE_BYTAG(Voxel_##Tag)
+
+/**
+ * Chunk streaming stages with latency histograms
+ */
+enum class EVoxelLatencyStage : uint8
+{
+    QueueWait,          // Queued until a generation slot picked it up
+    Generate,           // Voxel data generated or loaded from a template
+    Mesh,               // Mesh built (worker thread when async)
+    Apply,              // Mesh sections uploaded on the game thread
+    RequestToVisible,   // Chunk needed until its mesh is applied
+    Count
+};
+
+/**
+ * Fixed-bucket log-linear (HDR style) histogram of durations.
+ * Exact up to 16us, then 8 buckets per power of two (<12.5% error) up to ~2 minutes.
+ * Recording is a few relaxed atomics, so any thread can record without locking.
+ */
+class HEARTHSHIREVOXEL_API FVoxelLatencyHistogram
+{
+public:
+    static constexpr int32 SubBucketBits = 3;
+    static constexpr int32 SubBucketCount = 1 << SubBucketBits;
+    static constexpr int32 LinearBucketCount = SubBucketCount * 2;
+    static constexpr int32 OctaveCount = 23;
+    static constexpr int32 NumBuckets = LinearBucketCount + OctaveCount * SubBucketCount;
+    
+    FVoxelLatencyHistogram();
+    
+    void Record(double Milliseconds);
+    void Reset();
+    
+    uint64 GetCount() const { return TotalCount.load(std::memory_order_relaxed); }
+    double GetMeanMs() const;
+    double GetMaxMs() const;
+    
+    // Upper edge of the bucket holding the percentile (0-1), never above the recorded max
+    double GetPercentileMs(double Percentile) const;
+    
+    static int32 GetBucketIndex(uint64 Microseconds);
+    
+    // Exclusive upper bound of a bucket in microseconds
+    static uint64 GetBucketUpperBound(int32 BucketIndex);
+    
+private:
+    std::atomic<uint64> Buckets[NumBuckets];
+    std::atomic<uint64> TotalCount;
+    std::atomic<uint64> TotalMicroseconds;
+    std::atomic<uint64> MaxMicroseconds;
+};
+
 /**
- * Performance monitoring utilities
+ * Performance monitoring utilities.
+ * Recording never takes a lock: samples go to a per-thread ring, per-frame totals to atomic
+ * counters. Readers merge the thread rings and the fixed-size frame history on demand.
  */
 class HEARTHSHIREVOXEL_API FVoxelPerformanceMonitor
 {
@@ -32,27 +100,40 @@ public:
     // Start/stop monitoring
     void StartMonitoring();
     void StopMonitoring();
-    bool IsMonitoring() const { return bIsMonitoring; }
+    bool IsMonitoring() const { return bIsMonitoring.load(std::memory_order_relaxed); }
     
-    // Record performance data
+    // Record performance data - safe from any thread
     void RecordMeshGeneration(float TimeMs, int32 TriangleCount, int32 VertexCount);
     void RecordGreedyMeshing(float TimeMs, float ReductionPercent);
+    
+    // Closes the current frame, call once per frame from the game thread
     void RecordChunkUpdate(int32 ActiveChunks, float MemoryMB);
     
+    // Streaming latency - always recording, lock free and safe from any thread
+    void RecordLatency(EVoxelLatencyStage Stage, double Milliseconds);
+    const FVoxelLatencyHistogram& GetLatencyHistogram(EVoxelLatencyStage Stage) const { return LatencyHistograms[(int32)Stage]; }
+    void ResetLatency();
+    FString GetLatencyReport() const;
+    static const TCHAR* GetLatencyStageName(EVoxelLatencyStage Stage);
+    
     // Get performance report
     FString GetPerformanceReport() const;
     
-    // CSV logging
+    // CSV logging - latency percentiles go to <File>_Latency.csv next to the frame data
     void EnableCSVLogging(bool bEnable);
     void DumpCSVData(const FString& FilePath) const;
+    bool DumpLatencyCSV(const FString& FilePath) const;
     
 private:
     FVoxelPerformanceMonitor();
     ~FVoxelPerformanceMonitor();
     
-    bool bIsMonitoring;
+    std::atomic<bool> bIsMonitoring;
     bool bCSVLoggingEnabled;
     
+    // Samples older than this are ignored when thread rings are merged
+    std::atomic<uint64> MonitoringStartCycles;
+    
     // Performance history
     struct FPerformanceFrame
     {
@@ -66,11 +147,70 @@ private:
         float MemoryUsageMB;
     };
     
+    // Fixed-capacity ring, HistoryHead is the next slot to write
+    static constexpr int32 MaxHistoryFrames = 1000;
     TArray<FPerformanceFrame> PerformanceHistory;
+    int32 HistoryHead;
+    int32 HistoryCount;
     mutable FCriticalSection HistoryLock;
     
-    // Current frame data
-    FPerformanceFrame CurrentFrame;
+    // Totals for the frame in progress, swapped out by RecordChunkUpdate
+    struct FFrameCounters
+    {
+        std::atomic<uint64> MeshGenerationMicroseconds;
+        std::atomic<uint64> MeshGenerationCount;
+        std::atomic<uint64> TriangleCount;
+        std::atomic<uint64> VertexCount;
+        std::atomic<uint64> GreedyMeshingMicroseconds;
+        std::atomic<uint64> GreedyMeshingCount;
+        std::atomic<uint64> ReductionHundredths;
+    };
+    
+    FFrameCounters CurrentFrame;
+    
+    // Individual samples, one ring per recording thread
+    enum class ESampleType : uint8
+    {
+        MeshGeneration,
+        GreedyMeshing
+    };
+    
+    struct FSample
+    {
+        uint64 Cycles;
+        float TimeMs;
+        float Value;
+        int32 TriangleCount;
+        int32 VertexCount;
+        ESampleType Type;
+    };
+    
+    // Per-slot seqlock: Sequence is 2 * Index + 1 while sample Index is being written, 2 * Index + 2 once it is
+    // complete. The payload goes through relaxed atomic words so a reader racing the writer is well defined
+    struct FSampleSlot
+    {
+        static constexpr int32 NumWords = (sizeof(FSample) + sizeof(uint64) - 1) / sizeof(uint64);
+        std::atomic<uint64> Sequence{0};
+        std::atomic<uint64> Words[NumWords];
+    };
+    
+    struct FThreadSampleRing
+    {
+        static constexpr uint32 Capacity = 1024;
+        FSampleSlot Slots[Capacity];
+        std::atomic<uint64> WriteCount{0};
+    };
+    
+    // Rings live as long as the monitor, the lock is only taken when a thread first records
+    TArray<TUniquePtr<FThreadSampleRing>> ThreadRings;
+    mutable FCriticalSection ThreadRingsLock;
+    
+    FThreadSampleRing& GetThreadRing();
+    void PushSample(const FSample& Sample);
+    
+    // Merges every thread's ring, oldest first, returns the number of threads
+    int32 GatherSamples(TArray<FSample>& OutSamples) const;
+    void CopyHistory(TArray<FPerformanceFrame>& OutFrames) const;
     
     // Statistics
     float AverageMeshGenerationMs;
@@ -78,6 +218,8 @@ private:
     float AverageTriangleReduction;
     float PeakMemoryUsageMB;
     
+    FVoxelLatencyHistogram LatencyHistograms[(int32)EVoxelLatencyStage::Count];
+    
     void UpdateStatistics();
 };
 
@@ -107,6 +249,16 @@ struct HEARTHSHIREVOXEL_API FVoxelPerformanceReport
     UPROPERTY(BlueprintReadOnly, Category = "Performance")
     int32 TotalChunksGenerated;
     
+    // Chunk request until visible
+    UPROPERTY(BlueprintReadOnly, Category = "Performance", meta = (DisplayName = "Streaming Latency P50 (ms)"))
+    float StreamingLatencyP50Ms;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Performance", meta = (DisplayName = "Streaming Latency P95 (ms)"))
+    float StreamingLatencyP95Ms;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Performance", meta = (DisplayName = "Streaming Latency P99 (ms)"))
+    float StreamingLatencyP99Ms;
+    
     UPROPERTY(BlueprintReadOnly, Category = "Performance")
     FString PerformanceSummary;
     
@@ -118,5 +270,8 @@ struct HEARTHSHIREVOXEL_API FVoxelPerformanceReport
         CurrentMemoryUsageMB = 0.0f;
         PeakMemoryUsageMB = 0.0f;
         TotalChunksGenerated = 0;
+        StreamingLatencyP50Ms = 0.0f;
+        StreamingLatencyP95Ms = 0.0f;
+        StreamingLatencyP99Ms = 0.0f;
     }
 };
\ No newline at end of file
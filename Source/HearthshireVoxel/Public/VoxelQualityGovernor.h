@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "VoxelQualityGovernor.generated.h"
+
+// Forward declarations
+class AVoxelWorld;
+class UVoxelDetailScatterComponent;
+
+/**
+ * Holds the frame rate by trading voxel quality for frame time.
+ * Watches smoothed game and render thread times against the target and steps a quality level
+ * up or down; each level maps view distance, LOD distance bands, chunks per frame and detail
+ * density between the configured minimums and the world's own settings. A step down needs
+ * the frame to stay over budget for DowngradeDelay, a step up needs clear headroom for
+ * UpgradeDelay, so busy scenes do not make settings oscillate.
+ * Add to an AVoxelWorld (next to its detail scatter component, if any).
+ */
+UCLASS(ClassGroup=(Voxel), meta=(BlueprintSpawnableComponent))
+class HEARTHSHIREVOXEL_API UVoxelQualityGovernorComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UVoxelQualityGovernorComponent();
+
+    // Component overrides
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor")
+    bool bEnabled = true;
+
+    // 0 picks 30 on mobile and 60 elsewhere
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor", meta = (ClampMin = "0", ClampMax = "240"))
+    int32 TargetFPS = 0;
+
+    // Quality steps between the minimum settings (level 0) and the world's configured ones
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor", meta = (ClampMin = "2", ClampMax = "10"))
+    int32 QualityLevels = 5;
+
+    // Time constant of the frame time average
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor", meta = (ClampMin = "0.1", ClampMax = "5"))
+    float SmoothingTime = 0.5f;
+
+    // Step down after the frame has been over budget this long
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor", meta = (ClampMin = "0", ClampMax = "10"))
+    float DowngradeDelay = 1.0f;
+
+    // Step up after the frame has been below UpgradeThreshold of the budget this long
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor", meta = (ClampMin = "0", ClampMax = "30"))
+    float UpgradeDelay = 5.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor", meta = (ClampMin = "0.3", ClampMax = "1"))
+    float UpgradeThreshold = 0.75f;
+
+    // Bounds at level 0
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor|Bounds", meta = (ClampMin = "1", ClampMax = "20"))
+    int32 MinViewDistanceInChunks = 3;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor|Bounds", meta = (ClampMin = "0.1", ClampMax = "1"))
+    float MinLODDistanceScale = 0.5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor|Bounds", meta = (ClampMin = "1", ClampMax = "20"))
+    int32 MinChunksPerFrame = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Governor|Bounds", meta = (ClampMin = "0", ClampMax = "1"))
+    float MinDetailDensityScale = 0.25f;
+
+    // Current level, QualityLevels - 1 is the world's configured quality
+    UFUNCTION(BlueprintPure, Category = "Voxel|Governor")
+    int32 GetQualityLevel() const { return QualityLevel; }
+
+    // Pin a level (bEnabled = false keeps it there)
+    UFUNCTION(BlueprintCallable, Category = "Voxel|Governor")
+    void SetQualityLevel(int32 NewLevel);
+
+    // Smoothed time of the slower of the game and render thread
+    UFUNCTION(BlueprintPure, Category = "Voxel|Governor")
+    float GetSmoothedFrameMs() const { return SmoothedFrameMs; }
+
+    UFUNCTION(BlueprintPure, Category = "Voxel|Governor")
+    float GetTargetFrameMs() const;
+
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnQualityLevelChanged, int32, NewLevel, int32, OldLevel);
+    UPROPERTY(BlueprintAssignable, Category = "Voxel|Governor")
+    FOnQualityLevelChanged OnQualityLevelChanged;
+
+protected:
+    void ApplyQualityLevel();
+
+    // Saves the world's settings as the top level - after its BeginPlay, so calibration has run
+    UFUNCTION()
+    void HandleWorldInitialized();
+
+    UPROPERTY()
+    AVoxelWorld* VoxelWorld;
+
+    UPROPERTY()
+    UVoxelDetailScatterComponent* DetailScatter;
+
+private:
+    // World settings once it is initialized - the top level
+    int32 BaseViewDistanceInChunks = 10;
+    int32 BaseChunksPerFrame = 5;
+    bool bHasBaseSettings = false;
+
+    int32 QualityLevel = 0;
+    float SmoothedFrameMs = 0.0f;
+    float OverBudgetTime = 0.0f;
+    float UnderBudgetTime = 0.0f;
+};
@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EVoxelMaterial : uint8;
+struct FVoxel;
+
+/**
+ * Sub-grid of one refined voxel - Resolution^3 sub-voxels stored as palette indices.
+ * Indices use 1, 2, 4 or 8 bits depending on how many materials the cell holds, so a two-material
+ * 8^3 cell takes 64 bytes.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelRefinedCell
+{
+    // Sub-voxels per axis, 4 (6.25cm) or 8 (3.125cm)
+    uint8 Resolution;
+    uint8 BitsPerIndex;
+
+    TArray<EVoxelMaterial, TInlineAllocator<4>> Palette;
+
+    // Sub-voxels using each palette entry - entries at zero are reused before the palette grows
+    TArray<uint16, TInlineAllocator<4>> PaletteCounts;
+
+    // Packed palette indices, X fastest
+    TArray<uint8> Indices;
+
+    FVoxelRefinedCell() : Resolution(0), BitsPerIndex(1) {}
+
+    static bool IsValidResolution(int32 Resolution) { return Resolution == 4 || Resolution == 8; }
+
+    // Whole cell of one material
+    void Init(int32 InResolution, EVoxelMaterial Material);
+
+    FORCEINLINE int32 GetSubVoxelCount() const { return Resolution * Resolution * Resolution; }
+    FORCEINLINE int32 GetSubIndex(int32 X, int32 Y, int32 Z) const { return X + (Y + Z * Resolution) * Resolution; }
+
+    FORCEINLINE EVoxelMaterial Get(int32 SubIndex) const
+    {
+        const int32 Bit = SubIndex * BitsPerIndex;
+        return Palette[(Indices[Bit >> 3] >> (Bit & 7)) & ((1 << BitsPerIndex) - 1)];
+    }
+
+    void Set(int32 SubIndex, EVoxelMaterial Material);
+
+    // True when every sub-voxel has the same material
+    bool IsUniform(EVoxelMaterial& OutMaterial) const;
+
+    // Stand-in for systems that only see whole voxels (LODs, material volume) - most common solid material,
+    // or air when most of the cell is empty
+    EVoxelMaterial GetRepresentativeMaterial() const;
+
+    int64 GetAllocatedSize() const;
+
+private:
+    FORCEINLINE void WriteIndex(int32 SubIndex, int32 PaletteIndex)
+    {
+        const int32 Bit = SubIndex * BitsPerIndex;
+        const int32 Mask = ((1 << BitsPerIndex) - 1) << (Bit & 7);
+        Indices[Bit >> 3] = (uint8)((Indices[Bit >> 3] & ~Mask) | (PaletteIndex << (Bit & 7)));
+    }
+
+    void Repack(int32 NewBitsPerIndex);
+};
+
+/**
+ * Refined voxels of one chunk, keyed by voxel index. The voxel itself holds EVoxelMaterial::Refined.
+ * Memory, meshing and collision cost scale with the number of refined voxels only.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelRefinementLayer
+{
+    FORCEINLINE const FVoxelRefinedCell* Find(int32 VoxelIndex) const { return Cells.Find(VoxelIndex); }
+
+    bool IsEmpty() const { return Cells.Num() == 0; }
+    int32 Num() const { return Cells.Num(); }
+    const TMap<int32, FVoxelRefinedCell>& GetCells() const { return Cells; }
+
+    void Reset() { Cells.Empty(); }
+
+    // Splits a voxel into a sub-grid of its current material and marks it refined; already refined voxels keep their grid
+    bool Refine(int32 VoxelIndex, int32 Resolution, FVoxel& InOutVoxel);
+
+    // Writes one sub-voxel and folds the cell back into a plain voxel when it becomes uniform.
+    // False when the voxel isn't refined or nothing changed
+    bool SetSubVoxel(int32 VoxelIndex, const FIntVector& SubVoxel, EVoxelMaterial Material, FVoxel& InOutVoxel);
+
+    // Sub-voxel material, or the voxel's own material when it isn't refined
+    EVoxelMaterial GetSubVoxel(int32 VoxelIndex, const FIntVector& SubVoxel, const FVoxel& Voxel) const;
+
+    // Drops a cell without touching the voxel - for callers overwriting it
+    void Remove(int32 VoxelIndex) { Cells.Remove(VoxelIndex); }
+
+    // Replaces refined markers with each cell's representative material
+    void ResolveRepresentatives(TArray<FVoxel>& InOutVoxels) const;
+
+    // Drops cells whose voxel isn't marked and clears markers without a cell - after loading voxels and cells separately
+    void Reconcile(TArray<FVoxel>& InOutVoxels);
+
+    int64 GetAllocatedSize() const;
+
+    // Byte stream of every cell, empty when there are none
+    void Save(int32 VoxelCount, TArray<uint8>& OutBytes) const;
+
+    // Replaces all cells, false on malformed data or a voxel count mismatch
+    bool Load(const TArray<uint8>& Bytes, int32 VoxelCount);
+
+private:
+    TMap<int32, FVoxelRefinedCell> Cells;
+};
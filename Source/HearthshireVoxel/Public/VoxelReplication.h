@@ -0,0 +1,286 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "VoxelTypes.h"
+
+// Forward declarations
+class AVoxelWorld;
+
+/**
+ * Message types carried by the voxel replication stream
+ */
+enum class EVoxelReplicationMessage : uint8
+{
+    FullChunk = 0,      // Compressed snapshot of a whole chunk
+    EditDelta = 1,      // Run-length encoded voxel edits for a chunk
+    ChunkRelease = 2    // Chunk left the client's interest region
+};
+
+/**
+ * Run of consecutive voxel indices set to a single material
+ */
+struct HEARTHSHIREVOXEL_API FVoxelEditRun
+{
+    int32 StartIndex;
+    int32 Length;
+    EVoxelMaterial Material;
+
+    FVoxelEditRun()
+    {
+        StartIndex = 0;
+        Length = 0;
+        Material = EVoxelMaterial::Air;
+    }
+
+    FVoxelEditRun(int32 InStartIndex, int32 InLength, EVoxelMaterial InMaterial)
+        : StartIndex(InStartIndex), Length(InLength), Material(InMaterial) {}
+};
+
+/**
+ * Edit delta for one chunk - sequence numbers are per chunk and start at 1
+ */
+struct HEARTHSHIREVOXEL_API FVoxelEditDelta
+{
+    FIntVector ChunkPosition;
+    uint32 Sequence;
+    TArray<FVoxelEditRun> Runs;
+
+    FVoxelEditDelta()
+    {
+        ChunkPosition = FIntVector::ZeroValue;
+        Sequence = 0;
+    }
+
+    // Build runs from individual (index, material) edits; later edits to the same index win
+    void BuildRuns(const TMap<int32, EVoxelMaterial>& Edits);
+};
+
+/**
+ * Byte transport between a replication server and one client
+ */
+class HEARTHSHIREVOXEL_API IVoxelReplicationTransport
+{
+public:
+    virtual ~IVoxelReplicationTransport() {}
+
+    // Server side: queue a packet for the client
+    virtual void SendPacket(TArray<uint8>&& Packet) = 0;
+
+    // Client side: pop the next received packet, false if none
+    virtual bool ReceivePacket(TArray<uint8>& OutPacket) = 0;
+};
+
+/**
+ * In-process transport - packets are delivered in order on the next receive
+ */
+class HEARTHSHIREVOXEL_API FVoxelLoopbackTransport : public IVoxelReplicationTransport
+{
+public:
+    FVoxelLoopbackTransport();
+
+    virtual void SendPacket(TArray<uint8>&& Packet) override;
+    virtual bool ReceivePacket(TArray<uint8>& OutPacket) override;
+
+    int64 GetTotalBytesSent() const { return TotalBytesSent; }
+    int32 GetTotalPacketsSent() const { return TotalPacketsSent; }
+
+private:
+    TQueue<TArray<uint8>> Packets;
+    int64 TotalBytesSent;
+    int32 TotalPacketsSent;
+};
+
+/**
+ * Wire format for the replication stream
+ */
+struct HEARTHSHIREVOXEL_API FVoxelReplicationSerializer
+{
+    // Full chunk: material bytes compressed with the template codec, then the chunk's auxiliary channels and refined voxels
+    static bool WriteFullChunk(const FVoxelChunkData& ChunkData, uint32 Sequence, TArray<uint8>& OutPacket);
+
+    // Edit delta: varint-packed runs, start indices delta-coded against the previous run
+    static void WriteEditDelta(const FVoxelEditDelta& Delta, TArray<uint8>& OutPacket);
+
+    static void WriteChunkRelease(const FIntVector& ChunkPosition, TArray<uint8>& OutPacket);
+
+    // Read the message header; leaves the reader positioned at the payload
+    static bool ReadHeader(FArchive& Ar, EVoxelReplicationMessage& OutType, FIntVector& OutChunkPosition, uint32& OutSequence);
+    static bool ReadFullChunkPayload(FArchive& Ar, FVoxelChunkData& OutChunkData);
+    static bool ReadEditDeltaPayload(FArchive& Ar, FVoxelEditDelta& OutDelta);
+};
+
+/**
+ * Per-client replication settings
+ */
+struct HEARTHSHIREVOXEL_API FVoxelReplicationSettings
+{
+    // Sustained bandwidth for full chunk transfers
+    int32 MaxBytesPerSecond;
+
+    // Bucket size - caps how much unused bandwidth can accumulate
+    int32 MaxBurstBytes;
+
+    // Interest radius around the client's focus point
+    int32 InterestRadiusInChunks;
+
+    FVoxelReplicationSettings()
+    {
+#if VOXEL_MOBILE_PLATFORM
+        MaxBytesPerSecond = 32 * 1024;
+        InterestRadiusInChunks = 4;
+#else
+        MaxBytesPerSecond = 128 * 1024;
+        InterestRadiusInChunks = 8;
+#endif
+        MaxBurstBytes = MaxBytesPerSecond / 4;
+    }
+};
+
+/**
+ * Replication statistics
+ */
+struct HEARTHSHIREVOXEL_API FVoxelReplicationStats
+{
+    int64 FullChunkBytes;
+    int64 EditDeltaBytes;
+    int32 FullChunksSent;
+    int32 EditDeltasSent;
+    int32 ChunksReleased;
+
+    FVoxelReplicationStats()
+    {
+        FullChunkBytes = 0;
+        EditDeltaBytes = 0;
+        FullChunksSent = 0;
+        EditDeltasSent = 0;
+        ChunksReleased = 0;
+    }
+};
+
+/**
+ * Server side of the replication stream - captures edits on the authoritative world
+ * and streams chunks and deltas to clients within their interest region
+ */
+class HEARTHSHIREVOXEL_API FVoxelReplicationServer
+{
+public:
+    explicit FVoxelReplicationServer(AVoxelWorld* InWorld);
+    ~FVoxelReplicationServer();
+
+    // Client management - the transport must outlive the client registration
+    int32 AddClient(IVoxelReplicationTransport* Transport, const FVoxelReplicationSettings& Settings = FVoxelReplicationSettings());
+    void RemoveClient(int32 ClientId);
+
+    // Move the client's interest focus (usually the pawn location)
+    void SetClientFocus(int32 ClientId, const FVector& WorldPosition);
+
+    // Client lost track of a chunk (sequence gap) - resend a full snapshot
+    void RequestResync(int32 ClientId, const FIntVector& ChunkPosition);
+
+    // Record an edit; called automatically for edits raised on the world's OnVoxelEditedNative
+    void RecordEdit(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, EVoxelMaterial Material);
+    
+    // Resend the whole chunk to every client holding it; called automatically for the world's OnChunkReplacedNative
+    void RecordChunkReplaced(const FIntVector& ChunkPosition);
+
+    // Flush pending edits and send chunks within the bandwidth budget
+    void Tick(float DeltaTime);
+
+    const FVoxelReplicationStats& GetStats() const { return Stats; }
+
+private:
+    struct FClientState
+    {
+        IVoxelReplicationTransport* Transport = nullptr;
+        FVoxelReplicationSettings Settings;
+        FIntVector FocusChunk = FIntVector::ZeroValue;
+        float AvailableBytes = 0.0f;
+
+        // Chunks the client holds a snapshot of
+        TSet<FIntVector> ReplicatedChunks;
+    };
+
+    void FlushPendingEdits(TArray<FVoxelEditDelta>& OutDeltas);
+    void SendEditDeltas(FClientState& Client, const TArray<FVoxelEditDelta>& Deltas, const TArray<TArray<uint8>>& Packets);
+    void UpdateInterest(FClientState& Client);
+    void SendPendingChunks(FClientState& Client);
+    bool IsInInterest(const FClientState& Client, const FIntVector& ChunkPosition) const;
+
+    void HandleVoxelEdited(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, EVoxelMaterial Material);
+    void HandleChunkReplaced(const FIntVector& ChunkPosition);
+
+    TWeakObjectPtr<AVoxelWorld> World;
+    FDelegateHandle EditHandle;
+    FDelegateHandle ReplacedHandle;
+
+    TMap<int32, FClientState> Clients;
+    int32 NextClientId;
+
+    // Edits since the last tick, keyed by chunk then local index
+    TMap<FIntVector, TMap<int32, EVoxelMaterial>> PendingEdits;
+
+    // Chunks rewritten since the last tick - resent whole, their edits are dropped
+    TSet<FIntVector> PendingResyncs;
+
+    // Latest sequence per chunk
+    TMap<FIntVector, uint32> ChunkSequences;
+
+    FVoxelReplicationStats Stats;
+};
+
+/**
+ * Client side of the replication stream - applies snapshots and deltas to a local world
+ */
+class HEARTHSHIREVOXEL_API FVoxelReplicationClient
+{
+public:
+    explicit FVoxelReplicationClient(AVoxelWorld* InWorld);
+
+    // Drain the transport and apply all received messages
+    void ProcessPackets(IVoxelReplicationTransport& Transport);
+
+    // Chunks whose delta stream had a gap since the last call
+    void ConsumeResyncRequests(TArray<FIntVector>& OutChunkPositions);
+
+    int32 GetAppliedDeltaCount() const { return AppliedDeltaCount; }
+
+private:
+    bool ApplyPacket(const TArray<uint8>& Packet);
+    void ApplyFullChunk(const FVoxelChunkData& ChunkData, uint32 Sequence);
+    void ApplyEditDelta(const FVoxelEditDelta& Delta);
+
+    TWeakObjectPtr<AVoxelWorld> World;
+    TMap<FIntVector, uint32> ChunkSequences;
+    TSet<FIntVector> ResyncRequests;
+    int32 AppliedDeltaCount;
+};
+
+/**
+ * Loopback harness - synchronises two worlds in one process, for automation tests
+ */
+class HEARTHSHIREVOXEL_API FVoxelReplicationLoopback
+{
+public:
+    FVoxelReplicationLoopback(AVoxelWorld* ServerWorld, AVoxelWorld* ClientWorld, const FVoxelReplicationSettings& Settings = FVoxelReplicationSettings());
+
+    void SetClientFocus(const FVector& WorldPosition);
+
+    // Run one server tick, deliver packets, feed resync requests back
+    void Tick(float DeltaTime);
+
+    FVoxelReplicationServer& GetServer() { return Server; }
+    FVoxelReplicationClient& GetClient() { return Client; }
+    const FVoxelLoopbackTransport& GetTransport() const { return Transport; }
+
+    // Compare voxel data of every chunk the client holds against the server
+    static bool CompareWorlds(const AVoxelWorld* ServerWorld, const AVoxelWorld* ClientWorld, TArray<FIntVector>* OutMismatchedChunks = nullptr);
+
+private:
+    FVoxelLoopbackTransport Transport;
+    FVoxelReplicationServer Server;
+    FVoxelReplicationClient Client;
+    int32 ClientId;
+};
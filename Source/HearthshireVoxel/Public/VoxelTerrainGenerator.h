@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelTypes.h"
+
+/**
+ * Procedural terrain fills for chunk data.
+ * Pure functions of chunk position, so they are thread safe and seamless across chunks.
+ */
+class HEARTHSHIREVOXEL_API FVoxelTerrainGenerator
+{
+public:
+    // Rolling hills height (in voxels) of a world column
+    static int32 GetRollingHillsHeight(int32 GlobalX, int32 GlobalY);
+
+    // Grass on top, three layers of dirt, stone below; air above the surface
+    static EVoxelMaterial GetSurfaceMaterial(int32 Z, int32 TerrainHeight);
+
+    // Default terrain used by AVoxelWorld when no template covers the chunk
+    static void GenerateRollingHills(FVoxelChunkData& ChunkData);
+
+    // Level ground at SurfaceHeight voxels
+    static void GenerateFlat(FVoxelChunkData& ChunkData, int32 SurfaceHeight);
+
+    // Rolling hills carved by 3D noise tunnels, filling the whole column height
+    static void GenerateCaves(FVoxelChunkData& ChunkData, float CaveThreshold = 0.25f);
+
+    // Alternating solid and air voxels - worst case for every mesher, nothing merges
+    static void GenerateCheckerboard(FVoxelChunkData& ChunkData, EVoxelMaterial Material = EVoxelMaterial::Stone);
+};
@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#define VOXEL_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if VOXEL_TRACE_ENABLED
+// Enable with -trace=default,voxel (or "trace.enable voxel" at runtime)
+UE_TRACE_CHANNEL_EXTERN(VoxelChannel, HEARTHSHIREVOXEL_API);
+#endif
+
+// Pipeline stage scope, shown in the Insights timing view
+#define VOXEL_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(Name)
+
+enum class EVoxelChunkLOD : uint8;
+
+/**
+ * Steps a chunk goes through from being needed to being on screen
+ */
+enum class EVoxelChunkTraceEvent : uint8
+{
+    Requested,      // Queued for meshing
+    DataReady,      // Voxel data generated or loaded
+    MeshStarted,    // Worker picked it up
+    MeshFinished,   // Worker produced mesh data
+    Applied,        // Mesh handed to the renderer
+    Evicted         // Unloaded
+};
+
+/**
+ * Voxel trace events for Unreal Insights.
+ * Every lifecycle step is logged on VoxelChannel with chunk position and LOD, and each chunk
+ * gets a timing region from request to apply so late pop-in can be traced to the slow stage.
+ */
+class HEARTHSHIREVOXEL_API FVoxelTrace
+{
+public:
+    static void ChunkEvent(EVoxelChunkTraceEvent Event, const FIntVector& ChunkPosition, EVoxelChunkLOD LOD);
+
+    // Pipeline counters
+    static void SetQueueDepth(int32 Depth);
+    static void SetActiveGenerations(int32 Count);
+
+    // Mesh jobs running on worker threads across all chunks
+    static void MeshWorkerStarted();
+    static void MeshWorkerFinished();
+};
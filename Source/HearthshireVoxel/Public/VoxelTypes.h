@@ -5,10 +5,15 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "ProceduralMeshComponent.h"
+#include "VoxelChannels.h"
+#include "VoxelRefinement.h"
+#include "VoxelColumns.h"
+#include "VoxelBlockEntities.h"
 #include "VoxelTypes.generated.h"
 
 // Forward declarations
 class UMaterialInterface;
+class UTexture2D;
 
 /**
  * Voxel material types - supports up to 256 materials
@@ -26,8 +31,9 @@ enum class EVoxelMaterial : uint8
     Water = 7       UMETA(DisplayName = "Water"),
     Snow = 8        UMETA(DisplayName = "Snow"),
     Ice = 9         UMETA(DisplayName = "Ice"),
-    // Add more materials as needed up to 255
+    // IDs up to 253 past these are added as UVoxelMaterialSet entries, without extending this enum
     
+    Refined = 254   UMETA(Hidden),     // Voxel split into sub-voxels, see FVoxelRefinementLayer
     Max = 255       UMETA(Hidden)
 };
 
@@ -45,6 +51,7 @@ struct HEARTHSHIREVOXEL_API FVoxel
     FVoxel() : Material(EVoxelMaterial::Air) {}
     FVoxel(EVoxelMaterial InMaterial) : Material(InMaterial) {}
     
+    // Built-in behaviour - kernels that honour a material set read FVoxelMaterialTraitTable instead
     FORCEINLINE bool IsAir() const { return Material == EVoxelMaterial::Air; }
     FORCEINLINE bool IsSolid() const { return Material != EVoxelMaterial::Air; }
     FORCEINLINE bool IsTransparent() const { return Material == EVoxelMaterial::Water || Material == EVoxelMaterial::Ice; }
@@ -53,6 +60,50 @@ struct HEARTHSHIREVOXEL_API FVoxel
     FORCEINLINE bool operator!=(const FVoxel& Other) const { return Material != Other.Material; }
 };
 
+/**
+ * Behaviour of one material, packed into 4 bytes
+ */
+struct FVoxelMaterialTraits
+{
+    uint32 bSolid : 1;              // Occupies its cell and is meshed - only air is not
+    uint32 bOpaque : 1;             // Hides the faces of its neighbors
+    uint32 bTranslucent : 1;        // Meshed into the translucent section instead of the opaque one
+    uint32 bCullSameMaterial : 1;   // No faces between two voxels of this material
+    uint32 bCollidable : 1;         // Blocks movement
+    uint32 bWalkable : 1;           // Characters are grounded when standing on it
+    uint32 bTickEnabled : 1;        // Wants simulation ticks
+    uint32 LightEmission : 4;       // 0-15
+    uint32 LightOpacity : 4;        // 0-15, light lost passing through one voxel
+    
+    FVoxelMaterialTraits()
+        : bSolid(0), bOpaque(0), bTranslucent(0), bCullSameMaterial(0), bCollidable(0), bWalkable(0), bTickEnabled(0)
+        , LightEmission(0), LightOpacity(0)
+    {}
+};
+
+static_assert(sizeof(FVoxelMaterialTraits) == 4, "Material traits are meant to stay one word");
+
+/**
+ * Traits of every material ID, baked once per material set.
+ * Kernels take the flat array and index it by material, so behaviour needs no code change and no switch per voxel.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelMaterialTraitTable
+{
+    FVoxelMaterialTraits Entries[256];
+    
+    FORCEINLINE const FVoxelMaterialTraits& operator[](EVoxelMaterial Material) const { return Entries[(uint8)Material]; }
+    FORCEINLINE const FVoxelMaterialTraits* GetData() const { return Entries; }
+    
+    // Fills every entry from the built-in behaviour, then applies the set's trait overrides
+    void Bake(const class UVoxelMaterialSet* MaterialSet);
+    
+    // What FVoxel's IsAir/IsSolid/IsTransparent and collision assumed before material sets carried traits
+    static FVoxelMaterialTraits GetBuiltInTraits(EVoxelMaterial Material);
+    
+    // Built-in table, used when there is no material set
+    static const FVoxelMaterialTraitTable& GetDefault();
+};
+
 /**
  * Voxel face for mesh generation
  */
@@ -112,6 +163,18 @@ struct HEARTHSHIREVOXEL_API FVoxelChunkData
     // Flat array of voxels (size = ChunkSize.X * ChunkSize.Y * ChunkSize.Z)
     TArray<FVoxel> Voxels;
     
+    // Optional per-voxel channels (light, water level, ...), allocated on first write, same indexing as Voxels
+    FVoxelChunkChannels Channels;
+    
+    // Sub-voxel grids of voxels marked EVoxelMaterial::Refined, same indexing as Voxels
+    FVoxelRefinementLayer Refinement;
+    
+    // Run-length form of untouched terrain (see CompactToColumns) - while set, Voxels is empty
+    FVoxelColumnChunk Columns;
+    
+    // Crops, containers and machines keyed by voxel index - removed when their voxel changes material
+    FVoxelBlockEntityStore BlockEntities;
+    
     // Chunk dimensions
     FVoxelChunkSize ChunkSize;
     
@@ -144,6 +207,11 @@ struct HEARTHSHIREVOXEL_API FVoxelChunkData
             return FVoxel(EVoxelMaterial::Air);
         }
         
+        if (IsColumnStored())
+        {
+            return FVoxel(Columns.GetMaterial(X, Y, Z));
+        }
+        
         const int32 Index = X + Y * ChunkSize.X + Z * ChunkSize.X * ChunkSize.Y;
         return Voxels[Index];
     }
@@ -153,7 +221,25 @@ struct HEARTHSHIREVOXEL_API FVoxelChunkData
     {
         if (X >= 0 && X < ChunkSize.X && Y >= 0 && Y < ChunkSize.Y && Z >= 0 && Z < ChunkSize.Z)
         {
+            if (IsColumnStored())
+            {
+                ExpandColumns();
+            }
+            
             const int32 Index = X + Y * ChunkSize.X + Z * ChunkSize.X * ChunkSize.Y;
+            if (Voxels[Index].Material == EVoxelMaterial::Refined || Voxel.Material == EVoxelMaterial::Refined)
+            {
+                // Only RefineVoxel creates the marker; overwriting a refined voxel drops its sub-voxels
+                if (Voxel.Material == EVoxelMaterial::Refined)
+                {
+                    return;
+                }
+                Refinement.Remove(Index);
+            }
+            if (!BlockEntities.IsEmpty() && Voxels[Index].Material != Voxel.Material)
+            {
+                BlockEntities.Remove(Index);
+            }
             Voxels[Index] = Voxel;
             bIsDirty = true;
         }
@@ -165,17 +251,191 @@ struct HEARTHSHIREVOXEL_API FVoxelChunkData
         return X + Y * ChunkSize.X + Z * ChunkSize.X * ChunkSize.Y;
     }
     
+    // Channel value at local position, 0 outside the chunk or for channels never written
+    FORCEINLINE uint16 GetChannel(EVoxelChannel Channel, int32 X, int32 Y, int32 Z) const
+    {
+        if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+        {
+            return 0;
+        }
+        return Channels.Get(Channel, GetIndex(X, Y, Z));
+    }
+    
+    // Channels don't affect the mesh, so this leaves bIsDirty alone
+    FORCEINLINE bool SetChannel(EVoxelChannel Channel, int32 X, int32 Y, int32 Z, uint16 Value)
+    {
+        if (X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+        {
+            return false;
+        }
+        return Channels.Set(Channel, GetIndex(X, Y, Z), Value, ChunkSize.GetVoxelCount());
+    }
+    
+    // Block entity at local position, null outside the chunk or when the voxel has none
+    FORCEINLINE const FVoxelBlockEntity* FindBlockEntity(int32 X, int32 Y, int32 Z) const
+    {
+        if (BlockEntities.IsEmpty() || X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+        {
+            return nullptr;
+        }
+        return BlockEntities.Find(GetIndex(X, Y, Z));
+    }
+    
+    // Attaches an entity to a voxel, replacing any it had. Air voxels can't hold one
+    bool SetBlockEntity(int32 X, int32 Y, int32 Z, const FVoxelBlockEntity& Entity);
+    
+    // False when the voxel had no entity
+    bool RemoveBlockEntity(int32 X, int32 Y, int32 Z);
+    
+    // Splits a voxel into Resolution^3 (4 or 8) sub-voxels of its current material
+    bool RefineVoxel(int32 X, int32 Y, int32 Z, int32 Resolution);
+    
+    // Sub-voxel write on a refined voxel; a cell that becomes uniform folds back into a plain voxel
+    bool SetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel, EVoxelMaterial Material);
+    
+    // Sub-voxel material, or the whole voxel's material when it isn't refined
+    EVoxelMaterial GetSubVoxel(int32 X, int32 Y, int32 Z, const FIntVector& SubVoxel) const;
+    
+    // Refined cell at local position, null for plain voxels
+    FORCEINLINE const FVoxelRefinedCell* FindRefinedCell(int32 X, int32 Y, int32 Z) const
+    {
+        if (Refinement.IsEmpty() || X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y || Z < 0 || Z >= ChunkSize.Z)
+        {
+            return nullptr;
+        }
+        return Refinement.Find(GetIndex(X, Y, Z));
+    }
+    
+    // True while the voxels live in Columns instead of the dense array
+    FORCEINLINE bool IsColumnStored() const { return !Columns.IsEmpty(); }
+    
+    // Voxels of the full chunk exist in either form
+    FORCEINLINE bool HasVoxelData() const { return IsColumnStored() || Voxels.Num() == ChunkSize.GetVoxelCount(); }
+    
+    // Moves the voxels into column spans and frees the dense array. Refused while voxels are refined, or when
+    // a column needs more than MaxSpansPerColumn spans
+    bool CompactToColumns(int32 MaxSpansPerColumn);
+    
+    // Back to the dense array - every write does this first
+    void ExpandColumns();
+    
+    // Dense voxels to read from - Voxels itself, or the spans expanded into Scratch
+    const TArray<FVoxel>& GetDenseVoxels(TArray<FVoxel>& Scratch) const;
+    
+    // One material byte per voxel in Voxels order, for serialization
+    void GetMaterialBytes(TArray<uint8>& OutBytes) const;
+    
+    // Highest and lowest non-air voxel of a column, INDEX_NONE when empty. Scans the voxels of a dense chunk,
+    // only the column's spans (a few) on column storage
+    int32 GetColumnTop(int32 X, int32 Y) const;
+    int32 GetColumnBottom(int32 X, int32 Y) const;
+    
     // Clear all voxels
     void Clear()
     {
+        // Nothing to keep - drop the spans instead of expanding them
+        if (IsColumnStored())
+        {
+            Columns.Reset();
+            Voxels.SetNum(ChunkSize.GetVoxelCount());
+        }
+        
         for (auto& Voxel : Voxels)
         {
             Voxel = FVoxel(EVoxelMaterial::Air);
         }
+        Channels.Reset();
+        Refinement.Reset();
+        BlockEntities.Reset();
         bIsDirty = true;
     }
 };
 
+/**
+ * Packed per-voxel material IDs for pixel shader lookup.
+ * Z slices are tiled into a square 2D atlas (one byte per texel) so it can be uploaded as a transient texture.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelMaterialVolume
+{
+    // Volume size in voxels
+    FIntVector Dimensions;
+    
+    // Z slices per atlas row
+    int32 TilesPerRow;
+    
+    // Atlas texel size
+    int32 AtlasWidth;
+    int32 AtlasHeight;
+    
+    // World size of one volume voxel - larger than the chunk's for downsampled LOD meshes
+    float VoxelSize;
+    
+    // Material ID per texel, row-major
+    TArray<uint8> Texels;
+    
+    FVoxelMaterialVolume()
+    {
+        Dimensions = FIntVector::ZeroValue;
+        TilesPerRow = 0;
+        AtlasWidth = 0;
+        AtlasHeight = 0;
+        VoxelSize = 0.0f;
+    }
+    
+    FORCEINLINE bool IsValid() const { return Texels.Num() > 0; }
+    FORCEINLINE SIZE_T GetAllocatedSize() const { return Texels.GetAllocatedSize(); }
+    
+    // Atlas texel holding voxel (X, Y, Z)
+    FORCEINLINE FIntPoint GetAtlasCoord(int32 X, int32 Y, int32 Z) const
+    {
+        return FIntPoint((Z % TilesPerRow) * Dimensions.X + X, (Z / TilesPerRow) * Dimensions.Y + Y);
+    }
+    
+    void Build(const FVoxelChunkData& ChunkData, float InVoxelSize);
+    
+    void Reset()
+    {
+        Dimensions = FIntVector::ZeroValue;
+        TilesPerRow = 0;
+        AtlasWidth = 0;
+        AtlasHeight = 0;
+        VoxelSize = 0.0f;
+        Texels.Empty();
+    }
+};
+
+/**
+ * Translucent geometry (water, ice) kept apart from the opaque buffers, sorted bottom to top
+ */
+struct HEARTHSHIREVOXEL_API FVoxelTranslucentMeshData
+{
+    TArray<FVector> Vertices;
+    TArray<int32> Triangles;
+    TArray<FVector> Normals;
+    TArray<FVector2D> UV0;
+    TArray<FProcMeshTangent> Tangents;
+    TArray<FColor> VertexColors;
+    
+    FORCEINLINE bool IsEmpty() const { return Triangles.Num() == 0; }
+    FORCEINLINE int32 GetTriangleCount() const { return Triangles.Num() / 3; }
+    
+    SIZE_T GetAllocatedSize() const
+    {
+        return Vertices.GetAllocatedSize() + Triangles.GetAllocatedSize() + Normals.GetAllocatedSize() +
+            UV0.GetAllocatedSize() + Tangents.GetAllocatedSize() + VertexColors.GetAllocatedSize();
+    }
+    
+    void Clear()
+    {
+        Vertices.Empty();
+        Triangles.Empty();
+        Normals.Empty();
+        UV0.Empty();
+        Tangents.Empty();
+        VertexColors.Empty();
+    }
+};
+
 /**
  * Mesh data for procedural generation
  */
@@ -195,6 +455,12 @@ struct HEARTHSHIREVOXEL_API FVoxelMeshData
     TMap<EVoxelMaterial, int32> MaterialSections;
     TArray<int32> MaterialTriangles;
     
+    // Filled when faces were merged across materials - shading reads materials from here
+    FVoxelMaterialVolume MaterialVolume;
+    
+    // Water and ice surfaces, rendered as their own section
+    FVoxelTranslucentMeshData Translucent;
+    
     // Statistics
     int32 TriangleCount;
     int32 VertexCount;
@@ -217,10 +483,21 @@ struct HEARTHSHIREVOXEL_API FVoxelMeshData
         VertexColors.Empty();
         MaterialSections.Empty();
         MaterialTriangles.Empty();
+        MaterialVolume.Reset();
+        Translucent.Clear();
         TriangleCount = 0;
         VertexCount = 0;
     }
     
+    // CPU-side bytes held by this mesh, including water and the material volume
+    SIZE_T GetAllocatedSize() const
+    {
+        return Vertices.GetAllocatedSize() + Triangles.GetAllocatedSize() + Normals.GetAllocatedSize() +
+            UV0.GetAllocatedSize() + Tangents.GetAllocatedSize() + VertexColors.GetAllocatedSize() +
+            MaterialSections.GetAllocatedSize() + MaterialTriangles.GetAllocatedSize() +
+            MaterialVolume.GetAllocatedSize() + Translucent.GetAllocatedSize();
+    }
+    
     // Reserve memory for expected mesh size
     void Reserve(int32 ExpectedVertices, int32 ExpectedTriangles)
     {
@@ -241,6 +518,10 @@ struct HEARTHSHIREVOXEL_API FVoxelMaterialConfig
 {
     GENERATED_BODY()
     
+    // Designer-facing name - how game code finds materials that have no EVoxelMaterial entry
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material")
+    FName Name;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material")
     UMaterialInterface* Material;
     
@@ -253,12 +534,50 @@ struct HEARTHSHIREVOXEL_API FVoxelMaterialConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material", meta = (ClampMin = "0.0", ClampMax = "1.0"))
     float Metallic;
     
+    // Use the traits below instead of the built-in behaviour of this material ID - needed for new materials
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits")
+    bool bOverrideTraits;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits"))
+    bool bOpaque;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits"))
+    bool bTranslucent;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits"))
+    bool bCullSameMaterial;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits"))
+    bool bCollidable;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits"))
+    bool bWalkable;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits"))
+    bool bTickEnabled;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits", ClampMin = "0", ClampMax = "15"))
+    int32 LightEmission;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traits", meta = (EditCondition = "bOverrideTraits", ClampMin = "0", ClampMax = "15"))
+    int32 LightOpacity;
+    
     FVoxelMaterialConfig()
     {
+        Name = NAME_None;
         Material = nullptr;
         BaseColor = FLinearColor::White;
         Roughness = 0.5f;
         Metallic = 0.0f;
+        bOverrideTraits = false;
+        bOpaque = true;
+        bTranslucent = false;
+        bCullSameMaterial = true;
+        bCollidable = true;
+        bWalkable = true;
+        bTickEnabled = false;
+        LightEmission = 0;
+        LightOpacity = 15;
     }
 };
 
@@ -271,19 +590,57 @@ class HEARTHSHIREVOXEL_API UVoxelMaterialSet : public UDataAsset
     GENERATED_BODY()
     
 public:
+    // Keyed by material ID, the value stored in each voxel. New materials are new entries - 0 (air), 254 and 255 are reserved
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materials")
-    TMap<EVoxelMaterial, FVoxelMaterialConfig> Materials;
+    TMap<uint8, FVoxelMaterialConfig> MaterialConfigs;
     
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materials")
     UMaterialInterface* DefaultMaterial;
     
+    // Material for chunks meshed across material boundaries. Receives VoxelMaterialVolume, VoxelMaterialPalette,
+    // VoxelVolumeLayout (SizeX, SizeY, SizeZ, TilesPerRow) and VoxelSize parameters
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materials|Volume")
+    UMaterialInterface* VolumeMaterial;
+    
+    // Cheap translucent material for the water/ice section - falls back to the Water material
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materials")
+    UMaterialInterface* TranslucentMaterial;
+    
     UVoxelMaterialSet();
     
+    virtual void PostLoad() override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+    
+    // Baked on load and on edit - pass GetData() to kernels
+    const FVoxelMaterialTraitTable& GetTraitTable() const { return TraitTable; }
+    
+    const FVoxelMaterialConfig* FindConfig(EVoxelMaterial VoxelMaterial) const { return MaterialConfigs.Find((uint8)VoxelMaterial); }
+    
+    // ID of the material with this Name, Max when no entry has it
+    UFUNCTION(BlueprintCallable, Category = "Voxel")
+    EVoxelMaterial FindMaterialByName(FName MaterialName) const;
+    
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     UMaterialInterface* GetMaterial(EVoxelMaterial VoxelMaterial) const;
     
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     FLinearColor GetBaseColor(EVoxelMaterial VoxelMaterial) const;
+    
+    // 256x1 texture of base colors indexed by material ID
+    UFUNCTION(BlueprintCallable, Category = "Voxel")
+    UTexture2D* GetPaletteTexture();
+    
+private:
+    UPROPERTY(Transient)
+    UTexture2D* PaletteTexture;
+    
+    // Enum-keyed configs of sets saved before MaterialConfigs, moved over in PostLoad
+    UPROPERTY()
+    TMap<EVoxelMaterial, FVoxelMaterialConfig> Materials_DEPRECATED;
+    
+    FVoxelMaterialTraitTable TraitTable;
 };
 
 /**
@@ -465,4 +822,28 @@ struct HEARTHSHIREVOXEL_API FVoxelPerformanceStats
         ActiveChunks = 0;
         MemoryUsageMB = 0.0f;
     }
+};
+
+/**
+ * Bytes held by a chunk, split by subsystem
+ */
+struct HEARTHSHIREVOXEL_API FVoxelMemoryUsage
+{
+    int64 VoxelData = 0;      // Materials plus allocated channels and refined voxels
+    int64 MeshCPU = 0;        // Generated mesh plus the component's section copies
+    int64 MeshGPU = 0;        // Vertex and index buffers, estimated from section sizes
+    int64 Collision = 0;      // Body setup and cooked collision
+    int64 MaterialVolume = 0; // Material volume texture
+    
+    int64 GetTotal() const { return VoxelData + MeshCPU + MeshGPU + Collision + MaterialVolume; }
+    
+    FVoxelMemoryUsage& operator+=(const FVoxelMemoryUsage& Other)
+    {
+        VoxelData += Other.VoxelData;
+        MeshCPU += Other.MeshCPU;
+        MeshGPU += Other.MeshGPU;
+        Collision += Other.Collision;
+        MaterialVolume += Other.MaterialVolume;
+        return *this;
+    }
 };
\ No newline at end of file
@@ -22,12 +22,22 @@ struct HEARTHSHIREVOXEL_API FVoxelWorldConfig
 {
     GENERATED_BODY()
     
+    // Horizontal (X and Y) chunk size in voxels
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel", meta = (ClampMin = "1", ClampMax = "64"))
     int32 ChunkSize;
     
+    // Vertical chunk size in voxels, 0 = same as ChunkSize. Tall column chunks (e.g. 32x32x128) cover a
+    // mostly flat world with one chunk per column instead of a stack of cubes
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel", meta = (ClampMin = "0", ClampMax = "256"))
+    int32 ChunkHeight;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel", meta = (ClampMin = "1", ClampMax = "20"))
     int32 ViewDistanceInChunks;
     
+    // Voxels above and below the player that are kept loaded - chunk layers follow from ChunkHeight
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel", meta = (ClampMin = "0", ClampMax = "512"))
+    int32 VerticalViewDistanceInVoxels;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel", meta = (ClampMin = "10", ClampMax = "200"))
     int32 ChunkPoolSize;
     
@@ -43,26 +53,46 @@ struct HEARTHSHIREVOXEL_API FVoxelWorldConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (ClampMin = "1", ClampMax = "8"))
     int32 MaxConcurrentChunkGenerations;
     
+    // Queued chunks handed to mesh workers per tick - bounds the game thread cost of streaming
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (ClampMin = "1", ClampMax = "20"))
+    int32 MaxChunksPerFrame;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (ClampMin = "400", ClampMax = "2000"))
     int32 MobileMemoryBudgetMB;
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (ClampMin = "800", ClampMax = "4000"))
     int32 PCMemoryBudgetMB;
     
+    // Keep chunks nobody has edited as run-length spans per (X, Y) column once meshed - heightfield terrain
+    // takes a fraction of its dense size, and the first edit expands the chunk again
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+    bool bUseColumnStorage;
+    
+    // Chunks with a column of more spans than this (caves, overhangs) stay dense
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (ClampMin = "1", ClampMax = "64", EditCondition = "bUseColumnStorage"))
+    int32 MaxColumnSpans;
+    
     FVoxelWorldConfig()
     {
 #if VOXEL_MOBILE_PLATFORM
         ChunkSize = 16;
         ViewDistanceInChunks = 6;
+        VerticalViewDistanceInVoxels = 32;
         MobileMemoryBudgetMB = 400;
+        bUseColumnStorage = true;
 #else
         ChunkSize = 32;
         ViewDistanceInChunks = 10;
+        VerticalViewDistanceInVoxels = 64;
         PCMemoryBudgetMB = 800;
+        bUseColumnStorage = false;
 #endif
+        ChunkHeight = 0;
         ChunkPoolSize = 100;
         bUseMultithreading = true;
         MaxConcurrentChunkGenerations = 4;
+        MaxChunksPerFrame = 5;
+        MaxColumnSpans = 8;
         MaterialSet = nullptr;
         
         // Default LOD configuration
@@ -94,6 +124,18 @@ struct HEARTHSHIREVOXEL_API FVoxelWorldConfig
         LOD3.bGenerateCollision = false;
         LODConfigs.Add(LOD3);
     }
+    
+    // Per-axis chunk size in voxels
+    FVoxelChunkSize GetChunkDimensions() const
+    {
+        return FVoxelChunkSize(ChunkSize, ChunkSize, ChunkHeight > 0 ? ChunkHeight : ChunkSize);
+    }
+    
+    // Per-axis chunk size in world units
+    FVector GetChunkWorldSize(float VoxelSize) const
+    {
+        return FVector(GetChunkDimensions().ToIntVector()) * VoxelSize;
+    }
 };
 
 /**
@@ -108,11 +150,15 @@ struct FVoxelChunkTask
     int32 Priority;
     bool bIsRegeneration;
     
+    // FPlatformTime::Seconds() when queued
+    double QueuedTime;
+    
     FVoxelChunkTask()
     {
         ChunkPosition = FIntVector::ZeroValue;
         Priority = 0;
         bIsRegeneration = false;
+        QueuedTime = 0.0;
     }
 };
 
@@ -136,6 +182,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel")
     FVoxelWorldConfig Config;
     
+    // Measure this device once and use the results for chunk size, workers, chunks per frame and view distance
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Performance", meta = (DisplayName = "Auto Calibrate", Tooltip = "Run the first-launch calibration (cached in GameUserSettings.ini) and override Config with its results"))
+    bool bAutoCalibrate = false;
+    
+    // Frame rate the calibration plans for, 0 picks 30 on mobile and 60 elsewhere
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Performance", meta = (EditCondition = "bAutoCalibrate", ClampMin = "0", ClampMax = "240"))
+    int32 CalibrationTargetFPS = 0;
+    
     // Template support - Organized for better workflow
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Template", meta = (DisplayName = "Template Mode", Tooltip = "When enabled, world loads from template instead of procedural generation"))
     bool bUseTemplate = false;
@@ -160,6 +214,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Debug", meta = (DisplayName = "Preserve Editor Chunks", Tooltip = "Keep chunks created in editor when entering Play mode"))
     bool bPreserveEditorChunks = true;
     
+    // Keep built chunks in editor memory when a Play-In-Editor session ends and reuse them in the next one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Debug", meta = (DisplayName = "Reuse PIE Snapshot", Tooltip = "Restore chunks and meshes from the previous Play-In-Editor session where their content is unchanged (voxel.snapshot.clear drops them)"))
+    bool bUsePIESnapshot = true;
+    
     // Dynamic generation control
     UPROPERTY(EditAnywhere, BlueprintReadWrite, SaveGame, Category = "Voxel|Debug", meta = (DisplayName = "Disable Dynamic Generation", Tooltip = "When true, only loads existing chunks, doesn't generate new ones based on player position"))
     bool bDisableDynamicGeneration = false;
@@ -188,6 +246,27 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     void SetVoxelSphere(const FVector& Center, float Radius, EVoxelMaterial Material);
     
+    // Sub-voxel detail for building - splits the voxel at WorldPosition into Resolution^3 (4 or 8) sub-voxels
+    UFUNCTION(BlueprintCallable, Category = "Voxel")
+    bool RefineVoxel(const FVector& WorldPosition, int32 Resolution = 8);
+    
+    // Writes the sub-voxel containing WorldPosition; the voxel must be refined first
+    UFUNCTION(BlueprintCallable, Category = "Voxel")
+    bool SetSubVoxel(const FVector& WorldPosition, EVoxelMaterial Material);
+    
+    // Material of the sub-voxel containing WorldPosition, or of the whole voxel when it isn't refined
+    UFUNCTION(BlueprintCallable, Category = "Voxel")
+    EVoxelMaterial GetSubVoxel(const FVector& WorldPosition) const;
+    
+    // Auxiliary channel at a world position - 0 in unloaded chunks, writes go to loaded chunks only
+    uint16 GetVoxelChannel(const FVector& WorldPosition, EVoxelChannel Channel) const;
+    bool SetVoxelChannel(const FVector& WorldPosition, EVoxelChannel Channel, uint16 Value);
+    
+    // Block entity of the voxel at a world position - null in unloaded chunks; entities need a solid voxel
+    const FVoxelBlockEntity* FindBlockEntity(const FVector& WorldPosition) const;
+    bool SetBlockEntity(const FVector& WorldPosition, const FVoxelBlockEntity& Entity);
+    bool RemoveBlockEntity(const FVector& WorldPosition);
+    
     // World queries
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     FIntVector WorldToChunkPosition(const FVector& WorldPosition) const;
@@ -195,6 +274,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     FIntVector WorldToLocalVoxel(const FVector& WorldPosition, const FIntVector& ChunkPosition) const;
     
+    // World position of a chunk's minimum corner
+    UFUNCTION(BlueprintCallable, Category = "Voxel")
+    FVector ChunkToWorldPosition(const FIntVector& ChunkPosition) const;
+    
     // Performance
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     FVoxelPerformanceStats GetWorldStats() const;
@@ -205,6 +288,12 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel")
     int32 GetPooledChunkCount() const { return ChunkPool.Num(); }
     
+    // Chunks handed to mesh workers that have not been applied yet
+    int32 GetActiveGenerationCount() const { return ActiveGenerations.GetValue(); }
+    
+    // Memory per subsystem, LOD and chunk state (voxel.memreport)
+    FString GetMemoryReport() const;
+    
     // Additional management functions
     UFUNCTION(BlueprintCallable, Category = "Voxel", meta = (DisplayName = "Get All Active Chunks"))
     TArray<AVoxelChunk*> GetAllActiveChunks() const;
@@ -218,6 +307,21 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel", meta = (DisplayName = "Get Chunk At Position"))
     AVoxelChunk* GetChunkAtPosition(const FIntVector& ChunkPosition) const;
     
+    // Install externally produced chunk data (replication, snapshots) - bypasses procedural generation
+    AVoxelChunk* AdoptChunkData(const FVoxelChunkData& ChunkData);
+    
+    // Stream around a fixed point instead of the tracked player (camera path replay)
+    void SetStreamingSourceOverride(const FVector& WorldPosition);
+    void ClearStreamingSourceOverride();
+    bool HasStreamingSourceOverride() const { return bHasStreamingSourceOverride; }
+    
+    // Point chunks are streamed around - false when there is neither an override nor a tracked player
+    bool GetStreamingSourcePosition(FVector& OutPosition) const;
+    
+    // Multiplier on the chunk LOD distance bands (quality governor)
+    void SetLODDistanceScale(float Scale) { LODDistanceScale = FMath::Clamp(Scale, 0.1f, 4.0f); }
+    float GetLODDistanceScale() const { return LODDistanceScale; }
+    
     // Events
     DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChunkLoaded, const FIntVector&, ChunkPosition);
     UPROPERTY(BlueprintAssignable, Category = "Voxel")
@@ -240,6 +344,15 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Voxel")
     FOnWorldInitialized OnWorldInitialized;
     
+    // Native edit hook for C++ listeners (replication) - fired for every material change made through a chunk's
+    // SetVoxel, SetVoxelRange, SetVoxelBatch, RefineVoxel or SetSubVoxel
+    DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnVoxelEditedNative, const FIntVector& /*ChunkPosition*/, const FIntVector& /*LocalVoxel*/, EVoxelMaterial /*Material*/);
+    FOnVoxelEditedNative OnVoxelEditedNative;
+    
+    // Fired instead of per-voxel edits when a chunk's voxels were rewritten wholesale (fills, clears, flat terrain)
+    DECLARE_MULTICAST_DELEGATE_OneParam(FOnChunkReplacedNative, const FIntVector& /*ChunkPosition*/);
+    FOnChunkReplacedNative OnChunkReplacedNative;
+    
     // Chunk storage (made public for Blueprint access)
     UPROPERTY(BlueprintReadOnly, Category = "Voxel")
     TMap<FIntVector, AVoxelChunk*> ActiveChunks;
@@ -285,6 +398,9 @@ protected:
     TQueue<FVoxelChunkTask> ChunkTaskQueue;
     FCriticalSection TaskQueueLock;
     
+    // Tasks in ChunkTaskQueue (TQueue has no count) - guarded by TaskQueueLock
+    int32 QueuedTaskCount = 0;
+    
     // Currently generating chunks
     TSet<FIntVector> GeneratingChunks;
     FCriticalSection GeneratingChunksLock;
@@ -299,6 +415,11 @@ protected:
     APawn* TrackedPlayer;
     FVector LastPlayerPosition;
     
+    float LODDistanceScale = 1.0f;
+    
+    bool bHasStreamingSourceOverride = false;
+    FVector StreamingSourceOverride = FVector::ZeroVector;
+    
     // Update frequencies
     UPROPERTY(EditAnywhere, Category = "Voxel|Performance", meta = (ClampMin = "0.05", ClampMax = "1.0"))
     float ChunkUpdateTimer;
@@ -322,18 +443,37 @@ protected:
     void ReturnChunkToPool(AVoxelChunk* Chunk);
     
     void QueueChunkGeneration(const FIntVector& ChunkPosition, int32 Priority, bool bRegeneration = false);
+    
+    // Remeshes loaded neighbors when an edited voxel sits on the chunk border
+    void QueueBorderNeighbors(const FIntVector& ChunkPosition, const FIntVector& LocalVoxel);
+    
+    // Sub-voxel of WorldPosition inside a refined cell of the given resolution
+    FIntVector WorldToSubVoxel(const FVector& WorldPosition, const FIntVector& ChunkPosition, const FIntVector& LocalVoxel, int32 Resolution) const;
+    
+    // Play-In-Editor snapshots (FVoxelWorldSnapshot) - key from level and actor name, fingerprint of the settings chunks are built with
+    FString GetSnapshotKey() const;
+    uint64 GetSnapshotFingerprint() const;
+    void CapturePIESnapshot();
+    
+    // Installs snapshot chunks whose content still matches their source, returns how many
+    int32 RestorePIESnapshot();
+    
+#if WITH_EDITOR
+    void HandlePrePIEEnded(const bool bIsSimulating);
+#endif
+    
     bool ShouldLoadChunk(const FIntVector& ChunkPosition) const;
     int32 CalculateChunkPriority(const FIntVector& ChunkPosition) const;
     
+    // Chunk layers within VerticalViewDistanceInVoxels of SourcePosition
+    void GetVerticalChunkRange(const FVector& SourcePosition, int32& OutMinZ, int32& OutMaxZ) const;
+    
     UFUNCTION()
     void OnChunkGenerated(UVoxelChunkComponent* ChunkComponent);
     
 private:
     // Voxel size constant (25cm)
     static constexpr float VoxelSize = 25.0f;
-    
-    // Maximum chunks to process per frame
-    static constexpr int32 MaxChunksPerFrame = 5;
 };
 
 /**
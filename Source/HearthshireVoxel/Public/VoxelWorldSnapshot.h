@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelChunk.h"
+
+/**
+ * One chunk as it was when the snapshot was taken - voxels, the mesh built from them and its LOD
+ */
+struct FVoxelChunkSnapshot
+{
+    FVoxelChunkData ChunkData;
+    FVoxelMeshData MeshData;
+    EVoxelChunkLOD LOD = EVoxelChunkLOD::LOD0;
+
+    // UVoxelChunkComponent::HasBeenGenerated - set for template and editor chunks, not for procedural ones
+    bool bWasGenerated = false;
+
+    // FVoxelWorldSnapshot::HashChunkContent of ChunkData - the mesh is reused only while this matches
+    uint64 ContentHash = 0;
+};
+
+/**
+ * Built chunks of a voxel world kept in editor memory between Play-In-Editor sessions, so the next
+ * session can skip generation and meshing for everything that hasn't changed.
+ * Snapshots are keyed by level and actor name, and are dropped when the world settings they were built
+ * with (Fingerprint) no longer match.
+ */
+struct HEARTHSHIREVOXEL_API FVoxelWorldSnapshot
+{
+    // AVoxelWorld::GetSnapshotFingerprint at capture time
+    uint64 Fingerprint = 0;
+
+    double CaptureTime = 0.0;
+
+    TArray<FVoxelChunkSnapshot> Chunks;
+
+    int64 GetAllocatedSize() const;
+
+    // Hash of everything the mesh is built from - materials and sub-voxel grids, not channels or block entities
+    static uint64 HashChunkContent(const FVoxelChunkData& ChunkData);
+
+    // Snapshot store, game thread only. Storing replaces any previous snapshot under the same key
+    static void Store(const FString& Key, FVoxelWorldSnapshot&& Snapshot);
+    static const FVoxelWorldSnapshot* Find(const FString& Key);
+    static void Discard(const FString& Key);
+    static void DiscardAll();
+};
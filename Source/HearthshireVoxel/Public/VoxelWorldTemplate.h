@@ -59,11 +59,35 @@ struct HEARTHSHIREVOXEL_API FVoxelTemplateChunk
     UPROPERTY()
     bool bHasData;
     
+    // Auxiliary channels (FVoxelChunkChannels::Save), empty when the chunk had none
+    UPROPERTY()
+    TArray<uint8> CompressedChannelData;
+    
+    UPROPERTY()
+    int32 UncompressedChannelSize;
+    
+    // Sub-voxel grids of refined voxels (FVoxelRefinementLayer::Save), empty when the chunk had none
+    UPROPERTY()
+    TArray<uint8> CompressedRefinementData;
+    
+    UPROPERTY()
+    int32 UncompressedRefinementSize;
+    
+    // Block entities (FVoxelBlockEntityStore::Save), empty when the chunk had none
+    UPROPERTY()
+    TArray<uint8> CompressedBlockEntityData;
+    
+    UPROPERTY()
+    int32 UncompressedBlockEntitySize;
+    
     FVoxelTemplateChunk()
     {
         ChunkPosition = FIntVector::ZeroValue;
         UncompressedSize = 0;
         bHasData = false;
+        UncompressedChannelSize = 0;
+        UncompressedRefinementSize = 0;
+        UncompressedBlockEntitySize = 0;
     }
 };
 
@@ -81,6 +105,10 @@ struct HEARTHSHIREVOXEL_API FVoxelVariationParams
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variation", meta = (ClampMin = "0", ClampMax = "1"))
     float FlowerDensity = 0.2f;
     
+    // Disable when a UVoxelDetailScatterComponent renders flowers as instances
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variation")
+    bool bPlaceFlowerVoxels = true;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variation", meta = (ClampMin = "0", ClampMax = "1"))
     float TreeVariation = 0.4f;
     
@@ -131,6 +159,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Template")
     int32 ChunkSize = 32;
     
+    // Vertical chunk size, 0 = cubic (templates saved before column chunks)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Template")
+    int32 ChunkHeight = 0;
+    
     // Compressed chunk data
     UPROPERTY()
     TArray<FVoxelTemplateChunk> ChunkData;
@@ -153,6 +185,8 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel Template")
     FVector GetWorldSize() const;
     
+    FVoxelChunkSize GetChunkDimensions() const { return FVoxelChunkSize(ChunkSize, ChunkSize, ChunkHeight > 0 ? ChunkHeight : ChunkSize); }
+    
     UFUNCTION(BlueprintCallable, Category = "Voxel Template")
     bool HasChunkData(const FIntVector& ChunkPosition) const;
     
@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+[SupportedPlatforms(UnrealPlatformClass.Desktop)]
+public class HearthshireVoxelBenchTarget : TargetRules
+{
+	public HearthshireVoxelBenchTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Program;
+		LinkType = TargetLinkType.Monolithic;
+		LaunchModuleName = "HearthshireVoxelBench";
+		DefaultBuildSettings = BuildSettingsVersion.V5;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_6;
+
+		// The voxel module's types are reflected and its mesh data uses ProceduralMeshComponent,
+		// so both have to be linked - the bench itself never creates a world, loads assets or renders
+		bCompileAgainstEngine = true;
+		bCompileAgainstCoreUObject = true;
+		bCompileAgainstApplicationCore = true;
+		bCompileWithPluginSupport = true;
+		bBuildWithEditorOnlyData = false;
+		bBuildDeveloperTools = false;
+		bCompileICU = false;
+
+		bIsBuildingConsoleApplication = true;
+		bUseLoggingInShipping = true;
+	}
+}
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class HearthshireVoxelBench : ModuleRules
+{
+	public HearthshireVoxelBench(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateIncludePathModuleNames.Add("Launch");
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "ApplicationCore", "Projects", "HearthshireVoxel" });
+	}
+}
@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RequiredProgramMainCPPInclude.h"
+#include "VoxelBenchmark.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeExit.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHearthshireVoxelBench, Log, All);
+
+IMPLEMENT_APPLICATION(HearthshireVoxelBench, "HearthshireVoxelBench");
+
+namespace VoxelBench
+{
+    void PrintUsage()
+    {
+        FPlatformMisc::LocalPrint(TEXT(
+            "Usage: HearthshireVoxelBench [options]\n"
+            "  -filter=<a,b>      Only run Stage/Fixture cases containing one of the terms (e.g. -filter=GreedyMesh/Caves)\n"
+            "  -iterations=<n>    Timed iterations per case (default 30)\n"
+            "  -warmup=<n>        Untimed warm-up iterations per case (default 3)\n"
+            "  -size=<n>          Chunk edge length in voxels (default 32)\n"
+            "  -scaling           Run the thread scaling benchmark instead of the pipeline\n"
+            "  -layout            Compare the linear and tiled voxel layouts per pass instead\n"
+            "  -batch=<n>         Chunks per scaling batch (default 64)\n"
+            "  -workers=<n>       Highest scaling worker count (default all hardware threads)\n"
+            "  -output=<file>     Write JSON results to a file instead of stdout\n"
+            "  -summary           Also print a human readable table\n"));
+    }
+}
+
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
+{
+    FTaskTagScope Scope(ETaskTag::EGameThread);
+    ON_SCOPE_EXIT
+    {
+        RequestEngineExit(TEXT("HearthshireVoxelBench exiting"));
+        FEngineLoop::AppPreExit();
+        FModuleManager::Get().UnloadModulesAtShutdown();
+        FEngineLoop::AppExit();
+    };
+
+    // Pre-init only - no world, renderer or asset loading is needed for the mesher
+    if (int32 Ret = GEngineLoop.PreInit(ArgC, ArgV, TEXT("-nullrhi -nosound -unattended -nosplash -nopause")))
+    {
+        return Ret;
+    }
+
+    const TCHAR* CommandLine = FCommandLine::Get();
+    if (FParse::Param(CommandLine, TEXT("help")) || FParse::Param(CommandLine, TEXT("?")))
+    {
+        VoxelBench::PrintUsage();
+        return 0;
+    }
+
+    int32 Iterations = 30;
+    int32 WarmupIterations = 3;
+    int32 ChunkSize = 32;
+    int32 BatchSize = 64;
+    int32 MaxWorkers = 0;
+    FString Filter;
+    FString OutputPath;
+    FParse::Value(CommandLine, TEXT("iterations="), Iterations);
+    FParse::Value(CommandLine, TEXT("warmup="), WarmupIterations);
+    FParse::Value(CommandLine, TEXT("size="), ChunkSize);
+    FParse::Value(CommandLine, TEXT("batch="), BatchSize);
+    FParse::Value(CommandLine, TEXT("workers="), MaxWorkers);
+    FParse::Value(CommandLine, TEXT("filter="), Filter);
+    FParse::Value(CommandLine, TEXT("output="), OutputPath);
+
+    if (ChunkSize < 4 || ChunkSize > 128)
+    {
+        UE_LOG(LogHearthshireVoxelBench, Error, TEXT("Chunk size %d out of range (4-128)"), ChunkSize);
+        return 1;
+    }
+
+    TArray<FVoxelBenchmarkFixture> Fixtures;
+    FVoxelBenchmarkRunner::BuildSyntheticFixtures(FVoxelChunkSize(ChunkSize), Fixtures);
+
+    FVoxelBenchmarkRunner Runner(WarmupIterations, Iterations);
+    Runner.Filter = Filter;
+    if (FParse::Param(CommandLine, TEXT("scaling")))
+    {
+        Runner.RunThreadScaling(Fixtures, BatchSize, MaxWorkers);
+    }
+    else if (FParse::Param(CommandLine, TEXT("layout")))
+    {
+        Runner.RunLayoutComparison(Fixtures);
+    }
+    else
+    {
+        Runner.RunPipeline(Fixtures);
+    }
+
+    if (Runner.GetResults().Num() == 0)
+    {
+        UE_LOG(LogHearthshireVoxelBench, Error, TEXT("No benchmark matched filter '%s'"), *Filter);
+        return 1;
+    }
+
+    if (FParse::Param(CommandLine, TEXT("summary")))
+    {
+        FPlatformMisc::LocalPrint(*Runner.GetSummary());
+    }
+
+    if (OutputPath.IsEmpty())
+    {
+        FPlatformMisc::LocalPrint(*(Runner.ToJson() + TEXT("\n")));
+    }
+    else if (!Runner.SaveJson(OutputPath))
+    {
+        return 1;
+    }
+
+    // Any codec round trip mismatch fails the run
+    for (const FVoxelBenchmarkResult& Result : Runner.GetResults())
+    {
+        const double* RoundTrip = Result.Counters.Find(TEXT("roundtrip_ok"));
+        if (RoundTrip && *RoundTrip == 0.0)
+        {
+            UE_LOG(LogHearthshireVoxelBench, Error, TEXT("%s: decompressed data does not match the input"), *Result.GetName());
+            return 1;
+        }
+    }
+
+    return 0;
+}